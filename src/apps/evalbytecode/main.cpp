@@ -1,23 +1,68 @@
+#include <sjtd_tracer.h>
+#include <sjtm_perfmap.h>
+#include <sjto_constantfoldutil.h>
+#include <sjto_inlineutil.h>
+#include <sjto_looputil.h>
+#include <sjto_peepholeutil.h>
+#include <sjtu_bytecodedslreader.h>
 #include <sjtu_bytecodedslutil.h>
 #include <sjtu_interpretutil.h>
+#include <sjtu_trampolinetable.h>
 
 #include <bdlma_sequentialallocator.h>
 
+#include <bsl_cstring.h>
+#include <bsl_fstream.h>
 #include <bsl_iostream.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 using namespace BloombergLP;
 
 namespace {
 void printUsage() {
     bsl::cerr << "Usage:\n"
-        << "evalbytecode <bytecode DSL>\n\n"
+        << "evalbytecode [<option>...] <bytecode DSL>\n"
+        << "evalbytecode [<option>...] -f <file>\n"
+        << "evalbytecode [<option>...] -\n\n"
         << "Where <bytecode> is described in 'sjtu_bytedslutil.h', print the "
-        << "result.\n";
-}
+        << "result.  The program is read from the command line, from the "
+        << "specified <file>, or, given '-', from standard input.  Given "
+        << "'--perf-map' or '--jitdump', the program is evaluated in a frame "
+        << "named for it, which is described to 'perf' in "
+        << "/tmp/perf-<pid>.map, or in /tmp/jit-<pid>.dump for "
+        << "'perf inject --jit', respectively.  Given '--trace <json>', "
+        << "a timeline of the reading, evaluation, compilation and garbage "
+        << "collection is written to <json>, in the Chrome trace event "
+        << "format read by 'chrome://tracing' and Perfetto.  Given '-O', "
+        << "the program is optimized by inlining calls, optimizing loops, "
+        << "folding constants and rewriting peepholes before it is "
+        << "evaluated, and the functions it calls often are compiled to "
+        << "machine code, which '--perf-map' and '--jitdump' also describe; "
+        << "otherwise it is interpreted as read.\n";
 }
 
-int main(int argc, char* argv[]) {
-    if (2 != argc) {
+struct Collector {
+    // Sink that appends every bytecode read to a vector.
+
+    bsl::vector<sjtt::Bytecode> *d_codes_p;
+
+    void operator()(const sjtt::Bytecode& code) const {
+        d_codes_p->push_back(code);
+    }
+};
+
+int evaluate(int argc, char* argv[], int perfFormats, bool optimize) {
+    // Evaluate the program given by the specified 'argc' arguments 'argv',
+    // left after the options, in a frame described to 'perf' in the
+    // specified 'perfFormats', print its result, and return the exit status
+    // of this program.  Optimize the program before evaluating it if the
+    // specified 'optimize' is 'true'.
+
+    const bool fromFile  = 3 == argc && 0 == bsl::strcmp(argv[1], "-f");
+    const bool fromStdin = 2 == argc && 0 == bsl::strcmp(argv[1], "-");
+    if (2 != argc && !fromFile) {
         printUsage();
         return 1;
     }
@@ -25,18 +70,136 @@ int main(int argc, char* argv[]) {
     bsl::vector<sjtt::Bytecode> codes(&alloc);
     bsl::string errorMessage;
     sjtu::BytecodeDSLUtil::FunctionNameToAddressMap functions;
-    const int ret = sjtu::BytecodeDSLUtil::readDSL(&codes,
-                                                   &errorMessage,
-                                                   argv[1],
-                                                   functions);
+    int ret;
+    if (fromFile || fromStdin) {
+        const Collector collector = { &codes };
+        sjtu::BytecodeDSLReader reader(collector, &functions, &alloc);
+        if (fromStdin) {
+            ret = reader.readFileDescriptor(0);
+        }
+        else {
+            const int fd = ::open(argv[2], O_RDONLY);
+            if (0 > fd) {
+                bsl::cerr << "unable to open '" << argv[2] << "'\n\n";
+                printUsage();
+                return 1;
+            }
+            ret = reader.readMappedFile(fd);
+            ::close(fd);
+        }
+        errorMessage = reader.errorMessage();
+    }
+    else {
+        ret = sjtu::BytecodeDSLUtil::readDSL(&codes,
+                                             &errorMessage,
+                                             argv[1],
+                                             functions);
+    }
     if (0 != ret) {
         bsl::cerr << errorMessage << "\n\n";
         printUsage();
         return 1;
     }
-    const bdld::Datum value = sjtu::InterpretUtil::interpretBytecode(
-                                                                    &alloc,
-                                                                    &codes[0]);
+    if (codes.empty()) {
+        bsl::cerr << "empty program\n\n";
+        printUsage();
+        return 1;
+    }
+    if (optimize) {
+        sjto::InlineUtil::inlineCalls(&codes);
+        sjto::LoopUtil::optimize(&codes);
+        sjto::ConstantFoldUtil::optimize(&codes);
+        sjto::PeepholeUtil::optimize(&codes);
+    }
+    const int baselineThreshold =
+                optimize ? sjtu::InterpretUtil::s_DefaultBaselineThreshold : 0;
+    if (0 == perfFormats) {
+        bdlma::SequentialAllocator scratch;
+        bdld::Datum                value;
+        sjtu::InterpretUtil::interpretBytecode(&value,
+                                               &alloc,
+                                               &codes[0],
+                                               0,
+                                               0,
+                                               0,
+                                               &scratch,
+                                               0,
+                                               0,
+                                               0,
+                                               baselineThreshold);
+        bsl::cout << value << '\n';
+        return 0;
+    }
+
+    // The perf map outlives the trampolines, and is left in place for the
+    // profiler.
+
+    sjtm::PerfMap         perfMap(perfFormats, &alloc);
+    sjtu::TrampolineTable trampolines(&perfMap, &alloc);
+    if (perfFormats != perfMap.formats()) {
+        bsl::cerr << "unable to write every format requested to /tmp\n";
+    }
+    const char *sourceName = fromFile ? argv[2] : fromStdin ? "stdin" : "";
+    bdlma::SequentialAllocator scratch;
+    bdld::Datum                value;
+    trampolines.interpretBytecode(&value,
+                                  &alloc,
+                                  &codes[0],
+                                  0,
+                                  0,
+                                  0,
+                                  &scratch,
+                                  sourceName,
+                                  0,
+                                  0,
+                                  0,
+                                  baselineThreshold);
     bsl::cout << value << '\n';
     return 0;
 }
+}
+
+int main(int argc, char* argv[]) {
+    int         perfFormats = 0;
+    const char *tracePath   = 0;
+    bool        optimize    = false;
+    while (1 < argc) {
+        if (0 == bsl::strcmp(argv[1], "--perf-map")) {
+            perfFormats |= sjtm::PerfMap::e_PERF_MAP;
+        }
+        else if (0 == bsl::strcmp(argv[1], "--jitdump")) {
+            perfFormats |= sjtm::PerfMap::e_JITDUMP;
+        }
+        else if (0 == bsl::strcmp(argv[1], "-O")) {
+            optimize = true;
+        }
+        else if (0 == bsl::strcmp(argv[1], "--trace") && 2 < argc) {
+            tracePath = argv[2];
+            ++argv;
+            --argc;
+        }
+        else {
+            break;
+        }
+        ++argv;
+        --argc;
+    }
+    if (0 == tracePath) {
+        return evaluate(argc, argv, perfFormats, optimize);
+    }
+
+    // The timeline covers every thread, including those compiling and
+    // marking, until the evaluation returns.
+
+    sjtd::Tracer tracer;
+    sjtd::Tracer::install(&tracer);
+    const int rc = evaluate(argc, argv, perfFormats, optimize);
+    sjtd::Tracer::install(0);
+
+    bsl::ofstream trace(tracePath);
+    if (0 != tracer.writeChromeJson(trace)) {
+        bsl::cerr << "unable to write the trace to '" << tracePath << "'\n";
+        return 0 == rc ? 1 : rc;
+    }
+    return rc;
+}
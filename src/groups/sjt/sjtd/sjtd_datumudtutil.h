@@ -9,6 +9,7 @@
 
 namespace sjtt { class ExecutionContext; }
 namespace sjtt { class Bytecode; }
+namespace sjtm { class Object; }
 
 namespace sjtd {
 
@@ -33,6 +34,9 @@ struct DatumUdtUtil {
         e_Code,
             // the data of the datum will be of type 'const Byecode *'
 
+        e_Object,
+            // the data of the datum will be of type 'sjtm::Object *'
+
         e_User,
             // Values >= 'e_User' are available for use by clients of Scramjet
     };
@@ -62,6 +66,17 @@ struct DatumUdtUtil {
 
     static Datum datumFromExternalFunction(ExternalFunction function);
         // Return a new 'Datum' object containing the specified 'function'.
+
+    static bool isObject(const Datum& value);
+        // Return true if the specified 'value' refers to a heap object and
+        // false otherwise.
+
+    static sjtm::Object *getObject(const Datum& value);
+        // Return the heap object referred to by the specified 'value'.  The
+        // behavior is undefined unless 'true == isObject(value)'.
+
+    static Datum datumFromObject(sjtm::Object *object);
+        // Return a new 'Datum' object referring to the specified 'object'.
 };
 
 // ============================================================================
@@ -111,6 +126,24 @@ DatumUdtUtil::datumFromExternalFunction(ExternalFunction function) {
     return Datum::createUdt(reinterpret_cast<void *>(function),
                             e_ExternalFunction);
 }
+
+inline
+bool DatumUdtUtil::isObject(const Datum& value) {
+    return value.isUdt() && value.theUdt().type() == e_Object;
+}
+
+inline
+sjtm::Object *DatumUdtUtil::getObject(const Datum& value) {
+    BSLS_ASSERT(isObject(value));
+
+    return static_cast<sjtm::Object *>(value.theUdt().data());
+}
+
+inline
+DatumUdtUtil::Datum DatumUdtUtil::datumFromObject(sjtm::Object *object) {
+    BSLS_ASSERT(0 != object);
+    return Datum::createUdt(object, e_Object);
+}
 }
 
 #endif
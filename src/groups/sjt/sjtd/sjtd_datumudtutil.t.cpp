@@ -73,6 +73,20 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 9: {
+        if (verbose) cout << endl
+                          << "object" << endl
+                          << "======" << endl;
+
+        int storage;
+        sjtm::Object *object = reinterpret_cast<sjtm::Object *>(&storage);
+        const bdld::Datum d = DatumUdtUtil::datumFromObject(object);
+        ASSERT(DatumUdtUtil::isObject(d));
+        ASSERT(object == DatumUdtUtil::getObject(d));
+        ASSERT(!DatumUdtUtil::isCode(d));
+        ASSERT(!DatumUdtUtil::isObject(DatumUdtUtil::datumFromCode(0)));
+        ASSERT(!DatumUdtUtil::isObject(bdld::Datum::createNull()));
+      } break;
       case 8: {
         if (verbose) cout << endl
                           << "datumFromCode" << endl
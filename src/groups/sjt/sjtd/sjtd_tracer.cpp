@@ -0,0 +1,244 @@
+// sjtd_tracer.cpp
+#include <sjtd_tracer.h>
+
+#include <bslma_default.h>
+#include <bslmt_lockguard.h>
+#include <bsls_assert.h>
+#include <bsls_timeutil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstdio.h>
+#include <bsl_new.h>
+#include <bsl_ostream.h>
+
+#include <unistd.h>
+
+using namespace BloombergLP;
+
+namespace sjtd {
+namespace {
+
+typedef bsls::Types::Uint64 Uint64;
+
+bsls::AtomicUint64 s_nextId(1);
+    // The identifier of the next tracer created.
+
+struct ThreadCache {
+    // This 'struct' remembers the ring buffer of the calling thread in the
+    // tracer it last recorded into, found by the identifier of the tracer,
+    // so that a tracer created at the address of a destroyed one is not
+    // mistaken for it.
+
+    Uint64  d_id;
+    void   *d_buffer_p;
+};
+
+thread_local ThreadCache t_cache = { 0, 0 };
+
+bool isBefore(const Tracer::Event& lhs, const Tracer::Event& rhs)
+    // Return 'true' if the specified 'lhs' is exported before the specified
+    // 'rhs', and 'false' otherwise.
+{
+    if (lhs.d_thread != rhs.d_thread) {
+        return lhs.d_thread < rhs.d_thread;                           // RETURN
+    }
+    if (lhs.d_begin != rhs.d_begin) {
+        return lhs.d_begin < rhs.d_begin;                             // RETURN
+    }
+    return lhs.d_end > rhs.d_end;
+}
+
+void writeMicroseconds(bsl::ostream& stream, Tracer::Int64 nanoseconds)
+    // Write to the specified 'stream' the specified 'nanoseconds' in
+    // microseconds, with three decimals.
+{
+    const long long magnitude = nanoseconds < 0 ? -nanoseconds : nanoseconds;
+
+    char buffer[32];
+    bsl::snprintf(buffer,
+                  sizeof buffer,
+                  "%s%lld.%03d",
+                  nanoseconds < 0 ? "-" : "",
+                  magnitude / 1000,
+                  static_cast<int>(magnitude % 1000));
+    stream << buffer;
+}
+
+}  // close unnamed namespace
+
+                                // ------------
+                                // class Tracer
+                                // ------------
+
+// CLASS DATA
+bsls::AtomicPointer<Tracer> Tracer::s_installed(0);
+
+// PRIVATE MANIPULATORS
+Tracer::Buffer *Tracer::bufferOfThisThread()
+{
+    if (d_id == t_cache.d_id) {
+        return static_cast<Buffer *>(t_cache.d_buffer_p);             // RETURN
+    }
+
+    Buffer *buffer = static_cast<Buffer *>(
+                                     d_allocator_p->allocate(sizeof(Buffer)));
+    new (buffer) Buffer();
+    buffer->d_events = static_cast<Event *>(
+                          d_allocator_p->allocate(d_capacity * sizeof(Event)));
+    {
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        buffer->d_thread = static_cast<int>(d_buffers.size());
+        d_buffers.push_back(buffer);
+    }
+    t_cache.d_id       = d_id;
+    t_cache.d_buffer_p = buffer;
+    return buffer;
+}
+
+// CLASS METHODS
+void Tracer::install(Tracer *tracer)
+{
+    s_installed.storeRelease(tracer);
+}
+
+Tracer::Int64 Tracer::now()
+{
+    return bsls::TimeUtil::getTimer();
+}
+
+// CREATORS
+Tracer::Tracer(int capacity, Allocator *basicAllocator)
+: d_buffers(basicAllocator)
+, d_capacity(1)
+, d_start(now())
+, d_id(s_nextId.add(1) - 1)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+    BSLS_ASSERT(0 < capacity);
+
+    // A ring buffer has a slot more than the events it keeps, being written
+    // while they are exported.
+
+    while (d_capacity <= capacity) {
+        d_capacity *= 2;
+    }
+}
+
+Tracer::~Tracer()
+{
+    BSLS_ASSERT(this != installed());
+
+    for (bsl::size_t i = 0; i < d_buffers.size(); ++i) {
+        d_allocator_p->deallocate(d_buffers[i]->d_events);
+        d_buffers[i]->~Buffer();
+        d_allocator_p->deallocate(d_buffers[i]);
+    }
+}
+
+// MANIPULATORS
+void Tracer::record(const char *category,
+                    const char *name,
+                    Int64       begin,
+                    Int64       end)
+{
+    BSLS_ASSERT(0 != category);
+    BSLS_ASSERT(0 != name);
+    BSLS_ASSERT(begin <= end);
+
+    // The event is complete before the count publishing it is stored, with
+    // release semantics, so that an export having loaded the count with
+    // acquire semantics sees it.
+
+    Buffer      *buffer    = bufferOfThisThread();
+    const Int64  numEvents = buffer->d_numEvents.loadRelaxed();
+    Event&       event     = buffer->d_events[numEvents & (d_capacity - 1)];
+    event.d_category_p = category;
+    event.d_name_p     = name;
+    event.d_begin      = begin;
+    event.d_end        = end;
+    event.d_thread     = buffer->d_thread;
+    buffer->d_numEvents.storeRelease(numEvents + 1);
+}
+
+// ACCESSORS
+void Tracer::events(bsl::vector<Event> *result) const
+{
+    BSLS_ASSERT(0 != result);
+
+    result->clear();
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    for (bsl::size_t i = 0; i < d_buffers.size(); ++i) {
+        const Buffer& buffer = *d_buffers[i];
+
+        // Copy the events published, then drop those that may have been
+        // overwritten meanwhile: the thread may be writing the event after
+        // the last one published, in the spare slot, and then over the
+        // oldest ones kept.
+
+        const Int64       last  = buffer.d_numEvents.loadAcquire();
+        const Int64       first = bsl::max(last - d_capacity + 1, Int64(0));
+        const bsl::size_t size  = result->size();
+        for (Int64 j = first; j < last; ++j) {
+            result->push_back(buffer.d_events[j & (d_capacity - 1)]);
+        }
+        const Int64 kept = buffer.d_numEvents.loadAcquire() - d_capacity + 1;
+        if (first < kept) {
+            result->erase(result->begin() + size,
+                          result->begin() + size
+                                      + static_cast<bsl::size_t>(
+                                              bsl::min(kept, last) - first));
+        }
+    }
+    bsl::sort(result->begin(), result->end(), &isBefore);
+}
+
+Tracer::Int64 Tracer::numEvents() const
+{
+    Int64 numEvents = 0;
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    for (bsl::size_t i = 0; i < d_buffers.size(); ++i) {
+        numEvents += d_buffers[i]->d_numEvents.loadAcquire();
+    }
+    return numEvents;
+}
+
+int Tracer::numThreads() const
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    return static_cast<int>(d_buffers.size());
+}
+
+int Tracer::writeChromeJson(bsl::ostream& stream) const
+{
+    bsl::vector<Event> all(d_allocator_p);
+    events(&all);
+    const int numThreads = this->numThreads();
+    const int pid        = static_cast<int>(::getpid());
+
+    // Each thread is named by its index, in the order it first recorded.
+
+    stream << "{\"traceEvents\":[";
+    const char *separator = "\n";
+    for (int i = 0; i < numThreads; ++i) {
+        stream << separator
+               << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+               << ",\"tid\":" << i
+               << ",\"args\":{\"name\":\"thread " << i << "\"}}";
+        separator = ",\n";
+    }
+    for (bsl::size_t i = 0; i < all.size(); ++i) {
+        const Event& event = all[i];
+        stream << separator
+               << "{\"name\":\"" << event.d_name_p
+               << "\",\"cat\":\"" << event.d_category_p
+               << "\",\"ph\":\"X\",\"ts\":";
+        writeMicroseconds(stream, event.d_begin - d_start);
+        stream << ",\"dur\":";
+        writeMicroseconds(stream, event.d_end - event.d_begin);
+        stream << ",\"pid\":" << pid << ",\"tid\":" << event.d_thread << "}";
+        separator = ",\n";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return stream.good() ? 0 : 1;
+}
+}
@@ -0,0 +1,264 @@
+// sjtd_tracer.h
+
+#ifndef INCLUDED_SJTD_TRACER
+#define INCLUDED_SJTD_TRACER
+
+#ifndef INCLUDED_BSL_IOSFWD
+#include <bsl_iosfwd.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_MUTEX
+#include <bslmt_mutex.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtd {
+
+                                // ============
+                                // class Tracer
+                                // ============
+
+class Tracer {
+    // This class is a mechanism recording a timeline of the phases of
+    // evaluation -- reading programs, interpreting them, calling external
+    // functions, compiling and collecting garbage -- and exporting it as
+    // Chrome trace events, which 'chrome://tracing' and Perfetto display.
+    //
+    // Phases are recorded by the 'SJTD_TRACER_SCOPE' macro, as events lasting
+    // from the macro to the end of its scope, into the tracer installed by
+    // 'install', if any.  Each thread records into a ring buffer of its own,
+    // created the first time it records, without taking a lock or writing
+    // memory that another thread writes; when a ring buffer is full, its
+    // oldest events are overwritten.  With no tracer installed, a scope
+    // costs one load of the installed tracer, and if 'SJTD_TRACER_DISABLE'
+    // is defined when this header is included, it costs nothing at all.
+    //
+    // The events are exported by 'writeChromeJson', which expects the
+    // threads that recorded them to have stopped recording; events that a
+    // thread overwrites during the export are omitted.  A tracer may be
+    // used concurrently from multiple threads, but must not be destroyed
+    // while it is installed, or while a thread is recording into it.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    struct Event {
+        // This 'struct' describes one event.
+
+        const char *d_category_p;   // static string
+        const char *d_name_p;       // static string
+        Int64       d_begin;        // nanoseconds, as 'now'
+        Int64       d_end;          // nanoseconds, as 'now'
+        int         d_thread;       // index of the recording thread
+    };
+
+    // CONSTANTS
+    static const int s_DefaultCapacity = 16384;
+        // The number of events each thread keeps, unless specified
+        // otherwise.
+
+  private:
+    // PRIVATE TYPES
+    struct Buffer {
+        // This 'struct' is the ring buffer of one thread.
+
+        Event                           *d_events;    // 'd_capacity' events
+        BloombergLP::bsls::AtomicInt64   d_numEvents; // ever recorded;
+                                                      // written only by its
+                                                      // thread
+        int                              d_thread;
+    };
+
+    // CLASS DATA
+    static BloombergLP::bsls::AtomicPointer<Tracer>
+                                 s_installed;
+
+    // DATA
+    bsl::vector<Buffer *>        d_buffers;    // per recording thread
+    int                          d_capacity;   // a power of two, above
+                                               // the events kept
+    Int64                        d_start;      // as 'now', at creation
+    BloombergLP::bsls::Types::Uint64
+                                 d_id;         // unique among tracers
+    mutable BloombergLP::bslmt::Mutex
+                                 d_mutex;      // guards 'd_buffers'
+    Allocator                   *d_allocator_p;  // held, not owned
+
+    // PRIVATE MANIPULATORS
+    Buffer *bufferOfThisThread();
+        // Return the ring buffer of the calling thread, creating it if this
+        // thread has not recorded yet.
+
+    // NOT IMPLEMENTED
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+  public:
+    // CLASS METHODS
+    static void install(Tracer *tracer);
+        // Record the events of the scopes entered from now on, by any thread,
+        // into the specified 'tracer', or into none if 'tracer' is 0.
+
+    static Tracer *installed();
+        // Return the address of the installed tracer, or 0 if there is none.
+
+    static Int64 now();
+        // Return the current time, in nanoseconds from an arbitrary origin.
+
+    // CREATORS
+    explicit Tracer(int capacity = s_DefaultCapacity,
+                    Allocator *basicAllocator = 0);
+        // Create a tracer having no events, in which each thread keeps at
+        // least the optionally specified 'capacity' most recent events, or
+        // 's_DefaultCapacity' events otherwise.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.  The behavior
+        // is undefined unless '0 < capacity'.
+
+    ~Tracer();
+        // Destroy this object.  The behavior is undefined if this tracer is
+        // installed, or a thread is recording into it.
+
+    // MANIPULATORS
+    void record(const char *category,
+                const char *name,
+                Int64       begin,
+                Int64       end);
+        // Record, in the ring buffer of the calling thread, an event of the
+        // specified 'category' and 'name', lasting from the specified
+        // 'begin' to the specified 'end', as returned by 'now'.  The
+        // behavior is undefined unless 'category' and 'name' outlive this
+        // tracer, e.g., are string literals, hold no character that must be
+        // escaped in JSON, and 'begin <= end'.
+
+    // ACCESSORS
+    void events(bsl::vector<Event> *result) const;
+        // Load into the specified 'result' the events kept by every thread,
+        // ordered by thread, then by beginning, outermost first.
+
+    int numThreads() const;
+        // Return the number of threads that have recorded an event.
+
+    Int64 numEvents() const;
+        // Return the number of events ever recorded, including those
+        // overwritten.
+
+    int writeChromeJson(bsl::ostream& stream) const;
+        // Write to the specified 'stream' the events kept, as a JSON object
+        // in the Chrome trace event format, holding one complete event per
+        // event, timed in microseconds from the creation of this tracer, and
+        // the name of each thread, and return 0 on success, and a non-zero
+        // value if 'stream' fails.
+};
+
+                              // =================
+                              // class TracerScope
+                              // =================
+
+class TracerScope {
+    // This class is a guard recording, into the tracer installed when it is
+    // created, if any, an event lasting until it is destroyed.  It is
+    // typically created by 'SJTD_TRACER_SCOPE'.
+
+    // DATA
+    Tracer        *d_tracer_p;    // held, not owned, or 0
+    const char    *d_category_p;
+    const char    *d_name_p;
+    Tracer::Int64  d_begin;
+
+    // NOT IMPLEMENTED
+    TracerScope(const TracerScope&) = delete;
+    TracerScope& operator=(const TracerScope&) = delete;
+
+  public:
+    // CREATORS
+    TracerScope(const char *category, const char *name);
+        // Create a guard beginning an event of the specified 'category' and
+        // 'name', whose requirements are those of 'Tracer::record'.
+
+    ~TracerScope();
+        // Record the event, and destroy this object.
+};
+
+}
+
+// ============================================================================
+//                                   MACROS
+// ============================================================================
+
+#if defined(SJTD_TRACER_DISABLE)
+
+#define SJTD_TRACER_SCOPE(category, name)
+
+#else
+
+#define SJTD_TRACER_SCOPE(category, name)                                     \
+    const ::sjtd::TracerScope SJTD_TRACER_NAME(sjtdTracerScope, __LINE__)(    \
+                                                             category, name)
+    // Record an event of the specified 'category' and 'name', string
+    // literals, lasting until the end of the enclosing scope, into the
+    // installed tracer, if any.
+
+#define SJTD_TRACER_NAME(prefix, line) SJTD_TRACER_NAME_IMP(prefix, line)
+#define SJTD_TRACER_NAME_IMP(prefix, line) prefix ## line
+
+#endif
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+namespace sjtd {
+
+                                // ------------
+                                // class Tracer
+                                // ------------
+
+// CLASS METHODS
+inline
+Tracer *Tracer::installed()
+{
+    return s_installed.loadAcquire();
+}
+
+                              // -----------------
+                              // class TracerScope
+                              // -----------------
+
+// CREATORS
+inline
+TracerScope::TracerScope(const char *category, const char *name)
+: d_tracer_p(Tracer::installed())
+, d_category_p(category)
+, d_name_p(name)
+, d_begin(0 != d_tracer_p ? Tracer::now() : 0)
+{
+}
+
+inline
+TracerScope::~TracerScope()
+{
+    if (0 != d_tracer_p) {
+        d_tracer_p->record(d_category_p, d_name_p, d_begin, Tracer::now());
+    }
+}
+}
+
+#endif
@@ -0,0 +1,286 @@
+// sjtd_tracer.t.cpp                                              -*-C++-*-
+
+#include <sjtd_tracer.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+#include <bslmt_threadutil.h>
+
+#include <bsl_sstream.h>
+#include <bsl_string.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtd;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                     GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef Tracer::Event Event;
+
+void nest(int depth)
+    // Record the specified 'depth' nested events, named "nest".
+{
+    SJTD_TRACER_SCOPE("test", "nest");
+    if (1 < depth) {
+        nest(depth - 1);
+    }
+}
+
+bool contains(const bsl::string& string, const char *substring)
+    // Return 'true' if the specified 'string' contains the specified
+    // 'substring', and 'false' otherwise.
+{
+    return bsl::string::npos != string.find(substring);
+}
+}
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "concurrent threads" << endl
+                          << "==================" << endl;
+
+        // Each thread records into a buffer of its own.
+
+        const int NUM_THREADS = 4;
+        const int NUM_TIMES   = 100;
+        const int DEPTH       = 3;
+
+        bslma::TestAllocator ta;
+        {
+            Tracer tracer(NUM_TIMES * DEPTH, &ta);
+            Tracer::install(&tracer);
+
+            bsl::vector<bslmt::ThreadUtil::Handle> handles(NUM_THREADS);
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                ASSERT(0 == bslmt::ThreadUtil::create(&handles[i], []() {
+                    for (int j = 0; j < NUM_TIMES; ++j) {
+                        nest(DEPTH);
+                    }
+                }));
+            }
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                bslmt::ThreadUtil::join(handles[i]);
+            }
+            Tracer::install(0);
+
+            ASSERT(NUM_THREADS == tracer.numThreads());
+            ASSERT(NUM_THREADS * NUM_TIMES * DEPTH == tracer.numEvents());
+
+            bsl::vector<Event> events;
+            tracer.events(&events);
+            ASSERT(NUM_THREADS * NUM_TIMES * DEPTH == events.size());
+
+            // Each thread's events are ordered, outermost first, and nest.
+
+            for (bsl::size_t i = 0; i < events.size(); ++i) {
+                const Event& event = events[i];
+                LOOP_ASSERT(i, static_cast<int>(i / (NUM_TIMES * DEPTH))
+                                                          == event.d_thread);
+                LOOP_ASSERT(i, bsl::string("nest") == event.d_name_p);
+                if (0 != i % DEPTH) {
+                    const Event& outer = events[i - 1];
+                    LOOP_ASSERT(i, outer.d_begin <= event.d_begin);
+                    LOOP_ASSERT(i, event.d_end <= outer.d_end);
+                }
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "ring buffers" << endl
+                          << "============" << endl;
+
+        // A full buffer overwrites its oldest events.
+
+        const char *NAMES[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8",
+                                "9" };
+
+        bslma::TestAllocator ta;
+        {
+            Tracer tracer(3, &ta);
+            for (int i = 0; i < 10; ++i) {
+                tracer.record("test", NAMES[i], 10 * i, 10 * i + 5);
+                bsl::vector<Event> events;
+                tracer.events(&events);
+                LOOP_ASSERT(i,
+                            bsl::min(i + 1, 3) ==
+                                          static_cast<int>(events.size()));
+                LOOP_ASSERT(i, NAMES[i] == events.back().d_name_p);
+            }
+            ASSERT(10 == tracer.numEvents());
+            ASSERT(1 == tracer.numThreads());
+
+            bsl::vector<Event> events;
+            tracer.events(&events);
+            ASSERT(3 == events.size());
+            for (int i = 0; i < 3; ++i) {
+                LOOP_ASSERT(i, NAMES[7 + i] == events[i].d_name_p);
+                LOOP_ASSERT(i, 10 * (7 + i) == events[i].d_begin);
+                LOOP_ASSERT(i, 10 * (7 + i) + 5 == events[i].d_end);
+                LOOP_ASSERT(i, 0 == events[i].d_thread);
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "Chrome trace events" << endl
+                          << "===================" << endl;
+
+        bslma::TestAllocator ta;
+        {
+            Tracer tracer(16, &ta);
+            {
+                bsl::ostringstream empty;
+                ASSERT(0 == tracer.writeChromeJson(empty));
+                LOOP_ASSERT(empty.str(),
+                            "{\"traceEvents\":[\n],"
+                            "\"displayTimeUnit\":\"ns\"}\n" == empty.str());
+            }
+
+            const Tracer::Int64 start = Tracer::now() + 1000000;
+            tracer.record("parse", "readDSL", start, start + 2500);
+            tracer.record("gc", "scavenge", start + 3000, start + 3001);
+
+            bsl::ostringstream stream;
+            ASSERT(0 == tracer.writeChromeJson(stream));
+            const bsl::string json = stream.str();
+            if (verbose) cout << json;
+
+            ASSERT(0 == json.find("{\"traceEvents\":[\n"));
+            ASSERT(contains(json, "{\"name\":\"thread_name\",\"ph\":\"M\","));
+            ASSERT(contains(json, "\"args\":{\"name\":\"thread 0\"}}"));
+            ASSERT(contains(json, "{\"name\":\"readDSL\",\"cat\":\"parse\","
+                                  "\"ph\":\"X\",\"ts\":"));
+            ASSERT(contains(json, ",\"dur\":2.500,"));
+            ASSERT(contains(json, "{\"name\":\"scavenge\",\"cat\":\"gc\","));
+            ASSERT(contains(json, ",\"dur\":0.001,"));
+            ASSERT(json.find("readDSL") < json.find("scavenge"));
+            ASSERT(contains(json, ",\"tid\":0}"));
+            ASSERT(json.size() - 27 == json.find("\n],\"displayTimeUnit\""));
+
+            // A failed stream is reported.
+
+            bsl::ostringstream failed;
+            failed.setstate(bsl::ios::badbit);
+            ASSERT(0 != tracer.writeChromeJson(failed));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        ASSERT(0 == Tracer::installed());
+        ASSERT(Tracer::now() <= Tracer::now());
+
+        bslma::TestAllocator ta;
+        {
+            Tracer tracer(Tracer::s_DefaultCapacity, &ta);
+            ASSERT(0 == tracer.numThreads());
+            ASSERT(0 == ta.numBlocksInUse());
+
+            // No event is recorded unless a tracer is installed.
+
+            nest(2);
+            ASSERT(0 == tracer.numEvents());
+
+            Tracer::install(&tracer);
+            ASSERT(&tracer == Tracer::installed());
+            {
+                SJTD_TRACER_SCOPE("test", "outer");
+                nest(2);
+            }
+            Tracer::install(0);
+            nest(1);
+
+            ASSERT(3 == tracer.numEvents());
+            ASSERT(1 == tracer.numThreads());
+
+            bsl::vector<Event> events;
+            tracer.events(&events);
+            ASSERT(3 == events.size());
+            ASSERT(bsl::string("outer") == events[0].d_name_p);
+            ASSERT(bsl::string("test") == events[0].d_category_p);
+            ASSERT(bsl::string("nest") == events[1].d_name_p);
+            ASSERT(bsl::string("nest") == events[2].d_name_p);
+            ASSERT(events[0].d_begin <= events[1].d_begin);
+            ASSERT(events[1].d_end <= events[0].d_end);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,65 @@
+// sjtm_closureutil.cpp
+#include <sjtm_closureutil.h>
+
+#include <bsls_assert.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_heap.h>
+#include <sjtm_object.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+
+                             // ------------------
+                             // struct ClosureUtil
+                             // ------------------
+
+// CLASS METHODS
+Object *ClosureUtil::create(Heap         *heap,
+                            const Datum&  code,
+                            const Datum  *captured,
+                            int           numCaptured)
+{
+    BSLS_ASSERT(0 != heap);
+    BSLS_ASSERT(sjtd::DatumUdtUtil::isCode(code));
+    BSLS_ASSERT(0 <= numCaptured);
+
+    Object *closure = heap->allocate(numCaptured + 1);
+    heap->setSlot(closure, 0, code);
+    for (int i = 0; i < numCaptured; ++i) {
+        heap->setSlot(closure, i + 1, captured[i]);
+    }
+    return closure;
+}
+
+const bdld::Datum& ClosureUtil::captured(const Object *closure, int index)
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numCaptured(closure));
+
+    return closure->slot(index + 1);
+}
+
+const sjtt::Bytecode *ClosureUtil::code(const Object *closure)
+{
+    return sjtd::DatumUdtUtil::getCode(closure->slot(0));
+}
+
+bool ClosureUtil::isClosure(const Datum& value)
+{
+    if (!sjtd::DatumUdtUtil::isObject(value)) {
+        return false;                                                 // RETURN
+    }
+    const Object *object = sjtd::DatumUdtUtil::getObject(value);
+    return 0 < object->numSlots() &&
+           sjtd::DatumUdtUtil::isCode(object->slot(0));
+}
+
+int ClosureUtil::numCaptured(const Object *closure)
+{
+    BSLS_ASSERT(0 < closure->numSlots());
+
+    return closure->numSlots() - 1;
+}
+}
@@ -0,0 +1,67 @@
+// sjtm_closureutil.h
+
+#ifndef INCLUDED_SJTM_CLOSUREUTIL
+#define INCLUDED_SJTM_CLOSUREUTIL
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+namespace sjtt { class Bytecode; }
+
+namespace sjtm {
+
+class Heap;
+class Object;
+
+                             // ==================
+                             // struct ClosureUtil
+                             // ==================
+
+struct ClosureUtil {
+    // This 'struct' provides a namespace for functions that create and
+    // inspect closures: functions together with the values of the variables
+    // they capture.  A closure is a heap object whose slot 0 holds the code
+    // value of the function (see 'sjtd::DatumUdtUtil::datumFromCode') and
+    // whose remaining slots hold the captured values, in order.  The
+    // representation is flat: a captured value is copied into the closure
+    // when it is created, so reading one is a single slot access rather than
+    // a walk along a chain of enclosing scopes.  A variable that must be
+    // shared, and modified, by several closures is captured as an object
+    // holding it.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+
+    // CLASS METHODS
+    static Object *create(Heap         *heap,
+                          const Datum&  code,
+                          const Datum  *captured,
+                          int           numCaptured);
+        // Return a new closure allocated from the specified 'heap', of the
+        // function whose code value is the specified 'code', capturing the
+        // specified 'numCaptured' values starting at 'captured'.  This
+        // method may collect garbage, as 'Heap::allocate' does; the values
+        // are read after the closure is allocated, so 'captured' may refer to
+        // roots of 'heap'.  The behavior is undefined unless 'code' is a code
+        // value and '0 <= numCaptured'.
+
+    static const Datum& captured(const Object *closure, int index);
+        // Return a reference providing non-modifiable access to the captured
+        // value at the specified 'index' of the specified 'closure'.  The
+        // behavior is undefined unless '0 <= index < numCaptured(closure)'.
+
+    static const sjtt::Bytecode *code(const Object *closure);
+        // Return the address of the first code of the function of the
+        // specified 'closure'.
+
+    static bool isClosure(const Datum& value);
+        // Return 'true' if the specified 'value' refers to a closure, i.e., to
+        // an object whose slot 0 holds a code value, and 'false' otherwise.
+
+    static int numCaptured(const Object *closure);
+        // Return the number of values captured by the specified 'closure'.
+};
+}
+
+#endif
@@ -0,0 +1,177 @@
+// sjtm_closureutil.t.cpp                                         -*-C++-*-
+
+#include <sjtm_closureutil.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_heap.h>
+#include <sjtm_object.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// 'sjtm' does not depend on 'sjtt', so code values refer to stand-ins for
+// the first codes of two functions, which are never examined.
+
+const int FUNCTIONS[2] = { 0, 0 };
+
+const sjtt::Bytecode *const F = reinterpret_cast<const sjtt::Bytecode *>(
+                                                               FUNCTIONS + 0);
+const sjtt::Bytecode *const G = reinterpret_cast<const sjtt::Bytecode *>(
+                                                               FUNCTIONS + 1);
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    typedef bdld::Datum        Datum;
+    typedef sjtd::DatumUdtUtil DUU;
+    typedef ClosureUtil        Obj;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "capturing roots" << endl
+                          << "===============" << endl;
+
+        // Closures capturing young objects held only in the roots, read
+        // after each allocation that may move them, refer to the objects
+        // after they are moved.
+
+        bslma::TestAllocator ta;
+        Heap heap(4096, &ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        const Datum CODE = DUU::datumFromCode(F);
+
+        for (int i = 0; i < 100; ++i) {
+            Object *value = heap.allocate(1);
+            heap.setSlot(value, 0, Datum::createInteger(i));
+            roots.push_back(DUU::datumFromObject(value));
+            Object *closure = Obj::create(&heap,
+                                          CODE,
+                                          &roots.back(),
+                                          1);
+            roots.back() = DUU::datumFromObject(closure);
+        }
+        ASSERT(0 < heap.numScavenges());
+
+        for (int i = 0; i < 100; ++i) {
+            LOOP_ASSERT(i, Obj::isClosure(roots[i]));
+            const Object *closure = DUU::getObject(roots[i]);
+            LOOP_ASSERT(i, F == Obj::code(closure));
+            LOOP_ASSERT(i, 1 == Obj::numCaptured(closure));
+            const Object *value = DUU::getObject(Obj::captured(closure, 0));
+            LOOP_ASSERT(i, Datum::createInteger(i) == value->slot(0));
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+
+        const Datum CAPTURED[] = {
+            Datum::createInteger(1),
+            Datum::createDouble(2.5),
+        };
+
+        Object *closure = Obj::create(&heap,
+                                      DUU::datumFromCode(G),
+                                      CAPTURED,
+                                      2);
+        const Datum value = DUU::datumFromObject(closure);
+        ASSERT(Obj::isClosure(value));
+        ASSERT(G == Obj::code(closure));
+        ASSERT(2 == Obj::numCaptured(closure));
+        ASSERT(CAPTURED[0] == Obj::captured(closure, 0));
+        ASSERT(CAPTURED[1] == Obj::captured(closure, 1));
+
+        Object *empty = Obj::create(&heap, DUU::datumFromCode(F), 0, 0);
+        ASSERT(Obj::isClosure(DUU::datumFromObject(empty)));
+        ASSERT(0 == Obj::numCaptured(empty));
+
+        // Code values, other objects and other values are not closures.
+
+        ASSERT(!Obj::isClosure(DUU::datumFromCode(F)));
+        ASSERT(!Obj::isClosure(DUU::datumFromObject(heap.allocate(0))));
+        ASSERT(!Obj::isClosure(DUU::datumFromObject(heap.allocate(1))));
+        ASSERT(!Obj::isClosure(Datum::createInteger(1)));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
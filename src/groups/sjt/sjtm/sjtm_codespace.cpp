@@ -0,0 +1,372 @@
+// sjtm_codespace.cpp
+#include <sjtm_codespace.h>
+
+#include <bslma_allocator.h>
+#include <bslma_default.h>
+#include <bsls_assert.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstring.h>
+#include <bsl_utility.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+namespace {
+
+typedef bsls::Types::Uint64  Uint64;
+typedef bsls::Types::UintPtr UintPtr;
+
+const Uint64 k_ALL_FREE = ~Uint64(0);
+
+int findFirstSet(Uint64 word)
+    // Return the index of the lowest bit set in the specified 'word'.  The
+    // behavior is undefined unless 'word' is not 0.
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int index = 0;
+    while (0 == (word & 1)) {
+        word >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+void flushInstructionCache(char *begin, char *end)
+    // Make the instructions in the specified range '[begin, end)' visible to
+    // instruction fetch, after they are written.
+{
+#if defined(__GNUC__)
+    __builtin___clear_cache(begin, end);
+#else
+    (void)begin;
+    (void)end;
+#endif
+}
+
+char *mapPages(bsl::size_t size)
+    // Return the address of a new readable and executable mapping of the
+    // specified 'size' bytes, or 0 if it cannot be mapped.
+{
+    void *memory = ::mmap(0,
+                          size,
+                          PROT_READ | PROT_EXEC,
+                          MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1,
+                          0);
+    return MAP_FAILED == memory ? 0 : static_cast<char *>(memory);
+}
+
+}  // close unnamed namespace
+
+                              // ---------------
+                              // class CodeSpace
+                              // ---------------
+
+// PRIVATE CLASS METHODS
+void CodeSpace::link(Slab **list, Slab *slab)
+{
+    slab->d_prev_p = 0;
+    slab->d_next_p = *list;
+    if (0 != *list) {
+        (*list)->d_prev_p = slab;
+    }
+    *list = slab;
+}
+
+void CodeSpace::unlink(Slab **list, Slab *slab)
+{
+    if (0 != slab->d_prev_p) {
+        slab->d_prev_p->d_next_p = slab->d_next_p;
+    }
+    else {
+        BSLS_ASSERT(*list == slab);
+        *list = slab->d_next_p;
+    }
+    if (0 != slab->d_next_p) {
+        slab->d_next_p->d_prev_p = slab->d_prev_p;
+    }
+    slab->d_next_p = 0;
+    slab->d_prev_p = 0;
+}
+
+// PRIVATE MANIPULATORS
+void *CodeSpace::allocateLarge(bsl::size_t size)
+{
+    const bsl::size_t mapped = (size + d_pageSize - 1) / d_pageSize
+                                                       * d_pageSize;
+    char *begin = mapPages(mapped);
+    if (0 == begin) {
+        return 0;                                                     // RETURN
+    }
+    const Region region = { begin, mapped, 0, 0, 1 };
+    d_regions.insert(bsl::make_pair(begin, region));
+    d_sizes[begin] = size;
+
+    d_numBytesMapped     += mapped;
+    d_numBytesUsed       += size;
+    d_numBytesFragmented += mapped - size;
+    return begin;
+}
+
+CodeSpace::Slab *CodeSpace::findEmptySlab()
+{
+    if (0 != d_empty_p) {
+        return d_empty_p;                                             // RETURN
+    }
+
+    const int numSlabs = static_cast<int>(d_regionSize / s_SlabSize);
+    Slab     *slabs    = static_cast<Slab *>(
+                             d_allocator_p->allocate(numSlabs * sizeof(Slab)));
+    char     *begin    = mapPages(d_regionSize);
+    if (0 == begin) {
+        d_allocator_p->deallocate(slabs);
+        return 0;                                                     // RETURN
+    }
+    const Region initial = { begin, d_regionSize, slabs, numSlabs, 0 };
+    Region&      region  = d_regions.insert(bsl::make_pair(begin, initial))
+                                    .first->second;
+    for (int i = numSlabs - 1; 0 <= i; --i) {
+        Slab& slab = slabs[i];
+        slab.d_region_p  = &region;
+        slab.d_begin     = begin + i * s_SlabSize;
+        slab.d_sizeClass = -1;
+        slab.d_numLive   = 0;
+        link(&d_empty_p, &slab);
+    }
+    d_numBytesMapped += d_regionSize;
+    return d_empty_p;
+}
+
+void CodeSpace::unmapRegion(Regions::iterator region)
+{
+    Region& doomed = region->second;
+    for (int i = 0; i < doomed.d_numSlabs; ++i) {
+        BSLS_ASSERT(0 > doomed.d_slabs[i].d_sizeClass);
+        unlink(&d_empty_p, &doomed.d_slabs[i]);
+    }
+    if (0 != doomed.d_slabs) {
+        d_allocator_p->deallocate(doomed.d_slabs);
+    }
+    ::munmap(doomed.d_begin, doomed.d_size);
+    d_numBytesMapped -= doomed.d_size;
+    if (&doomed == d_spare_p) {
+        d_spare_p = 0;
+    }
+    d_regions.erase(region);
+}
+
+// CLASS METHODS
+int CodeSpace::sizeClassFor(bsl::size_t size)
+{
+    if (blockSizeOf(s_NumSizeClasses - 1) < size) {
+        return -1;                                                    // RETURN
+    }
+    int sizeClass = 0;
+    while (blockSizeOf(sizeClass) < size) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+// CREATORS
+CodeSpace::CodeSpace(Allocator *basicAllocator)
+: d_regions(basicAllocator)
+, d_sizes(basicAllocator)
+, d_empty_p(0)
+, d_spare_p(0)
+, d_regionSize(s_DefaultRegionSize)
+, d_pageSize(::sysconf(_SC_PAGESIZE))
+, d_numBytesMapped(0)
+, d_numBytesUsed(0)
+, d_numBytesFragmented(0)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+    BSLS_ASSERT(0 == s_SlabSize % d_pageSize);
+    BSLS_ASSERT(k_MAX_BLOCKS_PER_SLAB * s_MinBlockSize == s_SlabSize);
+    BSLS_ASSERT(2 * blockSizeOf(s_NumSizeClasses - 1) == s_SlabSize);
+
+    bsl::fill(d_partial, d_partial + s_NumSizeClasses, (Slab *)0);
+}
+
+CodeSpace::CodeSpace(bsl::size_t regionSize, Allocator *basicAllocator)
+: d_regions(basicAllocator)
+, d_sizes(basicAllocator)
+, d_empty_p(0)
+, d_spare_p(0)
+, d_regionSize((regionSize + s_SlabSize - 1) / s_SlabSize * s_SlabSize)
+, d_pageSize(::sysconf(_SC_PAGESIZE))
+, d_numBytesMapped(0)
+, d_numBytesUsed(0)
+, d_numBytesFragmented(0)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+    BSLS_ASSERT(0 < regionSize);
+    BSLS_ASSERT(0 == s_SlabSize % d_pageSize);
+
+    bsl::fill(d_partial, d_partial + s_NumSizeClasses, (Slab *)0);
+}
+
+CodeSpace::~CodeSpace()
+{
+    for (Regions::iterator it = d_regions.begin();
+         d_regions.end() != it;
+         ++it) {
+        if (0 != it->second.d_slabs) {
+            d_allocator_p->deallocate(it->second.d_slabs);
+        }
+        ::munmap(it->second.d_begin, it->second.d_size);
+    }
+}
+
+// MANIPULATORS
+void *CodeSpace::allocate(bsl::size_t size)
+{
+    BSLS_ASSERT(0 < size);
+
+    const int sizeClass = sizeClassFor(size);
+    if (0 > sizeClass) {
+        return allocateLarge(size);                                   // RETURN
+    }
+    const bsl::size_t blockSize = blockSizeOf(sizeClass);
+    const int         numBlocks = static_cast<int>(s_SlabSize / blockSize);
+
+    Slab *slab = d_partial[sizeClass];
+    if (0 == slab) {
+        slab = findEmptySlab();
+        if (0 == slab) {
+            return 0;                                                 // RETURN
+        }
+
+        // The slab takes the size class, all of its blocks free.
+
+        unlink(&d_empty_p, slab);
+        slab->d_sizeClass = sizeClass;
+        for (int i = 0; i < k_NUM_WORDS; ++i) {
+            const int remaining = numBlocks - 64 * i;
+            slab->d_free[i] = 64 <= remaining ? k_ALL_FREE
+                            : 0 < remaining   ? (Uint64(1) << remaining) - 1
+                            :                   0;
+        }
+        link(&d_partial[sizeClass], slab);
+        if (0 == slab->d_region_p->d_numLive++ &&
+            slab->d_region_p == d_spare_p) {
+            d_spare_p = 0;
+        }
+        d_numBytesFragmented += s_SlabSize;
+    }
+
+    int word = 0;
+    while (0 == slab->d_free[word]) {
+        ++word;
+    }
+    const int bit = findFirstSet(slab->d_free[word]);
+    slab->d_free[word] &= ~(Uint64(1) << bit);
+    if (numBlocks == ++slab->d_numLive) {
+        unlink(&d_partial[sizeClass], slab);
+    }
+
+    char *block = slab->d_begin + (64 * word + bit) * blockSize;
+    d_sizes[block] = size;
+    d_numBytesUsed       += size;
+    d_numBytesFragmented -= size;
+    return block;
+}
+
+void CodeSpace::deallocate(void *block)
+{
+    BSLS_ASSERT(0 != block);
+
+    const char        *address = static_cast<const char *>(block);
+    Regions::iterator  it      = d_regions.upper_bound(address);
+    BSLS_ASSERT(d_regions.begin() != it);
+    --it;
+    Region& region = it->second;
+
+    Sizes::iterator sizeIt = d_sizes.find(block);
+    BSLS_ASSERT(d_sizes.end() != sizeIt);
+    const bsl::size_t size = sizeIt->second;
+    d_sizes.erase(sizeIt);
+    d_numBytesUsed -= size;
+
+    if (0 == region.d_slabs) {
+        d_numBytesFragmented -= region.d_size - size;
+        unmapRegion(it);
+        return;                                                       // RETURN
+    }
+
+    Slab&             slab      = region.d_slabs[(address - region.d_begin)
+                                                 / s_SlabSize];
+    const int         sizeClass = slab.d_sizeClass;
+    const bsl::size_t blockSize = blockSizeOf(sizeClass);
+    const int         numBlocks = static_cast<int>(s_SlabSize / blockSize);
+    const int         index     = static_cast<int>((address - slab.d_begin)
+                                                   / blockSize);
+    BSLS_ASSERT(0 == (slab.d_free[index / 64] & Uint64(1) << index % 64));
+
+    if (numBlocks == slab.d_numLive) {
+        link(&d_partial[sizeClass], &slab);
+    }
+    slab.d_free[index / 64] |= Uint64(1) << index % 64;
+    d_numBytesFragmented += size;
+    if (0 != --slab.d_numLive) {
+        return;                                                       // RETURN
+    }
+
+    // The slab is empty: it no longer has a size class, and its region is
+    // unmapped if no slab of it has one, unless it is kept as the spare.
+
+    unlink(&d_partial[sizeClass], &slab);
+    slab.d_sizeClass = -1;
+    link(&d_empty_p, &slab);
+    d_numBytesFragmented -= s_SlabSize;
+    if (0 == --region.d_numLive) {
+        if (0 == d_spare_p) {
+            d_spare_p = &region;
+        }
+        else {
+            unmapRegion(it);
+        }
+    }
+}
+
+int CodeSpace::write(void        *block,
+                     bsl::size_t  offset,
+                     const void  *bytes,
+                     bsl::size_t  numBytes)
+{
+    BSLS_ASSERT(0 != block);
+    BSLS_ASSERT(d_sizes.end() != d_sizes.find(block));
+    BSLS_ASSERT(offset + numBytes <= d_sizes.find(block)->second);
+
+    if (0 == numBytes) {
+        return 0;                                                     // RETURN
+    }
+    char *begin = static_cast<char *>(block) + offset;
+    char *end   = begin + numBytes;
+
+    // Protection changes a page at a time.
+
+    const UintPtr mask  = ~static_cast<UintPtr>(d_pageSize - 1);
+    char         *first = reinterpret_cast<char *>(
+                                    reinterpret_cast<UintPtr>(begin) & mask);
+    char         *last  = reinterpret_cast<char *>(
+                     (reinterpret_cast<UintPtr>(end) + d_pageSize - 1) & mask);
+
+    if (0 != ::mprotect(first, last - first, PROT_READ | PROT_WRITE)) {
+        return 1;                                                     // RETURN
+    }
+    bsl::memcpy(begin, bytes, numBytes);
+    if (0 != ::mprotect(first, last - first, PROT_READ | PROT_EXEC)) {
+        return 2;                                                     // RETURN
+    }
+    flushInstructionCache(begin, end);
+    return 0;
+}
+}
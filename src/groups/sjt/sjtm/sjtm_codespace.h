@@ -0,0 +1,280 @@
+// sjtm_codespace.h
+
+#ifndef INCLUDED_SJTM_CODESPACE
+#define INCLUDED_SJTM_CODESPACE
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_MAP
+#include <bsl_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_UNORDERED_MAP
+#include <bsl_unordered_map.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm {
+
+                              // ===============
+                              // class CodeSpace
+                              // ===============
+
+class CodeSpace {
+    // This class is a mechanism supplying blocks of executable memory for
+    // native code, e.g., that of a compiled tier.
+    //
+    // Memory is mapped from the system in regions of a given size, each
+    // divided into slabs of 's_SlabSize' bytes.  A slab holds blocks of a
+    // single size class, a power of two from 's_MinBlockSize' to half a slab,
+    // so that a block of any size is found, and freed, in constant time, and
+    // code of similar sizes is packed onto the same pages.  A larger block
+    // has a mapping of its own.
+    //
+    // No page is ever both writable and executable: blocks are mapped
+    // readable and executable, and 'write' makes the pages holding the bytes
+    // written writable, and not executable, only while it copies them, then
+    // invalidates the instruction cache for them.  Code in other blocks on
+    // those pages must therefore not be executing while a block is written.
+    //
+    // Memory deallocated is reclaimed: a slab whose blocks are all free may
+    // be reused for any size class, a region whose slabs are all free is
+    // unmapped, except for one kept to serve the next allocation, and a
+    // large block is unmapped when it is deallocated, so that loading and
+    // unloading code does not leak memory.  The bytes mapped are either
+    // used, i.e., requested for the blocks allocated, fragmented, i.e., in
+    // blocks allocated beyond the size requested or in the free blocks of
+    // slabs having a size class, or free, i.e., in slabs having no size
+    // class.
+    //
+    // The free blocks of a slab are found in a bitmap kept with the
+    // bookkeeping of the code space, so that the memory of a block is never
+    // written but by 'write'.
+    //
+    // A code space, and the blocks it supplies, must be used by one thread
+    // at a time, except that the code of its blocks may be executed
+    // concurrently with anything but a 'write' to the same pages.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    // CONSTANTS
+    static const bsl::size_t s_SlabSize = 64 * 1024;
+        // The number of bytes of a slab.
+
+    static const bsl::size_t s_MinBlockSize = 64;
+        // The number of bytes of the smallest size class.
+
+    static const int s_NumSizeClasses = 10;
+        // The number of size classes, the largest of which is half a slab.
+
+    static const bsl::size_t s_DefaultRegionSize = 4 * 1024 * 1024;
+        // The number of bytes of a region, unless specified otherwise.
+
+  private:
+    // PRIVATE TYPES
+    typedef BloombergLP::bsls::Types::Uint64 Uint64;
+
+    enum {
+        k_MAX_BLOCKS_PER_SLAB = 1024,                 // of the smallest class
+        k_NUM_WORDS           = k_MAX_BLOCKS_PER_SLAB / 64
+    };
+
+    struct Region;
+
+    struct Slab {
+        // This 'struct' describes the blocks of one slab.
+
+        Region *d_region_p;              // containing the slab
+        char   *d_begin;                 // first byte
+        int     d_sizeClass;             // -1 if the slab has none
+        int     d_numLive;               // number of blocks allocated
+        Uint64  d_free[k_NUM_WORDS];     // bit set per free block
+        Slab   *d_next_p;                // in the list of its size class, or
+                                         // of the slabs having none
+        Slab   *d_prev_p;
+    };
+
+    struct Region {
+        // This 'struct' describes one mapping.
+
+        char        *d_begin;            // first byte
+        bsl::size_t  d_size;             // number of bytes
+        Slab        *d_slabs;            // 0 for a large block
+        int          d_numSlabs;
+        int          d_numLive;          // slabs having a size class
+    };
+
+    typedef bsl::map<const char *, Region> Regions;
+        // The regions, by first byte.
+
+    typedef bsl::unordered_map<const void *, bsl::size_t> Sizes;
+        // The size requested for each block allocated.
+
+    // DATA
+    Regions      d_regions;
+    Sizes        d_sizes;
+    Slab        *d_partial[s_NumSizeClasses];  // slabs having a free block
+    Slab        *d_empty_p;                    // slabs having no size class
+    Region      *d_spare_p;                    // region kept although all of
+                                               // its slabs are empty, or 0
+    bsl::size_t  d_regionSize;
+    bsl::size_t  d_pageSize;
+    bsl::size_t  d_numBytesMapped;
+    bsl::size_t  d_numBytesUsed;
+    bsl::size_t  d_numBytesFragmented;
+    Allocator   *d_allocator_p;                // held, not owned
+
+    // PRIVATE CLASS METHODS
+    static void link(Slab **list, Slab *slab);
+        // Add the specified 'slab' to the front of the specified 'list'.
+
+    static void unlink(Slab **list, Slab *slab);
+        // Remove the specified 'slab' from the specified 'list'.
+
+    // PRIVATE MANIPULATORS
+    void *allocateLarge(bsl::size_t size);
+        // Return the address of a block of at least the specified 'size'
+        // bytes having a mapping of its own, or 0 if it cannot be mapped.
+
+    Slab *findEmptySlab();
+        // Return the address of a slab having no size class, mapping a new
+        // region if there is none, or 0 if it cannot be mapped.
+
+    void unmapRegion(Regions::iterator region);
+        // Unmap the specified 'region', and forget it and its slabs.
+
+    // NOT IMPLEMENTED
+    CodeSpace(const CodeSpace&) = delete;
+    CodeSpace& operator=(const CodeSpace&) = delete;
+
+  public:
+    // CLASS METHODS
+    static int sizeClassFor(bsl::size_t size);
+        // Return the size class of a block of the specified 'size' bytes, or
+        // -1 if it has a mapping of its own.
+
+    static bsl::size_t blockSizeOf(int sizeClass);
+        // Return the number of bytes of a block of the specified
+        // 'sizeClass'.  The behavior is undefined unless
+        // '0 <= sizeClass < s_NumSizeClasses'.
+
+    // CREATORS
+    explicit CodeSpace(Allocator *basicAllocator = 0);
+    explicit CodeSpace(bsl::size_t regionSize,
+                       Allocator   *basicAllocator = 0);
+        // Create a code space mapping no memory, which maps regions of the
+        // optionally specified 'regionSize' bytes, rounded up to a whole
+        // number of slabs, or of 's_DefaultRegionSize' bytes otherwise.
+        // Optionally specify a 'basicAllocator' used to supply memory for
+        // the bookkeeping of the code space, which is not executable.  If
+        // 'basicAllocator' is 0, the currently installed default allocator
+        // is used.  The behavior is undefined unless '0 < regionSize'.
+
+    ~CodeSpace();
+        // Unmap every block of this code space and destroy it.
+
+    // MANIPULATORS
+    void *allocate(bsl::size_t size);
+        // Return the address of a block of at least the specified 'size'
+        // bytes of executable memory, whose contents are unspecified until
+        // written by 'write', or 0 if the memory cannot be mapped.  The
+        // block is aligned to 's_MinBlockSize' bytes.  The behavior is
+        // undefined unless '0 < size'.
+
+    void deallocate(void *block);
+        // Return the specified 'block' to this code space.  The behavior is
+        // undefined unless 'block' was allocated from this code space and
+        // not deallocated since, and its code is not executing.
+
+    int write(void              *block,
+              bsl::size_t        offset,
+              const void        *bytes,
+              bsl::size_t        numBytes);
+        // Copy the specified 'numBytes' 'bytes' to the specified 'offset'
+        // in the specified 'block', as described above, and return 0 on
+        // success, or a non-zero value, with the contents of 'block'
+        // unspecified, if the protection of its pages cannot be changed.
+        // The behavior is undefined unless 'block' was allocated from this
+        // code space with a size of at least 'offset + numBytes', and no
+        // code on the pages written is executing.
+
+    // ACCESSORS
+    bsl::size_t numBytesFragmented() const;
+        // Return the number of bytes mapped that are neither used nor free,
+        // as described above.
+
+    bsl::size_t numBytesFree() const;
+        // Return the number of bytes mapped that may be allocated in blocks
+        // of any size class.
+
+    bsl::size_t numBytesMapped() const;
+        // Return the number of bytes mapped by this code space.
+
+    bsl::size_t numBytesUsed() const;
+        // Return the number of bytes requested for the blocks allocated and
+        // not deallocated.
+
+    int numRegions() const;
+        // Return the number of mappings of this code space, including those
+        // of large blocks.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                              // ---------------
+                              // class CodeSpace
+                              // ---------------
+
+// CLASS METHODS
+inline
+bsl::size_t CodeSpace::blockSizeOf(int sizeClass)
+{
+    return s_MinBlockSize << sizeClass;
+}
+
+// ACCESSORS
+inline
+bsl::size_t CodeSpace::numBytesFragmented() const
+{
+    return d_numBytesFragmented;
+}
+
+inline
+bsl::size_t CodeSpace::numBytesFree() const
+{
+    return d_numBytesMapped - d_numBytesUsed - d_numBytesFragmented;
+}
+
+inline
+bsl::size_t CodeSpace::numBytesMapped() const
+{
+    return d_numBytesMapped;
+}
+
+inline
+bsl::size_t CodeSpace::numBytesUsed() const
+{
+    return d_numBytesUsed;
+}
+
+inline
+int CodeSpace::numRegions() const
+{
+    return static_cast<int>(d_regions.size());
+}
+}
+
+#endif
@@ -0,0 +1,343 @@
+// sjtm_codespace.t.cpp                                           -*-C++-*-
+
+#include <sjtm_codespace.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cstring.h>
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                     GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef bsls::Types::UintPtr UintPtr;
+
+bool isBalanced(const CodeSpace& space)
+    // Return 'true' if the bytes mapped by the specified 'space' are exactly
+    // those used, fragmented, and free, and 'false' otherwise.
+{
+    return space.numBytesMapped() == space.numBytesUsed()
+                                   + space.numBytesFragmented()
+                                   + space.numBytesFree();
+}
+
+bool writeAndCheck(CodeSpace *space, void *block, bsl::size_t size, char fill)
+    // Write the specified 'size' bytes of the specified 'fill' value to the
+    // specified 'block' of the specified 'space', and return 'true' if they
+    // read back, and 'false' otherwise.
+{
+    const bsl::vector<char> bytes(size, fill);
+    if (0 != space->write(block, 0, bytes.data(), size)) {
+        return false;                                                 // RETURN
+    }
+    return 0 == bsl::memcmp(block, bytes.data(), size);
+}
+}
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "large blocks" << endl
+                          << "============" << endl;
+
+        const bsl::size_t SIZE = CodeSpace::s_SlabSize + 100;
+
+        bslma::TestAllocator ta;
+        {
+            CodeSpace space(&ta);
+
+            void *a = space.allocate(SIZE);
+            ASSERT(0 != a);
+            ASSERT(1 == space.numRegions());
+            ASSERT(SIZE <= space.numBytesMapped());
+            ASSERT(SIZE == space.numBytesUsed());
+            ASSERT(space.numBytesMapped() - SIZE
+                                               == space.numBytesFragmented());
+            ASSERT(0 == space.numBytesFree());
+            ASSERT(writeAndCheck(&space, a, SIZE, 'a'));
+
+            // A block of a size class does not share the mapping.
+
+            void *b = space.allocate(1);
+            ASSERT(0 != b);
+            ASSERT(2 == space.numRegions());
+            ASSERT(isBalanced(space));
+
+            void *c = space.allocate(3 * SIZE);
+            ASSERT(0 != c);
+            ASSERT(3 == space.numRegions());
+            ASSERT(4 * SIZE + 1 == space.numBytesUsed());
+            ASSERT(writeAndCheck(&space, c, 3 * SIZE, 'c'));
+            ASSERT(0 == bsl::memcmp(a, bsl::vector<char>(SIZE, 'a').data(),
+                                    SIZE));
+
+            space.deallocate(a);
+            ASSERT(2 == space.numRegions());
+            ASSERT(3 * SIZE + 1 == space.numBytesUsed());
+            ASSERT(isBalanced(space));
+
+            space.deallocate(c);
+            ASSERT(1 == space.numRegions());
+            ASSERT(1 == space.numBytesUsed());
+            ASSERT(CodeSpace::s_DefaultRegionSize == space.numBytesMapped());
+
+            space.deallocate(b);
+            ASSERT(0 == space.numBytesUsed());
+            ASSERT(0 == space.numBytesFragmented());
+
+            // A block left allocated is unmapped with the code space.
+
+            ASSERT(0 != space.allocate(SIZE));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "reclamation" << endl
+                          << "===========" << endl;
+
+        const bsl::size_t REGION    = 2 * CodeSpace::s_SlabSize;
+        const int         NUM_TIMES = 3;
+
+        bslma::TestAllocator ta;
+        {
+            CodeSpace space(REGION, &ta);
+
+            // Loading and unloading code repeatedly maps no more memory than
+            // loading it once.
+
+            bsl::size_t maxMapped = 0;
+            for (int t = 0; t < NUM_TIMES; ++t) {
+                bsl::vector<void *> blocks;
+                for (int i = 0; i < 64; ++i) {
+                    const bsl::size_t size = 100 + 1000 * (i % 9);
+                    void *block = space.allocate(size);
+                    LOOP2_ASSERT(t, i, 0 != block);
+                    blocks.push_back(block);
+                }
+                ASSERT(1 < space.numRegions());
+                ASSERT(isBalanced(space));
+                if (0 == t) {
+                    maxMapped = space.numBytesMapped();
+                }
+                LOOP_ASSERT(t, maxMapped == space.numBytesMapped());
+
+                // Free in an order other than that of allocation.
+
+                for (bsl::size_t i = 0; i < blocks.size(); i += 2) {
+                    space.deallocate(blocks[i]);
+                }
+                ASSERT(isBalanced(space));
+                for (bsl::size_t i = 1; i < blocks.size(); i += 2) {
+                    space.deallocate(blocks[i]);
+                }
+                LOOP_ASSERT(t, 1 == space.numRegions());
+                LOOP_ASSERT(t, REGION == space.numBytesMapped());
+                LOOP_ASSERT(t, REGION == space.numBytesFree());
+                LOOP_ASSERT(t, 0 == space.numBytesUsed());
+                LOOP_ASSERT(t, 0 == space.numBytesFragmented());
+            }
+
+            // An empty slab takes any size class.
+
+            void *small = space.allocate(1);
+            void *big   = space.allocate(CodeSpace::s_SlabSize / 2);
+            ASSERT(0 != small);
+            ASSERT(0 != big);
+            ASSERT(1 == space.numRegions());
+            ASSERT(0 == space.numBytesFree());
+            space.deallocate(small);
+            ASSERT(CodeSpace::s_SlabSize == space.numBytesFree());
+            space.deallocate(big);
+            ASSERT(REGION == space.numBytesFree());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "size classes" << endl
+                          << "============" << endl;
+
+        ASSERT( 0 == CodeSpace::sizeClassFor(1));
+        ASSERT( 0 == CodeSpace::sizeClassFor(64));
+        ASSERT( 1 == CodeSpace::sizeClassFor(65));
+        ASSERT( 1 == CodeSpace::sizeClassFor(128));
+        ASSERT( 2 == CodeSpace::sizeClassFor(129));
+        ASSERT( 9 == CodeSpace::sizeClassFor(CodeSpace::s_SlabSize / 2));
+        ASSERT(-1 == CodeSpace::sizeClassFor(CodeSpace::s_SlabSize / 2 + 1));
+        for (int i = 0; i < CodeSpace::s_NumSizeClasses; ++i) {
+            const bsl::size_t size = CodeSpace::blockSizeOf(i);
+            LOOP_ASSERT(i, i == CodeSpace::sizeClassFor(size));
+            LOOP_ASSERT(i, CodeSpace::s_MinBlockSize << i == size);
+        }
+
+        bslma::TestAllocator ta;
+        {
+            CodeSpace space(&ta);
+            ASSERT(0 == space.numRegions());
+            ASSERT(0 == space.numBytesMapped());
+
+            // Blocks of one size class are packed into one slab, and are
+            // aligned.
+
+            const bsl::size_t SIZES[] = { 1, 40, 64, 100, 1000, 5000 };
+            const int         NUM_SIZES = sizeof SIZES / sizeof *SIZES;
+
+            bsl::vector<char *> blocks;
+            bsl::size_t         used = 0;
+            for (int i = 0; i < NUM_SIZES; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    char *block = static_cast<char *>(
+                                                  space.allocate(SIZES[i]));
+                    LOOP2_ASSERT(i, j, 0 != block);
+                    LOOP2_ASSERT(i, j, 0 == reinterpret_cast<UintPtr>(block)
+                                                % CodeSpace::s_MinBlockSize);
+                    for (bsl::size_t k = 0; k < blocks.size(); ++k) {
+                        LOOP3_ASSERT(i, j, k, block != blocks[k]);
+                    }
+                    if (0 < j) {
+                        const char *previous = blocks.back();
+                        LOOP2_ASSERT(i, j, previous + CodeSpace::blockSizeOf(
+                                          CodeSpace::sizeClassFor(SIZES[i]))
+                                                                   == block);
+                    }
+                    blocks.push_back(block);
+                    used += SIZES[i];
+                }
+            }
+            ASSERT(1 == space.numRegions());
+            ASSERT(CodeSpace::s_DefaultRegionSize == space.numBytesMapped());
+            ASSERT(used == space.numBytesUsed());
+            ASSERT(isBalanced(space));
+
+            // The sizes 1, 40 and 64 share a size class, so 4 slabs are
+            // taken.
+
+            ASSERT(CodeSpace::s_DefaultRegionSize - 4 * CodeSpace::s_SlabSize
+                                                      == space.numBytesFree());
+
+            for (bsl::size_t i = 0; i < blocks.size(); ++i) {
+                LOOP_ASSERT(i, writeAndCheck(&space, blocks[i], 1, 'x'));
+            }
+
+            // A freed block is reused first.
+
+            void *reused = blocks[4];
+            space.deallocate(reused);
+            ASSERT(reused == space.allocate(10));
+            ASSERT(used - 40 + 10 == space.numBytesUsed());
+            ASSERT(isBalanced(space));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta;
+        {
+            CodeSpace space(&ta);
+            ASSERT(0 == space.numBytesMapped());
+
+            char *block = static_cast<char *>(space.allocate(16));
+            ASSERT(0 != block);
+            ASSERT(16 == space.numBytesUsed());
+
+            const char BYTES[] = "0123456789";
+            ASSERT(0 == space.write(block, 3, BYTES, sizeof BYTES));
+            ASSERT(0 == bsl::memcmp(block + 3, BYTES, sizeof BYTES));
+            ASSERT(0 == space.write(block, 0, BYTES, 0));
+
+#if defined(__x86_64__) && defined(__linux__)
+            // mov eax, 42; ret
+
+            const unsigned char CODE[] = { 0xB8, 0x2A, 0x00, 0x00, 0x00,
+                                           0xC3 };
+            ASSERT(0 == space.write(block, 0, CODE, sizeof CODE));
+
+            int (*function)() = reinterpret_cast<int (*)()>(block);
+            ASSERT(42 == function());
+#endif
+
+            space.deallocate(block);
+            ASSERT(0 == space.numBytesUsed());
+            ASSERT(0 == space.numBytesFragmented());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,708 @@
+// sjtm_heap.cpp
+#include <sjtm_heap.h>
+
+#include <bslma_allocator.h>
+#include <bslma_default.h>
+#include <bslmt_lockguard.h>
+#include <bsls_assert.h>
+#include <bsls_timeutil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstring.h>
+#include <bsl_limits.h>
+#include <bsl_new.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtd_tracer.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+namespace {
+
+bool isYoungObject(const bdld::Datum& value)
+    // Return 'true' if the specified 'value' refers to a young object, and
+    // 'false' otherwise.
+{
+    return sjtd::DatumUdtUtil::isObject(value) &&
+           !sjtd::DatumUdtUtil::getObject(value)->isOld();
+}
+
+}  // close unnamed namespace
+
+                                 // ----------
+                                 // class Heap
+                                 // ----------
+
+// PRIVATE MANIPULATORS
+Object *Heap::allocateImp(int numSlots, bool raw)
+{
+    BSLS_ASSERT(0 <= numSlots);
+
+    if (d_oldBytes > d_oldLimit) {
+        if (e_Idle == d_state) {
+            startCollection();
+        }
+        else if (d_oldBytes > 2 * d_oldLimit) {
+            // The mutator is allocating faster than the collection is
+            // progressing.
+
+            const Int64 start = bsls::TimeUtil::getTimer();
+            bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+            finishCollection();
+            recordPause(start);
+        }
+    }
+
+    // Large objects would make scavenges slow to copy them, so they are
+    // allocated in the old generation directly, as are objects for which the
+    // survivors of a scavenge leave no room.
+
+    const bsl::size_t size = Object::sizeFor(numSlots);
+    bool              old  = size > d_nurserySize / 4;
+    if (!old) {
+        if (0 == d_fromSpace_p) {
+            d_fromSpace_p = static_cast<char *>(
+                                      d_allocator_p->allocate(d_nurserySize));
+            d_toSpace_p   = static_cast<char *>(
+                                      d_allocator_p->allocate(d_nurserySize));
+            d_top_p       = d_fromSpace_p;
+        }
+        if (d_top_p + size > d_fromSpace_p + d_nurserySize) {
+            scavenge();
+            old = d_top_p + size > d_fromSpace_p + d_nurserySize;
+        }
+    }
+    if (old) {
+        // An object allocated during a collection survives it; as its slots
+        // are undefined, it need not be scanned.
+
+        Object *object = new (allocateOld(size)) Object(numSlots,
+                                                        true,
+                                                        raw,
+                                                        &d_emptyShape);
+        if (e_Idle != d_state) {
+            object->d_marked = true;
+        }
+        return object;                                                // RETURN
+    }
+    Object *object = reinterpret_cast<Object *>(d_top_p);
+    d_top_p += size;
+    return new (object) Object(numSlots, false, raw, &d_emptyShape);
+}
+
+Object *Heap::allocateOld(bsl::size_t size)
+{
+    Object *object = static_cast<Object *>(d_allocator_p->allocate(size));
+    d_oldObjects.push_back(object);
+    d_oldBytes += size;
+    return object;
+}
+
+bool Heap::drainMarkStack(int maxObjects)
+{
+    for (int n = 0; n < maxObjects && !d_markStack.empty(); ++n) {
+        const Object *object = d_markStack.back();
+        d_markStack.pop_back();
+        for (int i = 0; i < object->numSlots(); ++i) {
+            mark(object->slot(i));
+        }
+        mark(object->d_properties);
+    }
+    return d_markStack.empty();
+}
+
+Object *Heap::evacuate(Object *object)
+{
+    BSLS_ASSERT(!object->isOld());
+
+    if (0 != object->d_forward_p) {
+        return object->d_forward_p;                                   // RETURN
+    }
+    const bsl::size_t size = object->size();
+    Object *copy;
+    if (object->d_age + 1 >= s_PromotionAge) {
+        copy = allocateOld(size);
+        bsl::memcpy(static_cast<void *>(copy), object, size);
+        copy->d_flags |= Object::e_Old;
+
+        // The slots of a promoted object are not in the copy space, so they
+        // are scanned from the worklist instead.  An object promoted during a
+        // collection survives it, and, while marking, its slots are marked.
+
+        d_worklist.push_back(copy);
+        if (e_Idle != d_state) {
+            copy->d_marked = true;
+            if (e_Marking == d_state) {
+                d_markStack.push_back(copy);
+            }
+        }
+    }
+    else {
+        copy = reinterpret_cast<Object *>(d_copyTop_p);
+        d_copyTop_p += size;
+        bsl::memcpy(static_cast<void *>(copy), object, size);
+    }
+    ++copy->d_age;
+    copy->d_forward_p   = 0;
+    object->d_forward_p = copy;
+    return copy;
+}
+
+void Heap::evacuate(Datum *value)
+{
+    if (!sjtd::DatumUdtUtil::isObject(*value)) {
+        return;                                                       // RETURN
+    }
+    Object *object = sjtd::DatumUdtUtil::getObject(*value);
+    if (!object->isOld()) {
+        *value = sjtd::DatumUdtUtil::datumFromObject(evacuate(object));
+    }
+}
+
+void Heap::finishCollection()
+{
+    if (e_Marking == d_state) {
+        drainMarkStack(bsl::numeric_limits<int>::max());
+        finishMarking();
+    }
+    if (e_Sweeping == d_state) {
+        sweep(bsl::numeric_limits<Int64>::max());
+    }
+}
+
+void Heap::finishMarking()
+{
+    BSLS_ASSERT(e_Marking == d_state);
+
+    // Stores into the roots and into young objects are not barriered, so
+    // both are scanned again before marking can complete.
+
+    for (bsl::size_t i = 0; i < d_roots.size(); ++i) {
+        const Roots& roots = *d_roots[i];
+        for (bsl::size_t j = 0; j < roots.size(); ++j) {
+            mark(roots[j]);
+        }
+    }
+    for (bsl::size_t i = 0; i < d_handles.size(); ++i) {
+        mark(d_handles[i]);
+    }
+    for (char *next = d_fromSpace_p; next != d_top_p;) {
+        const Object *object = reinterpret_cast<Object *>(next);
+        for (int i = 0; i < object->numSlots(); ++i) {
+            mark(object->slot(i));
+        }
+        mark(object->d_properties);
+        next += object->size();
+    }
+    drainMarkStack(bsl::numeric_limits<int>::max());
+
+    // Forget the remembered objects that are about to be freed; no unmarked
+    // object can be remembered again, as none is reachable.
+
+    bsl::size_t numRemembered = 0;
+    for (bsl::size_t i = 0; i < d_remembered.size(); ++i) {
+        Object *object = d_remembered[i];
+        if (object->d_marked) {
+            d_remembered[numRemembered++] = object;
+        }
+    }
+    d_remembered.resize(numRemembered);
+
+    d_state     = e_Sweeping;
+    d_sweepNext = 0;
+    d_sweepKept = 0;
+}
+
+void Heap::mark(const Datum& value)
+{
+    if (!sjtd::DatumUdtUtil::isObject(value)) {
+        return;                                                       // RETURN
+    }
+    Object *object = sjtd::DatumUdtUtil::getObject(value);
+    if (object->isOld() && !object->d_marked) {
+        object->d_marked = true;
+        d_markStack.push_back(object);
+        if (d_hasMarkingThread && 1 == d_markStack.size()) {
+            d_markingCondition.signal();
+        }
+    }
+}
+
+void Heap::markingThreadMain()
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    while (!d_stopMarkingThread) {
+        if (e_Marking != d_state || d_markStack.empty()) {
+            d_markingCondition.wait(&d_mutex);
+            continue;                                              // CONTINUE
+        }
+        {
+            SJTD_TRACER_SCOPE("gc", "markBatch");
+            drainMarkStack(s_MarkBatchSize);
+        }
+
+        // Let the mutator in between batches.
+
+        bslmt::LockGuardUnlock<bslmt::Mutex> unlock(&d_mutex);
+        bslmt::ThreadUtil::yield();
+    }
+}
+
+void Heap::recordPause(Int64 start)
+{
+    d_pauses.record(bsls::TimeUtil::getTimer() - start);
+}
+
+void Heap::remember(Object *object)
+{
+    BSLS_ASSERT(object->isOld());
+
+    if (0 == (object->d_flags & Object::e_Remembered)) {
+        object->d_flags |= Object::e_Remembered;
+        d_remembered.push_back(object);
+    }
+}
+
+void Heap::scanOld(Object *object)
+{
+    Datum      *slots     = object->slots();
+    const int   numSlots  = object->numSlots();
+    bool        needed    = false;
+    for (int i = 0; i < numSlots; ++i) {
+        evacuate(&slots[i]);
+        needed = needed ||
+                 (sjtd::DatumUdtUtil::isObject(slots[i]) &&
+                  !sjtd::DatumUdtUtil::getObject(slots[i])->isOld());
+    }
+    evacuate(&object->d_properties);
+    needed = needed ||
+             (sjtd::DatumUdtUtil::isObject(object->d_properties) &&
+              !sjtd::DatumUdtUtil::getObject(object->d_properties)->isOld());
+    if (needed) {
+        remember(object);
+    }
+}
+
+void Heap::scavengeImp()
+{
+    SJTD_TRACER_SCOPE("gc", "scavenge");
+
+    ++d_numScavenges;
+    if (0 == d_fromSpace_p) {
+        return;                                                       // RETURN
+    }
+    d_copyTop_p = d_toSpace_p;
+
+    // The remembered set is rebuilt as it is scanned: objects that still
+    // refer to young objects afterwards are appended to it again.
+
+    const bsl::size_t numRemembered = d_remembered.size();
+    for (bsl::size_t i = 0; i < numRemembered; ++i) {
+        d_remembered[i]->d_flags &= ~Object::e_Remembered;
+    }
+
+    for (bsl::size_t i = 0; i < d_roots.size(); ++i) {
+        Roots& roots = *d_roots[i];
+        for (bsl::size_t j = 0; j < roots.size(); ++j) {
+            evacuate(&roots[j]);
+        }
+    }
+    for (bsl::size_t i = 0; i < d_handles.size(); ++i) {
+        evacuate(&d_handles[i]);
+    }
+    for (bsl::size_t i = 0; i < numRemembered; ++i) {
+        scanOld(d_remembered[i]);
+    }
+
+    // Scan the copied objects in the order they were copied, interleaved with
+    // the promoted objects, until no unscanned object remains.
+
+    char *scan = d_toSpace_p;
+    while (scan != d_copyTop_p || !d_worklist.empty()) {
+        while (scan != d_copyTop_p) {
+            Object    *object   = reinterpret_cast<Object *>(scan);
+            Datum     *slots    = object->slots();
+            const int  numSlots = object->numSlots();
+            for (int i = 0; i < numSlots; ++i) {
+                evacuate(&slots[i]);
+            }
+            evacuate(&object->d_properties);
+            scan += object->size();
+        }
+        while (!d_worklist.empty()) {
+            Object *object = d_worklist.back();
+            d_worklist.pop_back();
+            scanOld(object);
+        }
+    }
+    d_remembered.erase(d_remembered.begin(),
+                       d_remembered.begin() + numRemembered);
+
+    bsl::swap(d_fromSpace_p, d_toSpace_p);
+    d_top_p = d_copyTop_p;
+}
+
+void Heap::startMarking()
+{
+    BSLS_ASSERT(e_Idle == d_state);
+
+    d_state = e_Marking;
+    for (bsl::size_t i = 0; i < d_roots.size(); ++i) {
+        const Roots& roots = *d_roots[i];
+        for (bsl::size_t j = 0; j < roots.size(); ++j) {
+            mark(roots[j]);
+        }
+    }
+    for (bsl::size_t i = 0; i < d_handles.size(); ++i) {
+        mark(d_handles[i]);
+    }
+}
+
+void Heap::store(Object *object, Datum *location, const Datum& value)
+{
+    if (e_Marking == d_state) {
+        // The marking thread may be reading the slots and the flags of old
+        // objects, so they are written under the lock.  The stored object
+        // must not be missed if 'object' has already been scanned.
+
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        *location = value;
+        if (object->isOld()) {
+            mark(value);
+            if (isYoungObject(value)) {
+                remember(object);
+            }
+        }
+        return;                                                       // RETURN
+    }
+    *location = value;
+
+    // Record old objects that refer to young ones.
+
+    if (object->isOld() && isYoungObject(value)) {
+        remember(object);
+    }
+}
+
+bool Heap::sweep(Int64 deadline)
+{
+    BSLS_ASSERT(e_Sweeping == d_state);
+
+    // Objects made old during the sweep are appended to 'd_oldObjects' and
+    // are marked, so they are kept.
+
+    while (d_sweepNext < d_oldObjects.size()) {
+        Object *object = d_oldObjects[d_sweepNext++];
+        if (object->d_marked) {
+            object->d_marked = false;
+            d_oldObjects[d_sweepKept++] = object;
+        }
+        else {
+            d_oldBytes -= object->size();
+            d_allocator_p->deallocate(object);
+        }
+        if (0 == d_sweepNext % s_MarkBatchSize &&
+            bsls::TimeUtil::getTimer() > deadline) {
+            return false;                                             // RETURN
+        }
+    }
+    d_oldObjects.resize(d_sweepKept);
+
+    d_oldLimit = 2 * d_oldBytes;
+    if (d_oldLimit < s_MinOldGenerationLimit) {
+        d_oldLimit = s_MinOldGenerationLimit;
+    }
+    d_state = e_Idle;
+    ++d_numFullCollections;
+    return true;
+}
+
+// CREATORS
+Heap::Heap(Allocator *basicAllocator)
+: d_allocator_p(bslma::Default::allocator(basicAllocator))
+, d_nurserySize(s_DefaultNurserySize)
+, d_fromSpace_p(0)
+, d_toSpace_p(0)
+, d_top_p(0)
+, d_copyTop_p(0)
+, d_oldObjects(basicAllocator)
+, d_oldBytes(0)
+, d_oldLimit(s_MinOldGenerationLimit)
+, d_remembered(basicAllocator)
+, d_roots(basicAllocator)
+, d_handles(basicAllocator)
+, d_emptyShape(basicAllocator)
+, d_worklist(basicAllocator)
+, d_markStack(basicAllocator)
+, d_state(e_Idle)
+, d_sweepNext(0)
+, d_sweepKept(0)
+, d_pauseBudget(s_DefaultPauseBudget)
+, d_numScavenges(0)
+, d_numFullCollections(0)
+, d_numSteps(0)
+, d_hasMarkingThread(false)
+, d_stopMarkingThread(false)
+{
+}
+
+Heap::Heap(bsl::size_t nurserySize, Allocator *basicAllocator)
+: d_allocator_p(bslma::Default::allocator(basicAllocator))
+, d_nurserySize(nurserySize)
+, d_fromSpace_p(0)
+, d_toSpace_p(0)
+, d_top_p(0)
+, d_copyTop_p(0)
+, d_oldObjects(basicAllocator)
+, d_oldBytes(0)
+, d_oldLimit(s_MinOldGenerationLimit)
+, d_remembered(basicAllocator)
+, d_roots(basicAllocator)
+, d_handles(basicAllocator)
+, d_emptyShape(basicAllocator)
+, d_worklist(basicAllocator)
+, d_markStack(basicAllocator)
+, d_state(e_Idle)
+, d_sweepNext(0)
+, d_sweepKept(0)
+, d_pauseBudget(s_DefaultPauseBudget)
+, d_numScavenges(0)
+, d_numFullCollections(0)
+, d_numSteps(0)
+, d_hasMarkingThread(false)
+, d_stopMarkingThread(false)
+{
+    BSLS_ASSERT(Object::sizeFor(0) <= nurserySize);
+}
+
+Heap::~Heap()
+{
+    BSLS_ASSERT(d_roots.empty());
+
+    stopMarkingThread();
+    for (bsl::size_t i = 0; i < d_oldObjects.size(); ++i) {
+        d_allocator_p->deallocate(d_oldObjects[i]);
+    }
+    d_allocator_p->deallocate(d_fromSpace_p);
+    d_allocator_p->deallocate(d_toSpace_p);
+}
+
+// MANIPULATORS
+void Heap::addProperty(Object *object, Shape *newShape, const Datum& value)
+{
+    BSLS_ASSERT(0 != object);
+    BSLS_ASSERT(0 != newShape);
+    BSLS_ASSERT(newShape->parent() == object->shape());
+
+    const int index    = newShape->numProperties() - 1;
+    const int overflow = index - object->numSlots();
+    const int capacity = sjtd::DatumUdtUtil::isObject(object->d_properties)
+                       ? sjtd::DatumUdtUtil::getObject(object->d_properties)
+                                                                 ->numSlots()
+                       : 0;
+    if (0 > overflow || overflow < capacity) {
+        object->d_shape_p = newShape;
+        setPropertyAt(object, index, value);
+        return;                                                       // RETURN
+    }
+
+    // Grow the property storage.  Allocation may move 'object', 'value', and
+    // the current storage, so they are held as roots meanwhile.
+
+    d_handles.push_back(sjtd::DatumUdtUtil::datumFromObject(object));
+    d_handles.push_back(value);
+    Object *storage = allocate(0 == capacity ? s_MinPropertyCapacity
+                                             : 2 * capacity);
+    const Datum movedValue = d_handles.back();
+    d_handles.pop_back();
+    object = sjtd::DatumUdtUtil::getObject(d_handles.back());
+    d_handles.pop_back();
+
+    if (0 != capacity) {
+        const Object *current =
+                         sjtd::DatumUdtUtil::getObject(object->d_properties);
+        for (int i = 0; i < capacity; ++i) {
+            store(storage, &storage->slots()[i], current->slot(i));
+        }
+    }
+    store(object,
+          &object->d_properties,
+          sjtd::DatumUdtUtil::datumFromObject(storage));
+    object->d_shape_p = newShape;
+    setPropertyAt(object, index, movedValue);
+}
+
+void Heap::addRoots(Roots *roots)
+{
+    BSLS_ASSERT(0 != roots);
+
+    d_roots.push_back(roots);
+}
+
+Object *Heap::allocate(int numSlots)
+{
+    BSLS_ASSERT(0 <= numSlots);
+
+    return allocateImp(numSlots, false);
+}
+
+Object *Heap::allocateRaw(int numBytes)
+{
+    BSLS_ASSERT(0 <= numBytes);
+
+    const int wordSize = static_cast<int>(sizeof(Datum));
+    return allocateImp((numBytes + wordSize - 1) / wordSize, true);
+}
+
+void Heap::collectGarbage()
+{
+    SJTD_TRACER_SCOPE("gc", "collectGarbage");
+
+    const Int64 start = bsls::TimeUtil::getTimer();
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+
+    // Finish any collection in progress, whose marks may be stale, then
+    // collect again from scratch.
+
+    scavengeImp();
+    finishCollection();
+    startMarking();
+    finishCollection();
+    recordPause(start);
+}
+
+void Heap::removeRoots(Roots *roots)
+{
+    const bsl::vector<Roots *>::iterator it = bsl::find(d_roots.begin(),
+                                                        d_roots.end(),
+                                                        roots);
+    BSLS_ASSERT(d_roots.end() != it);
+
+    d_roots.erase(it);
+}
+
+void Heap::resetPauses()
+{
+    d_pauses.reset();
+}
+
+void Heap::scavenge()
+{
+    const Int64 start = bsls::TimeUtil::getTimer();
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    scavengeImp();
+    recordPause(start);
+}
+
+void Heap::setProperty(Object           *object,
+                       const StringRef&  name,
+                       const Datum&      value)
+{
+    BSLS_ASSERT(0 != object);
+
+    const int index = object->shape()->find(name);
+    if (0 <= index) {
+        setPropertyAt(object, index, value);
+    }
+    else {
+        addProperty(object, object->shape()->addProperty(name), value);
+    }
+}
+
+void Heap::setPropertyAt(Object *object, int index, const Datum& value)
+{
+    BSLS_ASSERT(0 != object);
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < object->shape()->numProperties());
+
+    if (index < object->numSlots()) {
+        store(object, &object->slots()[index], value);
+    }
+    else {
+        Object *storage = sjtd::DatumUdtUtil::getObject(object->d_properties);
+        store(storage,
+              &storage->slots()[index - object->numSlots()],
+              value);
+    }
+}
+
+void Heap::setPauseBudget(Int64 nanoseconds)
+{
+    BSLS_ASSERT(0 < nanoseconds);
+
+    d_pauseBudget = nanoseconds;
+}
+
+void Heap::setSlot(Object *object, int index, const Datum& value)
+{
+    BSLS_ASSERT(0 != object);
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < object->numSlots());
+
+    store(object, &object->slots()[index], value);
+}
+
+void Heap::startCollection()
+{
+    if (e_Idle == d_state) {
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        startMarking();
+    }
+}
+
+int Heap::startMarkingThread()
+{
+    BSLS_ASSERT(!d_hasMarkingThread);
+
+    d_stopMarkingThread = false;
+    const int rc = bslmt::ThreadUtil::create(&d_markingThread,
+                                             [this]() {
+                                                 markingThreadMain();
+                                             });
+    if (0 == rc) {
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        d_hasMarkingThread = true;
+    }
+    return rc;
+}
+
+void Heap::step()
+{
+    if (e_Idle == d_state) {
+        return;                                                       // RETURN
+    }
+    SJTD_TRACER_SCOPE("gc", "step");
+
+    const Int64 start    = bsls::TimeUtil::getTimer();
+    const Int64 deadline = start + d_pauseBudget;
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    ++d_numSteps;
+    if (e_Marking == d_state) {
+        while (!drainMarkStack(s_MarkBatchSize) &&
+               bsls::TimeUtil::getTimer() < deadline) {
+        }
+        if (d_markStack.empty()) {
+            finishMarking();
+        }
+    }
+    if (e_Sweeping == d_state) {
+        sweep(deadline);
+    }
+    recordPause(start);
+}
+
+void Heap::stopMarkingThread()
+{
+    {
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        if (!d_hasMarkingThread) {
+            return;                                                   // RETURN
+        }
+        d_stopMarkingThread = true;
+        d_hasMarkingThread  = false;
+        d_markingCondition.signal();
+    }
+    bslmt::ThreadUtil::join(d_markingThread);
+}
+}
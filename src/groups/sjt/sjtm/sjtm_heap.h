@@ -0,0 +1,560 @@
+// sjtm_heap.h
+
+#ifndef INCLUDED_SJTM_HEAP
+#define INCLUDED_SJTM_HEAP
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_CONDITION
+#include <bslmt_condition.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_MUTEX
+#include <bslmt_mutex.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_THREADUTIL
+#include <bslmt_threadutil.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+#ifndef INCLUDED_SJTM_OBJECT
+#include <sjtm_object.h>
+#endif
+
+#ifndef INCLUDED_SJTM_PAUSEHISTOGRAM
+#include <sjtm_pausehistogram.h>
+#endif
+
+#ifndef INCLUDED_SJTM_SHAPE
+#include <sjtm_shape.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm {
+
+                                 // ==========
+                                 // class Heap
+                                 // ==========
+
+class Heap {
+    // This class is a mechanism that allocates script objects and reclaims
+    // those that are no longer reachable.  The heap is divided into two
+    // generations:
+    //
+    // # Young generation
+    //
+    // New objects are bump-allocated from a nursery of 'nurserySize()'
+    // bytes.  When the nursery is full it is scavenged: the objects reachable
+    // from the roots and from the remembered set are copied, breadth first,
+    // into a second space of the same size, which then becomes the nursery.
+    // The pause of a scavenge is proportional to the number of surviving
+    // objects rather than to the size of the heap.  An object that survives
+    // 's_PromotionAge' scavenges is promoted, i.e., copied into the old
+    // generation instead.
+    //
+    // # Old generation
+    //
+    // Promoted objects, and objects too large for the nursery, are allocated
+    // individually and are never moved.  References from old objects to
+    // young ones are recorded by 'setSlot' in a remembered set that the
+    // scavenger treats as additional roots, so a scavenge need not examine
+    // the old generation.
+    //
+    // When the old generation grows beyond a limit, a collection of the old
+    // generation begins.  It marks the old objects reachable from the roots
+    // and then frees the rest, incrementally: each call to 'safePoint' (or
+    // 'step') does at most 'pauseBudget()' nanoseconds of work, so the
+    // mutator is never paused for long.  A marking thread, started by
+    // 'startMarkingThread', additionally marks concurrently with the mutator.
+    // While marking, 'setSlot' marks the old object it stores (an insertion
+    // barrier), objects allocated in or promoted to the old generation are
+    // marked, and marking finishes by rescanning the roots and the young
+    // objects, so no reachable object is freed.  If the old generation
+    // reaches twice its limit during a collection, the collection is
+    // finished at once.  The duration of every pause is recorded in
+    // 'pauses()'.
+    //
+    // # Properties
+    //
+    // Every object allocated from a heap begins with the heap's
+    // 'emptyShape()'; 'setProperty' and 'addProperty' move it along the
+    // transitions of the shape tree as properties are added.  Properties
+    // beyond the slots of an object are kept in a property storage object,
+    // whose capacity is doubled as needed.  Shapes are owned by the heap and
+    // live as long as it does.
+    //
+    // # Raw objects
+    //
+    // Objects allocated by 'allocateRaw' hold raw data, such as the elements
+    // of typed arrays, in place of slots.  They are collected like other
+    // objects, but their data is copied without being scanned.
+    //
+    // # Roots
+    //
+    // The roots of a heap are the values in the vectors registered with
+    // 'addRoots'.  Collection is precise: every reference to a young object
+    // must be either in a root or in a slot of an object, as young objects
+    // are moved by 'allocate', 'scavenge' and 'collectGarbage'.
+    //
+    // # Thread safety
+    //
+    // Except for the marking thread, a heap, and the objects allocated from
+    // it, must be used by one thread at a time.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef bsl::vector<Datum> Roots;
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+    // CONSTANTS
+    static const bsl::size_t s_DefaultNurserySize = 256 * 1024;
+        // The default number of bytes in the nursery.
+
+    static const int s_PromotionAge = 2;
+        // The number of scavenges a young object survives before it is
+        // promoted to the old generation.
+
+    static const bsl::size_t s_MinOldGenerationLimit = 1024 * 1024;
+        // The minimum number of bytes the old generation may grow to before a
+        // collection of the old generation begins.
+
+    static const Int64 s_DefaultPauseBudget = 1000 * 1000;
+        // The default number of nanoseconds of work done by 'step'.
+
+    static const int s_MarkBatchSize = 64;
+        // The number of objects marked or swept between checks of the time
+        // remaining in a step, and by the marking thread between releases of
+        // the heap's lock.
+
+    static const int s_MinPropertyCapacity = 4;
+        // The number of properties for which space is allocated when an
+        // object first needs property storage beyond its slots.
+
+  private:
+    // TYPES
+    enum State {
+        // Enumeration of the phases of a collection of the old generation.
+
+        e_Idle,        // no collection is in progress
+        e_Marking,     // marking reachable old objects
+        e_Sweeping     // freeing unmarked old objects
+    };
+
+    // DATA
+    Allocator             *d_allocator_p;      // held, not owned
+    bsl::size_t            d_nurserySize;      // bytes in each space
+    char                  *d_fromSpace_p;      // nursery, owned, or 0
+    char                  *d_toSpace_p;        // copy space, owned, or 0
+    char                  *d_top_p;            // next free byte of nursery
+    char                  *d_copyTop_p;        // next free byte of copy space
+                                               // during a scavenge
+    bsl::vector<Object *>  d_oldObjects;       // every old object, owned
+    bsl::size_t            d_oldBytes;         // bytes of old objects
+    bsl::size_t            d_oldLimit;         // 'd_oldBytes' that begins a
+                                               // collection
+    bsl::vector<Object *>  d_remembered;       // old objects that may refer
+                                               // to young ones
+    bsl::vector<Roots *>   d_roots;            // held, not owned
+    Roots                  d_handles;          // values kept alive across an
+                                               // allocation by this heap
+    Shape                  d_emptyShape;       // root of the shape tree
+    bsl::vector<Object *>  d_worklist;         // promoted objects yet to be
+                                               // scanned by a scavenge
+    bsl::vector<Object *>  d_markStack;        // marked objects yet to be
+                                               // scanned
+    State                  d_state;            // written only by the mutator
+    bsl::size_t            d_sweepNext;        // next old object to sweep
+    bsl::size_t            d_sweepKept;        // number of swept survivors
+    Int64                  d_pauseBudget;      // nanoseconds
+    PauseHistogram         d_pauses;
+    int                    d_numScavenges;
+    int                    d_numFullCollections;
+    int                    d_numSteps;
+    BloombergLP::bslmt::Mutex
+                           d_mutex;            // guards marking state shared
+                                               // with the marking thread
+    BloombergLP::bslmt::Condition
+                           d_markingCondition; // signaled when there is work
+                                               // for the marking thread
+    BloombergLP::bslmt::ThreadUtil::Handle
+                           d_markingThread;
+    bool                   d_hasMarkingThread;
+    bool                   d_stopMarkingThread;
+
+    // PRIVATE MANIPULATORS
+    Object *allocateImp(int numSlots, bool raw);
+        // Return a new object having the specified 'numSlots' slots, or, if
+        // the specified 'raw' is 'true', the same amount of raw data.
+
+    Object *allocateOld(bsl::size_t size);
+        // Return the address of uninitialized storage for an old object of
+        // the specified 'size' bytes.  Note that the caller must mark the
+        // object if a collection is in progress.
+
+    Object *evacuate(Object *object);
+        // Return the address of the copy of the specified young 'object' made
+        // by the current scavenge, copying or promoting it if it has not been
+        // copied yet.
+
+    void evacuate(Datum *value);
+        // If the specified 'value' refers to a young object, replace it with
+        // a reference to the copy of that object made by the current
+        // scavenge.
+
+    bool drainMarkStack(int maxObjects);
+        // Scan at most the specified 'maxObjects' objects from the mark stack,
+        // marking the old objects they refer to, and return 'true' if the
+        // mark stack is then empty and 'false' otherwise.  The behavior is
+        // undefined unless 'd_mutex' is locked.
+
+    void finishCollection();
+        // Finish the collection in progress, if any, without regard to the
+        // pause budget.  The behavior is undefined unless 'd_mutex' is
+        // locked.
+
+    void finishMarking();
+        // Mark the old objects reachable from the roots, from the young
+        // objects, and from the mark stack, then begin sweeping.  The
+        // behavior is undefined unless 'd_mutex' is locked.
+
+    void mark(const Datum& value);
+        // If the specified 'value' refers to an unmarked old object, mark it
+        // and push it on the mark stack.
+
+    void markingThreadMain();
+        // Mark objects while there are any to mark, until the marking thread
+        // is stopped.
+
+    void recordPause(Int64 start);
+        // Record a pause that began at the specified 'start' time and ends
+        // now.
+
+    void scavengeImp();
+        // Scavenge the young generation.  The behavior is undefined unless
+        // 'd_mutex' is locked.
+
+    void startMarking();
+        // Begin a collection of the old generation by marking the old objects
+        // referred to by the roots.  The behavior is undefined unless
+        // 'd_mutex' is locked and no collection is in progress.
+
+    bool sweep(Int64 deadline);
+        // Sweep old objects until all have been swept or the specified
+        // 'deadline' has passed, and return 'true' if the collection is then
+        // complete and 'false' otherwise.  The behavior is undefined unless
+        // 'd_mutex' is locked.
+
+    void remember(Object *object);
+        // Add the specified old 'object' to the remembered set, if it is not
+        // already in it.
+
+    void scanOld(Object *object);
+        // Evacuate the slots and property storage of the specified old
+        // 'object', remembering it if it still refers to a young object
+        // afterwards.
+
+    void store(Object *object, Datum *location, const Datum& value);
+        // Store the specified 'value' at the specified 'location' within the
+        // specified 'object', recording the reference for the collector.
+
+    // NOT IMPLEMENTED
+    Heap(const Heap&) = delete;
+    Heap& operator=(const Heap&) = delete;
+
+  public:
+    // CREATORS
+    explicit Heap(Allocator *basicAllocator = 0);
+    explicit Heap(bsl::size_t nurserySize, Allocator *basicAllocator = 0);
+        // Create an empty heap.  Optionally specify a 'nurserySize' in bytes;
+        // if 'nurserySize' is not specified, 's_DefaultNurserySize' is used.
+        // Optionally specify a 'basicAllocator' used to supply memory.  If
+        // 'basicAllocator' is 0, the currently installed default allocator is
+        // used.  Note that no memory is allocated for the nursery until the
+        // first object is allocated.
+
+    ~Heap();
+        // Stop the marking thread, if any, and destroy this object and every
+        // object allocated from it.  The behavior is undefined unless no
+        // roots are registered.
+
+    // MANIPULATORS
+    void addProperty(Object *object, Shape *newShape, const Datum& value);
+        // Add to the specified 'object' the last property of the specified
+        // 'newShape', having the specified 'value', and make 'newShape' the
+        // shape of 'object'.  This method may allocate, so every object that
+        // is still needed must be reachable from the roots of this heap, or
+        // be 'object' or 'value', when it is called.  The behavior is
+        // undefined unless 'newShape->parent() == object->shape()'.
+
+    void addRoots(Roots *roots);
+        // Add the values in the specified 'roots' to the roots of this heap.
+        // The behavior is undefined unless 'roots' remains valid until it is
+        // passed to 'removeRoots'.
+
+    Object *allocate(int numSlots);
+        // Return a new object having the specified 'numSlots' slots, each
+        // 'DatumUdtUtil::s_Undefined'.  This method may collect garbage, so
+        // every object that is still needed must be reachable from the roots
+        // of this heap when it is called.  The behavior is undefined unless
+        // '0 <= numSlots'.
+
+    Object *allocateRaw(int numBytes);
+        // Return a new raw object having at least the specified 'numBytes'
+        // bytes of raw data, each 0.  This method may collect garbage, as
+        // 'allocate' does.  The behavior is undefined unless '0 <= numBytes'.
+
+    void collectGarbage();
+        // Scavenge the young generation, then, without regard to the pause
+        // budget, finish the collection of the old generation in progress,
+        // if any, and perform a complete collection of the old generation.
+
+    Shape *emptyShape();
+        // Return the shape of newly allocated objects, which has no
+        // properties.
+
+    void removeRoots(Roots *roots);
+        // Remove the specified 'roots' from the roots of this heap.  The
+        // behavior is undefined unless 'roots' was added by 'addRoots'.
+
+    void resetPauses();
+        // Remove every pause from the histogram returned by 'pauses'.
+
+    void safePoint();
+        // Perform a step of the collection of the old generation in progress,
+        // if any.  This method is intended to be called by the mutator
+        // frequently, e.g., on every backward jump and call, at a point where
+        // the slots of objects are consistent.
+
+    void scavenge();
+        // Copy the young objects reachable from the roots and the remembered
+        // set of this heap out of the nursery, promoting those that have
+        // survived 's_PromotionAge' scavenges, and reclaim the rest of the
+        // nursery.
+
+    void setProperty(Object           *object,
+                     const StringRef&  name,
+                     const Datum&      value);
+        // Set the property having the specified 'name' of the specified
+        // 'object' to the specified 'value', adding the property if 'object'
+        // does not have it.  This method may allocate, as 'addProperty' does.
+
+    void setPropertyAt(Object *object, int index, const Datum& value);
+        // Set the property at the specified 'index' of the specified 'object'
+        // to the specified 'value'.  The behavior is undefined unless
+        // '0 <= index < object->shape()->numProperties()'.
+
+    void setPauseBudget(Int64 nanoseconds);
+        // Set the amount of work done by 'step' to the specified
+        // 'nanoseconds'.  The behavior is undefined unless '0 < nanoseconds'.
+
+    void setSlot(Object *object, int index, const Datum& value);
+        // Set the slot at the specified 'index' of the specified 'object' to
+        // the specified 'value'.  The behavior is undefined unless 'object'
+        // was allocated from this heap and '0 <= index < object->numSlots()'.
+
+    void startCollection();
+        // Begin a collection of the old generation, if none is in progress.
+
+    int startMarkingThread();
+        // Start a thread that marks objects concurrently with the mutator
+        // during collections of the old generation, and return 0 on success
+        // and a non-zero value otherwise.  The behavior is undefined if a
+        // marking thread is running.
+
+    void step();
+        // Perform at most 'pauseBudget()' nanoseconds of the work of the
+        // collection of the old generation in progress, if any, completing
+        // it if all of its work is done.  Note that each step marks or sweeps
+        // at least one batch of 's_MarkBatchSize' objects.
+
+    void stopMarkingThread();
+        // Stop the marking thread, if any, and wait for it to exit.
+
+    // ACCESSORS
+    bool isCollecting() const;
+        // Return 'true' if a collection of the old generation is in progress
+        // and 'false' otherwise.
+
+    bsl::size_t nurserySize() const;
+        // Return the number of bytes in the nursery.
+
+    int numFullCollections() const;
+        // Return the number of collections of the old generation completed
+        // by this heap.
+
+    int numOldObjects() const;
+        // Return the number of objects in the old generation.
+
+    int numScavenges() const;
+        // Return the number of scavenges performed by this heap, including
+        // those performed by full collections.
+
+    int numSteps() const;
+        // Return the number of steps performed by this heap.
+
+    bsl::size_t oldBytesInUse() const;
+        // Return the number of bytes occupied by objects in the old
+        // generation.
+
+    Int64 pauseBudget() const;
+        // Return the number of nanoseconds of work done by 'step'.
+
+    const PauseHistogram& pauses() const;
+        // Return a reference providing non-modifiable access to the histogram
+        // of the durations of the pauses caused by this heap, i.e., of its
+        // scavenges, steps and full collections.
+
+    bsl::size_t youngBytesInUse() const;
+        // Return the number of bytes occupied by objects in the nursery.
+};
+
+                             // ===================
+                             // class HeapRootGuard
+                             // ===================
+
+class HeapRootGuard {
+    // This class is a guard that registers a vector of values as roots of a
+    // 'Heap' for its lifetime.
+
+    // DATA
+    Heap        *d_heap_p;    // held, not owned
+    Heap::Roots *d_roots_p;   // held, not owned
+
+    // NOT IMPLEMENTED
+    HeapRootGuard(const HeapRootGuard&) = delete;
+    HeapRootGuard& operator=(const HeapRootGuard&) = delete;
+
+  public:
+    // CREATORS
+    HeapRootGuard(Heap *heap, Heap::Roots *roots);
+        // Add the specified 'roots' to the roots of the specified 'heap'.
+
+    ~HeapRootGuard();
+        // Remove the roots managed by this object from their heap.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                 // ----------
+                                 // class Heap
+                                 // ----------
+
+// MANIPULATORS
+inline
+Shape *Heap::emptyShape()
+{
+    return &d_emptyShape;
+}
+
+inline
+void Heap::safePoint()
+{
+    if (e_Idle != d_state) {
+        step();
+    }
+}
+
+// ACCESSORS
+inline
+bool Heap::isCollecting() const
+{
+    return e_Idle != d_state;
+}
+
+inline
+bsl::size_t Heap::nurserySize() const
+{
+    return d_nurserySize;
+}
+
+inline
+int Heap::numFullCollections() const
+{
+    return d_numFullCollections;
+}
+
+inline
+int Heap::numOldObjects() const
+{
+    return static_cast<int>(d_oldObjects.size());
+}
+
+inline
+int Heap::numScavenges() const
+{
+    return d_numScavenges;
+}
+
+inline
+int Heap::numSteps() const
+{
+    return d_numSteps;
+}
+
+inline
+bsl::size_t Heap::oldBytesInUse() const
+{
+    return d_oldBytes;
+}
+
+inline
+Heap::Int64 Heap::pauseBudget() const
+{
+    return d_pauseBudget;
+}
+
+inline
+const PauseHistogram& Heap::pauses() const
+{
+    return d_pauses;
+}
+
+inline
+bsl::size_t Heap::youngBytesInUse() const
+{
+    return d_top_p - d_fromSpace_p;
+}
+
+                             // -------------------
+                             // class HeapRootGuard
+                             // -------------------
+
+// CREATORS
+inline
+HeapRootGuard::HeapRootGuard(Heap *heap, Heap::Roots *roots)
+: d_heap_p(heap)
+, d_roots_p(roots)
+{
+    d_heap_p->addRoots(d_roots_p);
+}
+
+inline
+HeapRootGuard::~HeapRootGuard()
+{
+    d_heap_p->removeRoots(d_roots_p);
+}
+}
+
+#endif
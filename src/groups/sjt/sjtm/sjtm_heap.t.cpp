@@ -0,0 +1,621 @@
+// sjtm_heap.t.cpp                                                -*-C++-*-
+
+#include <sjtm_heap.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_object.h>
+#include <sjtm_shape.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+namespace {
+
+typedef bdld::Datum Datum;
+typedef sjtd::DatumUdtUtil DUU;
+
+Object *object(const Datum& value)
+    // Return the object referred to by the specified 'value'.
+{
+    return DUU::getObject(value);
+}
+
+Datum makeList(Heap *heap, Heap::Roots *roots, int length)
+    // Push onto the specified 'roots' of the specified 'heap' a list of the
+    // specified 'length' two-slot nodes, each holding its position in slot 0
+    // and the next node in slot 1, and return a reference to the head.
+{
+    roots->push_back(DUU::s_Null);
+    const bsl::size_t head = roots->size() - 1;
+    for (int i = length - 1; 0 <= i; --i) {
+        Object *node = heap->allocate(2);
+        heap->setSlot(node, 0, Datum::createInteger(i));
+        heap->setSlot(node, 1, (*roots)[head]);
+        (*roots)[head] = DUU::datumFromObject(node);
+    }
+    return (*roots)[head];
+}
+
+bool checkList(const Datum& head, int length)
+    // Return 'true' if the specified 'head' is a list of the specified
+    // 'length' nodes as created by 'makeList', and 'false' otherwise.
+{
+    Datum next = head;
+    for (int i = 0; i < length; ++i) {
+        if (!DUU::isObject(next) ||
+            Datum::createInteger(i) != object(next)->slot(0)) {
+            return false;                                             // RETURN
+        }
+        next = object(next)->slot(1);
+    }
+    return DUU::s_Null == next;
+}
+}
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 11: {
+        if (verbose) cout << endl
+                          << "write barrier while a thread marks" << endl
+                          << "==================================" << endl;
+
+        // Store young objects into old ones, which remembers them, while the
+        // marking thread sets the flags of the same old objects, and verify
+        // that no mark is lost, i.e., that no reachable object is freed.
+        // This case is meant to be run under ThreadSanitizer as well, which
+        // reports the flags written concurrently if they are not guarded.
+
+        const int LENGTH = 2000;
+
+        bslma::TestAllocator ta;
+        {
+            Heap heap(1 << 16, &ta);
+            Heap::Roots roots(&ta);
+            HeapRootGuard guard(&heap, &roots);
+
+            makeList(&heap, &roots, LENGTH);
+            for (int i = 0; i < Heap::s_PromotionAge; ++i) {
+                heap.scavenge();
+            }
+            ASSERT(LENGTH == heap.numOldObjects());
+
+            ASSERT(0 == heap.startMarkingThread());
+            for (int round = 0; round < 20; ++round) {
+                heap.startCollection();
+                int index = 0;
+                while (heap.isCollecting()) {
+                    Object *young = heap.allocate(1);
+                    heap.setSlot(young, 0, Datum::createInteger(index));
+                    roots.push_back(DUU::datumFromObject(young));
+
+                    // Visit the nodes in order, as the marking thread does.
+
+                    Datum next = roots[0];
+                    for (int j = 0; DUU::isObject(next); ++j) {
+                        Object *node = object(next);
+                        heap.setSlot(node, 0, roots.back());
+                        heap.setSlot(node, 0, Datum::createInteger(j));
+                        next = node->slot(1);
+                    }
+                    roots.pop_back();
+                    heap.safePoint();
+                    ++index;
+                }
+                LOOP_ASSERT(round, checkList(roots[0], LENGTH));
+            }
+            heap.stopMarkingThread();
+
+            heap.collectGarbage();
+            ASSERT(checkList(roots[0], LENGTH));
+            ASSERT(LENGTH == heap.numOldObjects());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 10: {
+        if (verbose) cout << endl
+                          << "raw objects" << endl
+                          << "===========" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(4096, &ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        Object *raw = heap.allocateRaw(20);
+        ASSERT(raw->isRaw());
+        ASSERT(20 <= raw->numRawBytes());
+        ASSERT(0 == raw->numRawBytes() % sizeof(Datum));
+        ASSERT(0 == raw->numSlots());
+        ASSERT(!heap.allocate(1)->isRaw());
+
+        const int *data = static_cast<const int *>(raw->rawData());
+        for (int i = 0; i < 5; ++i) {
+            ASSERTV(i, 0 == data[i]);
+        }
+
+        // Raw data is copied, but not interpreted, by every collection.
+
+        unsigned char *bytes = static_cast<unsigned char *>(raw->rawData());
+        for (int i = 0; i < raw->numRawBytes(); ++i) {
+            bytes[i] = static_cast<unsigned char>(0xff - i);
+        }
+        roots.push_back(DUU::datumFromObject(raw));
+        heap.setProperty(raw, "a", Datum::createInteger(7));
+        for (int i = 0; i <= Heap::s_PromotionAge; ++i) {
+            heap.scavenge();
+        }
+        heap.collectGarbage();
+
+        raw = object(roots.back());
+        ASSERT(raw->isOld());
+        ASSERT(raw->isRaw());
+        ASSERT(Datum::createInteger(7) == raw->property(0));
+        bytes = static_cast<unsigned char *>(raw->rawData());
+        for (int i = 0; i < raw->numRawBytes(); ++i) {
+            ASSERTV(i, 0xff - i == bytes[i]);
+        }
+      } break;
+      case 9: {
+        if (verbose) cout << endl
+                          << "properties" << endl
+                          << "==========" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(4096, &ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        // Objects to which the same properties are added in the same order
+        // share a shape.
+
+        Object *a = heap.allocate(1);
+        roots.push_back(DUU::datumFromObject(a));
+        Object *b = heap.allocate(1);
+        roots.push_back(DUU::datumFromObject(b));
+        ASSERT(heap.emptyShape() == a->shape());
+        heap.setProperty(a, "x", Datum::createInteger(1));
+        heap.setProperty(b, "x", Datum::createInteger(2));
+        ASSERT(a->shape() == b->shape());
+        ASSERT(1 == a->shape()->numProperties());
+        ASSERT(1 == heap.emptyShape()->numTransitions());
+        ASSERT(Datum::createInteger(1) == a->property(0));
+        ASSERT(Datum::createInteger(1) == a->slot(0));
+
+        heap.setProperty(a, "x", Datum::createInteger(3));
+        ASSERT(1 == a->shape()->numProperties());
+        ASSERT(Datum::createInteger(3) == a->property(0));
+
+        // Properties beyond the slots are kept in property storage that
+        // survives scavenges and promotion, and that holds the objects it
+        // refers to alive.
+
+        const int NUM_PROPERTIES = 40;
+        for (int i = 1; i < NUM_PROPERTIES; ++i) {
+            char name[] = { 'p', char('0' + i / 10), char('0' + i % 10), 0 };
+            Object *value = heap.allocate(1);
+            heap.setSlot(value, 0, Datum::createInteger(i));
+            a = object(roots[0]);
+            heap.setProperty(a, name, DUU::datumFromObject(value));
+            a = object(roots[0]);
+            ASSERT(i + 1 == a->shape()->numProperties());
+            ASSERT(i == a->shape()->find(name));
+        }
+        ASSERT(b->shape() != a->shape());
+        for (int i = 0; i <= Heap::s_PromotionAge; ++i) {
+            heap.scavenge();
+        }
+        heap.collectGarbage();
+        a = object(roots[0]);
+        ASSERT(a->isOld());
+        ASSERT(Datum::createInteger(3) == a->property(0));
+        for (int i = 1; i < NUM_PROPERTIES; ++i) {
+            LOOP_ASSERT(i, Datum::createInteger(i) ==
+                                             object(a->property(i))->slot(0));
+        }
+
+        // Adding a property that has been added to an object of the same
+        // shape follows the existing transition.
+
+        b = object(roots[1]);
+        Shape *shape = b->shape()->addProperty("p01");
+        const Shape *ancestor = a->shape();
+        while (2 < ancestor->numProperties()) {
+            ancestor = ancestor->parent();
+        }
+        ASSERT(ancestor == shape);
+        heap.addProperty(b, shape, Datum::createInteger(5));
+        ASSERT(shape == b->shape());
+        ASSERT(Datum::createInteger(5) == b->property(1));
+        ASSERT(-1 == b->shape()->find("p02"));
+      } break;
+      case 8: {
+        if (verbose) cout << endl
+                          << "marking thread" << endl
+                          << "==============" << endl;
+
+        // Mutate the heap while a helper thread marks, and verify that no
+        // reachable object is freed.
+
+        bslma::TestAllocator ta;
+        {
+            Heap heap(4096, &ta);
+            Heap::Roots roots(&ta);
+            HeapRootGuard guard(&heap, &roots);
+
+            ASSERT(0 == heap.startMarkingThread());
+            makeList(&heap, &roots, 1000);
+            for (int i = 0; i < 200; ++i) {
+                makeList(&heap, &roots, 500);
+                if (0 == i % 2) {
+                    // Splice the new list into an old node of the kept one.
+
+                    Object *node = object(roots[0]);
+                    for (int j = 0; j < i; ++j) {
+                        node = object(node->slot(1));
+                    }
+                    heap.setSlot(node, 0, roots[1]);
+                    heap.setSlot(node, 0, Datum::createInteger(i));
+                }
+                roots.pop_back();
+                heap.safePoint();
+            }
+            heap.stopMarkingThread();
+            ASSERT(0 < heap.numFullCollections());
+            ASSERT(checkList(roots[0], 1000));
+
+            heap.collectGarbage();
+            heap.collectGarbage();
+            ASSERT(checkList(roots[0], 1000));
+            ASSERT(1000 == heap.numOldObjects());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 7: {
+        if (verbose) cout << endl
+                          << "write barrier" << endl
+                          << "=============" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(4096, &ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        // Make 'c' refer to 'b', with both old.
+
+        Object *c = heap.allocate(1);
+        roots.push_back(DUU::datumFromObject(c));
+        Object *b = heap.allocate(1);
+        heap.setSlot(b, 0, Datum::createInteger(42));
+        heap.setSlot(c, 0, DUU::datumFromObject(b));
+        for (int i = 0; i < Heap::s_PromotionAge; ++i) {
+            heap.scavenge();
+        }
+        c = object(roots[0]);
+        ASSERT(c->isOld());
+        ASSERT(2 == heap.numOldObjects());
+
+        // An object too large for the nursery, allocated while marking, is
+        // already marked and is not scanned again.  Moving the only
+        // reference to 'b' into it must not let 'b' be freed.
+
+        heap.startCollection();
+        ASSERT(heap.isCollecting());
+        Object *a = heap.allocate(200);
+        ASSERT(a->isOld());
+        roots.push_back(DUU::datumFromObject(a));
+        heap.setSlot(a, 0, c->slot(0));
+        heap.setSlot(c, 0, DUU::s_Null);
+        while (heap.isCollecting()) {
+            heap.step();
+        }
+        ASSERT(1 == heap.numFullCollections());
+        ASSERT(3 == heap.numOldObjects());
+        ASSERT(Datum::createInteger(42) == object(a->slot(0))->slot(0));
+
+        // Once nothing refers to it, 'b' is freed by the next collection.
+
+        heap.setSlot(a, 0, DUU::s_Null);
+        heap.startCollection();
+        while (heap.isCollecting()) {
+            heap.step();
+        }
+        ASSERT(2 == heap.numOldObjects());
+      } break;
+      case 6: {
+        if (verbose) cout << endl
+                          << "incremental collection" << endl
+                          << "======================" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        makeList(&heap, &roots, 1000);
+        makeList(&heap, &roots, 1000);
+        for (int i = 0; i < Heap::s_PromotionAge; ++i) {
+            heap.scavenge();
+        }
+        ASSERT(2000 == heap.numOldObjects());
+        roots.pop_back();
+
+        // With the smallest budget each step does a single batch of work,
+        // so the collection takes many steps; every step is a pause.
+
+        heap.resetPauses();
+        heap.setPauseBudget(1);
+        ASSERT(1 == heap.pauseBudget());
+        heap.safePoint();
+        ASSERT(0 == heap.numSteps());
+        heap.startCollection();
+        while (heap.isCollecting()) {
+            heap.safePoint();
+
+            // Allocation during the collection is not disturbed by it.
+
+            heap.allocate(2);
+        }
+        ASSERT(1000 / Heap::s_MarkBatchSize < heap.numSteps());
+        ASSERT(heap.numSteps() == heap.pauses().numPauses());
+        ASSERT(1 == heap.numFullCollections());
+        ASSERT(1000 == heap.numOldObjects());
+        ASSERT(checkList(roots[0], 1000));
+      } break;
+      case 5: {
+        if (verbose) cout << endl
+                          << "allocation pressure" << endl
+                          << "===================" << endl;
+
+        // Build long lists in a small nursery, so that allocation scavenges,
+        // promotes, and eventually performs full collections, while
+        // discarding most of what is built.
+
+        bslma::TestAllocator ta;
+        {
+            Heap heap(4096, &ta);
+            Heap::Roots roots(&ta);
+            HeapRootGuard guard(&heap, &roots);
+
+            const Datum kept = makeList(&heap, &roots, 1000);
+            (void)kept;
+            for (int i = 0; i < 200; ++i) {
+                makeList(&heap, &roots, 500);
+                roots.pop_back();
+            }
+            ASSERT(0 < heap.numScavenges());
+            ASSERT(0 < heap.numFullCollections());
+            ASSERT(checkList(roots[0], 1000));
+
+            // Everything but the kept list is garbage.
+
+            heap.collectGarbage();
+            heap.collectGarbage();
+            ASSERT(checkList(roots[0], 1000));
+            ASSERT(1000 == heap.numOldObjects());
+            ASSERT(0 == heap.youngBytesInUse());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "collectGarbage" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        // Promote a list of 10 objects and a cycle of two objects.
+
+        makeList(&heap, &roots, 10);
+        Object *a = heap.allocate(1);
+        roots.push_back(DUU::datumFromObject(a));
+        Object *b = heap.allocate(1);
+        heap.setSlot(a, 0, DUU::datumFromObject(b));
+        heap.setSlot(b, 0, roots[1]);
+        for (int i = 0; i < Heap::s_PromotionAge; ++i) {
+            heap.scavenge();
+        }
+        ASSERT(12 == heap.numOldObjects());
+        const bsl::size_t oldBytes = heap.oldBytesInUse();
+
+        // Unreachable old objects, including cycles, are freed.
+
+        roots.pop_back();
+        heap.collectGarbage();
+        ASSERT(1 == heap.numFullCollections());
+        ASSERT(10 == heap.numOldObjects());
+        ASSERT(oldBytes - 2 * Object::sizeFor(1) == heap.oldBytesInUse());
+        ASSERT(checkList(roots[0], 10));
+
+        // An old object reachable only through a young object survives.
+
+        Object *young = heap.allocate(1);
+        heap.setSlot(young, 0, roots[0]);
+        roots[0] = DUU::datumFromObject(young);
+        heap.collectGarbage();
+        ASSERT(10 == heap.numOldObjects());
+        ASSERT(checkList(object(roots[0])->slot(0), 10));
+
+        roots.clear();
+        heap.collectGarbage();
+        ASSERT(0 == heap.numOldObjects());
+        ASSERT(0 == heap.oldBytesInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "promotion and remembered set" << endl
+                          << "============================" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        roots.push_back(DUU::datumFromObject(heap.allocate(1)));
+        for (int i = 1; i < Heap::s_PromotionAge; ++i) {
+            heap.scavenge();
+            ASSERT(!object(roots[0])->isOld());
+            ASSERT(i == object(roots[0])->age());
+        }
+        heap.scavenge();
+        Object *old = object(roots[0]);
+        ASSERT(old->isOld());
+        ASSERT(1 == heap.numOldObjects());
+        ASSERT(0 == heap.youngBytesInUse());
+
+        // A young object referred to only by an old object survives a
+        // scavenge, and the old object is updated to refer to its copy.
+
+        Object *young = heap.allocate(1);
+        heap.setSlot(young, 0, Datum::createInteger(42));
+        heap.setSlot(old, 0, DUU::datumFromObject(young));
+        heap.scavenge();
+        ASSERT(old == object(roots[0]));
+        ASSERT(DUU::isObject(old->slot(0)));
+        young = object(old->slot(0));
+        ASSERT(!young->isOld());
+        ASSERT(Datum::createInteger(42) == young->slot(0));
+
+        // Once the young object is promoted the old object is no longer
+        // remembered, and the young object is not copied again.
+
+        heap.scavenge();
+        ASSERT(object(old->slot(0))->isOld());
+        ASSERT(2 == heap.numOldObjects());
+        ASSERT(0 == heap.youngBytesInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "scavenge" << endl
+                          << "========" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        makeList(&heap, &roots, 100);
+        Object *a = heap.allocate(1);
+        Object *b = heap.allocate(1);
+        heap.setSlot(a, 0, DUU::datumFromObject(b));
+        heap.setSlot(b, 0, DUU::datumFromObject(a));
+        roots.push_back(DUU::datumFromObject(a));
+        heap.allocate(10);                                      // garbage
+
+        const bsl::size_t live = 100 * Object::sizeFor(2) +
+                                 2 * Object::sizeFor(1);
+        ASSERT(live + Object::sizeFor(10) == heap.youngBytesInUse());
+
+        heap.scavenge();
+        ASSERT(1 == heap.numScavenges());
+        ASSERT(live == heap.youngBytesInUse());
+        ASSERT(0 == heap.numOldObjects());
+
+        // Rooted objects have moved, preserving the graph, including the
+        // cycle.
+
+        ASSERT(checkList(roots[0], 100));
+        a = object(roots[1]);
+        b = object(a->slot(0));
+        ASSERT(a != b);
+        ASSERT(a == object(b->slot(0)));
+
+        roots.clear();
+        heap.scavenge();
+        ASSERT(0 == heap.youngBytesInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta;
+        {
+            Heap heap(&ta);
+            ASSERT(Heap::s_DefaultNurserySize == heap.nurserySize());
+            ASSERT(0 == ta.numBlocksInUse());
+
+            Object *o = heap.allocate(2);
+            ASSERT(Object::sizeFor(2) == heap.youngBytesInUse());
+            heap.setSlot(o, 1, Datum::createInteger(7));
+            ASSERT(DUU::s_Undefined == o->slot(0));
+            ASSERT(Datum::createInteger(7) == o->slot(1));
+            ASSERT(0 == heap.numScavenges());
+            ASSERT(0 == heap.numOldObjects());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
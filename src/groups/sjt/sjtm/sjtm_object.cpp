@@ -0,0 +1,47 @@
+// sjtm_object.cpp
+#include <sjtm_object.h>
+
+#include <bslmf_assert.h>
+
+#include <bsl_cstring.h>
+
+#include <sjtd_datumudtutil.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+
+// The slots of an object follow its header, so the header must preserve the
+// alignment of 'Datum'.
+
+BSLMF_ASSERT(0 == sizeof(Object) % sizeof(void *));
+
+                                // ------------
+                                // class Object
+                                // ------------
+
+// PRIVATE CREATORS
+Object::Object(int numSlots, bool old, bool raw, Shape *shape)
+: d_forward_p(0)
+, d_shape_p(shape)
+, d_properties(sjtd::DatumUdtUtil::s_Undefined)
+, d_numSlots(numSlots)
+, d_age(0)
+, d_flags((old ? e_Old : 0) | (raw ? e_Raw : 0))
+, d_marked(false)
+{
+    BSLS_ASSERT(0 <= numSlots);
+    BSLS_ASSERT(0 != shape);
+
+    if (raw) {
+        bsl::memset(static_cast<void *>(slots()),
+                    0,
+                    numSlots * sizeof(Datum));
+        return;                                                       // RETURN
+    }
+    Datum *values = slots();
+    for (int i = 0; i < numSlots; ++i) {
+        values[i] = sjtd::DatumUdtUtil::s_Undefined;
+    }
+}
+}
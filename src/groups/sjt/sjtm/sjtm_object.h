@@ -0,0 +1,269 @@
+// sjtm_object.h
+
+#ifndef INCLUDED_SJTM_OBJECT
+#define INCLUDED_SJTM_OBJECT
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_SJTD_DATUMUDTUTIL
+#include <sjtd_datumudtutil.h>
+#endif
+
+namespace sjtm {
+
+class Heap;
+class Shape;
+
+                                // ============
+                                // class Object
+                                // ============
+
+class Object {
+    // This class is a mechanism describing the header of an object allocated
+    // from a 'Heap'.  The header is immediately followed in memory by the
+    // slots of the object, an array of 'numSlots()' 'Datum' values.  Objects
+    // are created, moved and destroyed only by their heap; in particular, a
+    // young object is moved by every scavenge it survives, so references to
+    // it must be held only in slots of other objects or in the roots of its
+    // heap.  Slots are modified through 'Heap::setSlot', which records the
+    // references from old objects to young ones.
+    //
+    // An object also has named properties, laid out as described by its
+    // 'shape()': the property at index 'i' is stored in slot 'i' if
+    // 'i < numSlots()', and otherwise in a separate property storage object
+    // managed by the heap.  Properties are modified through
+    // 'Heap::setProperty'.  Note that the slots of an object holding
+    // properties should not be modified directly.
+    //
+    // A raw object, allocated by 'Heap::allocateRaw', instead holds
+    // 'numRawBytes()' bytes of unstructured data that are never examined by
+    // the garbage collector; it has no slots, so all of its properties are in
+    // its property storage.  As raw data cannot refer to other objects, it
+    // may be modified directly through 'rawData'.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+
+    enum Flag {
+        // Enumeration of the bits of the state of an object used by the
+        // garbage collector.
+
+        e_Old        = 1 << 0,
+            // the object is in the old generation and is never moved
+
+        e_Remembered = 1 << 1,
+            // the object is old and is in the remembered set of its heap
+
+        e_Raw        = 1 << 3,
+            // the object holds raw data rather than slots
+    };
+
+  private:
+    // DATA
+    Object        *d_forward_p;  // address of the copy made by the scavenger,
+                                 // or 0
+    Shape         *d_shape_p;    // layout of the properties, held, not owned
+    Datum          d_properties; // property storage beyond the slots, or
+                                 // 'DatumUdtUtil::s_Undefined'
+    int            d_numSlots;   // number of slots, or of 'Datum'-sized
+                                 // words of raw data, following the header
+    unsigned char  d_age;        // number of scavenges survived
+    unsigned char  d_flags;      // bitwise-or of 'Flag' values
+    bool           d_marked;     // found to be reachable by a full
+                                 // collection; apart from 'd_flags', as the
+                                 // marking thread writes it while the
+                                 // mutator reads 'd_flags'
+
+    // FRIENDS
+    friend class Heap;
+
+    // PRIVATE CREATORS
+    Object(int numSlots, bool old, bool raw, Shape *shape);
+        // Create an object header for the specified 'numSlots' slots, which
+        // are set to 'DatumUdtUtil::s_Undefined', having the properties of
+        // the specified 'shape', in the old generation if the specified 'old'
+        // is 'true' and in the young generation otherwise.  If the specified
+        // 'raw' is 'true', the storage for the slots instead holds raw data,
+        // which is set to zero.  The behavior is undefined unless this object
+        // is followed by storage for 'numSlots' values and 'shape' has no
+        // properties.
+
+    // PRIVATE MANIPULATORS
+    Datum *slots();
+        // Return the address of the first slot of this object.
+
+    // NOT IMPLEMENTED
+    Object(const Object&) = delete;
+    Object& operator=(const Object&) = delete;
+
+  public:
+    // CLASS METHODS
+    static bsl::size_t sizeFor(int numSlots);
+        // Return the number of bytes occupied by an object having the
+        // specified 'numSlots' slots, including its header.
+
+    // MANIPULATORS
+    void *rawData();
+        // Return the address of the raw data of this object.  The behavior
+        // is undefined unless 'isRaw()'.
+
+    // ACCESSORS
+    int age() const;
+        // Return the number of scavenges this object has survived.
+
+    bool isOld() const;
+        // Return 'true' if this object is in the old generation and 'false'
+        // otherwise.
+
+    bool isRaw() const;
+        // Return 'true' if this object holds raw data and 'false' otherwise.
+
+    int numRawBytes() const;
+        // Return the number of bytes of raw data in this object, which is a
+        // multiple of 'sizeof(Datum)', or 0 if this object is not raw.
+
+    int numSlots() const;
+        // Return the number of slots in this object, which is 0 if this
+        // object is raw.
+
+    const Datum& property(int index) const;
+        // Return a reference providing non-modifiable access to the value of
+        // the property at the specified 'index'.  The behavior is undefined
+        // unless '0 <= index < shape()->numProperties()'.
+
+    const void *rawData() const;
+        // Return the address of the raw data of this object.  The behavior
+        // is undefined unless 'isRaw()'.
+
+    Shape *shape() const;
+        // Return the shape describing the properties of this object.
+
+    const Datum& slot(int index) const;
+        // Return a reference providing non-modifiable access to the slot at
+        // the specified 'index'.  The behavior is undefined unless
+        // '0 <= index < numSlots()'.
+
+    bsl::size_t size() const;
+        // Return the number of bytes occupied by this object, including its
+        // header.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                // ------------
+                                // class Object
+                                // ------------
+
+// PRIVATE MANIPULATORS
+inline
+BloombergLP::bdld::Datum *Object::slots()
+{
+    return reinterpret_cast<Datum *>(this + 1);
+}
+
+// MANIPULATORS
+inline
+void *Object::rawData()
+{
+    BSLS_ASSERT(isRaw());
+
+    return this + 1;
+}
+
+// CLASS METHODS
+inline
+bsl::size_t Object::sizeFor(int numSlots)
+{
+    BSLS_ASSERT(0 <= numSlots);
+
+    return sizeof(Object) + numSlots * sizeof(Datum);
+}
+
+// ACCESSORS
+inline
+int Object::age() const
+{
+    return d_age;
+}
+
+inline
+bool Object::isOld() const
+{
+    return 0 != (d_flags & e_Old);
+}
+
+inline
+bool Object::isRaw() const
+{
+    return 0 != (d_flags & e_Raw);
+}
+
+inline
+int Object::numRawBytes() const
+{
+    return isRaw() ? d_numSlots * static_cast<int>(sizeof(Datum)) : 0;
+}
+
+inline
+int Object::numSlots() const
+{
+    return isRaw() ? 0 : d_numSlots;
+}
+
+inline
+const BloombergLP::bdld::Datum& Object::property(int index) const
+{
+    BSLS_ASSERT(0 <= index);
+
+    const int numSlots = this->numSlots();
+    if (index < numSlots) {
+        return reinterpret_cast<const Datum *>(this + 1)[index];      // RETURN
+    }
+    return sjtd::DatumUdtUtil::getObject(d_properties)->slot(
+                                                           index - numSlots);
+}
+
+inline
+const void *Object::rawData() const
+{
+    BSLS_ASSERT(isRaw());
+
+    return this + 1;
+}
+
+inline
+Shape *Object::shape() const
+{
+    return d_shape_p;
+}
+
+inline
+const BloombergLP::bdld::Datum& Object::slot(int index) const
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numSlots());
+
+    return reinterpret_cast<const Datum *>(this + 1)[index];
+}
+
+inline
+bsl::size_t Object::size() const
+{
+    return sizeFor(d_numSlots);
+}
+}
+
+#endif
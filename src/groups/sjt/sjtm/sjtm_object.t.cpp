@@ -0,0 +1,120 @@
+// sjtm_object.t.cpp                                              -*-C++-*-
+
+#include <sjtm_object.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_heap.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    typedef bdld::Datum Datum;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "creation" << endl
+                          << "========" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+
+        const Object *young = heap.allocate(3);
+        ASSERT(3 == young->numSlots());
+        ASSERT(!young->isOld());
+        ASSERT(0 == young->age());
+        ASSERT(Object::sizeFor(3) == young->size());
+        ASSERT(heap.emptyShape() == young->shape());
+        for (int i = 0; i < young->numSlots(); ++i) {
+            ASSERT(sjtd::DatumUdtUtil::s_Undefined == young->slot(i));
+        }
+
+        // Objects too large for the nursery are created old.
+
+        const int numSlots = static_cast<int>(Heap::s_DefaultNurserySize /
+                                              sizeof(Datum));
+        const Object *old = heap.allocate(numSlots);
+        ASSERT(numSlots == old->numSlots());
+        ASSERT(old->isOld());
+        ASSERT(sjtd::DatumUdtUtil::s_Undefined == old->slot(numSlots - 1));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "sizeFor" << endl
+                          << "=======" << endl;
+
+        ASSERT(sizeof(Object) == Object::sizeFor(0));
+        ASSERT(sizeof(Object) + 2 * sizeof(Datum) == Object::sizeFor(2));
+        ASSERT(0 == sizeof(Object) % sizeof(void *));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
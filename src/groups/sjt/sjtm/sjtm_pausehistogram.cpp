@@ -0,0 +1,94 @@
+// sjtm_pausehistogram.cpp
+#include <sjtm_pausehistogram.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_ostream.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+
+                            // --------------------
+                            // class PauseHistogram
+                            // --------------------
+
+// CLASS METHODS
+int PauseHistogram::bucketFor(Int64 nanoseconds)
+{
+    int bucket = 0;
+    for (Int64 micros = nanoseconds / 1000; 0 < micros; micros >>= 1) {
+        ++bucket;
+    }
+    return bucket < k_NUM_BUCKETS ? bucket : k_NUM_BUCKETS - 1;
+}
+
+PauseHistogram::Int64 PauseHistogram::bucketLimit(int bucket)
+{
+    BSLS_ASSERT(0 <= bucket);
+    BSLS_ASSERT(bucket < k_NUM_BUCKETS - 1);
+
+    return (static_cast<Int64>(1) << bucket) * 1000;
+}
+
+// CREATORS
+PauseHistogram::PauseHistogram()
+{
+    reset();
+}
+
+// MANIPULATORS
+void PauseHistogram::record(Int64 nanoseconds)
+{
+    ++d_counts[bucketFor(nanoseconds)];
+    ++d_numPauses;
+    d_totalNanoseconds += nanoseconds;
+    if (d_maxNanoseconds < nanoseconds) {
+        d_maxNanoseconds = nanoseconds;
+    }
+}
+
+void PauseHistogram::reset()
+{
+    for (int i = 0; i < k_NUM_BUCKETS; ++i) {
+        d_counts[i] = 0;
+    }
+    d_numPauses        = 0;
+    d_totalNanoseconds = 0;
+    d_maxNanoseconds   = 0;
+}
+
+// ACCESSORS
+PauseHistogram::Int64 PauseHistogram::percentileNanoseconds(
+                                                         double fraction) const
+{
+    BSLS_ASSERT(0 <= fraction);
+    BSLS_ASSERT(fraction <= 1);
+
+    const double target = fraction * d_numPauses;
+    int          seen   = 0;
+    for (int i = 0; i < k_NUM_BUCKETS - 1; ++i) {
+        seen += d_counts[i];
+        if (target <= seen) {
+            return bsl::min(bucketLimit(i), d_maxNanoseconds);        // RETURN
+        }
+    }
+    return d_maxNanoseconds;
+}
+
+bsl::ostream& PauseHistogram::print(bsl::ostream& stream) const
+{
+    for (int i = 0; i < k_NUM_BUCKETS; ++i) {
+        if (0 == d_counts[i]) {
+            continue;                                              // CONTINUE
+        }
+        if (k_NUM_BUCKETS - 1 == i) {
+            stream << ">= " << bucketLimit(i - 1) / 1000 << "us";
+        }
+        else {
+            stream << "< " << bucketLimit(i) / 1000 << "us";
+        }
+        stream << ": " << d_counts[i] << '\n';
+    }
+    return stream;
+}
+}
@@ -0,0 +1,135 @@
+// sjtm_pausehistogram.h
+
+#ifndef INCLUDED_SJTM_PAUSEHISTOGRAM
+#define INCLUDED_SJTM_PAUSEHISTOGRAM
+
+#ifndef INCLUDED_BSL_IOSFWD
+#include <bsl_iosfwd.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace sjtm {
+
+                            // ====================
+                            // class PauseHistogram
+                            // ====================
+
+class PauseHistogram {
+    // This class is an in-core, value-semantic type that summarizes the
+    // durations of a sequence of pauses.  Durations are counted in buckets
+    // whose bounds grow by powers of two: bucket 0 counts pauses shorter than
+    // one microsecond, and bucket 'i > 0' counts pauses of at least '2^(i-1)'
+    // and less than '2^i' microseconds; the last bucket also counts all
+    // longer pauses.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    // CONSTANTS
+    enum { k_NUM_BUCKETS = 24 };
+
+  private:
+    // DATA
+    int   d_counts[k_NUM_BUCKETS];   // number of pauses in each bucket
+    int   d_numPauses;
+    Int64 d_totalNanoseconds;
+    Int64 d_maxNanoseconds;
+
+  public:
+    // CLASS METHODS
+    static int bucketFor(Int64 nanoseconds);
+        // Return the index of the bucket counting a pause of the specified
+        // 'nanoseconds'.
+
+    static Int64 bucketLimit(int bucket);
+        // Return the number of nanoseconds below which pauses are counted in
+        // the specified 'bucket' or a lower one.  The behavior is undefined
+        // unless '0 <= bucket < k_NUM_BUCKETS - 1'.
+
+    // CREATORS
+    PauseHistogram();
+        // Create a histogram having no pauses.
+
+    //! PauseHistogram(const PauseHistogram& original) = default;
+    //! ~PauseHistogram() = default;
+
+    // MANIPULATORS
+    //! PauseHistogram& operator=(const PauseHistogram& rhs) = default;
+
+    void record(Int64 nanoseconds);
+        // Add a pause lasting the specified 'nanoseconds' to this histogram.
+
+    void reset();
+        // Remove every pause from this histogram.
+
+    // ACCESSORS
+    int count(int bucket) const;
+        // Return the number of pauses counted in the specified 'bucket'.  The
+        // behavior is undefined unless '0 <= bucket < k_NUM_BUCKETS'.
+
+    Int64 maxNanoseconds() const;
+        // Return the duration of the longest pause, or 0 if there is none.
+
+    int numPauses() const;
+        // Return the number of pauses in this histogram.
+
+    Int64 percentileNanoseconds(double fraction) const;
+        // Return an upper bound on the duration of the specified 'fraction'
+        // of the pauses in this histogram having the shortest durations, with
+        // the resolution of a bucket.  The behavior is undefined unless
+        // '0 <= fraction <= 1'.
+
+    Int64 totalNanoseconds() const;
+        // Return the total duration of the pauses in this histogram.
+
+    bsl::ostream& print(bsl::ostream& stream) const;
+        // Write a description of the non-empty buckets of this histogram, one
+        // per line, to the specified 'stream', and return 'stream'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // --------------------
+                            // class PauseHistogram
+                            // --------------------
+
+// ACCESSORS
+inline
+int PauseHistogram::count(int bucket) const
+{
+    BSLS_ASSERT(0 <= bucket);
+    BSLS_ASSERT(bucket < k_NUM_BUCKETS);
+
+    return d_counts[bucket];
+}
+
+inline
+PauseHistogram::Int64 PauseHistogram::maxNanoseconds() const
+{
+    return d_maxNanoseconds;
+}
+
+inline
+int PauseHistogram::numPauses() const
+{
+    return d_numPauses;
+}
+
+inline
+PauseHistogram::Int64 PauseHistogram::totalNanoseconds() const
+{
+    return d_totalNanoseconds;
+}
+}
+
+#endif
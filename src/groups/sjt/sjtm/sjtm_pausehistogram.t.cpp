@@ -0,0 +1,163 @@
+// sjtm_pausehistogram.t.cpp                                      -*-C++-*-
+
+#include <sjtm_pausehistogram.h>
+
+#include <bdls_testutil.h>
+
+#include <bsl_sstream.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    typedef PauseHistogram::Int64 Int64;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "percentiles and print" << endl
+                          << "=====================" << endl;
+
+        PauseHistogram h;
+        ASSERT(0 == h.percentileNanoseconds(0.5));
+        for (int i = 0; i < 90; ++i) {
+            h.record(500);
+        }
+        for (int i = 0; i < 10; ++i) {
+            h.record(3000);
+        }
+        ASSERT(1000 == h.percentileNanoseconds(0.5));
+        ASSERT(1000 == h.percentileNanoseconds(0.9));
+        ASSERT(3000 == h.percentileNanoseconds(0.99));
+        ASSERT(3000 == h.percentileNanoseconds(1));
+
+        h.record(5000);
+        ASSERT(4000 == h.percentileNanoseconds(0.99));
+
+        ostringstream out;
+        h.print(out);
+        ASSERT("< 1us: 90\n< 4us: 10\n< 8us: 1\n" == out.str());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "buckets" << endl
+                          << "=======" << endl;
+
+        static const struct {
+            int   d_line;
+            Int64 d_nanoseconds;
+            int   d_bucket;
+        } DATA[] = {
+            { L_,          0,  0 },
+            { L_,        999,  0 },
+            { L_,       1000,  1 },
+            { L_,       1999,  1 },
+            { L_,       2000,  2 },
+            { L_,       3999,  2 },
+            { L_,       4000,  3 },
+            { L_,    1000000, 10 },
+            { L_, 1LL << 60, PauseHistogram::k_NUM_BUCKETS - 1 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(DATA[0]);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+            LOOP_ASSERT(LINE, DATA[i].d_bucket ==
+                            PauseHistogram::bucketFor(DATA[i].d_nanoseconds));
+        }
+        for (int i = 0; i < PauseHistogram::k_NUM_BUCKETS - 1; ++i) {
+            const Int64 limit = PauseHistogram::bucketLimit(i);
+            LOOP_ASSERT(i, i == PauseHistogram::bucketFor(limit - 1));
+            LOOP_ASSERT(i, i + 1 == PauseHistogram::bucketFor(limit));
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        PauseHistogram h;
+        ASSERT(0 == h.numPauses());
+        ASSERT(0 == h.totalNanoseconds());
+        ASSERT(0 == h.maxNanoseconds());
+
+        h.record(1500);
+        h.record(500);
+        ASSERT(2 == h.numPauses());
+        ASSERT(2000 == h.totalNanoseconds());
+        ASSERT(1500 == h.maxNanoseconds());
+        ASSERT(1 == h.count(0));
+        ASSERT(1 == h.count(1));
+
+        const PauseHistogram copy(h);
+        h.reset();
+        ASSERT(0 == h.numPauses());
+        ASSERT(0 == h.count(1));
+        ASSERT(2 == copy.numPauses());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,309 @@
+// sjtm_perfmap.cpp
+#include <sjtm_perfmap.h>
+
+#include <bslma_default.h>
+#include <bslmt_lockguard.h>
+#include <bsls_assert.h>
+#include <bsls_types.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+using namespace BloombergLP;
+
+namespace sjtm {
+namespace {
+
+typedef bsls::Types::Uint64  Uint64;
+typedef bsls::Types::UintPtr UintPtr;
+
+// The layout of a jitdump is that read by 'perf inject --jit', as described
+// in 'tools/perf/Documentation/jitdump-specification.txt' of the Linux
+// sources.  Its fields are in the byte order of the process.
+
+const unsigned int k_JITDUMP_MAGIC   = 0x4A695444;         // "JiTD"
+const unsigned int k_JITDUMP_VERSION = 1;
+
+enum RecordId {
+    e_JIT_CODE_LOAD  = 0,
+    e_JIT_CODE_CLOSE = 3
+};
+
+struct FileHeader {
+    unsigned int d_magic;
+    unsigned int d_version;
+    unsigned int d_totalSize;
+    unsigned int d_elfMachine;
+    unsigned int d_pad;
+    unsigned int d_pid;
+    Uint64       d_timestamp;
+    Uint64       d_flags;
+};
+
+struct RecordHeader {
+    unsigned int d_id;
+    unsigned int d_totalSize;
+    Uint64       d_timestamp;
+};
+
+struct CodeLoad {
+    // This 'struct' is followed by the name, with its terminating null, and
+    // the bytes of the code.
+
+    RecordHeader d_header;
+    unsigned int d_pid;
+    unsigned int d_tid;
+    Uint64       d_vma;
+    Uint64       d_codeAddress;
+    Uint64       d_codeSize;
+    Uint64       d_codeIndex;
+};
+
+unsigned int elfMachine()
+    // Return the ELF machine number of the processor the code is generated
+    // for, or 0 if it is not known.
+{
+#if defined(__x86_64__)
+    return 62;                                                   // EM_X86_64
+#elif defined(__aarch64__)
+    return 183;                                                 // EM_AARCH64
+#elif defined(__i386__)
+    return 3;                                                       // EM_386
+#else
+    return 0;
+#endif
+}
+
+Uint64 timestamp()
+    // Return the current time of 'CLOCK_MONOTONIC', in nanoseconds.
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<Uint64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+unsigned int threadId()
+    // Return the identifier of the calling thread known to the profiler.
+{
+#if defined(__linux__)
+    return static_cast<unsigned int>(::syscall(SYS_gettid));
+#else
+    return static_cast<unsigned int>(::getpid());
+#endif
+}
+
+int writeAll(int fd, const void *bytes, bsl::size_t numBytes)
+    // Write the specified 'numBytes' 'bytes' to the specified 'fd', and
+    // return 0 on success, and a non-zero value otherwise.
+{
+    const char *next = static_cast<const char *>(bytes);
+    while (0 < numBytes) {
+        const ssize_t rc = ::write(fd, next, numBytes);
+        if (0 > rc) {
+            if (EINTR == errno) {
+                continue;                                           // CONTINUE
+            }
+            return 1;                                                 // RETURN
+        }
+        next     += rc;
+        numBytes -= rc;
+    }
+    return 0;
+}
+
+int openFile(const bsl::string& path)
+    // Create, or truncate, the file at the specified 'path' and return its
+    // descriptor, or -1 if it cannot be opened.
+{
+    return ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+}
+
+}  // close unnamed namespace
+
+                               // -------------
+                               // class PerfMap
+                               // -------------
+
+// PRIVATE MANIPULATORS
+void PerfMap::open(int formats, const StringRef& directory)
+{
+    BSLS_ASSERT(0 == (formats & ~(e_PERF_MAP | e_JITDUMP)));
+
+    char pid[16];
+    bsl::snprintf(pid, sizeof pid, "%d", static_cast<int>(::getpid()));
+
+    d_perfMapPath.assign(directory.data(), directory.size());
+    d_perfMapPath.append("/perf-").append(pid).append(".map");
+    d_jitdumpPath.assign(directory.data(), directory.size());
+    d_jitdumpPath.append("/jit-").append(pid).append(".dump");
+
+    if (formats & e_PERF_MAP) {
+        d_perfMapFd = openFile(d_perfMapPath);
+    }
+    if (0 == (formats & e_JITDUMP)) {
+        return;                                                       // RETURN
+    }
+    d_jitdumpFd = openFile(d_jitdumpPath);
+    if (0 > d_jitdumpFd) {
+        return;                                                       // RETURN
+    }
+
+    const FileHeader header = { k_JITDUMP_MAGIC,
+                                k_JITDUMP_VERSION,
+                                sizeof(FileHeader),
+                                elfMachine(),
+                                0,
+                                static_cast<unsigned int>(::getpid()),
+                                timestamp(),
+                                0 };
+    if (0 != writeAll(d_jitdumpFd, &header, sizeof header)) {
+        ::close(d_jitdumpFd);
+        d_jitdumpFd = -1;
+        return;                                                       // RETURN
+    }
+
+    // 'perf record' finds the jitdump by the executable mapping of it, which
+    // is kept until the jitdump is closed.
+
+    d_markerSize = ::sysconf(_SC_PAGESIZE);
+    void *marker = ::mmap(0,
+                          d_markerSize,
+                          PROT_READ | PROT_EXEC,
+                          MAP_PRIVATE,
+                          d_jitdumpFd,
+                          0);
+    d_marker_p = MAP_FAILED == marker ? 0 : marker;
+}
+
+// CLASS METHODS
+bsl::string PerfMap::symbolName(const StringRef& sourceName, int entryIndex)
+{
+    BSLS_ASSERT(0 <= entryIndex);
+
+    char index[16];
+    bsl::snprintf(index, sizeof index, "%d", entryIndex);
+
+    bsl::string name("sjt::");
+    if (!sourceName.empty()) {
+        name.append(sourceName.data(), sourceName.size());
+        name += ':';
+    }
+    name += index;
+    return name;
+}
+
+// CREATORS
+PerfMap::PerfMap(int formats, Allocator *basicAllocator)
+: d_perfMapPath(basicAllocator)
+, d_jitdumpPath(basicAllocator)
+, d_perfMapFd(-1)
+, d_jitdumpFd(-1)
+, d_marker_p(0)
+, d_markerSize(0)
+, d_numRecords(0)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+    open(formats, "/tmp");
+}
+
+PerfMap::PerfMap(int               formats,
+                 const StringRef&  directory,
+                 Allocator        *basicAllocator)
+: d_perfMapPath(basicAllocator)
+, d_jitdumpPath(basicAllocator)
+, d_perfMapFd(-1)
+, d_jitdumpFd(-1)
+, d_marker_p(0)
+, d_markerSize(0)
+, d_numRecords(0)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+    open(formats, directory);
+}
+
+PerfMap::~PerfMap()
+{
+    if (0 <= d_jitdumpFd) {
+        const RecordHeader close = { e_JIT_CODE_CLOSE,
+                                     sizeof(RecordHeader),
+                                     timestamp() };
+        writeAll(d_jitdumpFd, &close, sizeof close);
+        if (0 != d_marker_p) {
+            ::munmap(d_marker_p, d_markerSize);
+        }
+        ::close(d_jitdumpFd);
+    }
+    if (0 <= d_perfMapFd) {
+        ::close(d_perfMapFd);
+    }
+}
+
+// MANIPULATORS
+int PerfMap::add(const void *address, bsl::size_t size, const StringRef& name)
+{
+    BSLS_ASSERT(0 != address);
+
+    // Each record is written at once, so that the records of concurrent
+    // callers are not interleaved.
+
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+
+    int rc = 0;
+    if (0 <= d_perfMapFd) {
+        char      range[48];
+        const int length = bsl::snprintf(
+                        range,
+                        sizeof range,
+                        "%llx %llx ",
+                        static_cast<unsigned long long>(
+                                         reinterpret_cast<UintPtr>(address)),
+                        static_cast<unsigned long long>(size));
+        bsl::string line(d_allocator_p);
+        line.assign(range, length);
+        line.append(name.data(), name.size());
+        line += '\n';
+        rc |= writeAll(d_perfMapFd, line.data(), line.size());
+    }
+    if (0 <= d_jitdumpFd) {
+        const bsl::size_t total = sizeof(CodeLoad) + name.size() + 1 + size;
+        const Uint64      start = reinterpret_cast<UintPtr>(address);
+
+        const CodeLoad load = {
+            { e_JIT_CODE_LOAD,
+              static_cast<unsigned int>(total),
+              timestamp() },
+            static_cast<unsigned int>(::getpid()),
+            threadId(),
+            start,
+            start,
+            size,
+            static_cast<Uint64>(d_numRecords)
+        };
+        bsl::string record(d_allocator_p);
+        record.assign(reinterpret_cast<const char *>(&load), sizeof load);
+        record.append(name.data(), name.size());
+        record += '\0';
+        record.append(static_cast<const char *>(address), size);
+        rc |= writeAll(d_jitdumpFd, record.data(), record.size());
+    }
+    ++d_numRecords;
+    return rc;
+}
+
+// ACCESSORS
+int PerfMap::numRecords() const
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    return d_numRecords;
+}
+}
@@ -0,0 +1,167 @@
+// sjtm_perfmap.h
+
+#ifndef INCLUDED_SJTM_PERFMAP
+#define INCLUDED_SJTM_PERFMAP
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_MUTEX
+#include <bslmt_mutex.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm {
+
+                               // =============
+                               // class PerfMap
+                               // =============
+
+class PerfMap {
+    // This class is a mechanism describing the blocks of code generated at
+    // run time to the Linux 'perf' profiler, so that it attributes the
+    // samples taken in them to named symbols rather than to '[unknown]'.
+    //
+    // Two formats may be written.  A perf map, 'perf-<pid>.map', has a line
+    // 'START SIZE name', in hexadecimal, per block; 'perf report' reads it
+    // directly when it is in '/tmp', but it names code only as long as that
+    // code is not replaced.  A jitdump, 'jit-<pid>.dump', records each block
+    // with its timestamp and a copy of its bytes, and is mapped executable
+    // when opened so that 'perf record' notes it; 'perf inject --jit' then
+    // turns it into symbols that stay correct when the addresses of blocks
+    // are reused, and lets 'perf annotate' disassemble them.  Timestamps are
+    // read from 'CLOCK_MONOTONIC', so the recording must use that clock,
+    // i.e., 'perf record -k mono'.
+    //
+    // A format that cannot be opened is not written, and writing is
+    // otherwise best effort: a block that cannot be recorded does not
+    // affect the code.  A perf map may be used concurrently from multiple
+    // threads, e.g., by compiling threads.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+    enum Format {
+        // The formats, which may be combined.
+
+        e_PERF_MAP = 1,
+        e_JITDUMP  = 2
+    };
+
+  private:
+    // DATA
+    bsl::string                  d_perfMapPath;
+    bsl::string                  d_jitdumpPath;
+    int                          d_perfMapFd;      // -1 if not written
+    int                          d_jitdumpFd;      // -1 if not written
+    void                        *d_marker_p;       // mapping of the jitdump,
+                                                   // or 0
+    bsl::size_t                  d_markerSize;
+    int                          d_numRecords;
+    mutable BloombergLP::bslmt::Mutex
+                                 d_mutex;          // guards the writes and
+                                                   // 'd_numRecords'
+    Allocator                   *d_allocator_p;    // held, not owned
+
+    // PRIVATE MANIPULATORS
+    void open(int formats, const StringRef& directory);
+        // Open the files of the specified 'formats' in the specified
+        // 'directory', as described for the constructors.
+
+    // NOT IMPLEMENTED
+    PerfMap(const PerfMap&) = delete;
+    PerfMap& operator=(const PerfMap&) = delete;
+
+  public:
+    // CLASS METHODS
+    static bsl::string symbolName(const StringRef& sourceName,
+                                  int              entryIndex);
+        // Return the name of the symbol for the code of the function entered
+        // at the specified 'entryIndex' of a program read from the specified
+        // 'sourceName', 'sjt::<sourceName>:<entryIndex>', or
+        // 'sjt::<entryIndex>' if 'sourceName' is empty.
+
+    // CREATORS
+    explicit PerfMap(int formats, Allocator *basicAllocator = 0);
+    PerfMap(int               formats,
+            const StringRef&  directory,
+            Allocator        *basicAllocator = 0);
+        // Create a perf map writing the specified 'formats', a combination of
+        // 'Format' values, to files named for the process in the optionally
+        // specified 'directory', or in '/tmp' otherwise, replacing any
+        // files already there.  Optionally specify a 'basicAllocator' used
+        // to supply memory.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.  Note that only the formats
+        // whose files can be opened are written, as reported by 'formats'.
+
+    ~PerfMap();
+        // Record in the jitdump, if it is written, that no more blocks
+        // follow, close the files, leaving them in place for the profiler,
+        // and destroy this object.
+
+    // MANIPULATORS
+    int add(const void *address, bsl::size_t size, const StringRef& name);
+        // Record that the specified 'size' bytes at the specified 'address'
+        // are code of the symbol having the specified 'name', in each format
+        // written, and return 0, or a non-zero value if a format could not
+        // record it.  The behavior is undefined unless the bytes may be
+        // read, and 'name' holds no newline.
+
+    // ACCESSORS
+    int formats() const;
+        // Return the combination of the 'Format' values written.
+
+    const bsl::string& jitdumpPath() const;
+        // Return the path of the jitdump, whether or not it is written.
+
+    int numRecords() const;
+        // Return the number of blocks recorded.
+
+    const bsl::string& perfMapPath() const;
+        // Return the path of the perf map, whether or not it is written.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                               // -------------
+                               // class PerfMap
+                               // -------------
+
+// ACCESSORS
+inline
+int PerfMap::formats() const
+{
+    return (0 <= d_perfMapFd ? e_PERF_MAP : 0)
+         | (0 <= d_jitdumpFd ? e_JITDUMP : 0);
+}
+
+inline
+const bsl::string& PerfMap::jitdumpPath() const
+{
+    return d_jitdumpPath;
+}
+
+inline
+const bsl::string& PerfMap::perfMapPath() const
+{
+    return d_perfMapPath;
+}
+}
+
+#endif
@@ -0,0 +1,302 @@
+// sjtm_perfmap.t.cpp                                             -*-C++-*-
+
+#include <sjtm_perfmap.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+#include <bsl_fstream.h>
+#include <bsl_sstream.h>
+#include <bsl_string.h>
+#include <bsl_vector.h>
+
+#include <bsls_types.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                     GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef bsls::Types::Uint64 Uint64;
+
+struct TemporaryDirectory {
+    // This 'struct' creates a directory for the files of a test, and removes
+    // it, and the files of the process in it, on destruction.
+
+    char d_path[32];
+
+    TemporaryDirectory()
+    {
+        bsl::strcpy(d_path, "/tmp/sjtm_perfmap.XXXXXX");
+        ASSERT(0 != ::mkdtemp(d_path));
+    }
+
+    ~TemporaryDirectory()
+    {
+        char pid[16];
+        bsl::snprintf(pid, sizeof pid, "%d", static_cast<int>(::getpid()));
+        ::unlink((bsl::string(d_path) + "/perf-" + pid + ".map").c_str());
+        ::unlink((bsl::string(d_path) + "/jit-" + pid + ".dump").c_str());
+        ::rmdir(d_path);
+    }
+};
+
+bsl::string readFile(const bsl::string& path)
+    // Return the contents of the file at the specified 'path', or an empty
+    // string if it cannot be read.
+{
+    bsl::ifstream     in(path.c_str(), bsl::ios::binary);
+    bsl::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+unsigned int word(const bsl::string& bytes, bsl::size_t offset)
+    // Return the 32-bit field at the specified 'offset' of the specified
+    // 'bytes'.
+{
+    unsigned int value = 0;
+    bsl::memcpy(&value, bytes.data() + offset, sizeof value);
+    return value;
+}
+
+Uint64 doubleWord(const bsl::string& bytes, bsl::size_t offset)
+    // Return the 64-bit field at the specified 'offset' of the specified
+    // 'bytes'.
+{
+    Uint64 value = 0;
+    bsl::memcpy(&value, bytes.data() + offset, sizeof value);
+    return value;
+}
+}
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "jitdump" << endl
+                          << "=======" << endl;
+
+        // The layout is that of the jitdump specification of the Linux
+        // sources: a 40-byte header, then a code load record per block, and
+        // a code close record.
+
+        const unsigned char CODE[] = { 0x55, 0x48, 0x31, 0xC0, 0x5D, 0xC3 };
+
+        TemporaryDirectory   directory;
+        bslma::TestAllocator ta;
+        bsl::string          path;
+        {
+            PerfMap map(PerfMap::e_JITDUMP, directory.d_path, &ta);
+            ASSERT(PerfMap::e_JITDUMP == map.formats());
+            path = map.jitdumpPath();
+            ASSERT(0 == map.add(CODE, sizeof CODE, "sjt::f:3"));
+            ASSERT(0 == map.add(CODE + 2, 2, "g"));
+            ASSERT(2 == map.numRecords());
+
+            // The perf map is not written.
+
+            ASSERT(0 != ::access(map.perfMapPath().c_str(), F_OK));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        const bsl::string bytes = readFile(path);
+        const bsl::size_t FIRST  = 56 + 9 + sizeof CODE;
+        const bsl::size_t SECOND = 56 + 2 + 2;
+        const bsl::size_t TOTAL  = 40 + FIRST + SECOND + 16;
+        LOOP_ASSERT(bytes.size(), TOTAL == bytes.size());
+        if (TOTAL != bytes.size()) {
+            break;                                                    // BREAK
+        }
+
+        ASSERT(0x4A695444 == word(bytes, 0));
+        ASSERT(1 == word(bytes, 4));
+        ASSERT(40 == word(bytes, 8));
+        ASSERT(static_cast<unsigned int>(::getpid()) == word(bytes, 20));
+        const Uint64 start = doubleWord(bytes, 24);
+
+        bsl::size_t offset = 40;
+        ASSERT(0 == word(bytes, offset));
+        ASSERT(FIRST == word(bytes, offset + 4));
+        ASSERT(start <= doubleWord(bytes, offset + 8));
+        ASSERT(static_cast<unsigned int>(::getpid())
+                                                == word(bytes, offset + 16));
+        ASSERT(reinterpret_cast<bsls::Types::UintPtr>(CODE)
+                                          == doubleWord(bytes, offset + 24));
+        ASSERT(doubleWord(bytes, offset + 24)
+                                          == doubleWord(bytes, offset + 32));
+        ASSERT(sizeof CODE == doubleWord(bytes, offset + 40));
+        ASSERT(0 == doubleWord(bytes, offset + 48));
+        ASSERT(bsl::string("sjt::f:3") == bytes.c_str() + offset + 56);
+        ASSERT(0 == bsl::memcmp(bytes.data() + offset + 65,
+                                CODE,
+                                sizeof CODE));
+
+        offset += FIRST;
+        ASSERT(0 == word(bytes, offset));
+        ASSERT(SECOND == word(bytes, offset + 4));
+        ASSERT(2 == doubleWord(bytes, offset + 40));
+        ASSERT(1 == doubleWord(bytes, offset + 48));
+        ASSERT(bsl::string("g") == bytes.c_str() + offset + 56);
+
+        offset += SECOND;
+        ASSERT(3 == word(bytes, offset));
+        ASSERT(16 == word(bytes, offset + 4));
+        ASSERT(doubleWord(bytes, 48) <= doubleWord(bytes, offset + 8));
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "perf map" << endl
+                          << "========" << endl;
+
+        const char CODE[64] = { 0 };
+
+        TemporaryDirectory   directory;
+        bslma::TestAllocator ta;
+        bsl::string          path;
+        {
+            PerfMap map(PerfMap::e_PERF_MAP, directory.d_path, &ta);
+            ASSERT(PerfMap::e_PERF_MAP == map.formats());
+            path = map.perfMapPath();
+
+            char expected[32];
+            bsl::snprintf(expected,
+                          sizeof expected,
+                          "/perf-%d.map",
+                          static_cast<int>(::getpid()));
+            ASSERT(bsl::string(directory.d_path) + expected == path);
+
+            ASSERT(0 == map.add(CODE, 64, PerfMap::symbolName("a.sjt", 0)));
+            ASSERT(0 == map.add(CODE + 16, 10, PerfMap::symbolName("", 17)));
+            ASSERT(2 == map.numRecords());
+
+            // The jitdump is not written.
+
+            ASSERT(0 != ::access(map.jitdumpPath().c_str(), F_OK));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        char expected[128];
+        bsl::snprintf(expected,
+                      sizeof expected,
+                      "%llx 40 sjt::a.sjt:0\n%llx a sjt::17\n",
+                      static_cast<unsigned long long>(
+                                    reinterpret_cast<bsls::Types::UintPtr>(
+                                                                     CODE)),
+                      static_cast<unsigned long long>(
+                                    reinterpret_cast<bsls::Types::UintPtr>(
+                                                                CODE + 16)));
+        LOOP_ASSERT(readFile(path), expected == readFile(path));
+
+        // A directory that cannot be written to writes nothing.
+
+        PerfMap none(PerfMap::e_PERF_MAP | PerfMap::e_JITDUMP,
+                     "/nonexistent/directory",
+                     &ta);
+        ASSERT(0 == none.formats());
+        ASSERT(0 == none.add(CODE, 64, "f"));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        ASSERT("sjt::main.sjt:12" == PerfMap::symbolName("main.sjt", 12));
+        ASSERT("sjt::0" == PerfMap::symbolName("", 0));
+
+        TemporaryDirectory   directory;
+        bslma::TestAllocator ta;
+        {
+            PerfMap map(0, directory.d_path, &ta);
+            ASSERT(0 == map.formats());
+            ASSERT(0 == map.numRecords());
+        }
+        {
+            PerfMap map(PerfMap::e_PERF_MAP | PerfMap::e_JITDUMP,
+                        directory.d_path,
+                        &ta);
+            ASSERT((PerfMap::e_PERF_MAP | PerfMap::e_JITDUMP)
+                                                             == map.formats());
+            ASSERT(0 == map.add(&directory, 1, "x"));
+            ASSERT(1 == map.numRecords());
+            ASSERT(0 == ::access(map.perfMapPath().c_str(), F_OK));
+            ASSERT(0 == ::access(map.jitdumpPath().c_str(), F_OK));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
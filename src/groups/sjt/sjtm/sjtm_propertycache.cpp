@@ -0,0 +1,5 @@
+// sjtm_propertycache.cpp
+#include <sjtm_propertycache.h>
+
+namespace sjtm {
+}
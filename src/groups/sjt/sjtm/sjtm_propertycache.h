@@ -0,0 +1,142 @@
+// sjtm_propertycache.h
+
+#ifndef INCLUDED_SJTM_PROPERTYCACHE
+#define INCLUDED_SJTM_PROPERTYCACHE
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace sjtm {
+
+class Shape;
+
+                            // ===================
+                            // class PropertyCache
+                            // ===================
+
+class PropertyCache {
+    // This class is an in-core, value-semantic type implementing the inline
+    // cache of a single property access site.  It remembers, for each of up
+    // to 'k_MAX_ENTRIES' shapes seen at the site, the index of the accessed
+    // property and, for a store that adds the property, the shape to which
+    // the object transitions.  A cache with no entries is uninitialized, one
+    // with a single entry is monomorphic, and one with several is
+    // polymorphic.  Once more shapes than it can hold have been seen the
+    // cache is megamorphic: it stops caching, and every access takes the
+    // slow path.
+
+  public:
+    // CONSTANTS
+    enum { k_MAX_ENTRIES = 4 };
+
+  private:
+    // TYPES
+    struct Entry {
+        const Shape *d_shape_p;      // held, not owned
+        Shape       *d_newShape_p;   // held, not owned, or 0
+        int          d_index;        // property index, or -1 if absent
+    };
+
+    // DATA
+    Entry d_entries[k_MAX_ENTRIES];
+    int   d_numEntries;              // -1 if megamorphic
+
+  public:
+    // CREATORS
+    PropertyCache();
+        // Create an uninitialized cache.
+
+    //! PropertyCache(const PropertyCache& original) = default;
+    //! ~PropertyCache() = default;
+
+    // MANIPULATORS
+    //! PropertyCache& operator=(const PropertyCache& rhs) = default;
+
+    void insert(const Shape *shape, int index, Shape *newShape = 0);
+        // Remember that the property accessed at this site has the specified
+        // 'index' in objects of the specified 'shape', where -1 means that
+        // they do not have it.  Optionally specify the 'newShape' to which a
+        // store transitions such objects by adding the property.  If this
+        // cache is full it becomes megamorphic.  The behavior is undefined if
+        // 'find' would succeed for 'shape'.
+
+    // ACCESSORS
+    bool find(int *index, Shape **newShape, const Shape *shape) const;
+        // Load into the specified 'index' and 'newShape' the values inserted
+        // for the specified 'shape', and return 'true', if there are any;
+        // otherwise return 'false'.
+
+    bool isMegamorphic() const;
+        // Return 'true' if this cache has stopped caching, and 'false'
+        // otherwise.
+
+    int numEntries() const;
+        // Return the number of shapes remembered by this cache.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // -------------------
+                            // class PropertyCache
+                            // -------------------
+
+// CREATORS
+inline
+PropertyCache::PropertyCache()
+: d_entries()
+, d_numEntries(0)
+{
+}
+
+// MANIPULATORS
+inline
+void PropertyCache::insert(const Shape *shape, int index, Shape *newShape)
+{
+    BSLS_ASSERT(0 != shape);
+    BSLS_ASSERT(-1 <= index);
+
+    if (k_MAX_ENTRIES == d_numEntries) {
+        d_numEntries = -1;
+    }
+    if (0 > d_numEntries) {
+        return;                                                       // RETURN
+    }
+    Entry& entry = d_entries[d_numEntries++];
+    entry.d_shape_p    = shape;
+    entry.d_newShape_p = newShape;
+    entry.d_index      = index;
+}
+
+// ACCESSORS
+inline
+bool PropertyCache::find(int         *index,
+                         Shape      **newShape,
+                         const Shape *shape) const
+{
+    for (int i = 0; i < d_numEntries; ++i) {
+        if (shape == d_entries[i].d_shape_p) {
+            *index    = d_entries[i].d_index;
+            *newShape = d_entries[i].d_newShape_p;
+            return true;                                              // RETURN
+        }
+    }
+    return false;
+}
+
+inline
+bool PropertyCache::isMegamorphic() const
+{
+    return 0 > d_numEntries;
+}
+
+inline
+int PropertyCache::numEntries() const
+{
+    return 0 > d_numEntries ? 0 : d_numEntries;
+}
+}
+
+#endif
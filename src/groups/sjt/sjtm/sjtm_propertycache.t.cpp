@@ -0,0 +1,151 @@
+// sjtm_propertycache.t.cpp                                       -*-C++-*-
+
+#include <sjtm_propertycache.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <sjtm_shape.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "polymorphic and megamorphic" << endl
+                          << "===========================" << endl;
+
+        bslma::TestAllocator ta;
+        Shape root(&ta);
+        const char *NAMES[] = { "a", "b", "c", "d", "e" };
+        Shape *shapes[5];
+        for (int i = 0; i < 5; ++i) {
+            shapes[i] = root.addProperty(NAMES[i])->addProperty("x");
+        }
+
+        PropertyCache cache;
+        for (int i = 0; i < PropertyCache::k_MAX_ENTRIES; ++i) {
+            cache.insert(shapes[i], 1);
+            LOOP_ASSERT(i, i + 1 == cache.numEntries());
+        }
+        ASSERT(!cache.isMegamorphic());
+        for (int i = 0; i < PropertyCache::k_MAX_ENTRIES; ++i) {
+            int    index    = -1;
+            Shape *newShape = &root;
+            LOOP_ASSERT(i, cache.find(&index, &newShape, shapes[i]));
+            LOOP_ASSERT(i, 1 == index);
+            LOOP_ASSERT(i, 0 == newShape);
+        }
+
+        // One shape too many makes the cache stop caching.
+
+        cache.insert(shapes[4], 1);
+        ASSERT(cache.isMegamorphic());
+        ASSERT(0 == cache.numEntries());
+        int    index;
+        Shape *newShape;
+        ASSERT(!cache.find(&index, &newShape, shapes[0]));
+        cache.insert(shapes[0], 1);
+        ASSERT(!cache.find(&index, &newShape, shapes[0]));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        Shape root(&ta);
+        Shape *x = root.addProperty("x");
+
+        PropertyCache cache;
+        ASSERT(0 == cache.numEntries());
+        ASSERT(!cache.isMegamorphic());
+
+        int    index    = 0;
+        Shape *newShape = 0;
+        ASSERT(!cache.find(&index, &newShape, &root));
+
+        // A store that adds a property remembers the transition.
+
+        cache.insert(&root, 0, x);
+        ASSERT(1 == cache.numEntries());
+        ASSERT(cache.find(&index, &newShape, &root));
+        ASSERT(0 == index);
+        ASSERT(x == newShape);
+
+        // A load of an absent property remembers its absence.
+
+        cache.insert(x, -1);
+        ASSERT(cache.find(&index, &newShape, x));
+        ASSERT(-1 == index);
+        ASSERT(0 == newShape);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,72 @@
+// sjtm_shape.cpp
+#include <sjtm_shape.h>
+
+#include <bslma_allocator.h>
+#include <bslma_default.h>
+#include <bsls_assert.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+
+                                // -----------
+                                // class Shape
+                                // -----------
+
+// PRIVATE CREATORS
+Shape::Shape(const Shape      *parent,
+             const StringRef&  name,
+             Allocator        *basicAllocator)
+: d_parent_p(parent)
+, d_name(name, basicAllocator)
+, d_numProperties(parent->d_numProperties + 1)
+, d_transitions(basicAllocator)
+, d_allocator_p(basicAllocator)
+{
+}
+
+// CREATORS
+Shape::Shape(Allocator *basicAllocator)
+: d_parent_p(0)
+, d_name(basicAllocator)
+, d_numProperties(0)
+, d_transitions(basicAllocator)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+}
+
+Shape::~Shape()
+{
+    for (bsl::size_t i = 0; i < d_transitions.size(); ++i) {
+        d_allocator_p->deleteObject(d_transitions[i]);
+    }
+}
+
+// MANIPULATORS
+Shape *Shape::addProperty(const StringRef& name)
+{
+    BSLS_ASSERT(0 > find(name));
+
+    for (bsl::size_t i = 0; i < d_transitions.size(); ++i) {
+        if (name == d_transitions[i]->d_name) {
+            return d_transitions[i];                                  // RETURN
+        }
+    }
+    d_transitions.push_back(0);
+    Shape *child = new (*d_allocator_p) Shape(this, name, d_allocator_p);
+    d_transitions.back() = child;
+    return child;
+}
+
+// ACCESSORS
+int Shape::find(const StringRef& name) const
+{
+    for (const Shape *shape = this; 0 != shape->d_parent_p;
+                                                 shape = shape->d_parent_p) {
+        if (name == shape->d_name) {
+            return shape->d_numProperties - 1;                        // RETURN
+        }
+    }
+    return -1;
+}
+}
@@ -0,0 +1,137 @@
+// sjtm_shape.h
+
+#ifndef INCLUDED_SJTM_SHAPE
+#define INCLUDED_SJTM_SHAPE
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm {
+
+                                // ===========
+                                // class Shape
+                                // ===========
+
+class Shape {
+    // This class is a mechanism describing the layout of the properties of an
+    // object, often called a hidden class.  A shape maps each of the names of
+    // 'numProperties()' properties to a distinct index in
+    // '[0, numProperties())', in the order in which the properties were
+    // added.  Shapes form a tree rooted at an empty shape: the child of a
+    // shape reached by 'addProperty' has one more property, so objects to
+    // which the same properties are added in the same order share a shape.
+    // A shape owns its children, and shapes are never modified once created,
+    // except to add children; a reference to a shape can therefore be used as
+    // the key of a cache of property indices.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+  private:
+    // DATA
+    const Shape           *d_parent_p;       // held, not owned, or 0
+    bsl::string            d_name;           // name of the last property
+    int                    d_numProperties;
+    bsl::vector<Shape *>   d_transitions;    // children, owned
+    Allocator             *d_allocator_p;    // held, not owned
+
+    // PRIVATE CREATORS
+    Shape(const Shape      *parent,
+          const StringRef&  name,
+          Allocator        *basicAllocator);
+        // Create a shape having the properties of the specified 'parent'
+        // followed by one having the specified 'name', using the specified
+        // 'basicAllocator' to supply memory.
+
+    // NOT IMPLEMENTED
+    Shape(const Shape&) = delete;
+    Shape& operator=(const Shape&) = delete;
+
+  public:
+    // CREATORS
+    explicit Shape(Allocator *basicAllocator = 0);
+        // Create an empty shape.  Optionally specify a 'basicAllocator' used
+        // to supply memory for this shape and its descendants.  If
+        // 'basicAllocator' is 0, the currently installed default allocator is
+        // used.
+
+    ~Shape();
+        // Destroy this shape and its descendants.
+
+    // MANIPULATORS
+    Shape *addProperty(const StringRef& name);
+        // Return the shape having the properties of this shape followed by
+        // one having the specified 'name', creating it if necessary.  The
+        // behavior is undefined if this shape has a property named 'name'.
+
+    // ACCESSORS
+    int find(const StringRef& name) const;
+        // Return the index of the property having the specified 'name', or
+        // -1 if this shape has no such property.  Note that this method takes
+        // time proportional to 'numProperties()'.
+
+    const bsl::string& lastName() const;
+        // Return the name of the property most recently added to this shape.
+        // The behavior is undefined unless '0 < numProperties()'.
+
+    int numProperties() const;
+        // Return the number of properties of this shape.
+
+    int numTransitions() const;
+        // Return the number of shapes created by 'addProperty' on this shape.
+
+    const Shape *parent() const;
+        // Return the shape having all but the last property of this shape, or
+        // 0 if this shape is empty.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                                // -----------
+                                // class Shape
+                                // -----------
+
+// ACCESSORS
+inline
+const bsl::string& Shape::lastName() const
+{
+    return d_name;
+}
+
+inline
+int Shape::numProperties() const
+{
+    return d_numProperties;
+}
+
+inline
+int Shape::numTransitions() const
+{
+    return static_cast<int>(d_transitions.size());
+}
+
+inline
+const Shape *Shape::parent() const
+{
+    return d_parent_p;
+}
+}
+
+#endif
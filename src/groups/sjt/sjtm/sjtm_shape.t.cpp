@@ -0,0 +1,129 @@
+// sjtm_shape.t.cpp                                               -*-C++-*-
+
+#include <sjtm_shape.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "transitions" << endl
+                          << "===========" << endl;
+
+        bslma::TestAllocator ta;
+        {
+            Shape root(&ta);
+            Shape *x  = root.addProperty("x");
+            Shape *xy = x->addProperty("y");
+            Shape *y  = root.addProperty("y");
+            Shape *yx = y->addProperty("x");
+
+            // Adding the same property again follows the same transition.
+
+            ASSERT(x == root.addProperty("x"));
+            ASSERT(xy == x->addProperty("y"));
+            ASSERT(2 == root.numTransitions());
+            ASSERT(1 == x->numTransitions());
+
+            // The order in which properties are added determines the shape.
+
+            ASSERT(xy != yx);
+            ASSERT(0 == xy->find("x"));
+            ASSERT(1 == xy->find("y"));
+            ASSERT(1 == yx->find("x"));
+            ASSERT(0 == yx->find("y"));
+            ASSERT(-1 == xy->find("z"));
+            ASSERT(-1 == root.find("x"));
+            ASSERT(0 < ta.numBlocksInUse());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        Shape root(&ta);
+        ASSERT(0 == root.numProperties());
+        ASSERT(0 == root.parent());
+        ASSERT(0 == root.numTransitions());
+
+        Shape *child = root.addProperty("name");
+        ASSERT(1 == child->numProperties());
+        ASSERT(&root == child->parent());
+        ASSERT("name" == child->lastName());
+        ASSERT(0 == child->find("name"));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,224 @@
+// sjtm_typedarray.cpp
+#include <sjtm_typedarray.h>
+
+#include <bslmf_assert.h>
+#include <bsls_assert.h>
+
+#include <bsl_limits.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_heap.h>
+#include <sjtm_object.h>
+#include <sjtm_vectorutil.h>
+
+using namespace BloombergLP;
+
+namespace sjtm {
+namespace {
+
+struct Header {
+    // This 'struct' describes the beginning of the raw data of a typed
+    // array, which is followed by its elements.
+
+    int d_type;     // 'TypedArrayUtil::ElementType'
+    int d_length;   // number of elements
+};
+
+// The elements follow the header, so the header must preserve the alignment
+// of doubles.
+
+BSLMF_ASSERT(0 == sizeof(Header) % sizeof(double));
+
+const Header *header(const Object *array)
+    // Return the header of the specified typed 'array'.
+{
+    BSLS_ASSERT(array->isRaw());
+
+    return static_cast<const Header *>(array->rawData());
+}
+
+bdld::Datum boxInt64(VectorUtil::Int64 value)
+    // Return the specified 'value' as an integer if it fits in one, and as a
+    // double otherwise.
+{
+    if (bsl::numeric_limits<int>::min() <= value &&
+        value <= bsl::numeric_limits<int>::max()) {
+        return bdld::Datum::createInteger(static_cast<int>(value));   // RETURN
+    }
+    return bdld::Datum::createDouble(static_cast<double>(value));
+}
+}
+
+                            // ---------------------
+                            // struct TypedArrayUtil
+                            // ---------------------
+
+// CLASS METHODS
+Object *TypedArrayUtil::create(Heap *heap, ElementType type, int length)
+{
+    BSLS_ASSERT(0 != heap);
+    BSLS_ASSERT(0 <= length);
+
+    const int elementSize = e_Int32 == type ? sizeof(int) : sizeof(double);
+    Object *array = heap->allocateRaw(sizeof(Header) + length * elementSize);
+    Header *h     = static_cast<Header *>(array->rawData());
+    h->d_type     = type;
+    h->d_length   = length;
+    return array;
+}
+
+bool TypedArrayUtil::isTypedArray(const Datum& value)
+{
+    return sjtd::DatumUdtUtil::isObject(value) &&
+           sjtd::DatumUdtUtil::getObject(value)->isRaw();
+}
+
+TypedArrayUtil::ElementType TypedArrayUtil::elementType(const Object *array)
+{
+    return static_cast<ElementType>(header(array)->d_type);
+}
+
+int TypedArrayUtil::length(const Object *array)
+{
+    return header(array)->d_length;
+}
+
+int *TypedArrayUtil::int32Data(Object *array)
+{
+    return const_cast<int *>(int32Data(const_cast<const Object *>(array)));
+}
+
+const int *TypedArrayUtil::int32Data(const Object *array)
+{
+    BSLS_ASSERT(e_Int32 == elementType(array));
+
+    return reinterpret_cast<const int *>(header(array) + 1);
+}
+
+double *TypedArrayUtil::float64Data(Object *array)
+{
+    return const_cast<double *>(
+                             float64Data(const_cast<const Object *>(array)));
+}
+
+const double *TypedArrayUtil::float64Data(const Object *array)
+{
+    BSLS_ASSERT(e_Float64 == elementType(array));
+
+    return reinterpret_cast<const double *>(header(array) + 1);
+}
+
+bdld::Datum TypedArrayUtil::element(const Object *array, int index)
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < length(array));
+
+    return e_Int32 == elementType(array)
+           ? Datum::createInteger(int32Data(array)[index])
+           : Datum::createDouble(float64Data(array)[index]);
+}
+
+void TypedArrayUtil::setElement(Object       *array,
+                                int           index,
+                                const Datum&  value)
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < length(array));
+    BSLS_ASSERT(value.isInteger() || value.isDouble());
+
+    if (e_Int32 == elementType(array)) {
+        int32Data(array)[index] = value.isInteger()
+                                ? value.theInteger()
+                                : static_cast<int>(value.theDouble());
+    }
+    else {
+        float64Data(array)[index] = value.isInteger()
+                                  ? value.theInteger()
+                                  : value.theDouble();
+    }
+}
+
+void TypedArrayUtil::add(Object *result, const Object *values)
+{
+    BSLS_ASSERT(elementType(result) == elementType(values));
+    BSLS_ASSERT(length(result) == length(values));
+
+    if (e_Int32 == elementType(result)) {
+        VectorUtil::addInt32(int32Data(result),
+                             int32Data(values),
+                             length(result));
+    }
+    else {
+        VectorUtil::addFloat64(float64Data(result),
+                               float64Data(values),
+                               length(result));
+    }
+}
+
+bdld::Datum TypedArrayUtil::dot(const Object *lhs, const Object *rhs)
+{
+    BSLS_ASSERT(elementType(lhs) == elementType(rhs));
+    BSLS_ASSERT(length(lhs) == length(rhs));
+
+    if (e_Int32 == elementType(lhs)) {
+        return boxInt64(VectorUtil::dotInt32(int32Data(lhs),
+                                             int32Data(rhs),
+                                             length(lhs)));           // RETURN
+    }
+    return Datum::createDouble(VectorUtil::dotFloat64(float64Data(lhs),
+                                                      float64Data(rhs),
+                                                      length(lhs)));
+}
+
+bdld::Datum TypedArrayUtil::max(const Object *array)
+{
+    if (0 == length(array)) {
+        return sjtd::DatumUdtUtil::s_Undefined;                       // RETURN
+    }
+    return e_Int32 == elementType(array)
+           ? Datum::createInteger(VectorUtil::maxInt32(int32Data(array),
+                                                       length(array)))
+           : Datum::createDouble(VectorUtil::maxFloat64(float64Data(array),
+                                                        length(array)));
+}
+
+bdld::Datum TypedArrayUtil::min(const Object *array)
+{
+    if (0 == length(array)) {
+        return sjtd::DatumUdtUtil::s_Undefined;                       // RETURN
+    }
+    return e_Int32 == elementType(array)
+           ? Datum::createInteger(VectorUtil::minInt32(int32Data(array),
+                                                       length(array)))
+           : Datum::createDouble(VectorUtil::minFloat64(float64Data(array),
+                                                        length(array)));
+}
+
+void TypedArrayUtil::scale(Object *array, const Datum& factor)
+{
+    BSLS_ASSERT(factor.isInteger() ||
+                (factor.isDouble() && e_Float64 == elementType(array)));
+
+    if (e_Int32 == elementType(array)) {
+        VectorUtil::scaleInt32(int32Data(array),
+                               length(array),
+                               factor.theInteger());
+    }
+    else {
+        VectorUtil::scaleFloat64(float64Data(array),
+                                 length(array),
+                                 factor.isInteger() ? factor.theInteger()
+                                                    : factor.theDouble());
+    }
+}
+
+bdld::Datum TypedArrayUtil::sum(const Object *array)
+{
+    if (e_Int32 == elementType(array)) {
+        return boxInt64(VectorUtil::sumInt32(int32Data(array),
+                                             length(array)));         // RETURN
+    }
+    return Datum::createDouble(VectorUtil::sumFloat64(float64Data(array),
+                                                      length(array)));
+}
+}
@@ -0,0 +1,109 @@
+// sjtm_typedarray.h
+
+#ifndef INCLUDED_SJTM_TYPEDARRAY
+#define INCLUDED_SJTM_TYPEDARRAY
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+namespace sjtm {
+
+class Heap;
+class Object;
+
+                            // =====================
+                            // struct TypedArrayUtil
+                            // =====================
+
+struct TypedArrayUtil {
+    // This 'struct' provides a namespace for functions that create and
+    // operate on typed arrays: raw heap objects holding a contiguous, unboxed
+    // array of 32-bit integers or of doubles.  Elements are boxed as
+    // 'Datum' values only when they are read individually; the bulk
+    // operations work on the unboxed elements with 'VectorUtil'.  The
+    // elements of a new typed array are 0.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+
+    enum ElementType {
+        // Enumeration of the types of the elements of typed arrays.
+
+        e_Int32,
+        e_Float64
+    };
+
+    // CLASS METHODS
+    static Object *create(Heap *heap, ElementType type, int length);
+        // Return a new typed array allocated from the specified 'heap',
+        // having the specified 'length' elements of the specified 'type'.
+        // This method may collect garbage, as 'Heap::allocate' does.  The
+        // behavior is undefined unless '0 <= length'.
+
+    static bool isTypedArray(const Datum& value);
+        // Return 'true' if the specified 'value' refers to a typed array and
+        // 'false' otherwise.
+
+    static ElementType elementType(const Object *array);
+        // Return the type of the elements of the specified typed 'array'.
+
+    static int length(const Object *array);
+        // Return the number of elements of the specified typed 'array'.
+
+    static int *int32Data(Object *array);
+    static const int *int32Data(const Object *array);
+        // Return the address of the first element of the specified typed
+        // 'array'.  The behavior is undefined unless
+        // 'e_Int32 == elementType(array)'.
+
+    static double *float64Data(Object *array);
+    static const double *float64Data(const Object *array);
+        // Return the address of the first element of the specified typed
+        // 'array'.  The behavior is undefined unless
+        // 'e_Float64 == elementType(array)'.
+
+    static Datum element(const Object *array, int index);
+        // Return the element at the specified 'index' of the specified typed
+        // 'array', as an integer or a double according to its element type.
+        // The behavior is undefined unless '0 <= index < length(array)'.
+
+    static void setElement(Object *array, int index, const Datum& value);
+        // Set the element at the specified 'index' of the specified typed
+        // 'array' to the specified 'value'.  A double stored in an array of
+        // integers is truncated toward zero.  The behavior is undefined
+        // unless '0 <= index < length(array)', and 'value' is an integer or a
+        // double within the range of the element type.
+
+    static void add(Object *result, const Object *values);
+        // Add to each element of the specified typed array 'result' the
+        // corresponding element of the specified typed array 'values'.  The
+        // behavior is undefined unless the arrays have the same element type
+        // and length.
+
+    static Datum dot(const Object *lhs, const Object *rhs);
+        // Return the sum of the products of the corresponding elements of the
+        // specified typed arrays 'lhs' and 'rhs', as described for 'sum'.
+        // The behavior is undefined unless the arrays have the same element
+        // type and length.
+
+    static Datum max(const Object *array);
+    static Datum min(const Object *array);
+        // Return the largest, or respectively smallest, element of the
+        // specified typed 'array', or 'DatumUdtUtil::s_Undefined' if 'array'
+        // is empty.
+
+    static void scale(Object *array, const Datum& factor);
+        // Multiply each element of the specified typed 'array' by the
+        // specified 'factor'.  The behavior is undefined unless 'factor' is
+        // an integer, or is a double and 'array' holds doubles.
+
+    static Datum sum(const Object *array);
+        // Return the sum of the elements of the specified typed 'array'.  The
+        // sum of an array of integers is computed exactly and returned as an
+        // integer if it fits in one, and as a double otherwise; the sum of an
+        // array of doubles is a double.
+};
+}
+
+#endif
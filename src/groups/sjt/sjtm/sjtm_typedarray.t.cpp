@@ -0,0 +1,193 @@
+// sjtm_typedarray.t.cpp                                          -*-C++-*-
+
+#include <sjtm_typedarray.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_heap.h>
+#include <sjtm_object.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    typedef bdld::Datum        Datum;
+    typedef sjtd::DatumUdtUtil DUU;
+    typedef TypedArrayUtil     Obj;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "collection" << endl
+                          << "==========" << endl;
+
+        // Typed arrays survive scavenges and promotion with their elements.
+
+        bslma::TestAllocator ta;
+        Heap heap(4096, &ta);
+        Heap::Roots roots(&ta);
+        HeapRootGuard guard(&heap, &roots);
+
+        Object *a = Obj::create(&heap, Obj::e_Float64, 100);
+        for (int i = 0; i < 100; ++i) {
+            Obj::setElement(a, i, Datum::createDouble(i * 0.5));
+        }
+        roots.push_back(DUU::datumFromObject(a));
+        for (int i = 0; i < 50; ++i) {
+            heap.allocate(4);
+        }
+        heap.collectGarbage();
+
+        a = DUU::getObject(roots[0]);
+        ASSERT(Obj::isTypedArray(roots[0]));
+        ASSERT(Obj::e_Float64 == Obj::elementType(a));
+        ASSERT(100 == Obj::length(a));
+        ASSERT(Datum::createDouble(2475) == Obj::sum(a));
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "bulk operations" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+
+        Object *i = Obj::create(&heap, Obj::e_Int32, 5);
+        Object *j = Obj::create(&heap, Obj::e_Int32, 5);
+        Object *d = Obj::create(&heap, Obj::e_Float64, 5);
+        for (int k = 0; k < 5; ++k) {
+            Obj::setElement(i, k, Datum::createInteger(k - 2));
+            Obj::setElement(j, k, Datum::createInteger(k));
+            Obj::setElement(d, k, Datum::createDouble(k + 0.5));
+        }
+
+        ASSERT(Datum::createInteger(0) == Obj::sum(i));
+        ASSERT(Datum::createDouble(12.5) == Obj::sum(d));
+        ASSERT(Datum::createInteger(10) == Obj::dot(i, j));
+        ASSERT(Datum::createDouble(41.25) == Obj::dot(d, d));
+        ASSERT(Datum::createInteger(-2) == Obj::min(i));
+        ASSERT(Datum::createInteger(2) == Obj::max(i));
+        ASSERT(Datum::createDouble(0.5) == Obj::min(d));
+        ASSERT(Datum::createDouble(4.5) == Obj::max(d));
+
+        Obj::add(i, j);
+        ASSERT(Datum::createInteger(6) == Obj::element(i, 4));
+        Obj::scale(i, Datum::createInteger(-3));
+        ASSERT(Datum::createInteger(-18) == Obj::element(i, 4));
+        Obj::scale(d, Datum::createDouble(2));
+        ASSERT(Datum::createDouble(9) == Obj::element(d, 4));
+        Obj::add(d, d);
+        ASSERT(Datum::createDouble(18) == Obj::element(d, 4));
+
+        // The sum of integers is exact, and is a double if it is too large
+        // for an integer.
+
+        Object *big = Obj::create(&heap, Obj::e_Int32, 3);
+        for (int k = 0; k < 3; ++k) {
+            Obj::setElement(big, k, Datum::createInteger(0x40000000));
+        }
+        ASSERT(Datum::createDouble(3.0 * 0x40000000) == Obj::sum(big));
+
+        // The minimum and maximum of an empty array are undefined.
+
+        Object *empty = Obj::create(&heap, Obj::e_Float64, 0);
+        ASSERT(DUU::s_Undefined == Obj::min(empty));
+        ASSERT(DUU::s_Undefined == Obj::max(empty));
+        ASSERT(Datum::createDouble(0) == Obj::sum(empty));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        Heap heap(&ta);
+
+        Object *a = Obj::create(&heap, Obj::e_Int32, 3);
+        ASSERT(Obj::isTypedArray(DUU::datumFromObject(a)));
+        ASSERT(!Obj::isTypedArray(DUU::datumFromObject(heap.allocate(1))));
+        ASSERT(!Obj::isTypedArray(Datum::createInteger(1)));
+        ASSERT(Obj::e_Int32 == Obj::elementType(a));
+        ASSERT(3 == Obj::length(a));
+        ASSERT(Datum::createInteger(0) == Obj::element(a, 2));
+
+        Obj::setElement(a, 1, Datum::createInteger(7));
+        Obj::setElement(a, 2, Datum::createDouble(-2.5));
+        ASSERT(7 == Obj::int32Data(a)[1]);
+        ASSERT(Datum::createInteger(-2) == Obj::element(a, 2));
+
+        Object *b = Obj::create(&heap, Obj::e_Float64, 2);
+        Obj::setElement(b, 0, Datum::createInteger(3));
+        ASSERT(Obj::e_Float64 == Obj::elementType(b));
+        ASSERT(3 == Obj::float64Data(b)[0]);
+        ASSERT(Datum::createDouble(3) == Obj::element(b, 0));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,799 @@
+// sjtm_vectorutil.cpp
+#include <sjtm_vectorutil.h>
+
+#include <bsls_assert.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SJTM_VECTORUTIL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sjtm {
+namespace {
+
+typedef VectorUtil::Int64 Int64;
+
+struct Kernels {
+    // This 'struct' holds the addresses of one implementation of each of the
+    // operations of 'VectorUtil'.
+
+    void   (*d_addFloat64)(double *, const double *, int);
+    void   (*d_addInt32)(int *, const int *, int);
+    double (*d_dotFloat64)(const double *, const double *, int);
+    Int64  (*d_dotInt32)(const int *, const int *, int);
+    double (*d_maxFloat64)(const double *, int);
+    int    (*d_maxInt32)(const int *, int);
+    double (*d_minFloat64)(const double *, int);
+    int    (*d_minInt32)(const int *, int);
+    void   (*d_scaleFloat64)(double *, int, double);
+    void   (*d_scaleInt32)(int *, int, int);
+    double (*d_sumFloat64)(const double *, int);
+    Int64  (*d_sumInt32)(const int *, int);
+};
+
+                                 // ------
+                                 // scalar
+                                 // ------
+
+namespace scalar {
+
+int wrap(Int64 value)
+    // Return the specified 'value' modulo 2^32, as a signed integer.
+{
+    return static_cast<int>(static_cast<unsigned int>(value));
+}
+
+void addFloat64(double *result, const double *values, int length)
+{
+    for (int i = 0; i < length; ++i) {
+        result[i] += values[i];
+    }
+}
+
+void addInt32(int *result, const int *values, int length)
+{
+    for (int i = 0; i < length; ++i) {
+        result[i] = wrap(static_cast<Int64>(result[i]) + values[i]);
+    }
+}
+
+double dotFloat64(const double *lhs, const double *rhs, int length)
+{
+    double sum = 0;
+    for (int i = 0; i < length; ++i) {
+        sum += lhs[i] * rhs[i];
+    }
+    return sum;
+}
+
+Int64 dotInt32(const int *lhs, const int *rhs, int length)
+{
+    Int64 sum = 0;
+    for (int i = 0; i < length; ++i) {
+        sum += static_cast<Int64>(lhs[i]) * rhs[i];
+    }
+    return sum;
+}
+
+double maxFloat64(const double *values, int length)
+{
+    double result = values[0];
+    for (int i = 1; i < length; ++i) {
+        result = result < values[i] ? values[i] : result;
+    }
+    return result;
+}
+
+int maxInt32(const int *values, int length)
+{
+    int result = values[0];
+    for (int i = 1; i < length; ++i) {
+        result = result < values[i] ? values[i] : result;
+    }
+    return result;
+}
+
+double minFloat64(const double *values, int length)
+{
+    double result = values[0];
+    for (int i = 1; i < length; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+int minInt32(const int *values, int length)
+{
+    int result = values[0];
+    for (int i = 1; i < length; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+void scaleFloat64(double *values, int length, double factor)
+{
+    for (int i = 0; i < length; ++i) {
+        values[i] *= factor;
+    }
+}
+
+void scaleInt32(int *values, int length, int factor)
+{
+    for (int i = 0; i < length; ++i) {
+        values[i] = static_cast<int>(static_cast<unsigned int>(values[i]) *
+                                     static_cast<unsigned int>(factor));
+    }
+}
+
+double sumFloat64(const double *values, int length)
+{
+    double sum = 0;
+    for (int i = 0; i < length; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+Int64 sumInt32(const int *values, int length)
+{
+    Int64 sum = 0;
+    for (int i = 0; i < length; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+const Kernels s_Kernels = {
+    addFloat64,
+    addInt32,
+    dotFloat64,
+    dotInt32,
+    maxFloat64,
+    maxInt32,
+    minFloat64,
+    minInt32,
+    scaleFloat64,
+    scaleInt32,
+    sumFloat64,
+    sumInt32,
+};
+}
+
+#ifdef SJTM_VECTORUTIL_X86
+
+                                  // ----
+                                  // sse2
+                                  // ----
+
+// The SSE2 kernels process two doubles or four integers per instruction.
+// SSE2 has no signed 32-bit multiplication, so the integer dot product and
+// scaling use the scalar kernels.
+
+namespace sse2 {
+
+#define SJTM_SSE2 __attribute__((target("sse2")))
+
+SJTM_SSE2
+double reduce(__m128d value)
+    // Return the sum of the two lanes of the specified 'value'.
+{
+    double lanes[2];
+    _mm_storeu_pd(lanes, value);
+    return lanes[0] + lanes[1];
+}
+
+SJTM_SSE2
+void addFloat64(double *result, const double *values, int length)
+{
+    int i = 0;
+    for (; i + 2 <= length; i += 2) {
+        _mm_storeu_pd(result + i, _mm_add_pd(_mm_loadu_pd(result + i),
+                                             _mm_loadu_pd(values + i)));
+    }
+    scalar::addFloat64(result + i, values + i, length - i);
+}
+
+SJTM_SSE2
+void addInt32(int *result, const int *values, int length)
+{
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128i *r = reinterpret_cast<__m128i *>(result + i);
+        const __m128i *v = reinterpret_cast<const __m128i *>(values + i);
+        _mm_storeu_si128(r, _mm_add_epi32(_mm_loadu_si128(r),
+                                          _mm_loadu_si128(v)));
+    }
+    scalar::addInt32(result + i, values + i, length - i);
+}
+
+SJTM_SSE2
+double dotFloat64(const double *lhs, const double *rhs, int length)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(lhs + i),
+                                           _mm_loadu_pd(rhs + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(lhs + i + 2),
+                                           _mm_loadu_pd(rhs + i + 2)));
+    }
+    return reduce(_mm_add_pd(acc0, acc1)) +
+           scalar::dotFloat64(lhs + i, rhs + i, length - i);
+}
+
+SJTM_SSE2
+double maxFloat64(const double *values, int length)
+{
+    if (length < 2) {
+        return values[0];                                             // RETURN
+    }
+    __m128d acc = _mm_loadu_pd(values);
+    int i = 2;
+    for (; i + 2 <= length; i += 2) {
+        acc = _mm_max_pd(acc, _mm_loadu_pd(values + i));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double result = lanes[0] < lanes[1] ? lanes[1] : lanes[0];
+    for (; i < length; ++i) {
+        result = result < values[i] ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_SSE2
+double minFloat64(const double *values, int length)
+{
+    if (length < 2) {
+        return values[0];                                             // RETURN
+    }
+    __m128d acc = _mm_loadu_pd(values);
+    int i = 2;
+    for (; i + 2 <= length; i += 2) {
+        acc = _mm_min_pd(acc, _mm_loadu_pd(values + i));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double result = lanes[1] < lanes[0] ? lanes[1] : lanes[0];
+    for (; i < length; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_SSE2
+__m128i select(__m128i mask, __m128i ifSet, __m128i ifClear)
+    // Return the bits of the specified 'ifSet' where the specified 'mask' is
+    // set, and those of the specified 'ifClear' elsewhere.
+{
+    return _mm_or_si128(_mm_and_si128(mask, ifSet),
+                        _mm_andnot_si128(mask, ifClear));
+}
+
+SJTM_SSE2
+int maxInt32(const int *values, int length)
+{
+    if (length < 4) {
+        return scalar::maxInt32(values, length);                      // RETURN
+    }
+    __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    int i = 4;
+    for (; i + 4 <= length; i += 4) {
+        const __m128i v =
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        acc = select(_mm_cmpgt_epi32(v, acc), v, acc);
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    int result = scalar::maxInt32(lanes, 4);
+    for (; i < length; ++i) {
+        result = result < values[i] ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_SSE2
+int minInt32(const int *values, int length)
+{
+    if (length < 4) {
+        return scalar::minInt32(values, length);                      // RETURN
+    }
+    __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    int i = 4;
+    for (; i + 4 <= length; i += 4) {
+        const __m128i v =
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        acc = select(_mm_cmplt_epi32(v, acc), v, acc);
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    int result = scalar::minInt32(lanes, 4);
+    for (; i < length; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_SSE2
+void scaleFloat64(double *values, int length, double factor)
+{
+    const __m128d f = _mm_set1_pd(factor);
+    int i = 0;
+    for (; i + 2 <= length; i += 2) {
+        _mm_storeu_pd(values + i, _mm_mul_pd(_mm_loadu_pd(values + i), f));
+    }
+    scalar::scaleFloat64(values + i, length - i, factor);
+}
+
+SJTM_SSE2
+double sumFloat64(const double *values, int length)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(values + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(values + i + 2));
+    }
+    return reduce(_mm_add_pd(acc0, acc1)) +
+           scalar::sumFloat64(values + i, length - i);
+}
+
+SJTM_SSE2
+Int64 sumInt32(const int *values, int length)
+{
+    // Sign-extend each group of four integers into two pairs of 64-bit
+    // lanes.
+
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        const __m128i v =
+               _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        const __m128i sign = _mm_srai_epi32(v, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+    }
+    Int64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    return lanes[0] + lanes[1] + scalar::sumInt32(values + i, length - i);
+}
+
+#undef SJTM_SSE2
+
+const Kernels s_Kernels = {
+    addFloat64,
+    addInt32,
+    dotFloat64,
+    scalar::dotInt32,
+    maxFloat64,
+    maxInt32,
+    minFloat64,
+    minInt32,
+    scaleFloat64,
+    scalar::scaleInt32,
+    sumFloat64,
+    sumInt32,
+};
+}
+
+                                  // ----
+                                  // avx2
+                                  // ----
+
+// The AVX2 kernels process four doubles or eight integers per instruction,
+// and use two accumulators to hide the latency of addition.
+
+namespace avx2 {
+
+#define SJTM_AVX2 __attribute__((target("avx2")))
+
+SJTM_AVX2
+double reduce(__m256d value)
+    // Return the sum of the four lanes of the specified 'value'.
+{
+    double lanes[4];
+    _mm256_storeu_pd(lanes, value);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+SJTM_AVX2
+Int64 reduce(__m256i value)
+    // Return the sum of the four 64-bit lanes of the specified 'value'.
+{
+    Int64 lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), value);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+SJTM_AVX2
+__m256i load4(const int *values)
+    // Return the four integers at the specified 'values', sign-extended to
+    // 64 bits.
+{
+    return _mm256_cvtepi32_epi64(
+                  _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)));
+}
+
+SJTM_AVX2
+__m256i load8(const int *values)
+    // Return the eight integers at the specified 'values'.
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+}
+
+SJTM_AVX2
+void store8(int *result, __m256i value)
+    // Store the eight integers of the specified 'value' at the specified
+    // 'result'.
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(result), value);
+}
+
+SJTM_AVX2
+void addFloat64(double *result, const double *values, int length)
+{
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        _mm256_storeu_pd(result + i,
+                         _mm256_add_pd(_mm256_loadu_pd(result + i),
+                                       _mm256_loadu_pd(values + i)));
+    }
+    scalar::addFloat64(result + i, values + i, length - i);
+}
+
+SJTM_AVX2
+void addInt32(int *result, const int *values, int length)
+{
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        store8(result + i,
+               _mm256_add_epi32(load8(result + i), load8(values + i)));
+    }
+    scalar::addInt32(result + i, values + i, length - i);
+}
+
+SJTM_AVX2
+double dotFloat64(const double *lhs, const double *rhs, int length)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        acc0 = _mm256_add_pd(acc0,
+                             _mm256_mul_pd(_mm256_loadu_pd(lhs + i),
+                                           _mm256_loadu_pd(rhs + i)));
+        acc1 = _mm256_add_pd(acc1,
+                             _mm256_mul_pd(_mm256_loadu_pd(lhs + i + 4),
+                                           _mm256_loadu_pd(rhs + i + 4)));
+    }
+    return reduce(_mm256_add_pd(acc0, acc1)) +
+           scalar::dotFloat64(lhs + i, rhs + i, length - i);
+}
+
+SJTM_AVX2
+Int64 dotInt32(const int *lhs, const int *rhs, int length)
+{
+    // 'mul_epi32' multiplies the low halves of 64-bit lanes, so the integers
+    // are sign-extended first and each product is exact.
+
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        acc = _mm256_add_epi64(acc,
+                               _mm256_mul_epi32(load4(lhs + i),
+                                                load4(rhs + i)));
+    }
+    return reduce(acc) + scalar::dotInt32(lhs + i, rhs + i, length - i);
+}
+
+SJTM_AVX2
+double maxFloat64(const double *values, int length)
+{
+    if (length < 4) {
+        return scalar::maxFloat64(values, length);                    // RETURN
+    }
+    __m256d acc = _mm256_loadu_pd(values);
+    int i = 4;
+    for (; i + 4 <= length; i += 4) {
+        acc = _mm256_max_pd(acc, _mm256_loadu_pd(values + i));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double result = scalar::maxFloat64(lanes, 4);
+    for (; i < length; ++i) {
+        result = result < values[i] ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_AVX2
+double minFloat64(const double *values, int length)
+{
+    if (length < 4) {
+        return scalar::minFloat64(values, length);                    // RETURN
+    }
+    __m256d acc = _mm256_loadu_pd(values);
+    int i = 4;
+    for (; i + 4 <= length; i += 4) {
+        acc = _mm256_min_pd(acc, _mm256_loadu_pd(values + i));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    double result = scalar::minFloat64(lanes, 4);
+    for (; i < length; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_AVX2
+int maxInt32(const int *values, int length)
+{
+    if (length < 8) {
+        return scalar::maxInt32(values, length);                      // RETURN
+    }
+    __m256i acc = load8(values);
+    int i = 8;
+    for (; i + 8 <= length; i += 8) {
+        acc = _mm256_max_epi32(acc, load8(values + i));
+    }
+    int lanes[8];
+    store8(lanes, acc);
+    int result = scalar::maxInt32(lanes, 8);
+    for (; i < length; ++i) {
+        result = result < values[i] ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_AVX2
+int minInt32(const int *values, int length)
+{
+    if (length < 8) {
+        return scalar::minInt32(values, length);                      // RETURN
+    }
+    __m256i acc = load8(values);
+    int i = 8;
+    for (; i + 8 <= length; i += 8) {
+        acc = _mm256_min_epi32(acc, load8(values + i));
+    }
+    int lanes[8];
+    store8(lanes, acc);
+    int result = scalar::minInt32(lanes, 8);
+    for (; i < length; ++i) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+SJTM_AVX2
+void scaleFloat64(double *values, int length, double factor)
+{
+    const __m256d f = _mm256_set1_pd(factor);
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        _mm256_storeu_pd(values + i,
+                         _mm256_mul_pd(_mm256_loadu_pd(values + i), f));
+    }
+    scalar::scaleFloat64(values + i, length - i, factor);
+}
+
+SJTM_AVX2
+void scaleInt32(int *values, int length, int factor)
+{
+    const __m256i f = _mm256_set1_epi32(factor);
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        store8(values + i, _mm256_mullo_epi32(load8(values + i), f));
+    }
+    scalar::scaleInt32(values + i, length - i, factor);
+}
+
+SJTM_AVX2
+double sumFloat64(const double *values, int length)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + i + 4));
+    }
+    return reduce(_mm256_add_pd(acc0, acc1)) +
+           scalar::sumFloat64(values + i, length - i);
+}
+
+SJTM_AVX2
+Int64 sumInt32(const int *values, int length)
+{
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, load4(values + i));
+        acc1 = _mm256_add_epi64(acc1, load4(values + i + 4));
+    }
+    return reduce(_mm256_add_epi64(acc0, acc1)) +
+           scalar::sumInt32(values + i, length - i);
+}
+
+#undef SJTM_AVX2
+
+const Kernels s_Kernels = {
+    addFloat64,
+    addInt32,
+    dotFloat64,
+    dotInt32,
+    maxFloat64,
+    maxInt32,
+    minFloat64,
+    minInt32,
+    scaleFloat64,
+    scaleInt32,
+    sumFloat64,
+    sumInt32,
+};
+}
+#endif
+
+const Kernels *kernelsFor(VectorUtil::Implementation implementation)
+    // Return the kernels of the specified 'implementation'.
+{
+    switch (implementation) {
+#ifdef SJTM_VECTORUTIL_X86
+      case VectorUtil::e_Avx2: return &avx2::s_Kernels;               // RETURN
+      case VectorUtil::e_Sse2: return &sse2::s_Kernels;               // RETURN
+#endif
+      default: return &scalar::s_Kernels;                             // RETURN
+    }
+}
+
+VectorUtil::Implementation bestImplementation()
+    // Return the fastest implementation supported by this processor.
+{
+#ifdef SJTM_VECTORUTIL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return VectorUtil::e_Avx2;                                    // RETURN
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return VectorUtil::e_Sse2;                                    // RETURN
+    }
+#endif
+    return VectorUtil::e_Scalar;
+}
+
+VectorUtil::Implementation  s_implementation;
+const Kernels              *s_kernels_p = 0;   // set by 'setImplementation'
+
+const Kernels& kernels()
+    // Return the kernels in use, selecting the best supported kernels on
+    // first use.
+{
+    static const Kernels *best = kernelsFor(bestImplementation());
+    return 0 != s_kernels_p ? *s_kernels_p : *best;
+}
+}
+
+                              // -----------------
+                              // struct VectorUtil
+                              // -----------------
+
+// CLASS METHODS
+void VectorUtil::addFloat64(double *result, const double *values, int length)
+{
+    BSLS_ASSERT(0 <= length);
+
+    kernels().d_addFloat64(result, values, length);
+}
+
+void VectorUtil::addInt32(int *result, const int *values, int length)
+{
+    BSLS_ASSERT(0 <= length);
+
+    kernels().d_addInt32(result, values, length);
+}
+
+double VectorUtil::dotFloat64(const double *lhs,
+                              const double *rhs,
+                              int           length)
+{
+    BSLS_ASSERT(0 <= length);
+
+    return kernels().d_dotFloat64(lhs, rhs, length);
+}
+
+VectorUtil::Int64 VectorUtil::dotInt32(const int *lhs,
+                                       const int *rhs,
+                                       int        length)
+{
+    BSLS_ASSERT(0 <= length);
+
+    return kernels().d_dotInt32(lhs, rhs, length);
+}
+
+double VectorUtil::maxFloat64(const double *values, int length)
+{
+    BSLS_ASSERT(0 < length);
+
+    return kernels().d_maxFloat64(values, length);
+}
+
+int VectorUtil::maxInt32(const int *values, int length)
+{
+    BSLS_ASSERT(0 < length);
+
+    return kernels().d_maxInt32(values, length);
+}
+
+double VectorUtil::minFloat64(const double *values, int length)
+{
+    BSLS_ASSERT(0 < length);
+
+    return kernels().d_minFloat64(values, length);
+}
+
+int VectorUtil::minInt32(const int *values, int length)
+{
+    BSLS_ASSERT(0 < length);
+
+    return kernels().d_minInt32(values, length);
+}
+
+void VectorUtil::scaleFloat64(double *values, int length, double factor)
+{
+    BSLS_ASSERT(0 <= length);
+
+    kernels().d_scaleFloat64(values, length, factor);
+}
+
+void VectorUtil::scaleInt32(int *values, int length, int factor)
+{
+    BSLS_ASSERT(0 <= length);
+
+    kernels().d_scaleInt32(values, length, factor);
+}
+
+double VectorUtil::sumFloat64(const double *values, int length)
+{
+    BSLS_ASSERT(0 <= length);
+
+    return kernels().d_sumFloat64(values, length);
+}
+
+VectorUtil::Int64 VectorUtil::sumInt32(const int *values, int length)
+{
+    BSLS_ASSERT(0 <= length);
+
+    return kernels().d_sumInt32(values, length);
+}
+
+VectorUtil::Implementation VectorUtil::implementation()
+{
+    static const Implementation best = bestImplementation();
+    return 0 != s_kernels_p ? s_implementation : best;
+}
+
+bool VectorUtil::isSupported(Implementation implementation)
+{
+    switch (implementation) {
+      case e_Scalar: return true;                                     // RETURN
+#ifdef SJTM_VECTORUTIL_X86
+      case e_Sse2:   return e_Sse2 <= bestImplementation();           // RETURN
+      case e_Avx2:   return e_Avx2 <= bestImplementation();           // RETURN
+#endif
+      default:       return false;                                    // RETURN
+    }
+}
+
+void VectorUtil::setImplementation(Implementation implementation)
+{
+    BSLS_ASSERT(isSupported(implementation));
+
+    s_implementation = implementation;
+    s_kernels_p      = kernelsFor(implementation);
+}
+}
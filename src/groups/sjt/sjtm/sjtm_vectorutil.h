@@ -0,0 +1,89 @@
+// sjtm_vectorutil.h
+
+#ifndef INCLUDED_SJTM_VECTORUTIL
+#define INCLUDED_SJTM_VECTORUTIL
+
+#ifndef INCLUDED_BSLS_TYPES
+#include <bsls_types.h>
+#endif
+
+namespace sjtm {
+
+                              // =================
+                              // struct VectorUtil
+                              // =================
+
+struct VectorUtil {
+    // This 'struct' provides a namespace for bulk operations on contiguous
+    // arrays of 32-bit integers and of doubles.  Each operation has a scalar
+    // implementation and, on x86 processors, implementations using SSE2 and
+    // AVX2 instructions; the best implementation supported by the processor
+    // is selected at run time, when an operation is first used.
+    //
+    // Integer arithmetic wraps on overflow, except that sums and dot
+    // products are accumulated in 64 bits.  The order in which the elements
+    // of a floating-point sum or dot product are added depends on the
+    // implementation, so results may differ by rounding.  The behavior of
+    // 'min' and 'max' is undefined if an element is NaN.
+
+    // TYPES
+    typedef BloombergLP::bsls::Types::Int64 Int64;
+
+    enum Implementation {
+        // Enumeration of the sets of instructions used by the operations.
+
+        e_Scalar,
+        e_Sse2,
+        e_Avx2
+    };
+
+    // CLASS METHODS
+    static void addFloat64(double *result, const double *values, int length);
+    static void addInt32(int *result, const int *values, int length);
+        // Add to each of the specified 'length' elements of the specified
+        // 'result' the corresponding element of the specified 'values'.  The
+        // behavior is undefined unless '0 <= length', and 'result' and
+        // 'values' are either identical or do not overlap.
+
+    static double dotFloat64(const double *lhs, const double *rhs, int length);
+    static Int64 dotInt32(const int *lhs, const int *rhs, int length);
+        // Return the sum of the products of the corresponding elements of the
+        // specified 'lhs' and 'rhs' arrays of the specified 'length'.  The
+        // behavior is undefined unless '0 <= length'.
+
+    static double maxFloat64(const double *values, int length);
+    static int maxInt32(const int *values, int length);
+        // Return the largest of the specified 'length' 'values'.  The
+        // behavior is undefined unless '0 < length'.
+
+    static double minFloat64(const double *values, int length);
+    static int minInt32(const int *values, int length);
+        // Return the smallest of the specified 'length' 'values'.  The
+        // behavior is undefined unless '0 < length'.
+
+    static void scaleFloat64(double *values, int length, double factor);
+    static void scaleInt32(int *values, int length, int factor);
+        // Multiply each of the specified 'length' 'values' by the specified
+        // 'factor'.  The behavior is undefined unless '0 <= length'.
+
+    static double sumFloat64(const double *values, int length);
+    static Int64 sumInt32(const int *values, int length);
+        // Return the sum of the specified 'length' 'values'.  The behavior is
+        // undefined unless '0 <= length'.
+
+    static Implementation implementation();
+        // Return the implementation used by the operations.
+
+    static bool isSupported(Implementation implementation);
+        // Return 'true' if the specified 'implementation' can be used on this
+        // processor, and 'false' otherwise.
+
+    static void setImplementation(Implementation implementation);
+        // Use the specified 'implementation' for subsequent operations.  The
+        // behavior is undefined unless 'isSupported(implementation)', and no
+        // operation is being performed concurrently.  Note that this method
+        // is intended for testing.
+};
+}
+
+#endif
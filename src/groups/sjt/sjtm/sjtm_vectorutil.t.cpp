@@ -0,0 +1,210 @@
+// sjtm_vectorutil.t.cpp                                          -*-C++-*-
+
+#include <sjtm_vectorutil.h>
+
+#include <bdls_testutil.h>
+
+#include <bsl_vector.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtm;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "implementations" << endl
+                          << "===============" << endl;
+
+        // Every supported implementation gives the results of the scalar
+        // implementation, for every length and alignment.  The values are
+        // small integers so that floating-point results are exact.
+
+        typedef VectorUtil Obj;
+
+        const Obj::Implementation IMPLEMENTATIONS[] = {
+            Obj::e_Sse2,
+            Obj::e_Avx2,
+        };
+        const int NUM_IMPLEMENTATIONS =
+                      sizeof IMPLEMENTATIONS / sizeof *IMPLEMENTATIONS;
+        const Obj::Implementation BEST = Obj::implementation();
+
+        bsl::vector<int>    ints(80);
+        bsl::vector<double> doubles(80);
+        for (int i = 0; i < 80; ++i) {
+            ints[i]    = (i * 37) % 101 - 50;
+            doubles[i] = ints[i];
+        }
+        ints[61] = 0x7fffffff;  // sums must not overflow
+
+        for (int k = 0; k < NUM_IMPLEMENTATIONS; ++k) {
+            const Obj::Implementation IMPL = IMPLEMENTATIONS[k];
+            if (!Obj::isSupported(IMPL)) {
+                if (verbose) cout << "skipping " << IMPL << endl;
+                continue;                                           // CONTINUE
+            }
+            for (int offset = 0; offset < 3; ++offset) {
+            for (int length = 0; length < 70; ++length) {
+                const int    *I = &ints[offset];
+                const int    *J = &ints[offset + 5];
+                const double *D = &doubles[offset];
+                const double *E = &doubles[offset + 5];
+
+                Obj::setImplementation(Obj::e_Scalar);
+                const Obj::Int64 sumI = Obj::sumInt32(I, length);
+                const double     sumD = Obj::sumFloat64(D, length);
+                const Obj::Int64 dotI = Obj::dotInt32(I, J, length);
+                const double     dotD = Obj::dotFloat64(D, E, length);
+                bsl::vector<int>      addI(I, I + length);
+                bsl::vector<double>   addD(D, D + length);
+                bsl::vector<int>      scaleI(I, I + length);
+                bsl::vector<double>   scaleD(D, D + length);
+                Obj::addInt32(addI.data(), J, length);
+                Obj::addFloat64(addD.data(), E, length);
+                Obj::scaleInt32(scaleI.data(), length, -3);
+                Obj::scaleFloat64(scaleD.data(), length, -3);
+
+                Obj::setImplementation(IMPL);
+                ASSERTV(IMPL, length, sumI == Obj::sumInt32(I, length));
+                ASSERTV(IMPL, length, sumD == Obj::sumFloat64(D, length));
+                ASSERTV(IMPL, length, dotI == Obj::dotInt32(I, J, length));
+                ASSERTV(IMPL, length, dotD == Obj::dotFloat64(D, E, length));
+
+                bsl::vector<int>    resultI(I, I + length);
+                bsl::vector<double> resultD(D, D + length);
+                Obj::addInt32(resultI.data(), J, length);
+                Obj::addFloat64(resultD.data(), E, length);
+                ASSERTV(IMPL, length, addI == resultI);
+                ASSERTV(IMPL, length, addD == resultD);
+
+                resultI.assign(I, I + length);
+                resultD.assign(D, D + length);
+                Obj::scaleInt32(resultI.data(), length, -3);
+                Obj::scaleFloat64(resultD.data(), length, -3);
+                ASSERTV(IMPL, length, scaleI == resultI);
+                ASSERTV(IMPL, length, scaleD == resultD);
+
+                if (0 < length) {
+                    Obj::setImplementation(Obj::e_Scalar);
+                    const int    minI = Obj::minInt32(I, length);
+                    const int    maxI = Obj::maxInt32(I, length);
+                    const double minD = Obj::minFloat64(D, length);
+                    const double maxD = Obj::maxFloat64(D, length);
+
+                    Obj::setImplementation(IMPL);
+                    ASSERTV(IMPL, length, minI == Obj::minInt32(I, length));
+                    ASSERTV(IMPL, length, maxI == Obj::maxInt32(I, length));
+                    ASSERTV(IMPL, length, minD == Obj::minFloat64(D, length));
+                    ASSERTV(IMPL, length, maxD == Obj::maxFloat64(D, length));
+                }
+            }
+            }
+        }
+        Obj::setImplementation(BEST);
+        ASSERT(BEST == Obj::implementation());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        typedef VectorUtil Obj;
+
+        ASSERT(Obj::isSupported(Obj::e_Scalar));
+        ASSERT(Obj::isSupported(Obj::implementation()));
+
+        int    ints[]    = { 3, -1, 4, 1, -5, 9, 2, -6, 5 };
+        double doubles[] = { 3, -1, 4, 1, -5, 9, 2, -6, 5 };
+        const int N = sizeof ints / sizeof *ints;
+
+        ASSERT(12 == Obj::sumInt32(ints, N));
+        ASSERT(12 == Obj::sumFloat64(doubles, N));
+        ASSERT(198 == Obj::dotInt32(ints, ints, N));
+        ASSERT(198 == Obj::dotFloat64(doubles, doubles, N));
+        ASSERT(-6 == Obj::minInt32(ints, N));
+        ASSERT(9 == Obj::maxInt32(ints, N));
+        ASSERT(-6 == Obj::minFloat64(doubles, N));
+        ASSERT(9 == Obj::maxFloat64(doubles, N));
+        ASSERT(0 == Obj::sumInt32(ints, 0));
+
+        Obj::scaleInt32(ints, N, 2);
+        Obj::scaleFloat64(doubles, N, 0.5);
+        ASSERT(-12 == ints[7]);
+        ASSERT(-3 == doubles[7]);
+
+        Obj::addInt32(ints, ints, N);
+        ASSERT(36 == ints[5]);
+
+        // Sums of integers do not wrap.
+
+        const int BIG[] = { 0x7fffffff, 0x7fffffff, 0x7fffffff };
+        ASSERT(3 * static_cast<Obj::Int64>(0x7fffffff) ==
+                                                     Obj::sumInt32(BIG, 3));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
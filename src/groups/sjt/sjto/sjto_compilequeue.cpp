@@ -0,0 +1,211 @@
+// sjto_compilequeue.cpp
+#include <sjto_compilequeue.h>
+
+#include <sjto_functionutil.h>
+#include <sjto_osrutil.h>
+
+#include <bdld_datum.h>
+#include <bslmt_lockguard.h>
+#include <bsls_assert.h>
+
+#include <sjtd_tracer.h>
+
+using namespace BloombergLP;
+
+namespace sjto {
+
+                         // -------------------------
+                         // class CompileQueue::Entry
+                         // -------------------------
+
+// PRIVATE ACCESSORS
+bool CompileQueue::Entry::isFor(const sjtt::Bytecode *firstCode,
+                                int                   numCodes,
+                                int                   header) const
+{
+    if (header != d_header ||
+        numCodes != static_cast<int>(d_source.size())) {
+        return false;                                                 // RETURN
+    }
+    for (int i = 0; i < numCodes; ++i) {
+        if (!(firstCode[i] == d_source[i])) {
+            return false;                                             // RETURN
+        }
+    }
+    return true;
+}
+
+// CREATORS
+CompileQueue::Entry::Entry(const sjtt::Bytecode *firstCode,
+                           int                   numCodes,
+                           int                   header,
+                           int                   height,
+                           Allocator            *basicAllocator)
+: d_source(basicAllocator)
+, d_header(header)
+, d_height(height)
+, d_codes(basicAllocator)
+, d_installed(0)
+, d_allocator_p(basicAllocator)
+{
+    d_source.reserve(numCodes);
+    for (int i = 0; i < numCodes; ++i) {
+        const sjtt::Bytecode& code = firstCode[i];
+        d_source.push_back(sjtt::Bytecode::createOpcode(
+                                            code.opcode(),
+                                            code.data().clone(d_allocator_p)));
+    }
+}
+
+CompileQueue::Entry::~Entry()
+{
+    for (bsl::size_t i = 0; i < d_source.size(); ++i) {
+        bdld::Datum::destroy(d_source[i].data(), d_allocator_p);
+    }
+}
+
+                             // ------------------
+                             // class CompileQueue
+                             // ------------------
+
+// PRIVATE MANIPULATORS
+void CompileQueue::compile(Entry *entry)
+{
+    SJTD_TRACER_SCOPE("compile", "osr");
+
+    // The codes are complete before their address is published, and are not
+    // written again, so that an evaluation having loaded the address with
+    // acquire semantics sees all of them.
+
+    if (0 == OsrUtil::compile(&entry->d_codes,
+                              entry->d_source.data(),
+                              entry->d_header,
+                              entry->d_height)) {
+        entry->d_installed.storeRelease(entry->d_codes.data());
+
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        ++d_numInstalled;
+    }
+}
+
+void CompileQueue::threadMain()
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    while (!d_isStopping) {
+        if (d_pending.empty()) {
+            d_workCondition.wait(&d_mutex);
+            continue;                                               // CONTINUE
+        }
+        Entry *entry = d_pending.front();
+        d_pending.pop_front();
+        ++d_numCompiling;
+        {
+            bslmt::LockGuardUnlock<bslmt::Mutex> unlock(&d_mutex);
+            compile(entry);
+        }
+        if (0 == --d_numCompiling && d_pending.empty()) {
+            d_idleCondition.broadcast();
+        }
+    }
+}
+
+// CREATORS
+CompileQueue::CompileQueue(int numThreads, Allocator *basicAllocator)
+: d_storage(basicAllocator)
+, d_entries(basicAllocator)
+, d_pending(basicAllocator)
+, d_numCompiling(0)
+, d_numInstalled(0)
+, d_isStopping(false)
+, d_threads(basicAllocator)
+, d_allocator_p(basicAllocator)
+{
+    BSLS_ASSERT(0 <= numThreads);
+
+    d_threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        bslmt::ThreadUtil::Handle handle;
+        if (0 != bslmt::ThreadUtil::create(&handle,
+                                           [this]() { threadMain(); })) {
+            break;                                                    // BREAK
+        }
+        d_threads.push_back(handle);
+    }
+}
+
+CompileQueue::~CompileQueue()
+{
+    {
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        d_pending.clear();
+        d_isStopping = true;
+        d_workCondition.broadcast();
+    }
+    for (bsl::size_t i = 0; i < d_threads.size(); ++i) {
+        bslmt::ThreadUtil::join(d_threads[i]);
+    }
+}
+
+// MANIPULATORS
+const CompileQueue::Entry *CompileQueue::request(
+                                               const sjtt::Bytecode *firstCode,
+                                               int                   header,
+                                               int                   height)
+{
+    BSLS_ASSERT(0 != firstCode);
+    BSLS_ASSERT(0 <= header);
+    BSLS_ASSERT(0 <= height);
+
+    // Another program may have been read into the memory of one requested
+    // before, so an entry is used only if it was copied from the same codes.
+
+    const int numCodes = FunctionUtil::findNumCodes(firstCode);
+
+    Entry *entry;
+    {
+        bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+        bsl::pair<Entries::iterator, Entries::iterator> range =
+                                     d_entries.equal_range(firstCode + header);
+        for (Entries::iterator it = range.first; range.second != it; ++it) {
+            if (it->second->isFor(firstCode, numCodes, header)) {
+                return it->second;                                    // RETURN
+            }
+        }
+        d_storage.emplace_back(firstCode,
+                               numCodes,
+                               header,
+                               height,
+                               d_allocator_p);
+        entry = &d_storage.back();
+        d_entries.emplace(firstCode + header, entry);
+        if (!d_threads.empty()) {
+            d_pending.push_back(entry);
+            d_workCondition.signal();
+            return entry;                                             // RETURN
+        }
+    }
+    compile(entry);
+    return entry;
+}
+
+void CompileQueue::waitUntilIdle()
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    while (!d_pending.empty() || 0 != d_numCompiling) {
+        d_idleCondition.wait(&d_mutex);
+    }
+}
+
+// ACCESSORS
+int CompileQueue::numInstalled() const
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    return d_numInstalled;
+}
+
+int CompileQueue::numRequests() const
+{
+    bslmt::LockGuard<bslmt::Mutex> guard(&d_mutex);
+    return static_cast<int>(d_entries.size());
+}
+}
@@ -0,0 +1,263 @@
+// sjto_compilequeue.h
+
+#ifndef INCLUDED_SJTO_COMPILEQUEUE
+#define INCLUDED_SJTO_COMPILEQUEUE
+
+#ifndef INCLUDED_BSL_DEQUE
+#include <bsl_deque.h>
+#endif
+
+#ifndef INCLUDED_BSL_UNORDERED_MAP
+#include <bsl_unordered_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_CONDITION
+#include <bslmt_condition.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_MUTEX
+#include <bslmt_mutex.h>
+#endif
+
+#ifndef INCLUDED_BSLMT_THREADUTIL
+#include <bslmt_threadutil.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ATOMIC
+#include <bsls_atomic.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjto {
+
+                             // ==================
+                             // class CompileQueue
+                             // ==================
+
+class CompileQueue {
+    // This class is a mechanism compiling, with 'OsrUtil', the versions of
+    // functions entered at a given code with a given number of values, on a
+    // configurable number of background threads, so that the thread whose
+    // evaluation made a function hot is not stalled while it compiles.
+    //
+    // Each version requested has an entry holding a copy of the program it
+    // is compiled from, found by the code it is entered at and the codes of
+    // the program, so that a version is never used for another program read
+    // into the same memory, and the program need not outlive its requests.
+    // A compiling thread installs a version into its entry by storing,
+    // with release semantics, the address of its first code, after which it
+    // is never changed; an evaluation polls the entry, with acquire
+    // semantics and no lock, at the calls and backward jumps to that code,
+    // and continues in the version from the first of them after it is
+    // installed.  Only requests and the compiling threads take the lock of
+    // the queue.  A version that fails to compile is never installed.
+    //
+    // A queue having no threads compiles each version on the thread
+    // requesting it, before 'request' returns.  The versions, and the
+    // entries, live as long as the queue, and the queue may be used
+    // concurrently from multiple threads, provided its allocator may be.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    class Entry {
+        // This class holds the version of a function entered at one code.
+
+        // DATA
+        bsl::vector<sjtt::Bytecode>  d_source;       // program of the
+                                                     // requesting frame,
+                                                     // owning its data
+        int                          d_header;       // index in 'd_source'
+        int                          d_height;
+        bsl::vector<sjtt::Bytecode>  d_codes;        // written only before
+                                                     // being installed
+        BloombergLP::bsls::AtomicPointer<const sjtt::Bytecode>
+                                     d_installed;    // first code, or 0
+        Allocator                   *d_allocator_p;  // held, not owned
+
+        // FRIENDS
+        friend class CompileQueue;
+
+        // PRIVATE ACCESSORS
+        bool isFor(const sjtt::Bytecode *firstCode,
+                   int                   numCodes,
+                   int                   header) const;
+            // Return 'true' if this entry is for the code at the specified
+            // 'header' index of the program of the specified 'numCodes'
+            // codes beginning at the specified 'firstCode', and 'false'
+            // otherwise.
+
+        // NOT IMPLEMENTED
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+      public:
+        // CREATORS
+        Entry(const sjtt::Bytecode *firstCode,
+              int                   numCodes,
+              int                   header,
+              int                   height,
+              Allocator            *basicAllocator);
+            // Create an entry, with no version installed, for the version of
+            // the function entered at the code at the specified 'header'
+            // index of the program of the specified 'numCodes' codes
+            // beginning at the specified 'firstCode', with the specified
+            // 'height' number of values, copying the codes and their data
+            // using the specified 'basicAllocator' to supply memory.
+
+        ~Entry();
+            // Destroy this object and the data of the codes it copied.
+
+        // ACCESSORS
+        const sjtt::Bytecode *codes() const;
+            // Return the address of the first code of the version installed
+            // in this entry, or 0 if none is installed.
+
+        int height() const;
+            // Return the number of values of the frames entering the version
+            // of this entry.
+
+        int numCodes() const;
+            // Return the number of codes of the version installed in this
+            // entry.  The behavior is undefined unless 'codes()' has
+            // returned a non-zero value.
+    };
+
+  private:
+    // PRIVATE TYPES
+    typedef bsl::unordered_multimap<const sjtt::Bytecode *, Entry *>
+                                                                      Entries;
+
+    // DATA
+    bsl::deque<Entry>         d_storage;
+    Entries                   d_entries;        // by entered code
+    bsl::deque<Entry *>       d_pending;        // not yet compiling
+    int                       d_numCompiling;
+    int                       d_numInstalled;
+    bool                      d_isStopping;
+    mutable BloombergLP::bslmt::Mutex
+                              d_mutex;          // guards the above
+    BloombergLP::bslmt::Condition
+                              d_workCondition;  // signaled when a request is
+                                                // queued, or the queue stops
+    BloombergLP::bslmt::Condition
+                              d_idleCondition;  // signaled when nothing is
+                                                // pending or compiling
+    bsl::vector<BloombergLP::bslmt::ThreadUtil::Handle>
+                              d_threads;
+    Allocator                *d_allocator_p;    // held, not owned
+
+    // PRIVATE MANIPULATORS
+    void compile(Entry *entry);
+        // Compile the version of the specified 'entry', and install it if it
+        // compiles.
+
+    void threadMain();
+        // Compile the versions of the requests queued, until the queue is
+        // destroyed.
+
+    // NOT IMPLEMENTED
+    CompileQueue(const CompileQueue&) = delete;
+    CompileQueue& operator=(const CompileQueue&) = delete;
+
+  public:
+    // CREATORS
+    explicit CompileQueue(int numThreads, Allocator *basicAllocator = 0);
+        // Create a queue served by at most the specified 'numThreads'
+        // background threads, or compiling on the requesting thread if
+        // 'numThreads' is 0.  Optionally specify a 'basicAllocator' used to
+        // supply memory.  If 'basicAllocator' is 0, the currently installed
+        // default allocator is used.  The behavior is undefined unless
+        // '0 <= numThreads'.  Note that fewer threads are started if the
+        // system declines to create them, down to none.
+
+    ~CompileQueue();
+        // Discard the requests not yet compiling, wait for the versions being
+        // compiled, stop the threads, and destroy this object and every
+        // version it holds.
+
+    // MANIPULATORS
+    const Entry *request(const sjtt::Bytecode *firstCode,
+                         int                   header,
+                         int                   height);
+        // Return the address of the entry for the version of the function
+        // containing the code at the specified 'header' index from the
+        // specified 'firstCode' of a frame, entered at that code with the
+        // specified 'height' number of values, queueing the version to be
+        // compiled, as by 'OsrUtil::compile', unless it was already
+        // requested for the same codes.  A version already requested with a
+        // different height is not requested again, and its entry is
+        // returned.  The program beginning at 'firstCode' is copied, with
+        // the data of its codes, before this method returns.  The behavior
+        // is undefined unless 'firstCode' and 'header' satisfy the
+        // requirements of 'OsrUtil::compile', '0 <= header', and
+        // '0 <= height'.
+
+    void waitUntilIdle();
+        // Block until every version requested is compiled or has failed to.
+
+    // ACCESSORS
+    int numInstalled() const;
+        // Return the number of versions installed.  Note that the value
+        // returned may be out of date by the time it is used.
+
+    int numRequests() const;
+        // Return the number of versions requested.  Note that the value
+        // returned may be out of date by the time it is used.
+
+    int numThreads() const;
+        // Return the number of background threads serving this queue.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                         // -------------------------
+                         // class CompileQueue::Entry
+                         // -------------------------
+
+// ACCESSORS
+inline
+const sjtt::Bytecode *CompileQueue::Entry::codes() const
+{
+    return d_installed.loadAcquire();
+}
+
+inline
+int CompileQueue::Entry::height() const
+{
+    return d_height;
+}
+
+inline
+int CompileQueue::Entry::numCodes() const
+{
+    return static_cast<int>(d_codes.size());
+}
+
+                             // ------------------
+                             // class CompileQueue
+                             // ------------------
+
+// ACCESSORS
+inline
+int CompileQueue::numThreads() const
+{
+    return static_cast<int>(d_threads.size());
+}
+}
+
+#endif
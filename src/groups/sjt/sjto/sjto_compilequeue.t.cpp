@@ -0,0 +1,352 @@
+// sjto_compilequeue.t.cpp                                        -*-C++-*-
+
+#include <sjto_compilequeue.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+#include <bslmt_threadutil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_vector.h>
+
+#include <sjto_osrutil.h>
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode      BC;
+typedef CompileQueue        Obj;
+typedef CompileQueue::Entry Entry;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+void sumLoop(bsl::vector<BC> *codes)
+    // Append to the specified 'codes' a program summing, in slot 1, the
+    // values of its induction variable, in slot 0, from 0 to 3, with the test
+    // following the body.
+{
+    codes->push_back(code(BC::e_Push, 0));                            //  0
+    codes->push_back(code(BC::e_Store, 0));                           //  1
+    codes->push_back(code(BC::e_Push, 0));                            //  2
+    codes->push_back(code(BC::e_Store, 1));                           //  3
+    codes->push_back(code(BC::e_Load, 1));                            //  4
+    codes->push_back(code(BC::e_Load, 0));                            //  5
+    codes->push_back(code(BC::e_AddInts));                            //  6
+    codes->push_back(code(BC::e_Store, 1));                           //  7
+    codes->push_back(code(BC::e_IncInt, 0));                          //  8
+    codes->push_back(code(BC::e_Load, 0));                            //  9
+    codes->push_back(code(BC::e_Push, 4));                            // 10
+    codes->push_back(code(BC::e_IfEqInts, 13));                       // 11
+    codes->push_back(code(BC::e_Jump, 4));                            // 12
+    codes->push_back(code(BC::e_Load, 1));                            // 13
+    codes->push_back(code(BC::e_Exit));                               // 14
+}
+
+bool isInstalledAs(const Entry *entry,
+                   const BC    *firstCode,
+                   int          header,
+                   int          height)
+    // Return 'true' if the specified 'entry' holds the version compiled by
+    // 'OsrUtil' from the specified 'firstCode' at the specified 'header'
+    // with the specified 'height', and 'false' otherwise.
+{
+    bsl::vector<BC> expected;
+    if (0 == entry->codes() ||
+        0 != OsrUtil::compile(&expected, firstCode, header, height) ||
+        static_cast<int>(expected.size()) != entry->numCodes()) {
+        return false;                                                 // RETURN
+    }
+    return bsl::equal(expected.begin(), expected.end(), entry->codes());
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "programs read into the same memory" << endl
+                          << "==================================" << endl;
+
+        // A version is used only for the codes it was compiled from, even if
+        // another program is read where they were.
+
+        bslma::TestAllocator ta;
+        {
+            Obj mX(0, &ta);  const Obj& X = mX;
+
+            bsl::vector<BC> codes;
+            sumLoop(&codes);
+            const Entry *first = mX.request(codes.data(), 4, 8);
+            ASSERT(isInstalledAs(first, codes.data(), 4, 8));
+
+            codes[10] = code(BC::e_Push, 6);
+            const Entry *second = mX.request(codes.data(), 4, 8);
+            ASSERT(first != second);
+            ASSERT(isInstalledAs(second, codes.data(), 4, 8));
+            ASSERT(second == mX.request(codes.data(), 4, 8));
+
+            codes[10] = code(BC::e_Push, 4);
+            ASSERT(first == mX.request(codes.data(), 4, 8));
+            ASSERTV(X.numRequests(), 2 == X.numRequests());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        // The codes, and their data, may be destroyed once they are
+        // requested, before the version is compiled.
+
+        bslma::TestAllocator da;
+        bsl::vector<BC> expected;
+        sumLoop(&expected);
+        expected[13] = BC::createOpcode(
+                               BC::e_Push,
+                               bdld::Datum::copyString("sum", 3, &da));
+        {
+            Obj mX(1, &ta);  const Obj& X = mX;
+
+            const Entry *entries[8];
+            for (int i = 0; i < 8; ++i) {
+                bsl::vector<BC> *codes = new bsl::vector<BC>();
+                sumLoop(codes);
+                (*codes)[13] = BC::createOpcode(
+                                   BC::e_Push,
+                                   bdld::Datum::copyString("sum", 3, &da));
+                entries[i] = mX.request(codes->data(), 4, 8);
+                bdld::Datum::destroy((*codes)[13].data(), &da);
+                bsl::fill(codes->begin(), codes->end(), code(BC::e_Exit));
+                delete codes;
+            }
+            mX.waitUntilIdle();
+
+            ASSERTV(X.numRequests(), 1 == X.numRequests());
+            for (int i = 0; i < 8; ++i) {
+                ASSERTV(i, entries[0] == entries[i]);
+            }
+            ASSERT(isInstalledAs(entries[0], expected.data(), 4, 8));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+        bdld::Datum::destroy(expected[13].data(), &da);
+        ASSERT(0 == da.numBlocksInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "concurrent requests" << endl
+                          << "===================" << endl;
+
+        // Threads requesting the same versions concurrently, while the
+        // background threads install them, get one entry per entered code,
+        // each installed once.
+
+        enum { k_NUM_REQUESTERS = 4, k_NUM_PROGRAMS = 16 };
+
+        bsl::vector<bsl::vector<BC> > programs(k_NUM_PROGRAMS);
+        for (int i = 0; i < k_NUM_PROGRAMS; ++i) {
+            sumLoop(&programs[i]);
+        }
+
+        bslma::TestAllocator ta;
+        {
+            Obj mX(3, &ta);  const Obj& X = mX;
+            ASSERTV(X.numThreads(), 3 == X.numThreads());
+
+            const Entry *entries[k_NUM_REQUESTERS][k_NUM_PROGRAMS];
+            bsl::vector<bslmt::ThreadUtil::Handle> requesters;
+            for (int t = 0; t < k_NUM_REQUESTERS; ++t) {
+                bslmt::ThreadUtil::Handle handle;
+                ASSERT(0 == bslmt::ThreadUtil::create(
+                                &handle,
+                                [&mX, &programs, &entries, t]() {
+                                    for (int i = 0; i < k_NUM_PROGRAMS; ++i) {
+                                        entries[t][i] = mX.request(
+                                                         programs[i].data(),
+                                                         4,
+                                                         8);
+                                    }
+                                }));
+                requesters.push_back(handle);
+            }
+            for (bsl::size_t t = 0; t < requesters.size(); ++t) {
+                bslmt::ThreadUtil::join(requesters[t]);
+            }
+            mX.waitUntilIdle();
+
+            ASSERTV(X.numRequests(), k_NUM_PROGRAMS == X.numRequests());
+            ASSERTV(X.numInstalled(), k_NUM_PROGRAMS == X.numInstalled());
+            for (int i = 0; i < k_NUM_PROGRAMS; ++i) {
+                for (int t = 1; t < k_NUM_REQUESTERS; ++t) {
+                    ASSERTV(i, t, entries[0][i] == entries[t][i]);
+                }
+                ASSERTV(i, isInstalledAs(entries[0][i],
+                                         programs[i].data(),
+                                         4,
+                                         8));
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        // A queue destroyed with requests pending discards them.
+
+        {
+            Obj mX(1, &ta);
+            for (int i = 0; i < k_NUM_PROGRAMS; ++i) {
+                mX.request(programs[i].data(), 4, 8);
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "compiling on the requesting thread" << endl
+                          << "==================================" << endl;
+
+        // A queue having no threads has installed a version when 'request'
+        // returns, unless it fails to compile.
+
+        bsl::vector<BC> codes;
+        sumLoop(&codes);
+
+        bslma::TestAllocator ta;
+        {
+            Obj mX(0, &ta);  const Obj& X = mX;
+            ASSERT(0 == X.numThreads());
+
+            const Entry *entry = mX.request(codes.data(), 4, 8);
+            ASSERT(isInstalledAs(entry, codes.data(), 4, 8));
+            ASSERT(8 == entry->height());
+
+            // A version is requested once per entered code, whatever the
+            // height.
+
+            ASSERT(entry == mX.request(codes.data(), 4, 8));
+            ASSERT(entry == mX.request(codes.data(), 4, 9));
+            ASSERT(8 == entry->height());
+
+            // A header that no frame beginning at the first code evaluates
+            // is not installed.
+
+            bsl::vector<BC> other;
+            other.push_back(code(BC::e_PushCode, 2));                 //  0
+            other.push_back(code(BC::e_Exit));                        //  1
+            other.push_back(code(BC::e_Push, 1));                     //  2
+            other.push_back(code(BC::e_Exit));                        //  3
+
+            const Entry *failed = mX.request(other.data(), 2, 8);
+            ASSERT(0 != failed);
+            ASSERT(0 == failed->codes());
+            ASSERT(failed != entry);
+
+            mX.waitUntilIdle();
+            ASSERTV(X.numRequests(), 2 == X.numRequests());
+            ASSERTV(X.numInstalled(), 1 == X.numInstalled());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "BREATHING TEST" << endl
+                          << "==============" << endl;
+
+        bsl::vector<BC> codes;
+        sumLoop(&codes);
+
+        bslma::TestAllocator ta;
+        {
+            Obj mX(2, &ta);  const Obj& X = mX;
+            ASSERT(2 == X.numThreads());
+            ASSERT(0 == X.numRequests());
+
+            const Entry *entry = mX.request(codes.data(), 4, 8);
+            ASSERT(0 != entry);
+            ASSERT(1 == X.numRequests());
+
+            mX.waitUntilIdle();
+            ASSERT(1 == X.numInstalled());
+            ASSERT(isInstalledAs(entry, codes.data(), 4, 8));
+            ASSERT(code(BC::e_Resize, 8) == entry->codes()[0]);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
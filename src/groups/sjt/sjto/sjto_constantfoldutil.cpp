@@ -0,0 +1,456 @@
+// sjto_constantfoldutil.cpp
+#include <sjto_constantfoldutil.h>
+
+#include <sjto_functionutil.h>
+
+#include <sjtd_datumudtutil.h>
+
+#include <bdld_datum.h>
+
+#include <bsl_algorithm.h>
+
+#include <bsls_assert.h>
+
+namespace sjto {
+namespace {
+
+using BloombergLP::bdld::Datum;
+
+typedef sjtt::Bytecode Bytecode;
+
+struct Value {
+    // This 'struct' describes what is known of the value of a slot.
+
+    bool  d_isConstant;  // the slot holds 'd_constant' on every path
+    Datum d_constant;
+};
+
+typedef bsl::vector<Value> State;
+    // The values of the slots of a frame, from its bottom.
+
+Value varying()
+    // Return the description of a slot whose value is not known.
+{
+    const Value value = { false, Datum::createNull() };
+    return value;
+}
+
+Value constant(const Datum& datum)
+    // Return the description of a slot holding the specified 'datum'.
+{
+    const Value value = { true, datum };
+    return value;
+}
+
+bool meet(State *state, const State& other)
+    // Make varying each slot of the specified 'state' whose value differs in
+    // the specified 'other' state, and return 'true' if any slot changed, and
+    // 'false' otherwise.  The behavior is undefined unless both states have
+    // the same number of slots.
+{
+    BSLS_ASSERT(state->size() == other.size());
+
+    bool isChanged = false;
+    for (bsl::size_t i = 0; i < state->size(); ++i) {
+        Value& value = (*state)[i];
+        if (value.d_isConstant &&
+            (!other[i].d_isConstant ||
+             !(other[i].d_constant == value.d_constant))) {
+            value     = varying();
+            isChanged = true;
+        }
+    }
+    return isChanged;
+}
+
+bool isJump(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // the index of a code of the same function, and 'false' otherwise.
+{
+    return Bytecode::e_Jump     == opcode ||
+           Bytecode::e_If       == opcode ||
+           Bytecode::e_IfEqInts == opcode;
+}
+
+bool isEntry(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // the index of the first code of a function, and 'false' otherwise.
+{
+    return Bytecode::e_Call     == opcode ||
+           Bytecode::e_TailCall == opcode ||
+           Bytecode::e_PushCode == opcode;
+}
+
+bool fold(Datum            *result,
+          Bytecode::Opcode  opcode,
+          const Datum&      lhs,
+          const Datum&      rhs)
+    // Load into the specified 'result' the value of a code having the
+    // specified 'opcode' whose operands are the specified 'lhs', pushed
+    // first, and 'rhs', and return 'true' if the code can be evaluated;
+    // otherwise, return 'false'.
+{
+    switch (opcode) {
+      case Bytecode::e_AddInts: {
+        if (!lhs.isInteger() || !rhs.isInteger()) {
+            return false;                                             // RETURN
+        }
+        *result = Datum::createInteger(static_cast<int>(
+                                    static_cast<unsigned>(lhs.theInteger()) +
+                                    static_cast<unsigned>(rhs.theInteger())));
+      } break;
+      case Bytecode::e_AddDoubles: {
+        if (!lhs.isDouble() || !rhs.isDouble()) {
+            return false;                                             // RETURN
+        }
+        *result = Datum::createDouble(lhs.theDouble() + rhs.theDouble());
+      } break;
+      case Bytecode::e_EqInts: {
+        if (!lhs.isInteger() || !rhs.isInteger()) {
+            return false;                                             // RETURN
+        }
+        *result = Datum::createBoolean(lhs.theInteger() == rhs.theInteger());
+      } break;
+      default: {
+        return false;                                                 // RETURN
+      }
+    }
+    return true;
+}
+
+int branchOutcome(const State& state, Bytecode::Opcode opcode)
+    // Return 1 if a branch having the specified 'opcode' is always taken in
+    // the specified 'state', 0 if it never is, and -1 if it is not known.
+{
+    const bsl::size_t height = state.size();
+    if (Bytecode::e_If == opcode) {
+        const Value& condition = state[height - 1];
+        return condition.d_isConstant && condition.d_constant.isBoolean()
+               ? condition.d_constant.theBoolean()
+               : -1;
+    }
+    const Value& lhs = state[height - 2];
+    const Value& rhs = state[height - 1];
+    return lhs.d_isConstant && lhs.d_constant.isInteger() &&
+           rhs.d_isConstant && rhs.d_constant.isInteger()
+           ? lhs.d_constant.theInteger() == rhs.d_constant.theInteger()
+           : -1;
+}
+
+Bytecode createCode(Bytecode::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return Bytecode::createOpcode(opcode, Datum::createInteger(data));
+}
+
+}  // close unnamed namespace
+
+                          // -----------------------
+                          // struct ConstantFoldUtil
+                          // -----------------------
+
+// CLASS METHODS
+int ConstantFoldUtil::optimize(bsl::vector<sjtt::Bytecode> *codes,
+                               int                          numArguments)
+{
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= numArguments);
+
+    const bsl::vector<Bytecode>& program  = *codes;
+    const int                    numCodes = static_cast<int>(program.size());
+    bsl::vector<int>             firstCodes;
+    if (0 != FunctionUtil::findFirstCodes(&firstCodes, program)) {
+        return 0;                                                     // RETURN
+    }
+
+    // The codes whose heights are not known, because they are reached by a
+    // function that cannot be analyzed, are kept unchanged.
+
+    bsl::vector<int> entries;
+    bsl::vector<int> heights;
+    FunctionUtil::findEntries(&entries, program, firstCodes);
+    FunctionUtil::findHeights(&heights, program, firstCodes, numArguments);
+
+    bsl::vector<char> isKept(numCodes, false);
+    for (int index = 0; index < numCodes; ++index) {
+        isKept[index] = 0 <= firstCodes[index] && 0 > heights[index];
+    }
+
+    // Track the values of the slots through the codes of each function that
+    // is analyzed, following the branches that can be taken.
+
+    bsl::vector<State> states(numCodes);
+    bsl::vector<char>  hasState(numCodes, false);
+    bsl::vector<int>   pending;
+    for (bsl::size_t e = 0; e < entries.size(); ++e) {
+        const int entry = entries[e];
+        if (isKept[entry]) {
+            continue;                                               // CONTINUE
+        }
+        const State state(heights[entry], varying());
+        if (!hasState[entry]) {
+            states[entry]   = state;
+            hasState[entry] = true;
+            pending.push_back(entry);
+        }
+        else if (meet(&states[entry], state)) {
+            pending.push_back(entry);
+        }
+    }
+
+    const Value undefined = constant(sjtd::DatumUdtUtil::s_Undefined);
+    while (!pending.empty()) {
+        const int index = pending.back();
+        pending.pop_back();
+
+        const Bytecode& code   = program[index];
+        const int       data   = code.data().isInteger()
+                                 ? code.data().theInteger()
+                                 : -1;
+        State           state  = states[index];
+        int             next   = index + 1;  // or -1 if not reached
+        int             target = -1;         // or the index jumped to
+
+        switch (code.opcode()) {
+          case Bytecode::e_Push: {
+            state.push_back(constant(code.data()));
+          } break;
+          case Bytecode::e_Load: {
+            state.push_back(state[data]);
+          } break;
+          case Bytecode::e_Store: {
+            state[data] = state.back();
+            state.pop_back();
+          } break;
+          case Bytecode::e_Resize: {
+            state.resize(data, undefined);
+          } break;
+          case Bytecode::e_IncInt: {
+            Value& slot = state[data];
+            if (slot.d_isConstant && slot.d_constant.isInteger()) {
+                slot.d_constant = Datum::createInteger(static_cast<int>(
+                         static_cast<unsigned>(slot.d_constant.theInteger()) +
+                         1u));
+            }
+            else {
+                slot = varying();
+            }
+          } break;
+          case Bytecode::e_AddInts:
+          case Bytecode::e_AddDoubles:
+          case Bytecode::e_EqInts: {
+            const Value lhs = state[state.size() - 2];
+            const Value rhs = state.back();
+            Datum       result;
+            state.resize(state.size() - 2);
+            state.push_back(lhs.d_isConstant &&
+                            rhs.d_isConstant &&
+                            fold(&result,
+                                 code.opcode(),
+                                 lhs.d_constant,
+                                 rhs.d_constant)
+                            ? constant(result)
+                            : varying());
+          } break;
+          case Bytecode::e_If:
+          case Bytecode::e_IfEqInts: {
+            const int outcome = branchOutcome(state, code.opcode());
+            state.resize(state.size() -
+                         (Bytecode::e_If == code.opcode() ? 1 : 2));
+            target = 0 != outcome ? firstCodes[index] + data : -1;
+            next   = 1 != outcome ? next : -1;
+          } break;
+          case Bytecode::e_Jump: {
+            target = firstCodes[index] + data;
+            next   = -1;
+          } break;
+          case Bytecode::e_Exit:
+          case Bytecode::e_TailCall:
+          case Bytecode::e_Throw: {
+            next = -1;
+          } break;
+          default: {
+            // Every other code pops values from the top of the frame and
+            // pushes at most one.
+
+            const int after = heights[next];
+            BSLS_ASSERT(0 < after);
+            state.resize(bsl::min<bsl::size_t>(state.size(), after - 1));
+            state.resize(after, varying());
+          } break;
+        }
+
+        const int successors[] = { target, next };
+        for (int s = 0; s < 2; ++s) {
+            const int successor = successors[s];
+            if (0 > successor || isKept[successor]) {
+                continue;                                           // CONTINUE
+            }
+            if (!hasState[successor]) {
+                states[successor]   = state;
+                hasState[successor] = true;
+                pending.push_back(successor);
+            }
+            else if (meet(&states[successor], state)) {
+                pending.push_back(successor);
+            }
+        }
+    }
+
+    // The codes that a jump may target begin sequences within which codes
+    // pushing the operands of another may be removed with it.
+
+    bsl::vector<char> isLeader(numCodes, false);
+    for (bsl::size_t e = 0; e < entries.size(); ++e) {
+        isLeader[entries[e]] = true;
+    }
+    for (int index = 0; index < numCodes; ++index) {
+        const Bytecode& code = program[index];
+        if ((isKept[index] || hasState[index]) &&
+            isJump(code.opcode()) &&
+            code.data().isInteger()) {
+            const int target = firstCodes[index] + code.data().theInteger();
+            if (0 <= target && target < numCodes) {
+                isLeader[target] = true;
+            }
+        }
+    }
+
+    // Emit the codes that are reached, folding those whose operands are
+    // constants, with the indices stored by codes still relative to the
+    // original first codes of their frames, and 'newIndices' mapping each
+    // original code to the first code emitted for it, or for the next code
+    // that is emitted.
+
+    bsl::vector<Bytecode> result;
+    bsl::vector<int>      resultFirstCodes;  // original, per emitted code
+    bsl::vector<int>      newIndices(numCodes + 1, 0);
+    bsl::size_t           sequenceStart = 0;
+    int                   numChanged    = 0;
+    for (int index = 0; index < numCodes; ++index) {
+        newIndices[index] = static_cast<int>(result.size());
+        if (!isKept[index] && !hasState[index]) {
+            ++numChanged;
+            continue;                                               // CONTINUE
+        }
+        if (isLeader[index]) {
+            sequenceStart = result.size();
+        }
+        const Bytecode& code = program[index];
+        if (isKept[index]) {
+            result.push_back(code);
+            resultFirstCodes.resize(result.size(), firstCodes[index]);
+            continue;                                               // CONTINUE
+        }
+
+        const State& state     = states[index];
+        const int    height    = static_cast<int>(state.size());
+        int          numPushes = 0;  // removable codes pushing constants
+        while (numPushes < 2 &&
+               sequenceStart + numPushes < result.size() &&
+               Bytecode::e_Push ==
+                           result[result.size() - 1 - numPushes].opcode()) {
+            ++numPushes;
+        }
+
+        bool isJumping = false;  // whether to emit a jump to the target
+        switch (code.opcode()) {
+          case Bytecode::e_Load: {
+            const Value& value = state[code.data().theInteger()];
+            if (value.d_isConstant) {
+                result.push_back(Bytecode::createOpcode(Bytecode::e_Push,
+                                                        value.d_constant));
+                ++numChanged;
+            }
+            else {
+                result.push_back(code);
+            }
+          } break;
+          case Bytecode::e_AddInts:
+          case Bytecode::e_AddDoubles:
+          case Bytecode::e_EqInts: {
+            const Value& lhs = state[height - 2];
+            const Value& rhs = state[height - 1];
+            Datum        folded;
+            if (2 == numPushes &&
+                lhs.d_isConstant &&
+                rhs.d_isConstant &&
+                fold(&folded,
+                     code.opcode(),
+                     lhs.d_constant,
+                     rhs.d_constant)) {
+                result.resize(result.size() - 2);
+                result.push_back(Bytecode::createOpcode(Bytecode::e_Push,
+                                                        folded));
+                ++numChanged;
+            }
+            else {
+                result.push_back(code);
+            }
+          } break;
+          case Bytecode::e_If:
+          case Bytecode::e_IfEqInts: {
+            const int outcome = branchOutcome(state, code.opcode());
+            if (0 > outcome) {
+                result.push_back(code);
+                break;                                                 // BREAK
+            }
+            const int numOperands = Bytecode::e_If == code.opcode() ? 1 : 2;
+            if (numOperands <= numPushes) {
+                result.resize(result.size() - numOperands);
+            }
+            else {
+                result.push_back(createCode(Bytecode::e_Resize,
+                                            height - numOperands));
+            }
+            isJumping = 1 == outcome;
+            ++numChanged;
+          } break;
+          case Bytecode::e_Jump: {
+            isJumping = true;
+          } break;
+          default: {
+            result.push_back(code);
+          } break;
+        }
+
+        if (isJumping) {
+            // A jump forward over codes that are all removed is itself
+            // removed.
+
+            const int target  = firstCodes[index] + code.data().theInteger();
+            int       between = index + 1;
+            while (between < target &&
+                   !isKept[between] &&
+                   !hasState[between]) {
+                ++between;
+            }
+            if (between == target) {
+                numChanged += Bytecode::e_Jump == code.opcode();
+            }
+            else {
+                result.push_back(createCode(Bytecode::e_Jump,
+                                            code.data().theInteger()));
+            }
+        }
+        resultFirstCodes.resize(result.size(), firstCodes[index]);
+    }
+    newIndices[numCodes] = static_cast<int>(result.size());
+
+    for (bsl::size_t i = 0; i < result.size(); ++i) {
+        Bytecode& code      = result[i];
+        const int firstCode = resultFirstCodes[i];
+        if ((isJump(code.opcode()) || isEntry(code.opcode())) &&
+            code.data().isInteger()) {
+            const int target = firstCode + code.data().theInteger();
+            if (0 <= target && target < numCodes) {
+                code = createCode(code.opcode(),
+                                  newIndices[target] - newIndices[firstCode]);
+            }
+        }
+    }
+
+    codes->swap(result);
+    return numChanged;
+}
+}
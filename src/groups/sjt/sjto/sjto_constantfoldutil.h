@@ -0,0 +1,66 @@
+// sjto_constantfoldutil.h
+
+#ifndef INCLUDED_SJTO_CONSTANTFOLDUTIL
+#define INCLUDED_SJTO_CONSTANTFOLDUTIL
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace sjto {
+
+                          // =======================
+                          // struct ConstantFoldUtil
+                          // =======================
+
+struct ConstantFoldUtil {
+    // This 'struct' provides a namespace for functions that evaluate, before
+    // a program runs, the codes whose operands are constants, and remove the
+    // codes that can never run.
+    //
+    // The values of the slots of each frame are tracked from the entry of
+    // each function through its codes, following only the branches that can
+    // be taken, so that a slot is known to hold a constant at a code if every
+    // path reaching the code leaves the same constant, pushed by 'e_Push',
+    // in it.  Then:
+    //: o An 'e_Load' of a constant becomes an 'e_Push' of it.
+    //:
+    //: o An 'e_AddInts', 'e_AddDoubles' or 'e_EqInts' whose operands are
+    //:   pushed by the two codes before it, which no jump targets, replaces
+    //:   those codes with an 'e_Push' of its result.
+    //:
+    //: o An 'e_If' or 'e_IfEqInts' whose operands are constants becomes an
+    //:   'e_Jump' if the branch is always taken, and nothing otherwise; its
+    //:   operands are removed with the codes pushing them, or else by an
+    //:   'e_Resize'.
+    //:
+    //: o An 'e_Jump' to the code following it is removed.
+    //:
+    //: o Codes that no path from the entry of a function reaches are removed.
+    //
+    // The remaining codes are moved together, and the indices stored by
+    // jumps, branches, calls and 'e_PushCode' are changed to follow them.
+    // The functions of a program are the one beginning at index 0 and the
+    // targets of the 'e_Call', 'e_TailCall' and 'e_PushCode' codes they
+    // reach.  A function that 'SsaUtil' cannot convert to SSA form, or whose
+    // number of arguments is not pushed by an 'e_Push' before each call, is
+    // kept unchanged, as are the codes it reaches.  Note that the ranges of
+    // an 'sjtt::ExceptionTable' do not follow the moved codes, so a program
+    // having exception handlers must not be optimized.
+
+    // CLASS METHODS
+    static int optimize(bsl::vector<sjtt::Bytecode> *codes,
+                        int                          numArguments = 0);
+        // Fold the constants of the specified 'codes', and remove the codes
+        // that cannot be reached, as described above, and return the number
+        // of codes replaced or removed.  Optionally specify 'numArguments',
+        // the largest number of arguments with which the program is
+        // evaluated.  The behavior is undefined unless '0 <= numArguments'.
+};
+}
+
+#endif
@@ -0,0 +1,460 @@
+// sjto_constantfoldutil.t.cpp                                    -*-C++-*-
+
+#include <sjto_constantfoldutil.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode   BC;
+typedef ConstantFoldUtil Util;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+BC push(bool value)
+    // Return an 'e_Push' of the specified boolean 'value'.
+{
+    return BC::createOpcode(BC::e_Push, bdld::Datum::createBoolean(value));
+}
+
+bool isSame(const bsl::vector<BC>& codes, const BC *expected, int numExpected)
+    // Return 'true' if the specified 'codes' are the specified 'numExpected'
+    // codes of the specified 'expected' array, and 'false' otherwise.
+{
+    if (static_cast<int>(codes.size()) != numExpected) {
+        return false;                                                 // RETURN
+    }
+    for (int i = 0; i < numExpected; ++i) {
+        if (!(codes[i] == expected[i])) {
+            return false;                                             // RETURN
+        }
+    }
+    return true;
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "functions kept" << endl
+                          << "==============" << endl;
+
+        // A function that cannot be analyzed is kept unchanged.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 0));                     // 0
+            codes.push_back(code(BC::e_If, 3));                       // 1
+            codes.push_back(code(BC::e_Push, 5));                     // 2
+            codes.push_back(code(BC::e_Push, 1));                     // 3
+            codes.push_back(code(BC::e_Push, 2));                     // 4
+            codes.push_back(code(BC::e_AddInts));                     // 5
+            codes.push_back(code(BC::e_Exit));                        // 6
+            const bsl::vector<BC> ORIGINAL(codes);
+
+            ASSERT(0 == Util::optimize(&codes));
+            ASSERT(ORIGINAL == codes);
+        }
+
+        // So is a function whose number of arguments is not pushed before
+        // its call, while its caller is optimized.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 1));                     // 0
+            codes.push_back(code(BC::e_Store, 1));                    // 1
+            codes.push_back(code(BC::e_Push, 4));                     // 2
+            codes.push_back(code(BC::e_Load, 1));                     // 3
+            codes.push_back(code(BC::e_Call, 6));                     // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+            codes.push_back(code(BC::e_Push, 2));                     // 6
+            codes.push_back(code(BC::e_Push, 3));                     // 7
+            codes.push_back(code(BC::e_AddInts));                     // 8
+            codes.push_back(code(BC::e_Exit));                        // 9
+
+            ASSERT(1 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 1),
+                code(BC::e_Store, 1),
+                code(BC::e_Push, 4),
+                code(BC::e_Push, 1),
+                code(BC::e_Call, 6),
+                code(BC::e_Exit),
+                code(BC::e_Push, 2),
+                code(BC::e_Push, 3),
+                code(BC::e_AddInts),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+
+        // A program reading slots beyond the frame of a call without
+        // arguments is optimized only if it is evaluated with enough
+        // arguments.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 8));                     // 0
+            codes.push_back(code(BC::e_Push, 1));                     // 1
+            codes.push_back(code(BC::e_Push, 2));                     // 2
+            codes.push_back(code(BC::e_AddInts));                     // 3
+            codes.push_back(code(BC::e_Exit));                        // 4
+            const bsl::vector<BC> ORIGINAL(codes);
+
+            ASSERT(0 == Util::optimize(&codes));
+            ASSERT(ORIGINAL == codes);
+
+            ASSERT(1 == Util::optimize(&codes, 9));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Load, 8),
+                code(BC::e_Push, 3),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "branches" << endl
+                          << "========" << endl;
+
+        // A branch always taken becomes a jump, removed if it only skips
+        // codes that are removed.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(push(true));                              // 0
+            codes.push_back(code(BC::e_If, 4));                       // 1
+            codes.push_back(code(BC::e_Push, 1));                     // 2
+            codes.push_back(code(BC::e_Exit));                        // 3
+            codes.push_back(code(BC::e_Push, 2));                     // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+
+            ASSERT(3 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 2),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+
+        // A branch never taken is removed with its folded condition.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 1));                     // 0
+            codes.push_back(code(BC::e_Push, 2));                     // 1
+            codes.push_back(code(BC::e_EqInts));                      // 2
+            codes.push_back(code(BC::e_If, 6));                       // 3
+            codes.push_back(code(BC::e_Push, 3));                     // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+            codes.push_back(code(BC::e_Push, 4));                     // 6
+            codes.push_back(code(BC::e_Exit));                        // 7
+
+            ASSERT(4 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 3),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+
+        // Calls and code values refer to the moved codes.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 3));                     // 0
+            codes.push_back(code(BC::e_Push, 3));                     // 1
+            codes.push_back(code(BC::e_IfEqInts, 5));                 // 2
+            codes.push_back(code(BC::e_Push, 0));                     // 3
+            codes.push_back(code(BC::e_Exit));                        // 4
+            codes.push_back(code(BC::e_Push, 7));                     // 5
+            codes.push_back(code(BC::e_Push, 1));                     // 6
+            codes.push_back(code(BC::e_Call, 9));                     // 7
+            codes.push_back(code(BC::e_Exit));                        // 8
+            codes.push_back(code(BC::e_Load, 0));                     // 9
+            codes.push_back(code(BC::e_Exit));                        // 10
+
+            ASSERT(3 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 7),
+                code(BC::e_Push, 1),
+                code(BC::e_Call, 4),
+                code(BC::e_Exit),
+                code(BC::e_Load, 0),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(push(true));                              // 0
+            codes.push_back(code(BC::e_If, 4));                       // 1
+            codes.push_back(code(BC::e_Push, 9));                     // 2
+            codes.push_back(code(BC::e_Exit));                        // 3
+            codes.push_back(code(BC::e_PushCode, 8));                 // 4
+            codes.push_back(code(BC::e_Push, 0));                     // 5
+            codes.push_back(code(BC::e_CallValue));                   // 6
+            codes.push_back(code(BC::e_Exit));                        // 7
+            codes.push_back(code(BC::e_Push, 6));                     // 8
+            codes.push_back(code(BC::e_Exit));                        // 9
+
+            ASSERT(3 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_PushCode, 4),
+                code(BC::e_Push, 0),
+                code(BC::e_CallValue),
+                code(BC::e_Exit),
+                code(BC::e_Push, 6),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+
+        // A function called through a code value stores indices relative to
+        // its first code, which remain so as codes move.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(push(true));                              //  0
+            codes.push_back(code(BC::e_If, 4));                       //  1
+            codes.push_back(code(BC::e_Push, 9));                     //  2
+            codes.push_back(code(BC::e_Exit));                        //  3
+            codes.push_back(code(BC::e_PushCode, 8));                 //  4
+            codes.push_back(code(BC::e_Push, 0));                     //  5
+            codes.push_back(code(BC::e_CallValue));                   //  6
+            codes.push_back(code(BC::e_Exit));                        //  7
+            codes.push_back(code(BC::e_Push, 1));                     //  8
+            codes.push_back(code(BC::e_Push, 2));                     //  9
+            codes.push_back(code(BC::e_AddInts));                     // 10
+            codes.push_back(code(BC::e_Load, 0));                     // 11
+            codes.push_back(code(BC::e_If, 6));                       // 12
+            codes.push_back(code(BC::e_Exit));                        // 13
+            codes.push_back(code(BC::e_Push, 4));                     // 14
+            codes.push_back(code(BC::e_Exit));                        // 15
+
+            ASSERT(4 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_PushCode, 4),
+                code(BC::e_Push, 0),
+                code(BC::e_CallValue),
+                code(BC::e_Exit),
+                code(BC::e_Push, 3),
+                code(BC::e_Load, 0),
+                code(BC::e_If, 4),
+                code(BC::e_Exit),
+                code(BC::e_Push, 4),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "propagation" << endl
+                          << "===========" << endl;
+
+        // Constants stored in slots are propagated to the loads of the slots,
+        // which may then be folded.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 2));                     // 0
+            codes.push_back(code(BC::e_Store, 1));                    // 1
+            codes.push_back(code(BC::e_Load, 1));                     // 2
+            codes.push_back(code(BC::e_Load, 1));                     // 3
+            codes.push_back(code(BC::e_AddInts));                     // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+
+            ASSERT(3 == Util::optimize(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 2),
+                code(BC::e_Store, 1),
+                code(BC::e_Push, 4),
+                code(BC::e_Exit),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+
+        // In a loop, a slot is a constant only if it is the same on every
+        // iteration: slot 2 is, slot 1 is not, and the exit of the loop,
+        // never taken on the first iteration, is taken on later ones.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 0));                     //  0
+            codes.push_back(code(BC::e_Store, 1));                    //  1
+            codes.push_back(code(BC::e_Push, 5));                     //  2
+            codes.push_back(code(BC::e_Store, 2));                    //  3
+            codes.push_back(code(BC::e_Load, 1));                     //  4
+            codes.push_back(code(BC::e_Load, 2));                     //  5
+            codes.push_back(code(BC::e_AddInts));                     //  6
+            codes.push_back(code(BC::e_Store, 1));                    //  7
+            codes.push_back(code(BC::e_Load, 1));                     //  8
+            codes.push_back(code(BC::e_Push, 50));                    //  9
+            codes.push_back(code(BC::e_IfEqInts, 12));                // 10
+            codes.push_back(code(BC::e_Jump, 4));                     // 11
+            codes.push_back(code(BC::e_Load, 1));                     // 12
+            codes.push_back(code(BC::e_Exit));                        // 13
+            bsl::vector<BC> expected(codes);
+            expected[5] = code(BC::e_Push, 5);
+
+            ASSERT(1 == Util::optimize(&codes));
+            ASSERT(expected == codes);
+        }
+
+        // A slot incremented from a constant holds a constant.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 3));                     // 0
+            codes.push_back(code(BC::e_Store, 0));                    // 1
+            codes.push_back(code(BC::e_IncInt, 0));                   // 2
+            codes.push_back(code(BC::e_Load, 0));                     // 3
+            codes.push_back(code(BC::e_Exit));                        // 4
+
+            ASSERT(1 == Util::optimize(&codes));
+            ASSERT(code(BC::e_Push, 4) == codes[3]);
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        // An operation on constants pushed before it becomes a push of its
+        // result.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Push, 3));
+        codes.push_back(code(BC::e_Push, 4));
+        codes.push_back(code(BC::e_AddInts));
+        codes.push_back(code(BC::e_Exit));
+
+        ASSERT(1 == Util::optimize(&codes));
+
+        const BC EXPECTED[] = {
+            code(BC::e_Push, 7),
+            code(BC::e_Exit),
+        };
+        const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+        ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+
+        // A program without constants to fold is unchanged.
+
+        const bsl::vector<BC> FOLDED(codes);
+        ASSERT(0 == Util::optimize(&codes));
+        ASSERT(FOLDED == codes);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
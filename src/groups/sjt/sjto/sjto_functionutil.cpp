@@ -0,0 +1,328 @@
+// sjto_functionutil.cpp
+#include <sjto_functionutil.h>
+
+#include <sjto_ssafunction.h>
+#include <sjto_ssautil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_string.h>
+#include <bsl_utility.h>
+
+#include <bsls_assert.h>
+
+namespace sjto {
+namespace {
+
+typedef sjtt::Bytecode Bytecode;
+
+bool isEntry(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // the index of the first code of a function, and 'false' otherwise.
+{
+    return Bytecode::e_Call     == opcode ||
+           Bytecode::e_TailCall == opcode ||
+           Bytecode::e_PushCode == opcode;
+}
+
+int pushedCount(const bsl::vector<Bytecode>& codes, int call)
+    // Return the number of arguments pushed by the code before the call at
+    // the specified 'call' index of the specified 'codes', or -1 if that
+    // code is not an 'e_Push' of a non-negative integer.
+{
+    if (0 == call) {
+        return -1;                                                    // RETURN
+    }
+    const Bytecode& count = codes[call - 1];
+    return Bytecode::e_Push == count.opcode() &&
+           count.data().isInteger() &&
+           0 <= count.data().theInteger()
+           ? count.data().theInteger()
+           : -1;
+}
+
+void unsetHeights(bsl::vector<int>             *heights,
+                  const bsl::vector<Bytecode>&  codes,
+                  const bsl::vector<int>&       firstCodes,
+                  int                           entry)
+    // Set to -1 the elements of the specified 'heights' for the codes among
+    // the specified 'codes', evaluated by frames beginning at the specified
+    // 'firstCodes', reachable from the specified 'entry' index by jumps,
+    // branches and falling through.
+{
+    const int         numCodes = static_cast<int>(codes.size());
+    bsl::vector<char> isVisited(numCodes, false);
+    bsl::vector<int>  pending(1, entry);
+    while (!pending.empty()) {
+        const int index = pending.back();
+        pending.pop_back();
+        if (0 > index || numCodes <= index || isVisited[index]) {
+            continue;                                               // CONTINUE
+        }
+        isVisited[index] = true;
+        (*heights)[index] = -1;
+
+        const Bytecode& code = codes[index];
+        if ((Bytecode::e_Jump     == code.opcode() ||
+             Bytecode::e_If       == code.opcode() ||
+             Bytecode::e_IfEqInts == code.opcode()) &&
+            code.data().isInteger()) {
+            pending.push_back(firstCodes[index] + code.data().theInteger());
+        }
+        if (Bytecode::e_Jump     != code.opcode() &&
+            Bytecode::e_Exit     != code.opcode() &&
+            Bytecode::e_TailCall != code.opcode() &&
+            Bytecode::e_Throw    != code.opcode()) {
+            pending.push_back(index + 1);
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+                            // -------------------
+                            // struct FunctionUtil
+                            // -------------------
+
+// CLASS METHODS
+void FunctionUtil::findEntries(bsl::vector<int>                   *result,
+                               const bsl::vector<sjtt::Bytecode>&  codes,
+                               const bsl::vector<int>&             firstCodes)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(codes.size() == firstCodes.size());
+
+    const int         numCodes = static_cast<int>(codes.size());
+    bsl::vector<char> isFound(numCodes, false);
+    result->clear();
+    if (0 < numCodes) {
+        isFound[0] = true;
+        result->push_back(0);
+    }
+    for (int index = 0; index < numCodes; ++index) {
+        const Bytecode& code = codes[index];
+        if (0 > firstCodes[index] ||
+            !isEntry(code.opcode()) ||
+            !code.data().isInteger()) {
+            continue;                                               // CONTINUE
+        }
+        const int entry = firstCodes[index] + code.data().theInteger();
+        if (0 <= entry && entry < numCodes && !isFound[entry]) {
+            isFound[entry] = true;
+            result->push_back(entry);
+        }
+    }
+}
+
+int FunctionUtil::findFirstCodes(bsl::vector<int>                   *result,
+                                 const bsl::vector<sjtt::Bytecode>&  codes)
+{
+    BSLS_ASSERT(0 != result);
+
+    typedef sjtt::Bytecode      BC;
+    typedef bsl::pair<int, int> Pending;  // index and its first code
+
+    const int numCodes = static_cast<int>(codes.size());
+    result->assign(numCodes, -1);
+
+    bsl::vector<Pending> pending;
+    if (0 < numCodes) {
+        pending.push_back(Pending(0, 0));
+    }
+    while (!pending.empty()) {
+        const int index     = pending.back().first;
+        const int firstCode = pending.back().second;
+        pending.pop_back();
+        if (0 > index || numCodes <= index) {
+            continue;                                               // CONTINUE
+        }
+        if (0 <= (*result)[index]) {
+            if (firstCode != (*result)[index]) {
+                return 1;                                             // RETURN
+            }
+            continue;                                               // CONTINUE
+        }
+        (*result)[index] = firstCode;
+
+        const BC&  code   = codes[index];
+        const int  target = code.data().isInteger()
+                            ? firstCode + code.data().theInteger()
+                            : -1;
+        switch (code.opcode()) {
+          case BC::e_Jump:
+          case BC::e_If:
+          case BC::e_IfEqInts:
+          case BC::e_Call:
+          case BC::e_TailCall: {
+            pending.push_back(Pending(target, firstCode));
+          } break;
+          case BC::e_PushCode: {
+            pending.push_back(Pending(target, target));
+          } break;
+          default: {
+          } break;
+        }
+        if (BC::e_Jump     != code.opcode() &&
+            BC::e_Exit     != code.opcode() &&
+            BC::e_TailCall != code.opcode() &&
+            BC::e_Throw    != code.opcode()) {
+            pending.push_back(Pending(index + 1, firstCode));
+        }
+    }
+    return 0;
+}
+
+void FunctionUtil::findHeights(
+                         bsl::vector<int>                   *result,
+                         const bsl::vector<sjtt::Bytecode>&  codes,
+                         const bsl::vector<int>&             firstCodes,
+                         int                                 numArguments)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(codes.size() == firstCodes.size());
+    BSLS_ASSERT(0 <= numArguments);
+
+    const int        numCodes = static_cast<int>(codes.size());
+    bsl::vector<int> entries;
+    findEntries(&entries, codes, firstCodes);
+    result->assign(numCodes, -1);
+
+    // Find the largest number of arguments each function is called with.  A
+    // function called as a code value takes the largest number of arguments
+    // of any 'e_CallValue'.
+
+    bsl::vector<int> arities(numCodes, 0);  // per entry, or -1 if unknown
+    int              valueArity = 0;
+    for (int index = 0; index < numCodes; ++index) {
+        if (Bytecode::e_CallValue == codes[index].opcode() &&
+            0 <= firstCodes[index] &&
+            0 <= valueArity) {
+            const int count = pushedCount(codes, index);
+            valueArity = 0 <= count ? bsl::max(valueArity, count) : -1;
+        }
+    }
+    if (0 < numCodes) {
+        arities[0] = numArguments;
+    }
+    for (int index = 0; index < numCodes; ++index) {
+        const Bytecode& code = codes[index];
+        if (0 > firstCodes[index] ||
+            !isEntry(code.opcode()) ||
+            !code.data().isInteger()) {
+            continue;                                               // CONTINUE
+        }
+        const int entry = firstCodes[index] + code.data().theInteger();
+        if (0 > entry || numCodes <= entry || 0 > arities[entry]) {
+            continue;                                               // CONTINUE
+        }
+        const int count = Bytecode::e_PushCode == code.opcode()
+                          ? valueArity
+                          : pushedCount(codes, index);
+        arities[entry] = 0 <= count ? bsl::max(arities[entry], count) : -1;
+    }
+
+    // Analyze each function, then forget the heights of the codes reached by
+    // a function that cannot be analyzed or that conflicts with another.
+
+    bsl::vector<bsl::vector<int> > functionHeights(entries.size());
+    bsl::vector<char>              isConflict(numCodes, false);
+    for (bsl::size_t e = 0; e < entries.size(); ++e) {
+        // The targets stored by a function are indices in the codes from
+        // the first code of its frames.
+
+        const int                   entry     = entries[e];
+        const int                   firstCode = firstCodes[entry];
+        const bsl::vector<Bytecode> view(codes.begin() + firstCode,
+                                         codes.end());
+        SsaFunction                 function;
+        bsl::string                 errorMessage;
+        bsl::vector<int>            viewHeights;
+        if (0 > arities[entry] ||
+            0 != SsaUtil::build(&function,
+                                &errorMessage,
+                                view,
+                                entry - firstCode,
+                                arities[entry],
+                                &viewHeights)) {
+            continue;                                               // CONTINUE
+        }
+        functionHeights[e].assign(firstCode, -1);
+        functionHeights[e].insert(functionHeights[e].end(),
+                                  viewHeights.begin(),
+                                  viewHeights.end());
+        for (int index = 0; index < numCodes; ++index) {
+            const int height = functionHeights[e][index];
+            if (0 > height) {
+                continue;                                           // CONTINUE
+            }
+            if (0 > (*result)[index]) {
+                (*result)[index] = height;
+            }
+            else if (height != (*result)[index]) {
+                isConflict[index] = true;
+            }
+        }
+    }
+    for (bsl::size_t e = 0; e < entries.size(); ++e) {
+        bool isAnalyzed = !functionHeights[e].empty();
+        for (int index = 0; isAnalyzed && index < numCodes; ++index) {
+            isAnalyzed = 0 > functionHeights[e][index] || !isConflict[index];
+        }
+        if (!isAnalyzed) {
+            unsetHeights(result, codes, firstCodes, entries[e]);
+        }
+    }
+}
+
+int FunctionUtil::findNumCodes(const sjtt::Bytecode *codes)
+{
+    BSLS_ASSERT(0 != codes);
+
+    typedef bsl::pair<int, int> Pending;  // index and its first code
+
+    bsl::vector<char>    isVisited;
+    bsl::vector<Pending> pending(1, Pending(0, 0));
+    int                  numCodes = 0;
+    while (!pending.empty()) {
+        const int index     = pending.back().first;
+        const int firstCode = pending.back().second;
+        pending.pop_back();
+        if (0 > index) {
+            continue;                                               // CONTINUE
+        }
+        if (static_cast<int>(isVisited.size()) <= index) {
+            isVisited.resize(index + 1, false);
+        }
+        if (isVisited[index]) {
+            continue;                                               // CONTINUE
+        }
+        isVisited[index] = true;
+        numCodes         = bsl::max(numCodes, index + 1);
+
+        const Bytecode& code   = codes[index];
+        const int       target = code.data().isInteger()
+                                 ? firstCode + code.data().theInteger()
+                                 : -1;
+        switch (code.opcode()) {
+          case Bytecode::e_Jump:
+          case Bytecode::e_If:
+          case Bytecode::e_IfEqInts:
+          case Bytecode::e_Call:
+          case Bytecode::e_TailCall: {
+            pending.push_back(Pending(target, firstCode));
+          } break;
+          case Bytecode::e_PushCode: {
+            pending.push_back(Pending(target, target));
+          } break;
+          default: {
+          } break;
+        }
+        if (Bytecode::e_Jump     != code.opcode() &&
+            Bytecode::e_Exit     != code.opcode() &&
+            Bytecode::e_TailCall != code.opcode() &&
+            Bytecode::e_Throw    != code.opcode()) {
+            pending.push_back(Pending(index + 1, firstCode));
+        }
+    }
+    return numCodes;
+}
+}
@@ -0,0 +1,82 @@
+// sjto_functionutil.h
+
+#ifndef INCLUDED_SJTO_FUNCTIONUTIL
+#define INCLUDED_SJTO_FUNCTIONUTIL
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace sjto {
+
+                            // ===================
+                            // struct FunctionUtil
+                            // ===================
+
+struct FunctionUtil {
+    // This 'struct' provides a namespace for functions that find the
+    // functions of a program of Scramjet bytecode.
+    //
+    // The indices stored by jumps, branches, calls and 'e_PushCode' are
+    // relative to the first code of the frame evaluating them (see
+    // 'sjtt::Frame::firstCode'): index 0 of the program for the function
+    // evaluated first, and for the functions it calls; and the first code of
+    // a function called through a code value for that function, and for the
+    // functions it calls.  A pass that moves codes, or reads the code an
+    // index refers to, must therefore know the first code of the frames
+    // evaluating each code.
+
+    // CLASS METHODS
+    static void findEntries(bsl::vector<int>                   *result,
+                            const bsl::vector<sjtt::Bytecode>&  codes,
+                            const bsl::vector<int>&             firstCodes);
+        // Load into the specified 'result' the indices of the first codes of
+        // the functions of the specified 'codes', whose frames begin at the
+        // specified 'firstCodes': index 0, if 'codes' is not empty, followed
+        // by the targets of the 'e_Call', 'e_TailCall' and 'e_PushCode' codes
+        // that are reached, each once, in the order of the codes targeting
+        // them.  The behavior is undefined unless 'firstCodes' was loaded by
+        // 'findFirstCodes' from 'codes'.
+
+    static int findFirstCodes(bsl::vector<int>                   *result,
+                              const bsl::vector<sjtt::Bytecode>&  codes);
+        // Load into the specified 'result' one element per code of the
+        // specified 'codes': the index of the first code of the frames
+        // evaluating it, or -1 if no path from index 0, following jumps,
+        // branches, falling through, calls, and 'e_PushCode', reaches it.
+        // Return 0 on success, and a non-zero value if a code is reached by
+        // frames having different first codes, in which case the state of
+        // 'result' is unspecified.
+
+    static void findHeights(bsl::vector<int>                   *result,
+                            const bsl::vector<sjtt::Bytecode>&  codes,
+                            const bsl::vector<int>&             firstCodes,
+                            int                                 numArguments);
+        // Load into the specified 'result' one element per code of the
+        // specified 'codes', whose frames begin at the specified
+        // 'firstCodes': the number of values in the frame before the code is
+        // evaluated, as found by 'SsaUtil::build' for each function, or -1 if
+        // it is not known.  The function at index 0 is evaluated with the
+        // specified 'numArguments', and every other one with the largest
+        // number of arguments pushed by an 'e_Push' before a call to it.  The
+        // height of every code reached by a function that 'SsaUtil' cannot
+        // analyze, that is called with a number of arguments not so pushed,
+        // or that reaches a code also reached at a different height, is not
+        // known.  The behavior is undefined unless 'firstCodes' was loaded by
+        // 'findFirstCodes' from 'codes', and '0 <= numArguments'.
+
+    static int findNumCodes(const sjtt::Bytecode *codes);
+        // Return one more than the largest index of the specified 'codes'
+        // reached from index 0 as by 'findFirstCodes', i.e., the length of
+        // the program beginning at 'codes' if it ends with a reachable code.
+        // The behavior is undefined unless every path from index 0 ends in
+        // an 'e_Exit', 'e_TailCall', 'e_Throw' or 'e_Jump', and reaches only
+        // valid indices.
+};
+}
+
+#endif
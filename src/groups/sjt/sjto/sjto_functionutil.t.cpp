@@ -0,0 +1,289 @@
+// sjto_functionutil.t.cpp                                        -*-C++-*-
+
+#include <sjto_functionutil.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+typedef FunctionUtil   Util;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "'findNumCodes'" << endl
+                          << "==============" << endl;
+
+        // The length of a program is found from its reachable codes, so
+        // codes following them are not counted.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_PushCode, 4));                     //  0
+        codes.push_back(code(BC::e_Push, 0));                         //  1
+        codes.push_back(code(BC::e_CallValue));                       //  2
+        codes.push_back(code(BC::e_Exit));                            //  3
+        codes.push_back(code(BC::e_Push, 1));                         //  4
+        codes.push_back(code(BC::e_Push, 1));                         //  5
+        codes.push_back(code(BC::e_Call, 4));                         //  6
+        codes.push_back(code(BC::e_Exit));                            //  7
+        codes.push_back(code(BC::e_Load, 0));                         //  8
+        codes.push_back(code(BC::e_Exit));                            //  9
+        codes.push_back(code(BC::e_Exit));                            // 10
+
+        ASSERT(10 == Util::findNumCodes(codes.data()));
+        ASSERT( 6 == Util::findNumCodes(codes.data() + 4));
+
+        // The function called through the code value is not counted once it
+        // is no longer reached.
+
+        codes[0] = code(BC::e_Push, 0);
+        ASSERT( 4 == Util::findNumCodes(codes.data()));
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "'findEntries' and 'findHeights'" << endl
+                          << "===============================" << endl;
+
+        // The heights of a function called as a code value are those of its
+        // codes in the frame it creates, padded as for a call.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_PushCode, 5));                 //  0
+            codes.push_back(code(BC::e_Push, 0));                     //  1
+            codes.push_back(code(BC::e_CallValue));                   //  2
+            codes.push_back(code(BC::e_Exit));                        //  3
+            codes.push_back(code(BC::e_Exit));                        //  4
+            codes.push_back(code(BC::e_Push, 1));                     //  5
+            codes.push_back(code(BC::e_Push, 1));                     //  6
+            codes.push_back(code(BC::e_Call, 4));                     //  7
+            codes.push_back(code(BC::e_Exit));                        //  8
+            codes.push_back(code(BC::e_Load, 0));                     //  9
+            codes.push_back(code(BC::e_Exit));                        // 10
+
+            bsl::vector<int> firstCodes;
+            ASSERT(0 == Util::findFirstCodes(&firstCodes, codes));
+
+            bsl::vector<int> entries;
+            Util::findEntries(&entries, codes, firstCodes);
+
+            ASSERTV(entries.size(), 3 == entries.size());
+            ASSERT(0 == entries[0]);
+            ASSERT(5 == entries[1]);
+            ASSERT(9 == entries[2]);
+
+            bsl::vector<int> heights;
+            Util::findHeights(&heights, codes, firstCodes, 0);
+
+            const int EXPECTED[] = { 8, 9, 10, 9, -1, 8, 9, 10, 9, 8, 9 };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERTV(heights.size(),
+                    NUM_EXPECTED == static_cast<int>(heights.size()));
+            for (int i = 0;
+                 i < NUM_EXPECTED && i < static_cast<int>(heights.size());
+                 ++i) {
+                ASSERTV(i, heights[i], EXPECTED[i] == heights[i]);
+            }
+        }
+
+        // The heights of a function whose number of arguments is not pushed
+        // before its call are not known, nor are those of the codes it
+        // shares with its caller; the heights of the other codes are.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 0));                     //  0
+            codes.push_back(code(BC::e_Store, 1));                    //  1
+            codes.push_back(code(BC::e_Load, 1));                     //  2
+            codes.push_back(code(BC::e_Call, 6));                     //  3
+            codes.push_back(code(BC::e_Push, 2));                     //  4
+            codes.push_back(code(BC::e_Exit));                        //  5
+            codes.push_back(code(BC::e_Push, 1));                     //  6
+            codes.push_back(code(BC::e_Jump, 5));                     //  7
+
+            bsl::vector<int> firstCodes;
+            ASSERT(0 == Util::findFirstCodes(&firstCodes, codes));
+
+            bsl::vector<int> heights;
+            Util::findHeights(&heights, codes, firstCodes, 0);
+
+            const int EXPECTED[] = { 8, 9, 8, 9, 9, -1, -1, -1 };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERTV(heights.size(),
+                    NUM_EXPECTED == static_cast<int>(heights.size()));
+            for (int i = 0;
+                 i < NUM_EXPECTED && i < static_cast<int>(heights.size());
+                 ++i) {
+                ASSERTV(i, heights[i], EXPECTED[i] == heights[i]);
+            }
+        }
+
+        // The heights of a function making a call whose number of arguments
+        // is not a constant are not known, as 'SsaUtil' cannot analyze it.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 0));                     //  0
+            codes.push_back(code(BC::e_Call, 4));                     //  1
+            codes.push_back(code(BC::e_Push, 2));                     //  2
+            codes.push_back(code(BC::e_Exit));                        //  3
+            codes.push_back(code(BC::e_Push, 1));                     //  4
+            codes.push_back(code(BC::e_Jump, 3));                     //  5
+
+            bsl::vector<int> firstCodes;
+            ASSERT(0 == Util::findFirstCodes(&firstCodes, codes));
+
+            bsl::vector<int> heights;
+            Util::findHeights(&heights, codes, firstCodes, 0);
+
+            ASSERTV(heights.size(), 6 == static_cast<int>(heights.size()));
+            for (int i = 0; i < static_cast<int>(heights.size()); ++i) {
+                ASSERTV(i, heights[i], -1 == heights[i]);
+            }
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "frames having different first codes" << endl
+                          << "===================================" << endl;
+
+        // A code both called as a code value and reached from index 0 cannot
+        // be given a first code.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_PushCode, 3));                     // 0
+        codes.push_back(code(BC::e_Push, 0));                         // 1
+        codes.push_back(code(BC::e_CallValue));                       // 2
+        codes.push_back(code(BC::e_Push, 1));                         // 3
+        codes.push_back(code(BC::e_Exit));                            // 4
+
+        bsl::vector<int> firstCodes;
+        ASSERT(0 != Util::findFirstCodes(&firstCodes, codes));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        // The function called through the code value at index 5, and the
+        // function it calls, store indices relative to index 5.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_PushCode, 5));                     //  0
+        codes.push_back(code(BC::e_Push, 0));                         //  1
+        codes.push_back(code(BC::e_CallValue));                       //  2
+        codes.push_back(code(BC::e_Exit));                            //  3
+        codes.push_back(code(BC::e_Exit));                            //  4
+        codes.push_back(code(BC::e_Push, 1));                         //  5
+        codes.push_back(code(BC::e_Push, 1));                         //  6
+        codes.push_back(code(BC::e_Call, 4));                         //  7
+        codes.push_back(code(BC::e_Exit));                            //  8
+        codes.push_back(code(BC::e_Load, 0));                         //  9
+        codes.push_back(code(BC::e_Exit));                            // 10
+
+        bsl::vector<int> firstCodes;
+        ASSERT(0 == Util::findFirstCodes(&firstCodes, codes));
+
+        const int EXPECTED[] = { 0, 0, 0, 0, -1, 5, 5, 5, 5, 5, 5 };
+        const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+        ASSERTV(firstCodes.size(), NUM_EXPECTED == firstCodes.size());
+        for (int i = 0;
+             i < NUM_EXPECTED && i < static_cast<int>(firstCodes.size());
+             ++i) {
+            ASSERTV(i, firstCodes[i], EXPECTED[i] == firstCodes[i]);
+        }
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
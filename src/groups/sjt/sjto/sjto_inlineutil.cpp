@@ -0,0 +1,310 @@
+// sjto_inlineutil.cpp
+#include <sjto_inlineutil.h>
+
+#include <sjto_functionutil.h>
+#include <sjto_ssafunction.h>
+#include <sjto_ssautil.h>
+
+#include <bdld_datum.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_string.h>
+
+#include <bsls_assert.h>
+
+namespace sjto {
+namespace {
+
+using BloombergLP::bdld::Datum;
+
+typedef sjtt::Bytecode Bytecode;
+
+const int k_UNKNOWN  = -1;  // no function reaches the code
+const int k_CONFLICT = -2;  // functions reach the code at different heights
+
+bool isTarget(const Bytecode& code, int numCodes)
+    // Return 'true' if the data of the specified 'code' is the index of one of
+    // 'numCodes' codes, and 'false' otherwise.
+{
+    return code.data().isInteger() &&
+           0 <= code.data().theInteger() &&
+           code.data().theInteger() < numCodes;
+}
+
+bool isJump(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // the index of a code of the same function, and 'false' otherwise.
+{
+    return Bytecode::e_Jump     == opcode ||
+           Bytecode::e_If       == opcode ||
+           Bytecode::e_IfEqInts == opcode;
+}
+
+bool isSlotAccess(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // relative to the bottom of the frame, and 'false' otherwise.
+{
+    return Bytecode::e_Load   == opcode ||
+           Bytecode::e_Store  == opcode ||
+           Bytecode::e_IncInt == opcode ||
+           Bytecode::e_Resize == opcode;
+}
+
+Bytecode createCode(Bytecode::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return Bytecode::createOpcode(opcode, Datum::createInteger(data));
+}
+
+struct Function {
+    // This 'struct' describes one function of the program.
+
+    bool             d_isAnalyzed;  // 'SsaUtil::build' succeeded
+    bool             d_isRecursive; // calls itself
+    bool             d_isSupported; // neither tail calls nor captured values
+    int              d_size;        // number of reachable codes
+    bsl::vector<int> d_heights;     // per code, from 'SsaUtil::build'
+};
+
+}  // close unnamed namespace
+
+                             // -----------------
+                             // struct InlineUtil
+                             // -----------------
+
+// CLASS METHODS
+int InlineUtil::inlineCalls(bsl::vector<sjtt::Bytecode> *codes,
+                            bsl::vector<Site>           *sites,
+                            int                          maxCalleeSize,
+                            sjtt::DeoptTable            *points)
+{
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= maxCalleeSize);
+
+    const int numCodes = static_cast<int>(codes->size());
+
+    // Find the call sites, the functions, and the largest number of arguments
+    // each function is called with, among the codes evaluated by frames
+    // beginning at index 0, whose indices the copies may use as they are.
+
+    bsl::vector<int> firstCodes;
+    if (0 != FunctionUtil::findFirstCodes(&firstCodes, *codes)) {
+        return 0;                                                     // RETURN
+    }
+
+    bsl::vector<int> calls;
+    bsl::vector<int> numArguments(numCodes, -1);
+    if (0 < numCodes) {
+        numArguments[0] = 0;
+    }
+    for (int i = 0; i < numCodes; ++i) {
+        const Bytecode& code = (*codes)[i];
+        if (0 != firstCodes[i] ||
+            (Bytecode::e_Call     != code.opcode() &&
+             Bytecode::e_TailCall != code.opcode()) ||
+            !isTarget(code, numCodes)) {
+            continue;                                               // CONTINUE
+        }
+        const int callee = code.data().theInteger();
+        numArguments[callee] = bsl::max(numArguments[callee], 0);
+
+        const Bytecode *count = 0 < i ? &(*codes)[i - 1] : 0;
+        if (Bytecode::e_Call == code.opcode() &&
+            0 != count &&
+            Bytecode::e_Push == count->opcode() &&
+            count->data().isInteger() &&
+            0 <= count->data().theInteger()) {
+            calls.push_back(i);
+            numArguments[callee] = bsl::max(numArguments[callee],
+                                            count->data().theInteger());
+        }
+    }
+
+    // Analyze each function, merging the heights at which they reach each
+    // code.
+
+    bsl::vector<Function> functions(numCodes);
+    bsl::vector<int>      heights(numCodes, k_UNKNOWN);
+    for (int entry = 0; entry < numCodes; ++entry) {
+        if (0 > numArguments[entry]) {
+            continue;                                               // CONTINUE
+        }
+        Function&   function = functions[entry];
+        SsaFunction ssa;
+        bsl::string errorMessage;
+        function.d_isAnalyzed = 0 == SsaUtil::build(&ssa,
+                                                    &errorMessage,
+                                                    *codes,
+                                                    entry,
+                                                    numArguments[entry],
+                                                    &function.d_heights);
+        if (!function.d_isAnalyzed) {
+            continue;                                               // CONTINUE
+        }
+        function.d_isRecursive = false;
+        function.d_isSupported = true;
+        function.d_size        = 0;
+        for (int k = 0; k < numCodes; ++k) {
+            const int height = function.d_heights[k];
+            if (0 > height) {
+                continue;                                           // CONTINUE
+            }
+            ++function.d_size;
+            if (k_UNKNOWN == heights[k]) {
+                heights[k] = height;
+            }
+            else if (height != heights[k]) {
+                heights[k] = k_CONFLICT;
+            }
+
+            const Bytecode& code = (*codes)[k];
+            if (Bytecode::e_TailCall     == code.opcode() ||
+                Bytecode::e_LoadCaptured == code.opcode()) {
+                function.d_isSupported = false;
+            }
+            if (Bytecode::e_Call == code.opcode() &&
+                code.data().isInteger() &&
+                entry == code.data().theInteger()) {
+                function.d_isRecursive = true;
+            }
+        }
+    }
+
+    // Inline each site whose callee qualifies, copying the codes as they were
+    // before any site was inlined.
+
+    const bsl::vector<sjtt::Bytecode> original(*codes);
+    int                               numInlined = 0;
+    for (bsl::size_t s = 0; s < calls.size(); ++s) {
+        const int       call     = calls[s];
+        const int       callee   = (*codes)[call].data().theInteger();
+        const Function& function = functions[callee];
+
+        Site site = { call, callee, -1, e_Unsupported, -1 };
+        if (function.d_isAnalyzed) {
+            site.d_size = function.d_size;
+            if (function.d_isRecursive) {
+                site.d_status = e_Recursive;
+            }
+            else if (!function.d_isSupported) {
+                site.d_status = e_Unsupported;
+            }
+            else if (maxCalleeSize < function.d_size) {
+                site.d_status = e_TooLarge;
+            }
+            else if (0 > heights[call - 1]) {
+                site.d_status = e_UnknownHeight;
+            }
+            else {
+                site.d_status = e_Inlined;
+            }
+        }
+        if (e_Inlined != site.d_status) {
+            if (sites) {
+                sites->push_back(site);
+            }
+            continue;                                               // CONTINUE
+        }
+
+        // The frame of the callee begins at 'base', the height of the caller
+        // below the arguments, and is padded as 'e_Call' would pad it.
+
+        const int n    = original[call - 1].data().theInteger();
+        const int base = heights[call - 1] - n;
+        BSLS_ASSERT(0 <= base);
+
+        site.d_copy = static_cast<int>(codes->size());
+        codes->push_back(createCode(
+                    Bytecode::e_Resize,
+                    base + bsl::max(n, Bytecode::s_MinInitialStackSize)));
+
+        // Lay out the copy, so that jumps forward can be resolved, beginning
+        // with a jump to the first code of the callee if another of its codes
+        // precedes it.
+
+        int first = 0;
+        while (0 > function.d_heights[first]) {
+            ++first;
+        }
+        bsl::vector<int> positions(numCodes, -1);
+        int              position = site.d_copy + 1 + (callee != first);
+        for (int k = first; k < numCodes; ++k) {
+            const int height = function.d_heights[k];
+            if (0 > height) {
+                continue;                                           // CONTINUE
+            }
+            positions[k] = position;
+            if (Bytecode::e_Exit == original[k].opcode()) {
+                position += 1 == height ? 1 : 3;
+            }
+            else {
+                ++position;
+            }
+        }
+        if (callee != first) {
+            codes->push_back(createCode(Bytecode::e_Jump, positions[callee]));
+        }
+
+        // Before the padding, the caller is about to push the number of
+        // arguments; after it, and before each code copied, the callee is
+        // about to evaluate that code; and once a result is stored, the
+        // caller is about to evaluate the code following the call.
+
+        typedef sjtt::DeoptTable::FrameState FrameState;
+
+        FrameState states[2] = { { 0, call - 1, 0 }, { 0, callee, base } };
+        if (points) {
+            points->addPoint(site.d_copy, states, 1);
+            states[0].d_pc = call;
+            if (callee != first) {
+                points->addPoint(site.d_copy + 1, states, 2);
+            }
+        }
+
+        for (int k = first; k < numCodes; ++k) {
+            const int height = function.d_heights[k];
+            if (0 > height) {
+                continue;                                           // CONTINUE
+            }
+            if (points) {
+                states[1].d_pc = k;
+                points->addPoint(positions[k], states, 2);
+            }
+            const Bytecode& code = original[k];
+            if (Bytecode::e_Exit == code.opcode()) {
+                if (1 != height) {
+                    codes->push_back(createCode(Bytecode::e_Store, base));
+                    codes->push_back(createCode(Bytecode::e_Resize,
+                                                base + 1));
+                    if (points) {
+                        const FrameState caller = { 0, call + 1, 0 };
+                        points->addPoint(positions[k] + 2, &caller, 1);
+                    }
+                }
+                codes->push_back(createCode(Bytecode::e_Jump, call + 1));
+            }
+            else if (isJump(code.opcode())) {
+                codes->push_back(createCode(
+                                  code.opcode(),
+                                  positions[code.data().theInteger()]));
+            }
+            else if (isSlotAccess(code.opcode())) {
+                codes->push_back(createCode(
+                                     code.opcode(),
+                                     base + code.data().theInteger()));
+            }
+            else {
+                codes->push_back(code);
+            }
+        }
+        BSLS_ASSERT(static_cast<int>(codes->size()) == position);
+
+        (*codes)[call - 1] = createCode(Bytecode::e_Jump, site.d_copy);
+        ++numInlined;
+        if (sites) {
+            sites->push_back(site);
+        }
+    }
+    return numInlined;
+}
+}
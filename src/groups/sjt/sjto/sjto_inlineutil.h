@@ -0,0 +1,107 @@
+// sjto_inlineutil.h
+
+#ifndef INCLUDED_SJTO_INLINEUTIL
+#define INCLUDED_SJTO_INLINEUTIL
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_SJTT_DEOPTTABLE
+#include <sjtt_deopttable.h>
+#endif
+
+namespace sjto {
+
+                             // =================
+                             // struct InlineUtil
+                             // =================
+
+struct InlineUtil {
+    // This 'struct' provides a namespace for functions that replace calls of
+    // small functions with copies of their code, saving the cost of creating
+    // and destroying a frame, padding its stack, and returning.
+    //
+    // A call site is an 'e_Call' immediately preceded by the 'e_Push' of its
+    // number of arguments, evaluated by frames beginning at index 0 (see
+    // 'FunctionUtil'); no site is inlined if a code is evaluated by frames
+    // having different first codes.  A site is inlined by appending to the
+    // program a copy of the code of the callee, and replacing the 'e_Push'
+    // with an 'e_Jump' to that copy, so that no code moves and every index
+    // used by jumps and calls remains valid.  The copy first pads the stack
+    // as the call would, then evaluates the code of the callee with the
+    // indices of its slots offset by the number of values of the caller
+    // below the arguments, and the targets of its jumps and branches moved to
+    // the copy.  Each 'e_Exit' of the callee becomes codes that leave its
+    // result in place of the arguments and jump to the code following the
+    // call.
+    //
+    // A callee is inlined only if it has at most a given number of codes,
+    // does not call itself, does not make tail calls or read captured
+    // values, and can be converted to SSA form by 'SsaUtil'; the number of
+    // values in the frame of the caller at the site must be known in the
+    // same way.  The copies are not themselves searched for call sites.
+    //
+    // The codes of a copy are laid out on the stack as the frame of the
+    // callee would be, so a frame evaluating a copy can be deoptimized into
+    // the frame of the caller, evaluating the call, and the frame of the
+    // callee, beginning at the values of the caller below the arguments.
+    // Each code of a copy at which the frames are in such a state is a point
+    // of an 'sjtt::DeoptTable', rebuilding frames that evaluate the program
+    // as it was before inlining; the codes of the caller, including the
+    // 'e_Jump' replacing the 'e_Push', are evaluated in the same state by the
+    // same frame, so they need no points.
+    // Note that the ranges of an 'sjtt::ExceptionTable' do not cover the
+    // copies, so the calls of a program having exception handlers must not
+    // be inlined.
+
+    // TYPES
+    enum Status {
+        // Enumeration of the outcomes of inlining a call site.
+
+        e_Inlined,         // the call was replaced by a copy of the callee
+        e_TooLarge,        // the callee has more codes than allowed
+        e_Recursive,       // the callee calls itself
+        e_Unsupported,     // the callee makes a tail call, reads a captured
+                           // value, or cannot be converted to SSA form
+        e_UnknownHeight    // the height of the stack at the site is unknown
+    };
+
+    struct Site {
+        // This 'struct' describes the outcome of inlining one call site.
+
+        int    d_call;     // index of the 'e_Call'
+        int    d_callee;   // index of the first code of the callee
+        int    d_size;     // number of codes of the callee, or -1 if unknown
+        Status d_status;   // outcome
+        int    d_copy;     // index of the first code of the copy, or -1
+    };
+
+    // CONSTANTS
+    static const int s_DefaultMaxCalleeSize = 16;
+        // The default largest number of codes of a callee that is inlined.
+
+    // CLASS METHODS
+    static int inlineCalls(bsl::vector<sjtt::Bytecode> *codes,
+                           bsl::vector<Site>           *sites = 0,
+                           int                          maxCalleeSize =
+                                                      s_DefaultMaxCalleeSize,
+                           sjtt::DeoptTable            *points = 0);
+        // Inline, as described above, each call site of the specified
+        // 'codes' whose callee has at most the optionally specified
+        // 'maxCalleeSize' codes, and return the number of sites inlined.
+        // Optionally specify 'sites', to which a description of every call
+        // site is appended, in the order of the sites.  The functions
+        // searched for call sites are the one beginning at index 0 and the
+        // targets of the 'e_Call' and 'e_TailCall' codes they contain.
+        // Optionally specify 'points', to which the points of the copies are
+        // added.  The behavior is undefined unless '0 <= maxCalleeSize', and
+        // 'points' has no point at an index of the copies.
+};
+}
+
+#endif
@@ -0,0 +1,462 @@
+// sjto_inlineutil.t.cpp                                          -*-C++-*-
+
+#include <sjto_inlineutil.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_deopttable.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+typedef InlineUtil     Util;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+void addOne(bsl::vector<BC> *codes, int callee)
+    // Append to the specified 'codes' a function returning the result of
+    // calling the function at the specified 'callee' index with the argument
+    // 1.
+{
+    codes->push_back(code(BC::e_Push, 1));
+    codes->push_back(code(BC::e_Push, 1));
+    codes->push_back(code(BC::e_Call, callee));
+    codes->push_back(code(BC::e_Exit));
+}
+
+bool isSame(const bsl::vector<BC>& codes, const BC *expected, int numExpected)
+    // Return 'true' if the specified 'codes' are the specified 'numExpected'
+    // codes of the specified 'expected' array, and 'false' otherwise.
+{
+    if (static_cast<int>(codes.size()) != numExpected) {
+        return false;                                                 // RETURN
+    }
+    for (int i = 0; i < numExpected; ++i) {
+        if (!(codes[i] == expected[i])) {
+            return false;                                             // RETURN
+        }
+    }
+    return true;
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "deoptimization points" << endl
+                          << "=====================" << endl;
+
+        // Each code of a copy at which the frames of the caller and the
+        // callee are in the state of those of the program before inlining is
+        // a point rebuilding them, the caller evaluating the call and the
+        // callee beginning below the arguments; the codes completing an
+        // 'e_Exit' are not points until the caller has its result.
+
+        bsl::vector<BC> codes;
+        addOne(&codes, 6);
+        codes.push_back(code(BC::e_Push, 7));                         // 4
+        codes.push_back(code(BC::e_Exit));                            // 5
+        codes.push_back(code(BC::e_Load, 0));                         // 6
+        codes.push_back(code(BC::e_If, 4));                           // 7
+        codes.push_back(code(BC::e_Push, 9));                         // 8
+        codes.push_back(code(BC::e_Exit));                            // 9
+
+        sjtt::DeoptTable points;
+        ASSERT(1 == Util::inlineCalls(&codes,
+                                      0,
+                                      Util::s_DefaultMaxCalleeSize,
+                                      &points));
+        ASSERT(22 == codes.size());
+        ASSERT(10 == points.numPoints());
+
+        const struct {
+            int d_line;
+            int d_index;
+            int d_numFrames;  // 0 if not a point
+            int d_callerPc;
+            int d_calleePc;   // -1 if only the caller is rebuilt
+        } DATA[] = {
+            { L_,  9, 0, -1, -1 },
+            { L_, 10, 1,  1, -1 },                  // padding
+            { L_, 11, 2,  2,  6 },                  // jump to the entry
+            { L_, 12, 2,  2,  4 },
+            { L_, 13, 2,  2,  5 },                  // 'e_Exit'
+            { L_, 14, 0, -1, -1 },
+            { L_, 15, 1,  3, -1 },
+            { L_, 16, 2,  2,  6 },
+            { L_, 17, 2,  2,  7 },
+            { L_, 18, 2,  2,  8 },
+            { L_, 19, 2,  2,  9 },                  // 'e_Exit'
+            { L_, 20, 0, -1, -1 },
+            { L_, 21, 1,  3, -1 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            int                                 numFrames = 0;
+            const sjtt::DeoptTable::FrameState *states =
+                                points.findPoint(&numFrames, DATA[i].d_index);
+            if (0 == DATA[i].d_numFrames) {
+                LOOP_ASSERT(LINE, 0 == states);
+                continue;                                           // CONTINUE
+            }
+            LOOP_ASSERT(LINE, 0 != states);
+            LOOP2_ASSERT(LINE, numFrames, DATA[i].d_numFrames == numFrames);
+            if (0 == states || DATA[i].d_numFrames != numFrames) {
+                continue;                                           // CONTINUE
+            }
+            LOOP_ASSERT(LINE, 0 == states[0].d_firstCode);
+            LOOP_ASSERT(LINE, DATA[i].d_callerPc == states[0].d_pc);
+            LOOP_ASSERT(LINE, 0 == states[0].d_bottom);
+            if (2 == numFrames) {
+                LOOP_ASSERT(LINE, 0 == states[1].d_firstCode);
+                LOOP_ASSERT(LINE, DATA[i].d_calleePc == states[1].d_pc);
+                LOOP_ASSERT(LINE, 8 == states[1].d_bottom);
+            }
+        }
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "sites not inlined" << endl
+                          << "=================" << endl;
+
+        // Each site is reported with the reason it was not inlined, and its
+        // codes are left unchanged.
+
+        bsl::vector<Util::Site> sites;
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_Load, 0));                     // 4
+            codes.push_back(code(BC::e_Push, 1));                     // 5
+            codes.push_back(code(BC::e_Call, 4));                     // 6
+            codes.push_back(code(BC::e_Exit));                        // 7
+            const bsl::vector<BC> ORIGINAL(codes);
+
+            ASSERT(0 == Util::inlineCalls(&codes, &sites));
+            ASSERT(ORIGINAL == codes);
+            ASSERTV(sites.size(), 2 == sites.size());
+            ASSERT(2 == sites[0].d_call);
+            ASSERT(4 == sites[0].d_callee);
+            ASSERT(4 == sites[0].d_size);
+            ASSERT(Util::e_Recursive == sites[0].d_status);
+            ASSERT(-1 == sites[0].d_copy);
+            ASSERT(6 == sites[1].d_call);
+            ASSERT(Util::e_Recursive == sites[1].d_status);
+        }
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_Load, 0));                     // 4
+            codes.push_back(code(BC::e_Push, 1));                     // 5
+            codes.push_back(code(BC::e_TailCall, 7));                 // 6
+            codes.push_back(code(BC::e_Load, 0));                     // 7
+            codes.push_back(code(BC::e_Exit));                        // 8
+
+            sites.clear();
+            ASSERT(0 == Util::inlineCalls(&codes, &sites));
+            ASSERTV(sites.size(), 1 == sites.size());
+            ASSERT(3 == sites[0].d_size);
+            ASSERT(Util::e_Unsupported == sites[0].d_status);
+        }
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_LoadCaptured, 0));             // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+
+            sites.clear();
+            ASSERT(0 == Util::inlineCalls(&codes, &sites));
+            ASSERTV(sites.size(), 1 == sites.size());
+            ASSERT(2 == sites[0].d_size);
+            ASSERT(Util::e_Unsupported == sites[0].d_status);
+        }
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_Jump, 100));                   // 4
+
+            sites.clear();
+            ASSERT(0 == Util::inlineCalls(&codes, &sites));
+            ASSERTV(sites.size(), 1 == sites.size());
+            ASSERT(-1 == sites[0].d_size);
+            ASSERT(Util::e_Unsupported == sites[0].d_status);
+        }
+        {
+            // The caller reaches the count at different heights.
+
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 0));                     // 0
+            codes.push_back(code(BC::e_If, 3));                       // 1
+            codes.push_back(code(BC::e_Push, 5));                     // 2
+            codes.push_back(code(BC::e_Push, 1));                     // 3
+            codes.push_back(code(BC::e_Call, 6));                     // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+            codes.push_back(code(BC::e_Load, 0));                     // 6
+            codes.push_back(code(BC::e_Exit));                        // 7
+
+            sites.clear();
+            ASSERT(0 == Util::inlineCalls(&codes, &sites));
+            ASSERTV(sites.size(), 1 == sites.size());
+            ASSERT(4 == sites[0].d_call);
+            ASSERT(2 == sites[0].d_size);
+            ASSERT(Util::e_UnknownHeight == sites[0].d_status);
+        }
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_Load, 0));                     // 4
+            codes.push_back(code(BC::e_Load, 0));                     // 5
+            codes.push_back(code(BC::e_AddInts));                     // 6
+            codes.push_back(code(BC::e_Exit));                        // 7
+            const bsl::vector<BC> ORIGINAL(codes);
+
+            sites.clear();
+            ASSERT(0 == Util::inlineCalls(&codes, &sites, 3));
+            ASSERT(ORIGINAL == codes);
+            ASSERTV(sites.size(), 1 == sites.size());
+            ASSERT(4 == sites[0].d_size);
+            ASSERT(Util::e_TooLarge == sites[0].d_status);
+
+            sites.clear();
+            ASSERT(1 == Util::inlineCalls(&codes, &sites, 4));
+            ASSERTV(sites.size(), 1 == sites.size());
+            ASSERT(Util::e_Inlined == sites[0].d_status);
+        }
+        {
+            // A call by a function called through a code value, whose
+            // indices are relative to its first code, is not a site.
+
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_PushCode, 4));                 // 0
+            codes.push_back(code(BC::e_Push, 0));                     // 1
+            codes.push_back(code(BC::e_CallValue));                   // 2
+            codes.push_back(code(BC::e_Exit));                        // 3
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_Load, 0));                     // 8
+            codes.push_back(code(BC::e_Exit));                        // 9
+            const bsl::vector<BC> ORIGINAL(codes);
+
+            sites.clear();
+            ASSERT(0 == Util::inlineCalls(&codes, &sites));
+            ASSERT(ORIGINAL == codes);
+            ASSERT(sites.empty());
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "copies" << endl
+                          << "======" << endl;
+
+        // Jumps and branches of the callee are moved to the copy, which
+        // begins with a jump to the entry of the callee if another of its
+        // codes precedes it.
+
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 6);
+            codes.push_back(code(BC::e_Push, 7));                     // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+            codes.push_back(code(BC::e_Load, 0));                     // 6
+            codes.push_back(code(BC::e_If, 4));                       // 7
+            codes.push_back(code(BC::e_Push, 9));                     // 8
+            codes.push_back(code(BC::e_Exit));                        // 9
+
+            ASSERT(1 == Util::inlineCalls(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 1),
+                code(BC::e_Jump, 10),
+                code(BC::e_Call, 6),
+                code(BC::e_Exit),
+                code(BC::e_Push, 7),
+                code(BC::e_Exit),
+                code(BC::e_Load, 0),
+                code(BC::e_If, 4),
+                code(BC::e_Push, 9),
+                code(BC::e_Exit),
+                code(BC::e_Resize, 16),           // copy
+                code(BC::e_Jump, 16),
+                code(BC::e_Push, 7),              // 4
+                code(BC::e_Store, 8),
+                code(BC::e_Resize, 9),
+                code(BC::e_Jump, 3),
+                code(BC::e_Load, 8),              // 6
+                code(BC::e_If, 12),
+                code(BC::e_Push, 9),              // 8
+                code(BC::e_Store, 8),
+                code(BC::e_Resize, 9),
+                code(BC::e_Jump, 3),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+
+        // An 'e_Exit' leaving only its result in the frame of the callee
+        // becomes a jump.
+
+        {
+            bsl::vector<BC> codes;
+            addOne(&codes, 4);
+            codes.push_back(code(BC::e_Resize, 1));                   // 4
+            codes.push_back(code(BC::e_Exit));                        // 5
+
+            ASSERT(1 == Util::inlineCalls(&codes));
+
+            const BC EXPECTED[] = {
+                code(BC::e_Push, 1),
+                code(BC::e_Jump, 6),
+                code(BC::e_Call, 4),
+                code(BC::e_Exit),
+                code(BC::e_Resize, 1),
+                code(BC::e_Exit),
+                code(BC::e_Resize, 16),           // copy
+                code(BC::e_Resize, 9),
+                code(BC::e_Jump, 3),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        // The count of arguments becomes a jump to a copy of the callee whose
+        // slots are above those of the caller.
+
+        bsl::vector<BC> codes;
+        addOne(&codes, 4);
+        codes.push_back(code(BC::e_Load, 0));                         // 4
+        codes.push_back(code(BC::e_Load, 0));                         // 5
+        codes.push_back(code(BC::e_AddInts));                         // 6
+        codes.push_back(code(BC::e_Exit));                            // 7
+
+        bsl::vector<Util::Site> sites;
+        ASSERT(1 == Util::inlineCalls(&codes, &sites));
+        ASSERTV(sites.size(), 1 == sites.size());
+        ASSERT(2 == sites[0].d_call);
+        ASSERT(4 == sites[0].d_callee);
+        ASSERT(4 == sites[0].d_size);
+        ASSERT(Util::e_Inlined == sites[0].d_status);
+        ASSERT(8 == sites[0].d_copy);
+
+        const BC EXPECTED[] = {
+            code(BC::e_Push, 1),
+            code(BC::e_Jump, 8),
+            code(BC::e_Call, 4),
+            code(BC::e_Exit),
+            code(BC::e_Load, 0),
+            code(BC::e_Load, 0),
+            code(BC::e_AddInts),
+            code(BC::e_Exit),
+            code(BC::e_Resize, 16),               // copy
+            code(BC::e_Load, 8),
+            code(BC::e_Load, 8),
+            code(BC::e_AddInts),
+            code(BC::e_Store, 8),
+            code(BC::e_Resize, 9),
+            code(BC::e_Jump, 3),
+        };
+        const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+        ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+
+        // A program without call sites is unchanged.
+
+        bsl::vector<BC> plain(codes.begin() + 4, codes.begin() + 8);
+        const bsl::vector<BC> PLAIN(plain);
+        ASSERT(0 == Util::inlineCalls(&plain));
+        ASSERT(PLAIN == plain);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
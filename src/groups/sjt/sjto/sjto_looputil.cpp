@@ -0,0 +1,571 @@
+// sjto_looputil.cpp
+#include <sjto_looputil.h>
+
+#include <sjto_functionutil.h>
+
+#include <bdld_datum.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_limits.h>
+
+#include <bsls_assert.h>
+#include <bsls_types.h>
+
+namespace sjto {
+namespace {
+
+using BloombergLP::bdld::Datum;
+using BloombergLP::bsls::Types;
+
+typedef sjtt::Bytecode Bytecode;
+
+bool isJump(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // the index of a code of the same function, and 'false' otherwise.
+{
+    return Bytecode::e_Jump     == opcode ||
+           Bytecode::e_If       == opcode ||
+           Bytecode::e_IfEqInts == opcode;
+}
+
+bool endsPath(Bytecode::Opcode opcode)
+    // Return 'true' if evaluation never continues at the code following one
+    // having the specified 'opcode', and 'false' otherwise.
+{
+    return Bytecode::e_Jump     == opcode ||
+           Bytecode::e_Exit     == opcode ||
+           Bytecode::e_TailCall == opcode ||
+           Bytecode::e_Throw    == opcode;
+}
+
+bool isSlotAccess(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // relative to the bottom of the frame, and 'false' otherwise.
+{
+    return Bytecode::e_Load   == opcode ||
+           Bytecode::e_Store  == opcode ||
+           Bytecode::e_IncInt == opcode ||
+           Bytecode::e_Resize == opcode;
+}
+
+bool isHoistable(Bytecode::Opcode opcode)
+    // Return 'true' if a code having the specified 'opcode' computes its
+    // result from its two operands alone, and 'false' otherwise.
+{
+    return Bytecode::e_AddInts    == opcode ||
+           Bytecode::e_AddDoubles == opcode ||
+           Bytecode::e_EqInts     == opcode;
+}
+
+bool isIntegerCode(const Bytecode& code, Bytecode::Opcode opcode)
+    // Return 'true' if the specified 'code' has the specified 'opcode' and
+    // integer data, and 'false' otherwise.
+{
+    return opcode == code.opcode() && code.data().isInteger();
+}
+
+Bytecode createCode(Bytecode::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return Bytecode::createOpcode(opcode, Datum::createInteger(data));
+}
+
+struct Shape {
+    // This 'struct' describes the codes of a counting loop.
+
+    bool d_isTestFirst;  // the test precedes the body
+    int  d_test;         // index of the first code of the test
+    int  d_bodyBegin;    // index of the first code of the body
+    int  d_bodyEnd;      // index following the last code of the body
+    int  d_slot;         // induction variable
+    int  d_bound;        // value ending the loop
+};
+
+bool matchTest(int                          *slot,
+               int                          *bound,
+               const bsl::vector<Bytecode>&  codes,
+               int                           index,
+               int                           exit)
+    // Load into the specified 'slot' and 'bound' the induction variable and
+    // bound of the test beginning at the specified 'index' of the specified
+    // 'codes', and return 'true' if those codes are a test whose branch
+    // stores the specified 'exit' index; otherwise, return 'false'.
+{
+    const Bytecode& lhs    = codes[index];
+    const Bytecode& rhs    = codes[index + 1];
+    const Bytecode& branch = codes[index + 2];
+    if (!isIntegerCode(branch, Bytecode::e_IfEqInts) ||
+        exit != branch.data().theInteger()) {
+        return false;                                                 // RETURN
+    }
+    const Bytecode *load = &lhs;
+    const Bytecode *push = &rhs;
+    if (Bytecode::e_Load != load->opcode()) {
+        bsl::swap(load, push);
+    }
+    if (!isIntegerCode(*load, Bytecode::e_Load) ||
+        !isIntegerCode(*push, Bytecode::e_Push)) {
+        return false;                                                 // RETURN
+    }
+    *slot  = load->data().theInteger();
+    *bound = push->data().theInteger();
+    return true;
+}
+
+bool matchBody(const bsl::vector<Bytecode>& codes,
+               int                          begin,
+               int                          end,
+               int                          slot)
+    // Return 'true' if the codes in the range '[begin, end)' of the specified
+    // 'codes' neither jump, branch, nor end the frame, and change the
+    // specified 'slot' only by exactly one 'e_IncInt'; otherwise, return
+    // 'false'.
+{
+    int numIncrements = 0;
+    for (int index = begin; index < end; ++index) {
+        const Bytecode& code = codes[index];
+        if (isJump(code.opcode()) || endsPath(code.opcode())) {
+            return false;                                             // RETURN
+        }
+        if (Bytecode::e_IncInt != code.opcode() &&
+            Bytecode::e_Store  != code.opcode()) {
+            continue;                                               // CONTINUE
+        }
+        if (!code.data().isInteger() ||
+            (slot == code.data().theInteger() &&
+             Bytecode::e_Store == code.opcode())) {
+            return false;                                             // RETURN
+        }
+        numIncrements += slot == code.data().theInteger();
+    }
+    return 1 == numIncrements;
+}
+
+bool matchCounting(Shape                        *shape,
+                   const bsl::vector<Bytecode>&  codes,
+                   int                           firstCode,
+                   int                           header,
+                   int                           latch)
+    // Load into the specified 'shape' a description of the loop from the
+    // specified 'header' to the specified 'latch' of the specified 'codes',
+    // evaluated by frames beginning at the specified 'firstCode', and return
+    // 'true' if it is a counting loop; otherwise, return 'false'.  The
+    // behavior is undefined unless the loop has every code from 'header' to
+    // 'latch'.
+{
+    const int exit = latch + 1 - firstCode;
+    if (latch - header < 4) {
+        return false;                                                 // RETURN
+    }
+    if (matchTest(&shape->d_slot, &shape->d_bound, codes, latch - 3, exit)) {
+        shape->d_isTestFirst = false;
+        shape->d_test        = latch - 3;
+        shape->d_bodyBegin   = header;
+        shape->d_bodyEnd     = latch - 3;
+    }
+    else if (matchTest(&shape->d_slot, &shape->d_bound, codes, header, exit)) {
+        shape->d_isTestFirst = true;
+        shape->d_test        = header;
+        shape->d_bodyBegin   = header + 3;
+        shape->d_bodyEnd     = latch;
+    }
+    else {
+        return false;                                                 // RETURN
+    }
+    return matchBody(codes,
+                     shape->d_bodyBegin,
+                     shape->d_bodyEnd,
+                     shape->d_slot);
+}
+
+int findTripCount(const Shape&                           shape,
+                  const bsl::vector<Bytecode>&           codes,
+                  const bsl::vector<char>&               isTarget,
+                  const bsl::vector<bsl::vector<int> >&  predecessors,
+                  int                                    header)
+    // Return the number of iterations of the counting loop described by the
+    // specified 'shape', whose first code is at the specified 'header' of the
+    // specified 'codes', where 'isTarget' and 'predecessors' tell the codes
+    // entered by jumps and the codes preceding each, or -1 if it is not
+    // known.
+{
+    if (0 == header ||
+        2 != predecessors[header].size() ||
+        (header - 1 != predecessors[header][0] &&
+         header - 1 != predecessors[header][1])) {
+        return -1;                                                    // RETURN
+    }
+
+    // Find the last pair initializing the induction variable, with no jump
+    // entering the pairs after it.
+
+    int initial = 0;
+    int index   = header - 1;
+    while (true) {
+        if (1 > index ||
+            isTarget[index] ||
+            !isIntegerCode(codes[index], Bytecode::e_Store) ||
+            Bytecode::e_Push != codes[index - 1].opcode()) {
+            return -1;                                                // RETURN
+        }
+        if (shape.d_slot == codes[index].data().theInteger()) {
+            if (!codes[index - 1].data().isInteger()) {
+                return -1;                                            // RETURN
+            }
+            initial = codes[index - 1].data().theInteger();
+            break;                                                     // BREAK
+        }
+        if (isTarget[index - 1]) {
+            return -1;                                                // RETURN
+        }
+        index -= 2;
+    }
+
+    // The induction variable is tested before each increment if the test
+    // comes first, and after it otherwise.
+
+    const Types::Int64 count = static_cast<Types::Int64>(shape.d_bound) -
+                               initial;
+    if (count < (shape.d_isTestFirst ? 0 : 1) ||
+        count > bsl::numeric_limits<int>::max()) {
+        return -1;                                                    // RETURN
+    }
+    return static_cast<int>(count);
+}
+
+struct Item {
+    // This 'struct' describes one code of the body of a loop being
+    // optimized.
+
+    Bytecode d_code;     // code, unless 'd_hoisted' is not negative
+    int      d_hoisted;  // index of the hoisted expression loaded, or -1
+};
+
+bool operator==(const Item& lhs, const Item& rhs)
+    // Return 'true' if the specified 'lhs' and 'rhs' items are the same, and
+    // 'false' otherwise.
+{
+    return lhs.d_hoisted == rhs.d_hoisted &&
+           (0 <= lhs.d_hoisted || lhs.d_code == rhs.d_code);
+}
+
+Item createItem(const Bytecode& code)
+    // Return an item of the specified 'code'.
+{
+    const Item item = { code, -1 };
+    return item;
+}
+
+bool isInvariant(const Item& item, const bsl::vector<char>& isChanged)
+    // Return 'true' if the specified 'item' pushes the same value at every
+    // iteration of a loop changing the slots for which the specified
+    // 'isChanged' is set, and whose slots from 'isChanged.size()' up are not
+    // kept across iterations; otherwise, return 'false'.
+{
+    const Bytecode& code = item.d_code;
+    return 0 <= item.d_hoisted ||
+           Bytecode::e_Push == code.opcode() ||
+           (isIntegerCode(code, Bytecode::e_Load) &&
+            0 <= code.data().theInteger() &&
+            code.data().theInteger() < static_cast<int>(isChanged.size()) &&
+            !isChanged[code.data().theInteger()]);
+}
+
+Bytecode emitItem(const Item& item, int height, int numHoisted)
+    // Return the code for the specified 'item' of a loop whose header is at
+    // the specified 'height', above which the specified 'numHoisted' slots
+    // hold the hoisted expressions.
+{
+    if (0 <= item.d_hoisted) {
+        return createCode(Bytecode::e_Load, height + item.d_hoisted);
+    }
+    const Bytecode& code = item.d_code;
+    if (isSlotAccess(code.opcode()) &&
+        code.data().isInteger() &&
+        height <= code.data().theInteger()) {
+        return createCode(code.opcode(),
+                          code.data().theInteger() + numHoisted);
+    }
+    return code;
+}
+
+}  // close unnamed namespace
+
+                              // ---------------
+                              // struct LoopUtil
+                              // ---------------
+
+// CLASS METHODS
+int LoopUtil::findLoops(bsl::vector<Loop>                  *result,
+                        const bsl::vector<sjtt::Bytecode>&  codes)
+{
+    BSLS_ASSERT(0 != result);
+
+    result->clear();
+
+    const int        numCodes = static_cast<int>(codes.size());
+    bsl::vector<int> firstCodes;
+    if (0 != FunctionUtil::findFirstCodes(&firstCodes, codes)) {
+        return 1;                                                     // RETURN
+    }
+    bsl::vector<int> entries;
+    FunctionUtil::findEntries(&entries, codes, firstCodes);
+
+    // Find the codes preceding each code, and those that a path can enter
+    // other than by falling through.
+
+    bsl::vector<bsl::vector<int> > predecessors(numCodes);
+    bsl::vector<char>              isTarget(numCodes, false);
+    bsl::vector<char>              isEntry(numCodes, false);
+    for (bsl::size_t e = 0; e < entries.size(); ++e) {
+        isTarget[entries[e]] = true;
+        isEntry[entries[e]]  = true;
+    }
+    for (int index = 0; index < numCodes; ++index) {
+        const Bytecode& code = codes[index];
+        if (0 > firstCodes[index]) {
+            continue;                                               // CONTINUE
+        }
+        if (isJump(code.opcode()) && code.data().isInteger()) {
+            const int target = firstCodes[index] + code.data().theInteger();
+            if (0 <= target && target < numCodes) {
+                predecessors[target].push_back(index);
+                isTarget[target] = true;
+            }
+        }
+        if (!endsPath(code.opcode()) && index + 1 < numCodes) {
+            predecessors[index + 1].push_back(index);
+        }
+    }
+
+    for (int latch = 0; latch < numCodes; ++latch) {
+        const Bytecode& code = codes[latch];
+        if (0 > firstCodes[latch] ||
+            !isIntegerCode(code, Bytecode::e_Jump)) {
+            continue;                                               // CONTINUE
+        }
+        const int header = firstCodes[latch] + code.data().theInteger();
+        if (0 > header || latch < header) {
+            continue;                                               // CONTINUE
+        }
+
+        // Collect the codes reaching the latch without passing through the
+        // header; reaching the entry of a function means the header is not
+        // on every path to the latch.
+
+        bsl::vector<char> isInLoop(numCodes, false);
+        bsl::vector<int>  pending(1, latch);
+        bool              isDominated = true;
+        int               size        = 1;
+        isInLoop[header] = true;
+        while (isDominated && !pending.empty()) {
+            const int index = pending.back();
+            pending.pop_back();
+            if (isInLoop[index]) {
+                continue;                                           // CONTINUE
+            }
+            isInLoop[index] = true;
+            isDominated     = !isEntry[index];
+            ++size;
+            pending.insert(pending.end(),
+                           predecessors[index].begin(),
+                           predecessors[index].end());
+        }
+        if (!isDominated) {
+            continue;                                               // CONTINUE
+        }
+
+        Loop  loop = { header, latch, size, -1, -1, 0, 1, -1 };
+        Shape shape;
+        if (latch - header + 1 == size &&
+            matchCounting(&shape,
+                          codes,
+                          firstCodes[header],
+                          header,
+                          latch)) {
+            loop.d_slot      = shape.d_slot;
+            loop.d_tripCount = findTripCount(shape,
+                                             codes,
+                                             isTarget,
+                                             predecessors,
+                                             header);
+        }
+        result->push_back(loop);
+    }
+    return 0;
+}
+
+int LoopUtil::optimize(bsl::vector<sjtt::Bytecode> *codes,
+                       bsl::vector<Loop>           *loops,
+                       int                          maxUnrolledSize)
+{
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= maxUnrolledSize);
+
+    bsl::vector<Loop> found;
+    bsl::vector<int>  firstCodes;
+    bsl::vector<int>  heights;
+    if (0 != findLoops(&found, *codes)) {
+        if (loops) {
+            loops->clear();
+        }
+        return 0;                                                     // RETURN
+    }
+    FunctionUtil::findFirstCodes(&firstCodes, *codes);
+    FunctionUtil::findHeights(&heights, *codes, firstCodes, 0);
+
+    // Copy the loops as they were before any was optimized.
+
+    const bsl::vector<sjtt::Bytecode> original(*codes);
+    int                               numChanged = 0;
+    for (bsl::size_t l = 0; l < found.size(); ++l) {
+        Loop&     loop      = found[l];
+        const int header    = loop.d_header;
+        const int height    = heights[header];
+        const int firstCode = firstCodes[header];
+        Shape     shape;
+        if (0 > loop.d_slot ||
+            0 > height ||
+            height <= loop.d_slot ||
+            !matchCounting(&shape,
+                           original,
+                           firstCode,
+                           header,
+                           loop.d_latch)) {
+            continue;                                               // CONTINUE
+        }
+
+        // Hoist the invariant expressions of the body, repeatedly, so that
+        // an expression of hoisted values is itself hoisted, unless the body
+        // resizes the frame below its header, which the new slots would not
+        // survive.
+
+        bsl::vector<Item> body;
+        bsl::vector<Item> hoisted;  // three items per expression
+        bsl::vector<char> isChanged(height, false);
+        bool              isHoisting = 0 != loop.d_tripCount;
+        for (int index = shape.d_bodyBegin; index < shape.d_bodyEnd; ++index) {
+            const Bytecode& code = original[index];
+            body.push_back(createItem(code));
+            if (!isSlotAccess(code.opcode()) || !code.data().isInteger()) {
+                continue;                                           // CONTINUE
+            }
+            const int slot = code.data().theInteger();
+            if (Bytecode::e_Resize == code.opcode()) {
+                isHoisting = isHoisting && height <= slot;
+            }
+            else if (Bytecode::e_Load != code.opcode() &&
+                     0 <= slot &&
+                     slot < height) {
+                isChanged[slot] = true;
+            }
+        }
+        for (bsl::size_t k = 2; isHoisting && k < body.size(); ++k) {
+            const Item& lhs = body[k - 2];
+            const Item& rhs = body[k - 1];
+            if (!isHoistable(body[k].d_code.opcode()) ||
+                0 <= body[k].d_hoisted ||
+                !isInvariant(lhs, isChanged) ||
+                !isInvariant(rhs, isChanged) ||
+                (Bytecode::e_Push == lhs.d_code.opcode() &&
+                 Bytecode::e_Push == rhs.d_code.opcode() &&
+                 0 > lhs.d_hoisted &&
+                 0 > rhs.d_hoisted)) {
+                continue;                                           // CONTINUE
+            }
+            bsl::size_t h = 0;
+            while (h < hoisted.size() &&
+                   !(hoisted[h]     == lhs &&
+                     hoisted[h + 1] == rhs &&
+                     hoisted[h + 2] == body[k])) {
+                h += 3;
+            }
+            if (h == hoisted.size()) {
+                hoisted.insert(hoisted.end(), body.begin() + k - 2,
+                                              body.begin() + k + 1);
+            }
+            Item load = createItem(body[k].d_code);
+            load.d_hoisted = static_cast<int>(h / 3);
+            body.erase(body.begin() + k - 2, body.begin() + k + 1);
+            body.insert(body.begin() + k - 2, load);
+            k = 1;  // rescan, as the load may be an operand
+        }
+
+        // Choose how many times to repeat the body: every iteration if they
+        // fit, or else the largest factor of the iterations that fits.
+
+        const int numHoisted = static_cast<int>(hoisted.size() / 3);
+        const int bodySize   = static_cast<int>(body.size());
+        const int tripCount  = loop.d_tripCount;
+        const int maxCopies  = maxUnrolledSize / bodySize;
+        const bool isFull    = 0 <= tripCount && tripCount <= maxCopies;
+        int        factor    = 1;
+        for (int d = bsl::min(tripCount - 1, maxCopies);
+             !isFull && 2 <= d;
+             --d) {
+            if (0 == tripCount % d) {
+                factor = d;
+                break;                                                 // BREAK
+            }
+        }
+        if (!isFull && 1 == factor && 0 == numHoisted) {
+            continue;                                               // CONTINUE
+        }
+
+        // Append the copy, whose indices are relative to the first code of
+        // the frames evaluating the loop.
+
+        const int exit = loop.d_latch + 1 - firstCode;
+        loop.d_copy       = static_cast<int>(codes->size());
+        loop.d_numHoisted = numHoisted;
+        loop.d_factor     = isFull ? 0 : factor;
+        if (0 == tripCount) {
+            codes->push_back(createCode(Bytecode::e_Jump, exit));
+        }
+        else {
+            if (shape.d_isTestFirst && 0 > tripCount) {
+                codes->insert(codes->end(),
+                              original.begin() + shape.d_test,
+                              original.begin() + shape.d_test + 3);
+            }
+            for (bsl::size_t h = 0; h < hoisted.size(); ++h) {
+                codes->push_back(emitItem(hoisted[h], height, numHoisted));
+            }
+            const int start  = static_cast<int>(codes->size());
+            const int copies = isFull ? tripCount : factor;
+            for (int c = 0; c < copies; ++c) {
+                for (int k = 0; k < bodySize; ++k) {
+                    codes->push_back(emitItem(body[k], height, numHoisted));
+                }
+            }
+            if (!isFull) {
+                // The test leaves the loop through codes removing the new
+                // slots, if any, which follow the jump back.
+
+                const int end = start + copies * bodySize + 4;
+                codes->push_back(original[shape.d_test]);
+                codes->push_back(original[shape.d_test + 1]);
+                codes->push_back(createCode(
+                                        Bytecode::e_IfEqInts,
+                                        0 < numHoisted ? end - firstCode
+                                                       : exit));
+                codes->push_back(createCode(Bytecode::e_Jump,
+                                            start - firstCode));
+            }
+            if (0 < numHoisted) {
+                codes->push_back(createCode(Bytecode::e_Resize, height));
+            }
+            if (isFull || 0 < numHoisted) {
+                codes->push_back(createCode(Bytecode::e_Jump, exit));
+            }
+        }
+        (*codes)[header] = createCode(Bytecode::e_Jump,
+                                      loop.d_copy - firstCode);
+        ++numChanged;
+    }
+    if (loops) {
+        loops->swap(found);
+    }
+    return numChanged;
+}
+}
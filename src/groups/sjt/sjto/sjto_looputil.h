@@ -0,0 +1,118 @@
+// sjto_looputil.h
+
+#ifndef INCLUDED_SJTO_LOOPUTIL
+#define INCLUDED_SJTO_LOOPUTIL
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace sjto {
+
+                              // ===============
+                              // struct LoopUtil
+                              // ===============
+
+struct LoopUtil {
+    // This 'struct' provides a namespace for functions that find the loops
+    // of a program of Scramjet bytecode, and optimize those that count.
+    //
+    // A loop is found for each 'e_Jump', the latch, to a code at the same or
+    // a lower index, the header, that every path reaching the latch from the
+    // entry of a function passes through.  Its codes are those reaching the
+    // latch without passing through the header, and the header.
+    //
+    // A loop counts if its codes are those from the header to the latch, and
+    // are, in order, either:
+    //: o a body, then a test, then the latch; or
+    //:
+    //: o a test, then a body, then the latch;
+    //
+    // where the test is an 'e_Load' of a slot, the induction variable, and
+    // an 'e_Push' of an integer, the bound, in either order, followed by an
+    // 'e_IfEqInts' to the code following the latch; and the body has neither
+    // jumps, branches, nor codes ending the frame, and changes the induction
+    // variable only by exactly one 'e_IncInt'.  The number of iterations of a
+    // counting loop is known if the header is reached only from the code
+    // before it, which ends a sequence of pairs of an 'e_Push' and an
+    // 'e_Store' that no jump enters after the pair storing an integer in the
+    // induction variable, and the loop ends before the induction variable
+    // overflows.
+    //
+    // A counting loop is optimized by appending to the program a copy of it,
+    // and replacing its header with an 'e_Jump' to that copy, so that no code
+    // moves, and leaving the original codes to be removed by
+    // 'ConstantFoldUtil'.  In the copy:
+    //: o Each 'e_AddInts', 'e_AddDoubles' or 'e_EqInts' of the body whose
+    //:   operands are pushed by the two codes before it, each an 'e_Push', an
+    //:   'e_Load' of a slot that the loop does not change, or a value already
+    //:   hoisted, and not both an 'e_Push', is hoisted: it is evaluated once,
+    //:   before the loop, into a new slot above those the loop had at its
+    //:   header, and the codes evaluating it in the body become an 'e_Load'
+    //:   of that slot.  The indices of the slots above it are moved up, and
+    //:   the new slots are removed when the loop ends.  The expressions of a
+    //:   loop whose test comes first are hoisted after a copy of its test,
+    //:   unless the loop is known to iterate.
+    //:
+    //: o The body, with its 'e_IncInt', of a loop whose number of iterations
+    //:   is known is repeated by the largest factor dividing that number such
+    //:   that the repeated codes are not more than a given number, and the
+    //:   test evaluated once per repetition; if that number of iterations
+    //:   fits, the loop is fully unrolled, without a test.
+    //
+    // The heights of the frame are found by 'FunctionUtil::findHeights',
+    // with no arguments for the function beginning at index 0; a loop whose
+    // heights are not known is not optimized, nor is one whose body resizes
+    // the frame below the height of its header when expressions are hoisted.
+    // Note that the ranges of an 'sjtt::ExceptionTable' do not cover the
+    // copies, so the loops of a program having exception handlers must not
+    // be optimized.
+
+    // TYPES
+    struct Loop {
+        // This 'struct' describes one loop.
+
+        int d_header;      // index of the first code of the loop
+        int d_latch;       // index of the 'e_Jump' back to the header
+        int d_size;        // number of codes of the loop
+        int d_slot;        // induction variable, or -1 if it doesn't count
+        int d_tripCount;   // number of iterations, or -1 if unknown
+        int d_numHoisted;  // number of expressions hoisted
+        int d_factor;      // copies of the body per test, or 0 if the loop
+                           // is fully unrolled
+        int d_copy;        // index of the first code of the copy, or -1
+    };
+
+    // CONSTANTS
+    static const int s_DefaultMaxUnrolledSize = 32;
+        // The default largest number of codes of the repeated bodies of an
+        // unrolled loop.
+
+    // CLASS METHODS
+    static int findLoops(bsl::vector<Loop>                  *result,
+                         const bsl::vector<sjtt::Bytecode>&  codes);
+        // Load into the specified 'result' a description of each loop of the
+        // specified 'codes', as described above, in the order of their
+        // latches, with 'd_numHoisted' 0, 'd_factor' 1, and 'd_copy' -1.
+        // Return 0 on success, and a non-zero value, with no loops, if a code
+        // of 'codes' is evaluated by frames having different first codes
+        // (see 'FunctionUtil').
+
+    static int optimize(bsl::vector<sjtt::Bytecode> *codes,
+                        bsl::vector<Loop>           *loops = 0,
+                        int                          maxUnrolledSize =
+                                                   s_DefaultMaxUnrolledSize);
+        // Optimize, as described above, each counting loop of the specified
+        // 'codes', unrolling it only if its repeated bodies have at most the
+        // optionally specified 'maxUnrolledSize' codes, and return the number
+        // of loops changed.  Optionally specify 'loops', into which a
+        // description of every loop is loaded, in the order of their
+        // latches.  The behavior is undefined unless '0 <= maxUnrolledSize'.
+};
+}
+
+#endif
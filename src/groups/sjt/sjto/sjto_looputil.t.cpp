@@ -0,0 +1,478 @@
+// sjto_looputil.t.cpp                                            -*-C++-*-
+
+#include <sjto_looputil.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+typedef LoopUtil       Util;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+BC push(bool value)
+    // Return an 'e_Push' of the specified boolean 'value'.
+{
+    return BC::createOpcode(BC::e_Push, bdld::Datum::createBoolean(value));
+}
+
+void sumLoop(bsl::vector<BC> *codes)
+    // Append to the specified 'codes' a program summing, in slot 1, the
+    // values of its induction variable, in slot 0, from 0 to 3, with the test
+    // following the body.
+{
+    codes->push_back(code(BC::e_Push, 0));                            //  0
+    codes->push_back(code(BC::e_Store, 0));                           //  1
+    codes->push_back(code(BC::e_Push, 0));                            //  2
+    codes->push_back(code(BC::e_Store, 1));                           //  3
+    codes->push_back(code(BC::e_Load, 1));                            //  4
+    codes->push_back(code(BC::e_Load, 0));                            //  5
+    codes->push_back(code(BC::e_AddInts));                            //  6
+    codes->push_back(code(BC::e_Store, 1));                           //  7
+    codes->push_back(code(BC::e_IncInt, 0));                          //  8
+    codes->push_back(code(BC::e_Load, 0));                            //  9
+    codes->push_back(code(BC::e_Push, 4));                            // 10
+    codes->push_back(code(BC::e_IfEqInts, 13));                       // 11
+    codes->push_back(code(BC::e_Jump, 4));                            // 12
+    codes->push_back(code(BC::e_Load, 1));                            // 13
+    codes->push_back(code(BC::e_Exit));                               // 14
+}
+
+bool isSame(const bsl::vector<BC>& codes, const BC *expected, int numExpected)
+    // Return 'true' if the specified 'codes' are the specified 'numExpected'
+    // codes of the specified 'expected' array, and 'false' otherwise.
+{
+    if (static_cast<int>(codes.size()) != numExpected) {
+        return false;                                                 // RETURN
+    }
+    for (int i = 0; i < numExpected; ++i) {
+        if (!(codes[i] == expected[i])) {
+            return false;                                             // RETURN
+        }
+    }
+    return true;
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "hoisting" << endl
+                          << "========" << endl;
+
+        // The invariant expressions of a loop whose number of iterations is
+        // not known, and whose test comes first, are hoisted after a copy of
+        // its test, into slots removed when the loop ends.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Push, 5));                         //  0
+        codes.push_back(code(BC::e_Store, 2));                        //  1
+        codes.push_back(code(BC::e_Push, 7));                         //  2
+        codes.push_back(code(BC::e_Store, 3));                        //  3
+        codes.push_back(code(BC::e_Load, 3));                         //  4
+        codes.push_back(code(BC::e_Store, 0));                        //  5
+        codes.push_back(code(BC::e_Load, 0));                         //  6
+        codes.push_back(code(BC::e_Push, 10));                        //  7
+        codes.push_back(code(BC::e_IfEqInts, 17));                    //  8
+        codes.push_back(code(BC::e_Load, 2));                         //  9
+        codes.push_back(code(BC::e_Load, 3));                         // 10
+        codes.push_back(code(BC::e_AddInts));                         // 11
+        codes.push_back(code(BC::e_Push, 1));                         // 12
+        codes.push_back(code(BC::e_AddInts));                         // 13
+        codes.push_back(code(BC::e_Store, 1));                        // 14
+        codes.push_back(code(BC::e_IncInt, 0));                       // 15
+        codes.push_back(code(BC::e_Jump, 6));                         // 16
+        codes.push_back(code(BC::e_Load, 1));                         // 17
+        codes.push_back(code(BC::e_Exit));                            // 18
+
+        bsl::vector<Util::Loop> loops;
+        ASSERT(1 == Util::optimize(&codes, &loops));
+        ASSERTV(loops.size(), 1 == loops.size());
+        ASSERT( 0 == loops[0].d_slot);
+        ASSERT(-1 == loops[0].d_tripCount);
+        ASSERT( 2 == loops[0].d_numHoisted);
+        ASSERT( 1 == loops[0].d_factor);
+        ASSERT(19 == loops[0].d_copy);
+
+        const BC EXPECTED[] = {
+            code(BC::e_Push, 5),
+            code(BC::e_Store, 2),
+            code(BC::e_Push, 7),
+            code(BC::e_Store, 3),
+            code(BC::e_Load, 3),
+            code(BC::e_Store, 0),
+            code(BC::e_Jump, 19),
+            code(BC::e_Push, 10),
+            code(BC::e_IfEqInts, 17),
+            code(BC::e_Load, 2),
+            code(BC::e_Load, 3),
+            code(BC::e_AddInts),
+            code(BC::e_Push, 1),
+            code(BC::e_AddInts),
+            code(BC::e_Store, 1),
+            code(BC::e_IncInt, 0),
+            code(BC::e_Jump, 6),
+            code(BC::e_Load, 1),
+            code(BC::e_Exit),
+            code(BC::e_Load, 0),                                      // 19
+            code(BC::e_Push, 10),
+            code(BC::e_IfEqInts, 17),
+            code(BC::e_Load, 2),                                      // 22
+            code(BC::e_Load, 3),
+            code(BC::e_AddInts),
+            code(BC::e_Load, 8),                                      // 25
+            code(BC::e_Push, 1),
+            code(BC::e_AddInts),
+            code(BC::e_Load, 9),                                      // 28
+            code(BC::e_Store, 1),
+            code(BC::e_IncInt, 0),
+            code(BC::e_Load, 0),                                      // 31
+            code(BC::e_Push, 10),
+            code(BC::e_IfEqInts, 35),
+            code(BC::e_Jump, 28),
+            code(BC::e_Resize, 8),                                    // 35
+            code(BC::e_Jump, 17),
+        };
+        const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+        ASSERT(isSame(codes, EXPECTED, NUM_EXPECTED));
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "unrolling" << endl
+                          << "=========" << endl;
+
+        // A loop whose iterations fit is fully unrolled.
+
+        {
+            bsl::vector<BC> codes;
+            sumLoop(&codes);
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(1 == Util::optimize(&codes, &loops));
+            ASSERTV(loops.size(), 1 == loops.size());
+            ASSERT( 4 == loops[0].d_tripCount);
+            ASSERT( 0 == loops[0].d_numHoisted);
+            ASSERT( 0 == loops[0].d_factor);
+            ASSERT(15 == loops[0].d_copy);
+            ASSERT(code(BC::e_Jump, 15) == codes[4]);
+            ASSERTV(codes.size(), 36 == codes.size());
+
+            for (int i = 0; i < 4; ++i) {
+                ASSERTV(i, code(BC::e_Load, 1)   == codes[15 + 5 * i]);
+                ASSERTV(i, code(BC::e_Load, 0)   == codes[16 + 5 * i]);
+                ASSERTV(i, code(BC::e_AddInts)   == codes[17 + 5 * i]);
+                ASSERTV(i, code(BC::e_Store, 1)  == codes[18 + 5 * i]);
+                ASSERTV(i, code(BC::e_IncInt, 0) == codes[19 + 5 * i]);
+            }
+            ASSERT(code(BC::e_Jump, 13) == codes[35]);
+        }
+
+        // Otherwise, its body is repeated by the largest factor of its
+        // iterations that fits.
+
+        {
+            bsl::vector<BC> codes;
+            sumLoop(&codes);
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(1 == Util::optimize(&codes, &loops, 10));
+            ASSERTV(loops.size(), 1 == loops.size());
+            ASSERT(2 == loops[0].d_factor);
+
+            const BC EXPECTED[] = {
+                code(BC::e_Load, 1),                                  // 15
+                code(BC::e_Load, 0),
+                code(BC::e_AddInts),
+                code(BC::e_Store, 1),
+                code(BC::e_IncInt, 0),
+                code(BC::e_Load, 1),
+                code(BC::e_Load, 0),
+                code(BC::e_AddInts),
+                code(BC::e_Store, 1),
+                code(BC::e_IncInt, 0),
+                code(BC::e_Load, 0),                                  // 25
+                code(BC::e_Push, 4),
+                code(BC::e_IfEqInts, 13),
+                code(BC::e_Jump, 15),
+            };
+            const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+            const bsl::vector<BC> copy(codes.begin() + 15, codes.end());
+            ASSERT(isSame(copy, EXPECTED, NUM_EXPECTED));
+        }
+
+        // A loop that does not fit, or whose number of iterations is prime
+        // and too large, is unchanged.
+
+        {
+            bsl::vector<BC> codes;
+            sumLoop(&codes);
+            const bsl::vector<BC> ORIGINAL(codes);
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(0 == Util::optimize(&codes, &loops, 4));
+            ASSERT(ORIGINAL == codes);
+            ASSERTV(loops.size(), 1 == loops.size());
+            ASSERT( 1 == loops[0].d_factor);
+            ASSERT(-1 == loops[0].d_copy);
+
+            codes[10] = code(BC::e_Push, 7);
+            ASSERT(0 == Util::optimize(&codes, &loops, 20));
+            ASSERT(7 == loops[0].d_tripCount);
+        }
+
+        // A loop testing first that never iterates is replaced by a jump
+        // past it.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 3));                     // 0
+            codes.push_back(code(BC::e_Store, 0));                    // 1
+            codes.push_back(code(BC::e_Load, 0));                     // 2
+            codes.push_back(code(BC::e_Push, 3));                     // 3
+            codes.push_back(code(BC::e_IfEqInts, 7));                 // 4
+            codes.push_back(code(BC::e_IncInt, 0));                   // 5
+            codes.push_back(code(BC::e_Jump, 2));                     // 6
+            codes.push_back(code(BC::e_Load, 0));                     // 7
+            codes.push_back(code(BC::e_Exit));                        // 8
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(1 == Util::optimize(&codes, &loops));
+            ASSERTV(loops.size(), 1 == loops.size());
+            ASSERT(0 == loops[0].d_tripCount);
+            ASSERT(0 == loops[0].d_factor);
+            ASSERTV(codes.size(), 10 == codes.size());
+            ASSERT(code(BC::e_Jump, 9) == codes[2]);
+            ASSERT(code(BC::e_Jump, 7) == codes[9]);
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "finding loops" << endl
+                          << "=============" << endl;
+
+        // Nested loops are found in the order of their latches; only the
+        // inner one counts.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 0));                     //  0
+            codes.push_back(code(BC::e_Store, 0));                    //  1
+            codes.push_back(code(BC::e_Push, 0));                     //  2
+            codes.push_back(code(BC::e_Store, 1));                    //  3
+            codes.push_back(code(BC::e_IncInt, 1));                   //  4
+            codes.push_back(code(BC::e_Load, 1));                     //  5
+            codes.push_back(code(BC::e_Push, 3));                     //  6
+            codes.push_back(code(BC::e_IfEqInts, 9));                 //  7
+            codes.push_back(code(BC::e_Jump, 4));                     //  8
+            codes.push_back(code(BC::e_IncInt, 0));                   //  9
+            codes.push_back(code(BC::e_Push, 2));                     // 10
+            codes.push_back(code(BC::e_Load, 0));                     // 11
+            codes.push_back(code(BC::e_IfEqInts, 14));                // 12
+            codes.push_back(code(BC::e_Jump, 2));                     // 13
+            codes.push_back(code(BC::e_Load, 0));                     // 14
+            codes.push_back(code(BC::e_Exit));                        // 15
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(0 == Util::findLoops(&loops, codes));
+            ASSERTV(loops.size(), 2 == loops.size());
+
+            ASSERT( 4 == loops[0].d_header);
+            ASSERT( 8 == loops[0].d_latch);
+            ASSERT( 5 == loops[0].d_size);
+            ASSERT( 1 == loops[0].d_slot);
+            ASSERT( 3 == loops[0].d_tripCount);
+            ASSERT( 0 == loops[0].d_numHoisted);
+            ASSERT( 1 == loops[0].d_factor);
+            ASSERT(-1 == loops[0].d_copy);
+
+            ASSERT( 2 == loops[1].d_header);
+            ASSERT(13 == loops[1].d_latch);
+            ASSERT(12 == loops[1].d_size);
+            ASSERT(-1 == loops[1].d_slot);
+            ASSERT(-1 == loops[1].d_tripCount);
+        }
+
+        // A jump back to a code that a path to it does not pass through is
+        // not a loop.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(push(true));                              // 0
+            codes.push_back(code(BC::e_If, 4));                       // 1
+            codes.push_back(code(BC::e_Push, 0));                     // 2
+            codes.push_back(code(BC::e_Store, 0));                    // 3
+            codes.push_back(code(BC::e_Jump, 3));                     // 4
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(0 == Util::findLoops(&loops, codes));
+            ASSERT(loops.empty());
+        }
+
+        // The number of iterations is not known if a jump enters the code
+        // after the induction variable is initialized, or if the induction
+        // variable overflows first.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(push(true));                              //  0
+            codes.push_back(code(BC::e_If, 4));                       //  1
+            codes.push_back(code(BC::e_Push, 0));                     //  2
+            codes.push_back(code(BC::e_Store, 0));                    //  3
+            codes.push_back(code(BC::e_Push, 0));                     //  4
+            codes.push_back(code(BC::e_Store, 1));                    //  5
+            codes.push_back(code(BC::e_Load, 1));                     //  6
+            codes.push_back(code(BC::e_Load, 0));                     //  7
+            codes.push_back(code(BC::e_AddInts));                     //  8
+            codes.push_back(code(BC::e_Store, 1));                    //  9
+            codes.push_back(code(BC::e_IncInt, 0));                   // 10
+            codes.push_back(code(BC::e_Load, 0));                     // 11
+            codes.push_back(code(BC::e_Push, 4));                     // 12
+            codes.push_back(code(BC::e_IfEqInts, 15));                // 13
+            codes.push_back(code(BC::e_Jump, 6));                     // 14
+            codes.push_back(code(BC::e_Load, 1));                     // 15
+            codes.push_back(code(BC::e_Exit));                        // 16
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(0 == Util::findLoops(&loops, codes));
+            ASSERTV(loops.size(), 1 == loops.size());
+            ASSERT( 0 == loops[0].d_slot);
+            ASSERT(-1 == loops[0].d_tripCount);
+        }
+        {
+            bsl::vector<BC> codes;
+            sumLoop(&codes);
+            codes[10] = code(BC::e_Push, 0);
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(0 == Util::findLoops(&loops, codes));
+            ASSERTV(loops.size(), 1 == loops.size());
+            ASSERT( 0 == loops[0].d_slot);
+            ASSERT(-1 == loops[0].d_tripCount);
+        }
+
+        // No loops are found if a code is evaluated by frames having
+        // different first codes.
+
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_PushCode, 3));                 // 0
+            codes.push_back(code(BC::e_Push, 0));                     // 1
+            codes.push_back(code(BC::e_CallValue));                   // 2
+            codes.push_back(code(BC::e_Push, 1));                     // 3
+            codes.push_back(code(BC::e_Exit));                        // 4
+
+            bsl::vector<Util::Loop> loops;
+            ASSERT(0 != Util::findLoops(&loops, codes));
+            ASSERT(loops.empty());
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bsl::vector<BC> codes;
+        sumLoop(&codes);
+
+        bsl::vector<Util::Loop> loops;
+        ASSERT(0 == Util::findLoops(&loops, codes));
+        ASSERTV(loops.size(), 1 == loops.size());
+        ASSERT( 4 == loops[0].d_header);
+        ASSERT(12 == loops[0].d_latch);
+        ASSERT( 9 == loops[0].d_size);
+        ASSERT( 0 == loops[0].d_slot);
+        ASSERT( 4 == loops[0].d_tripCount);
+
+        ASSERT(1 == Util::optimize(&codes));
+        ASSERT(code(BC::e_Jump, 15) == codes[4]);
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,96 @@
+// sjto_osrutil.cpp
+#include <sjto_osrutil.h>
+
+#include <sjto_constantfoldutil.h>
+#include <sjto_functionutil.h>
+#include <sjto_inlineutil.h>
+#include <sjto_looputil.h>
+#include <sjto_peepholeutil.h>
+
+#include <bdld_datum.h>
+
+#include <bsls_assert.h>
+
+namespace sjto {
+namespace {
+
+using BloombergLP::bdld::Datum;
+
+typedef sjtt::Bytecode Bytecode;
+
+const int k_ENTRY_SIZE = 2;  // number of codes of the entry
+
+bool isRelative(Bytecode::Opcode opcode)
+    // Return 'true' if the data of a code having the specified 'opcode' is
+    // an index relative to the first code of the frame evaluating it, and
+    // 'false' otherwise.
+{
+    return Bytecode::e_Jump     == opcode ||
+           Bytecode::e_If       == opcode ||
+           Bytecode::e_IfEqInts == opcode ||
+           Bytecode::e_Call     == opcode ||
+           Bytecode::e_TailCall == opcode ||
+           Bytecode::e_PushCode == opcode;
+}
+
+Bytecode createCode(Bytecode::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return Bytecode::createOpcode(opcode, Datum::createInteger(data));
+}
+
+}  // close unnamed namespace
+
+                              // --------------
+                              // struct OsrUtil
+                              // --------------
+
+// CLASS METHODS
+int OsrUtil::compile(bsl::vector<sjtt::Bytecode> *result,
+                     const sjtt::Bytecode        *firstCode,
+                     int                          header,
+                     int                          height)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != firstCode);
+    BSLS_ASSERT(0 <= header);
+    BSLS_ASSERT(0 <= height);
+
+    const int numCodes = FunctionUtil::findNumCodes(firstCode);
+
+    const bsl::vector<Bytecode> codes(firstCode, firstCode + numCodes);
+    bsl::vector<int>            firstCodes;
+    if (0 != FunctionUtil::findFirstCodes(&firstCodes, codes) ||
+        numCodes <= header ||
+        0 != firstCodes[header]) {
+        return 1;                                                     // RETURN
+    }
+
+    // The 'e_Resize' tells the passes the height of the frame at the entry,
+    // so that they do not assume the values of its slots.
+
+    result->clear();
+    result->reserve(k_ENTRY_SIZE + numCodes);
+    result->push_back(createCode(Bytecode::e_Resize, height));
+    result->push_back(createCode(Bytecode::e_Jump, header + k_ENTRY_SIZE));
+    for (int index = 0; index < numCodes; ++index) {
+        const Bytecode& code = codes[index];
+        if (0 == firstCodes[index] &&
+            isRelative(code.opcode()) &&
+            code.data().isInteger()) {
+            result->push_back(createCode(
+                                   code.opcode(),
+                                   code.data().theInteger() + k_ENTRY_SIZE));
+        }
+        else {
+            result->push_back(code);
+        }
+    }
+
+    InlineUtil::inlineCalls(result);
+    LoopUtil::optimize(result);
+    ConstantFoldUtil::optimize(result, height);
+    PeepholeUtil::optimize(result);
+    return 0;
+}
+}
@@ -0,0 +1,64 @@
+// sjto_osrutil.h
+
+#ifndef INCLUDED_SJTO_OSRUTIL
+#define INCLUDED_SJTO_OSRUTIL
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace sjto {
+
+                              // ==============
+                              // struct OsrUtil
+                              // ==============
+
+struct OsrUtil {
+    // This 'struct' provides a namespace for functions that compile, for
+    // on-stack replacement, an optimized version of a function to be entered
+    // in the middle of its evaluation, at the header of one of its loops.
+    //
+    // A frame evaluating a function continues in the compiled version by
+    // replacing its first code and program counter with the first code of
+    // that version, keeping its values in place: the version begins with an
+    // entry, an 'e_Resize' to the number of values the frame has at the
+    // header, which changes nothing, and an 'e_Jump' to the header.  Its
+    // codes are those reachable from the first code of the frame, moved up
+    // by two, with the indices stored by the codes evaluated by frames
+    // beginning at that first code moved with them, so that the version is
+    // a program whose index 0 is the entry, and whose other functions are
+    // called as they were.  That program is then optimized by
+    // 'InlineUtil', 'LoopUtil', 'ConstantFoldUtil' and 'PeepholeUtil', in
+    // that order, so that the codes the frame has already evaluated, and
+    // that the loop no longer reaches, are removed, and the values of its
+    // slots are not assumed to be known at the entry.
+    //
+    // The codes reachable from the first code are found by following jumps,
+    // branches, calls and 'e_PushCode' from it, so the program need not be
+    // given with its length.  Note that the ranges of an
+    // 'sjtt::ExceptionTable' do not cover the compiled version, so the
+    // frames of a program having exception handlers must not be replaced.
+
+    // CLASS METHODS
+    static int compile(bsl::vector<sjtt::Bytecode> *result,
+                       const sjtt::Bytecode        *firstCode,
+                       int                          header,
+                       int                          height);
+        // Load into the specified 'result' a version, as described above, of
+        // the function containing the code at the specified 'header' index
+        // from the specified 'firstCode' of a frame, which has the specified
+        // 'height' number of values when evaluating that code.  Return 0 on
+        // success, and a non-zero value, with 'result' unspecified, if
+        // 'header' is not reached from 'firstCode' by frames beginning at
+        // 'firstCode'.  The behavior is undefined unless every path from
+        // 'firstCode' ends in an 'e_Exit', 'e_TailCall', 'e_Throw' or
+        // 'e_Jump' and reaches only valid indices, '0 <= header', and
+        // '0 <= height'.
+};
+}
+
+#endif
@@ -0,0 +1,187 @@
+// sjto_osrutil.t.cpp                                             -*-C++-*-
+
+#include <sjto_osrutil.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+typedef OsrUtil        Util;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+void sumLoop(bsl::vector<BC> *codes)
+    // Append to the specified 'codes' a program summing, in slot 1, the
+    // values of its induction variable, in slot 0, from 0 to 3, with the test
+    // following the body.
+{
+    codes->push_back(code(BC::e_Push, 0));                            //  0
+    codes->push_back(code(BC::e_Store, 0));                           //  1
+    codes->push_back(code(BC::e_Push, 0));                            //  2
+    codes->push_back(code(BC::e_Store, 1));                           //  3
+    codes->push_back(code(BC::e_Load, 1));                            //  4
+    codes->push_back(code(BC::e_Load, 0));                            //  5
+    codes->push_back(code(BC::e_AddInts));                            //  6
+    codes->push_back(code(BC::e_Store, 1));                           //  7
+    codes->push_back(code(BC::e_IncInt, 0));                          //  8
+    codes->push_back(code(BC::e_Load, 0));                            //  9
+    codes->push_back(code(BC::e_Push, 4));                            // 10
+    codes->push_back(code(BC::e_IfEqInts, 13));                       // 11
+    codes->push_back(code(BC::e_Jump, 4));                            // 12
+    codes->push_back(code(BC::e_Load, 1));                            // 13
+    codes->push_back(code(BC::e_Exit));                               // 14
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "failures" << endl
+                          << "========" << endl;
+
+        // A header must be evaluated by frames beginning at the given first
+        // code.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_PushCode, 2));                     //  0
+        codes.push_back(code(BC::e_Exit));                            //  1
+        codes.push_back(code(BC::e_Push, 1));                         //  2
+        codes.push_back(code(BC::e_Exit));                            //  3
+
+        bsl::vector<BC> result;
+        ASSERT(0 == Util::compile(&result, codes.data(), 1, 9));
+        ASSERT(code(BC::e_Resize, 9) == result[0]);
+        ASSERT(0 != Util::compile(&result, codes.data(), 2, 9));
+        ASSERT(0 != Util::compile(&result, codes.data(), 4, 9));
+        ASSERT(0 == Util::compile(&result, codes.data() + 2, 0, 8));
+
+        // A code evaluated by frames having different first codes is a
+        // conflict.
+
+        codes[1] = code(BC::e_Jump, 2);
+        ASSERT(0 != Util::compile(&result, codes.data(), 0, 8));
+        ASSERT(0 == Util::compile(&result, codes.data() + 2, 0, 8));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bsl::vector<BC> codes;
+        sumLoop(&codes);
+
+        // The codes initializing the slots are no longer reached from the
+        // entry, so they are removed.
+
+        const BC EXP[] = {
+            code(BC::e_Resize, 8),                                    //  0
+            code(BC::e_Load, 1),                                      //  1
+            code(BC::e_Load, 0),                                      //  2
+            code(BC::e_AddInts),                                      //  3
+            code(BC::e_Store, 1),                                     //  4
+            code(BC::e_IncInt, 0),                                    //  5
+            code(BC::e_Load, 0),                                      //  6
+            code(BC::e_Push, 4),                                      //  7
+            code(BC::e_IfEqInts, 10),                                 //  8
+            code(BC::e_Jump, 1),                                      //  9
+            code(BC::e_Load, 1),                                      // 10
+            code(BC::e_Exit),                                         // 11
+        };
+        const int NUM_EXP = sizeof EXP / sizeof *EXP;
+
+        bsl::vector<BC> result;
+        ASSERT(0 == Util::compile(&result, codes.data(), 4, 8));
+        ASSERTV(result.size(), NUM_EXP == static_cast<int>(result.size()));
+        for (int i = 0; i < NUM_EXP && i < static_cast<int>(result.size());
+             ++i) {
+            ASSERTV(i, EXP[i] == result[i]);
+        }
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
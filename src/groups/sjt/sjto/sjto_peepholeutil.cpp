@@ -0,0 +1,42 @@
+// sjto_peepholeutil.cpp
+#include <sjto_peepholeutil.h>
+
+#include <bsls_assert.h>
+
+#include <sjtt_exceptiontable.h>
+
+namespace sjto {
+
+                            // -------------------
+                            // struct PeepholeUtil
+                            // -------------------
+
+// CLASS METHODS
+int PeepholeUtil::optimize(bsl::vector<sjtt::Bytecode> *codes,
+                           const sjtt::ExceptionTable  *handlers)
+{
+    BSLS_ASSERT(0 != codes);
+
+    return rewriteTailCalls(codes, handlers);
+}
+
+int PeepholeUtil::rewriteTailCalls(bsl::vector<sjtt::Bytecode> *codes,
+                                   const sjtt::ExceptionTable  *handlers)
+{
+    BSLS_ASSERT(0 != codes);
+
+    int numRewritten = 0;
+    for (bsl::size_t i = 0; i + 1 < codes->size(); ++i) {
+        sjtt::Bytecode& code = (*codes)[i];
+        if (sjtt::Bytecode::e_Call == code.opcode() &&
+            sjtt::Bytecode::e_Exit == (*codes)[i + 1].opcode() &&
+            (0 == handlers ||
+             0 == handlers->findHandler(static_cast<int>(i)))) {
+            code = sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_TailCall,
+                                                code.data());
+            ++numRewritten;
+        }
+    }
+    return numRewritten;
+}
+}
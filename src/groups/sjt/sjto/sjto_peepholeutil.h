@@ -0,0 +1,49 @@
+// sjto_peepholeutil.h
+
+#ifndef INCLUDED_SJTO_PEEPHOLEUTIL
+#define INCLUDED_SJTO_PEEPHOLEUTIL
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace sjtt { class ExceptionTable; }
+
+namespace sjto {
+
+                            // ===================
+                            // struct PeepholeUtil
+                            // ===================
+
+struct PeepholeUtil {
+    // This 'struct' provides a namespace for functions that rewrite short
+    // sequences of bytecode into equivalent, cheaper ones.  Each rewrite
+    // replaces codes in place and never moves a code, so the indices used by
+    // jumps and calls remain valid, and so do the ranges of exception
+    // handlers.  The rewrites are equivalent only if the handlers of codes
+    // that have any are supplied.
+
+    // CLASS METHODS
+    static int optimize(bsl::vector<sjtt::Bytecode> *codes,
+                        const sjtt::ExceptionTable  *handlers = 0);
+        // Apply every rewrite described below to the specified 'codes', whose
+        // exception handlers are described by the optionally specified
+        // 'handlers', and return the number of codes rewritten.
+
+    static int rewriteTailCalls(bsl::vector<sjtt::Bytecode> *codes,
+                                const sjtt::ExceptionTable  *handlers = 0);
+        // Replace each 'e_Call' in the specified 'codes' that is immediately
+        // followed by an 'e_Exit' with an 'e_TailCall' to the same index, and
+        // return the number of calls replaced.  The 'e_Exit' is kept, as it
+        // may be the target of a jump.  A call covered by a handler of the
+        // optionally specified 'handlers', which describes the exception
+        // handlers of 'codes', is not replaced, as the tail call would remove
+        // the frame of that handler.
+};
+}
+
+#endif
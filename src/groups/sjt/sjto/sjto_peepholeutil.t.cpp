@@ -0,0 +1,182 @@
+// sjto_peepholeutil.t.cpp                                        -*-C++-*-
+
+#include <sjto_peepholeutil.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtt_exceptiontable.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "exception handlers" << endl
+                          << "==================" << endl;
+
+        // A call covered by a handler is not made a tail call, as its frame
+        // holds the handler; other calls are.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Push, 0));                         // 0
+        codes.push_back(code(BC::e_Call, 6));                         // 1
+        codes.push_back(BC::createOpcode(BC::e_Exit));                // 2
+        codes.push_back(BC::createOpcode(BC::e_Exit));                // 3
+        codes.push_back(code(BC::e_Call, 6));                         // 4
+        codes.push_back(BC::createOpcode(BC::e_Exit));                // 5
+        codes.push_back(code(BC::e_Push, 42));                        // 6
+        codes.push_back(BC::createOpcode(BC::e_Throw));               // 7
+
+        sjtt::ExceptionTable handlers;
+        handlers.addHandler(1, 2, 3, 0);
+
+        bsl::vector<BC> copy(codes);
+        ASSERT(1 == PeepholeUtil::rewriteTailCalls(&copy, &handlers));
+        ASSERT(code(BC::e_Call, 6) == copy[1]);
+        ASSERT(code(BC::e_TailCall, 6) == copy[4]);
+
+        copy = codes;
+        ASSERT(1 == PeepholeUtil::optimize(&copy, &handlers));
+        ASSERT(code(BC::e_Call, 6) == copy[1]);
+        ASSERT(code(BC::e_TailCall, 6) == copy[4]);
+
+        // Without handlers, both calls are rewritten.
+
+        sjtt::ExceptionTable none;
+        copy = codes;
+        ASSERT(2 == PeepholeUtil::rewriteTailCalls(&copy, &none));
+        copy = codes;
+        ASSERT(2 == PeepholeUtil::rewriteTailCalls(&copy));
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "optimize" << endl
+                          << "========" << endl;
+
+        // 'optimize' rewrites tail calls.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Push, 0));
+        codes.push_back(code(BC::e_Call, 3));
+        codes.push_back(BC::createOpcode(BC::e_Exit));
+        codes.push_back(code(BC::e_Push, 1));
+        codes.push_back(BC::createOpcode(BC::e_Exit));
+
+        ASSERT(1 == PeepholeUtil::optimize(&codes));
+        ASSERT(5 == codes.size());
+        ASSERT(code(BC::e_TailCall, 3) == codes[1]);
+        ASSERT(0 == PeepholeUtil::optimize(&codes));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "rewriteTailCalls" << endl
+                          << "================" << endl;
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Call, 7));                         // 0
+        codes.push_back(BC::createOpcode(BC::e_Exit));                // 1
+        codes.push_back(code(BC::e_Call, 7));                         // 2
+        codes.push_back(code(BC::e_Store, 0));                        // 3
+        codes.push_back(BC::createOpcode(BC::e_Exit));                // 4
+        codes.push_back(code(BC::e_Push, 1));                         // 5
+        codes.push_back(code(BC::e_Call, 8));                         // 6
+        codes.push_back(BC::createOpcode(BC::e_Exit));                // 7
+        codes.push_back(code(BC::e_Call, 0));                         // 8
+
+        ASSERT(2 == PeepholeUtil::rewriteTailCalls(&codes));
+        ASSERT(9 == codes.size());
+        ASSERT(code(BC::e_TailCall, 7) == codes[0]);
+        ASSERT(BC::createOpcode(BC::e_Exit) == codes[1]);
+        ASSERT(code(BC::e_Call, 7) == codes[2]);
+        ASSERT(code(BC::e_TailCall, 8) == codes[6]);
+        ASSERT(BC::createOpcode(BC::e_Exit) == codes[7]);
+        ASSERT(code(BC::e_Call, 0) == codes[8]);
+
+        bsl::vector<BC> empty;
+        ASSERT(0 == PeepholeUtil::rewriteTailCalls(&empty));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
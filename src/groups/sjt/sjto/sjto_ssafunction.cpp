@@ -0,0 +1,252 @@
+// sjto_ssafunction.cpp
+#include <sjto_ssafunction.h>
+
+#include <bsl_ostream.h>
+
+namespace sjto {
+namespace {
+
+const char *mnemonic(sjtt::Bytecode::Opcode opcode)
+    // Return the mnemonic of the specified 'opcode' in the bytecode DSL.
+{
+    switch (opcode) {
+      case sjtt::Bytecode::e_Push:          return "P";               // RETURN
+      case sjtt::Bytecode::e_Load:          return "L";               // RETURN
+      case sjtt::Bytecode::e_Store:         return "S";               // RETURN
+      case sjtt::Bytecode::e_Jump:          return "J";               // RETURN
+      case sjtt::Bytecode::e_If:            return "I";               // RETURN
+      case sjtt::Bytecode::e_IfEqInts:      return "I=i";             // RETURN
+      case sjtt::Bytecode::e_EqInts:        return "=i";              // RETURN
+      case sjtt::Bytecode::e_IncInt:        return "++i";             // RETURN
+      case sjtt::Bytecode::e_AddDoubles:    return "+d";              // RETURN
+      case sjtt::Bytecode::e_AddInts:       return "+i";              // RETURN
+      case sjtt::Bytecode::e_Call:          return "C";               // RETURN
+      case sjtt::Bytecode::e_Execute:       return "E";               // RETURN
+      case sjtt::Bytecode::e_Exit:          return "X";               // RETURN
+      case sjtt::Bytecode::e_Resize:        return "V";               // RETURN
+      case sjtt::Bytecode::e_NewObject:     return "N";               // RETURN
+      case sjtt::Bytecode::e_GetSlot:       return "G";               // RETURN
+      case sjtt::Bytecode::e_SetSlot:       return "W";               // RETURN
+      case sjtt::Bytecode::e_GetProp:       return ".";               // RETURN
+      case sjtt::Bytecode::e_SetProp:       return ".=";              // RETURN
+      case sjtt::Bytecode::e_NewTypedArray: return "A";               // RETURN
+      case sjtt::Bytecode::e_GetElement:    return "[";               // RETURN
+      case sjtt::Bytecode::e_SetElement:    return "[=";              // RETURN
+      case sjtt::Bytecode::e_ArrayLength:   return "#len";            // RETURN
+      case sjtt::Bytecode::e_ArraySum:      return "#sum";            // RETURN
+      case sjtt::Bytecode::e_ArrayDot:      return "#dot";            // RETURN
+      case sjtt::Bytecode::e_ArrayMin:      return "#min";            // RETURN
+      case sjtt::Bytecode::e_ArrayMax:      return "#max";            // RETURN
+      case sjtt::Bytecode::e_ArrayScale:    return "#scale";          // RETURN
+      case sjtt::Bytecode::e_ArrayAdd:      return "#add";            // RETURN
+      case sjtt::Bytecode::e_PushCode:      return "F";               // RETURN
+      case sjtt::Bytecode::e_MakeClosure:   return "Fc";              // RETURN
+      case sjtt::Bytecode::e_LoadCaptured:  return "Lc";              // RETURN
+      case sjtt::Bytecode::e_CallValue:     return "@";               // RETURN
+      case sjtt::Bytecode::e_TailCall:      return "T";               // RETURN
+      case sjtt::Bytecode::e_Throw:         return "!";               // RETURN
+    }
+    return "?";
+}
+
+}  // close unnamed namespace
+
+                             // -----------------
+                             // class SsaFunction
+                             // -----------------
+
+// CLASS METHODS
+bool SsaFunction::hasValue(sjtt::Bytecode::Opcode opcode)
+{
+    switch (opcode) {
+      case sjtt::Bytecode::e_Load:
+      case sjtt::Bytecode::e_Store:
+      case sjtt::Bytecode::e_Jump:
+      case sjtt::Bytecode::e_If:
+      case sjtt::Bytecode::e_IfEqInts:
+      case sjtt::Bytecode::e_Exit:
+      case sjtt::Bytecode::e_Resize:
+      case sjtt::Bytecode::e_SetSlot:
+      case sjtt::Bytecode::e_SetProp:
+      case sjtt::Bytecode::e_SetElement:
+      case sjtt::Bytecode::e_ArrayScale:
+      case sjtt::Bytecode::e_ArrayAdd:
+      case sjtt::Bytecode::e_TailCall:
+      case sjtt::Bytecode::e_Throw: {
+        return false;                                                 // RETURN
+      }
+      default: {
+        return true;                                                  // RETURN
+      }
+    }
+}
+
+bool SsaFunction::isTerminator(sjtt::Bytecode::Opcode opcode)
+{
+    switch (opcode) {
+      case sjtt::Bytecode::e_Jump:
+      case sjtt::Bytecode::e_If:
+      case sjtt::Bytecode::e_IfEqInts:
+      case sjtt::Bytecode::e_Exit:
+      case sjtt::Bytecode::e_TailCall:
+      case sjtt::Bytecode::e_Throw: {
+        return true;                                                  // RETURN
+      }
+      default: {
+        return false;                                                 // RETURN
+      }
+    }
+}
+
+// CREATORS
+SsaFunction::SsaFunction(Allocator *basicAllocator)
+: d_kinds(basicAllocator)
+, d_codes(basicAllocator)
+, d_blockOf(basicAllocator)
+, d_operands(basicAllocator)
+, d_instructions(basicAllocator)
+, d_successors(basicAllocator)
+, d_predecessors(basicAllocator)
+, d_firstCodes(basicAllocator)
+, d_numParameters(0)
+{
+}
+
+// MANIPULATORS
+int SsaFunction::addBlock(int firstCode)
+{
+    BSLS_ASSERT(-1 <= firstCode);
+
+    d_instructions.resize(d_instructions.size() + 1);
+    d_successors.resize(d_successors.size() + 1);
+    d_predecessors.resize(d_predecessors.size() + 1);
+    d_firstCodes.push_back(firstCode);
+    return numBlocks() - 1;
+}
+
+void SsaFunction::addEdge(int from, int to)
+{
+    BSLS_ASSERT(0 <= from);
+    BSLS_ASSERT(from < numBlocks());
+    BSLS_ASSERT(0 <= to);
+    BSLS_ASSERT(to < numBlocks());
+
+    d_successors[from].push_back(to);
+    d_predecessors[to].push_back(from);
+}
+
+int SsaFunction::addInstruction(int                   block,
+                                Kind                  kind,
+                                const sjtt::Bytecode& code)
+{
+    BSLS_ASSERT(0 <= block);
+    BSLS_ASSERT(block < numBlocks());
+    BSLS_ASSERT(e_Parameter != kind ||
+                (0 == block && numInstructions() == d_numParameters));
+
+    const int instruction = numInstructions();
+    d_kinds.push_back(kind);
+    d_codes.push_back(code);
+    d_blockOf.push_back(block);
+    d_operands.resize(d_operands.size() + 1);
+    d_instructions[block].push_back(instruction);
+    if (e_Parameter == kind) {
+        ++d_numParameters;
+    }
+    return instruction;
+}
+
+void SsaFunction::addOperand(int instruction, int value)
+{
+    BSLS_ASSERT(0 <= instruction);
+    BSLS_ASSERT(instruction < numInstructions());
+    BSLS_ASSERT(0 <= value);
+
+    d_operands[instruction].push_back(value);
+}
+
+void SsaFunction::setOperand(int instruction, int index, int value)
+{
+    BSLS_ASSERT(0 <= instruction);
+    BSLS_ASSERT(instruction < numInstructions());
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < static_cast<int>(d_operands[instruction].size()));
+    BSLS_ASSERT(0 <= value);
+
+    d_operands[instruction][index] = value;
+}
+
+// ACCESSORS
+bool SsaFunction::hasValue(int instruction) const
+{
+    return e_Operation != kind(instruction) ||
+           hasValue(code(instruction).opcode());
+}
+
+bsl::ostream& SsaFunction::print(bsl::ostream& stream) const
+{
+    for (int b = 0; b < numBlocks(); ++b) {
+        stream << 'b' << b << ':';
+        if (!d_predecessors[b].empty()) {
+            stream << " <-";
+            for (bsl::size_t i = 0; i < d_predecessors[b].size(); ++i) {
+                stream << " b" << d_predecessors[b][i];
+            }
+        }
+        stream << '\n';
+
+        const bsl::vector<int>& block = d_instructions[b];
+        for (bsl::size_t i = 0; i < block.size(); ++i) {
+            const int             instruction = block[i];
+            const sjtt::Bytecode& code        = d_codes[instruction];
+
+            stream << "    ";
+            if (hasValue(instruction)) {
+                stream << 'v' << instruction << " = ";
+            }
+            switch (d_kinds[instruction]) {
+              case e_Parameter: {
+                stream << "param " << code.data().theInteger();
+              } break;
+              case e_Phi: {
+                stream << "phi";
+              } break;
+              case e_Operation: {
+                stream << mnemonic(code.opcode());
+                if (sjtt::Bytecode::e_Push == code.opcode()) {
+                    stream << ' ' << code.data();
+                }
+                else if (sjtt::Bytecode::e_NewTypedArray == code.opcode()) {
+                    stream << (0 == code.data().theInteger() ? 'i' : 'd');
+                }
+                else if (code.data().isInteger()) {
+                    stream << code.data().theInteger();
+                }
+                else if (code.data().isString()) {
+                    stream << code.data().theString();
+                }
+              } break;
+            }
+
+            const bsl::vector<int>& operands = d_operands[instruction];
+            for (bsl::size_t j = 0; j < operands.size(); ++j) {
+                stream << " v" << operands[j];
+            }
+            if (e_Operation == d_kinds[instruction] &&
+                isTerminator(code.opcode())) {
+                for (bsl::size_t j = 0; j < d_successors[b].size(); ++j) {
+                    stream << " b" << d_successors[b][j];
+                }
+            }
+            stream << '\n';
+        }
+    }
+    return stream;
+}
+
+// FREE OPERATORS
+bsl::ostream& operator<<(bsl::ostream& stream, const SsaFunction& function)
+{
+    return function.print(stream);
+}
+}
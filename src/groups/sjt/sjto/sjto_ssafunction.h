@@ -0,0 +1,314 @@
+// sjto_ssafunction.h
+
+#ifndef INCLUDED_SJTO_SSAFUNCTION
+#define INCLUDED_SJTO_SSAFUNCTION
+
+#ifndef INCLUDED_BSL_IOSFWD
+#include <bsl_iosfwd.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjto {
+
+                             // =================
+                             // class SsaFunction
+                             // =================
+
+class SsaFunction {
+    // This class is a mechanism holding one function of Scramjet bytecode in
+    // static single assignment (SSA) form: a control-flow graph of basic
+    // blocks, each a sequence of instructions ending with a terminator.
+    // Every instruction is identified by its index, which also names the
+    // value it defines, if any; each value is defined by exactly one
+    // instruction, and the values of the slots of the frame -- the arguments,
+    // locals and temporaries that bytecode keeps on its value stack -- become
+    // operands of the instructions that use them.
+    //
+    // There are three kinds of instruction:
+    //: o A parameter is the value of a slot of the frame when the function
+    //:   starts; the parameters are the first instructions of the first
+    //:   block, which is the entry of the function.
+    //:
+    //: o A phi is the value of a slot at the start of a block having several
+    //:   predecessors, having one operand per predecessor, in the order of
+    //:   'predecessors': the value of the slot at the end of that
+    //:   predecessor.  The phis of a block precede its other instructions.
+    //:
+    //: o An operation is the evaluation of a code, whose opcode and data are
+    //:   those of the code, and whose operands are the values the code pops,
+    //:   in the order they were pushed.  'e_Load', 'e_Store' and 'e_Resize'
+    //:   only move values between slots, so are never operations; the data of
+    //:   branches and of 'e_IncInt' is null, as their targets and slots are
+    //:   described by the graph and the operands.  The count of arguments
+    //:   popped by a call is the number of its argument operands, and is not
+    //:   an operand.
+    //
+    // The last instruction of each block is an operation whose opcode is a
+    // terminator (see 'isTerminator').  A block ending with 'e_Jump' has one
+    // successor; a block ending with 'e_If' or 'e_IfEqInts' has two: the
+    // block at which evaluation continues when the branch is taken, then the
+    // one at which it continues otherwise.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    enum Kind {
+        // Enumeration of the kinds of instruction.
+
+        e_Parameter,
+        e_Phi,
+        e_Operation
+    };
+
+  private:
+    // DATA
+    bsl::vector<Kind>              d_kinds;          // per instruction
+    bsl::vector<sjtt::Bytecode>    d_codes;          // per instruction
+    bsl::vector<int>               d_blockOf;        // per instruction
+    bsl::vector<bsl::vector<int> > d_operands;       // per instruction
+    bsl::vector<bsl::vector<int> > d_instructions;   // per block
+    bsl::vector<bsl::vector<int> > d_successors;     // per block
+    bsl::vector<bsl::vector<int> > d_predecessors;   // per block
+    bsl::vector<int>               d_firstCodes;     // per block
+    int                            d_numParameters;
+
+    // NOT IMPLEMENTED
+    SsaFunction(const SsaFunction&) = delete;
+    SsaFunction& operator=(const SsaFunction&) = delete;
+
+  public:
+    // CLASS METHODS
+    static bool hasValue(sjtt::Bytecode::Opcode opcode);
+        // Return 'true' if an operation having the specified 'opcode'
+        // defines a value, and 'false' otherwise.  Note that operations that
+        // modify an object, such as 'e_SetSlot', define no value, as the
+        // object they leave on the stack is their operand.
+
+    static bool isTerminator(sjtt::Bytecode::Opcode opcode);
+        // Return 'true' if the specified 'opcode' ends a block, and 'false'
+        // otherwise.
+
+    // CREATORS
+    explicit SsaFunction(Allocator *basicAllocator = 0);
+        // Create an empty function.  Optionally specify a 'basicAllocator'
+        // used to supply memory.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.
+
+    // MANIPULATORS
+    int addBlock(int firstCode = -1);
+        // Add a block, without instructions or edges, beginning at the
+        // optionally specified 'firstCode' index of the bytecode the function
+        // was built from, and return its index.  If 'firstCode' is -1, the
+        // block corresponds to no code.
+
+    void addEdge(int from, int to);
+        // Add the block at the specified 'to' index as the next successor of
+        // the block at the specified 'from' index, and 'from' as the next
+        // predecessor of 'to'.  The behavior is undefined unless both blocks
+        // exist.
+
+    int addInstruction(int block, Kind kind, const sjtt::Bytecode& code);
+        // Append to the block at the specified 'block' index an instruction
+        // of the specified 'kind' and 'code', without operands, and return
+        // its index.  For a parameter or a phi, the data of 'code' is the
+        // index of its slot, and its opcode is unused.  The behavior is
+        // undefined unless the block exists, and each parameter is added to
+        // block 0 before any other instruction.
+
+    void addOperand(int instruction, int value);
+        // Append the specified 'value' to the operands of the specified
+        // 'instruction'.  The behavior is undefined unless 'instruction'
+        // exists, and 'value' is the index of an instruction, which need not
+        // yet exist.
+
+    void setOperand(int instruction, int index, int value);
+        // Replace the operand at the specified 'index' of the specified
+        // 'instruction' with the specified 'value'.
+
+    // ACCESSORS
+    int block(int instruction) const;
+        // Return the index of the block of the specified 'instruction'.
+
+    const sjtt::Bytecode& code(int instruction) const;
+        // Return the code of the specified 'instruction'.
+
+    int firstCode(int block) const;
+        // Return the index of the first code of the specified 'block', or
+        // -1 if it corresponds to no code.
+
+    bool hasValue(int instruction) const;
+        // Return 'true' if the specified 'instruction' defines a value, and
+        // 'false' otherwise.
+
+    const bsl::vector<int>& instructions(int block) const;
+        // Return the indices of the instructions of the specified 'block', in
+        // order.
+
+    Kind kind(int instruction) const;
+        // Return the kind of the specified 'instruction'.
+
+    int numBlocks() const;
+        // Return the number of blocks in this function.
+
+    int numInstructions() const;
+        // Return the number of instructions in this function.
+
+    int numParameters() const;
+        // Return the number of parameters of this function, which are the
+        // instructions '[0, numParameters())', for the slots having the same
+        // indices.
+
+    const bsl::vector<int>& operands(int instruction) const;
+        // Return the operands of the specified 'instruction', in order.
+
+    const bsl::vector<int>& predecessors(int block) const;
+        // Return the indices of the predecessors of the specified 'block', in
+        // the order their edges were added.
+
+    bsl::ostream& print(bsl::ostream& stream) const;
+        // Write a description of this function to the specified 'stream',
+        // one block, then one instruction, per line, and return 'stream'.
+        // Each block is written as 'b<index>:', followed by '<-' and its
+        // predecessors, if any; each instruction as 'v<index> = ' if it
+        // defines a value, then 'param', 'phi', or the mnemonic of its opcode
+        // in the bytecode DSL (see 'sjtu_bytecodedslutil') followed by its
+        // data, then its operands and, for a terminator, its successors.  For
+        // example:
+        //..
+        //  b0:
+        //      v0 = param 0
+        //      J b1
+        //  b1: <- b0 b1
+        //      v1 = phi v0 v3
+        //      v2 = P 1
+        //      v3 = +i v1 v2
+        //      J b1
+        //..
+
+    const bsl::vector<int>& successors(int block) const;
+        // Return the indices of the successors of the specified 'block', in
+        // the order described above.
+};
+
+// FREE OPERATORS
+bsl::ostream& operator<<(bsl::ostream& stream, const SsaFunction& function);
+    // Write the specified 'function' to the specified 'stream' as 'print'
+    // does, and return 'stream'.
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // -----------------
+                             // class SsaFunction
+                             // -----------------
+
+// ACCESSORS
+inline
+int SsaFunction::block(int instruction) const
+{
+    BSLS_ASSERT(0 <= instruction);
+    BSLS_ASSERT(instruction < numInstructions());
+
+    return d_blockOf[instruction];
+}
+
+inline
+const sjtt::Bytecode& SsaFunction::code(int instruction) const
+{
+    BSLS_ASSERT(0 <= instruction);
+    BSLS_ASSERT(instruction < numInstructions());
+
+    return d_codes[instruction];
+}
+
+inline
+int SsaFunction::firstCode(int block) const
+{
+    BSLS_ASSERT(0 <= block);
+    BSLS_ASSERT(block < numBlocks());
+
+    return d_firstCodes[block];
+}
+
+inline
+const bsl::vector<int>& SsaFunction::instructions(int block) const
+{
+    BSLS_ASSERT(0 <= block);
+    BSLS_ASSERT(block < numBlocks());
+
+    return d_instructions[block];
+}
+
+inline
+SsaFunction::Kind SsaFunction::kind(int instruction) const
+{
+    BSLS_ASSERT(0 <= instruction);
+    BSLS_ASSERT(instruction < numInstructions());
+
+    return d_kinds[instruction];
+}
+
+inline
+int SsaFunction::numBlocks() const
+{
+    return static_cast<int>(d_instructions.size());
+}
+
+inline
+int SsaFunction::numInstructions() const
+{
+    return static_cast<int>(d_kinds.size());
+}
+
+inline
+int SsaFunction::numParameters() const
+{
+    return d_numParameters;
+}
+
+inline
+const bsl::vector<int>& SsaFunction::operands(int instruction) const
+{
+    BSLS_ASSERT(0 <= instruction);
+    BSLS_ASSERT(instruction < numInstructions());
+
+    return d_operands[instruction];
+}
+
+inline
+const bsl::vector<int>& SsaFunction::predecessors(int block) const
+{
+    BSLS_ASSERT(0 <= block);
+    BSLS_ASSERT(block < numBlocks());
+
+    return d_predecessors[block];
+}
+
+inline
+const bsl::vector<int>& SsaFunction::successors(int block) const
+{
+    BSLS_ASSERT(0 <= block);
+    BSLS_ASSERT(block < numBlocks());
+
+    return d_successors[block];
+}
+}
+
+#endif
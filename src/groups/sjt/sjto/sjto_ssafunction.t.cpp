@@ -0,0 +1,243 @@
+// sjto_ssafunction.t.cpp                                         -*-C++-*-
+
+#include <sjto_ssafunction.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_sstream.h>
+
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "print" << endl
+                          << "=====" << endl;
+
+        bslma::TestAllocator ta;
+        SsaFunction          f(&ta);
+        f.addBlock();
+        f.addBlock(3);
+        f.addBlock(9);
+        f.addEdge(0, 1);
+        f.addEdge(1, 2);
+        f.addEdge(1, 1);
+        const int p = f.addInstruction(0, SsaFunction::e_Parameter,
+                                       code(BC::e_Load, 0));
+        f.addInstruction(0, SsaFunction::e_Operation, code(BC::e_Jump));
+        const int phi = f.addInstruction(1, SsaFunction::e_Phi,
+                                         code(BC::e_Load, 0));
+        const int d = f.addInstruction(
+                       1,
+                       SsaFunction::e_Operation,
+                       BC::createOpcode(BC::e_Push,
+                                        bdld::Datum::createDouble(2.5)));
+        const int a = f.addInstruction(1, SsaFunction::e_Operation,
+                                       code(BC::e_NewTypedArray, 1));
+        f.addOperand(a, p);
+        const int g = f.addInstruction(
+                       1,
+                       SsaFunction::e_Operation,
+                       BC::createOpcode(BC::e_GetProp,
+                                        bdld::Datum::createStringRef("x",
+                                                                     1,
+                                                                     &ta)));
+        f.addOperand(g, a);
+        const int s = f.addInstruction(1, SsaFunction::e_Operation,
+                                       code(BC::e_ArrayScale));
+        f.addOperand(s, a);
+        f.addOperand(s, d);
+        const int c = f.addInstruction(1, SsaFunction::e_Operation,
+                                       code(BC::e_Call, 12));
+        f.addOperand(c, g);
+        f.addOperand(c, phi);
+        const int i = f.addInstruction(1, SsaFunction::e_Operation,
+                                       code(BC::e_If));
+        f.addOperand(i, c);
+        f.addOperand(phi, p);
+        f.addOperand(phi, c);
+        const int x = f.addInstruction(2, SsaFunction::e_Operation,
+                                       code(BC::e_Exit));
+        f.addOperand(x, phi);
+
+        const char *EXPECTED = "b0:\n"
+                               "    v0 = param 0\n"
+                               "    J b1\n"
+                               "b1: <- b0 b1\n"
+                               "    v2 = phi v0 v7\n"
+                               "    v3 = P 2.5\n"
+                               "    v4 = Ad v0\n"
+                               "    v5 = .x v4\n"
+                               "    #scale v4 v3\n"
+                               "    v7 = C12 v5 v2\n"
+                               "    I v7 b2 b1\n"
+                               "b2: <- b1\n"
+                               "    X v2\n";
+
+        bsl::ostringstream stream;
+        ASSERT(&stream == &f.print(stream));
+        ASSERTV(stream.str(), EXPECTED == stream.str());
+
+        bsl::ostringstream output;
+        output << f;
+        ASSERT(EXPECTED == output.str());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        ASSERT(SsaFunction::hasValue(BC::e_AddInts));
+        ASSERT(SsaFunction::hasValue(BC::e_Call));
+        ASSERT(!SsaFunction::hasValue(BC::e_SetSlot));
+        ASSERT(!SsaFunction::hasValue(BC::e_Exit));
+        ASSERT(SsaFunction::isTerminator(BC::e_IfEqInts));
+        ASSERT(SsaFunction::isTerminator(BC::e_TailCall));
+        ASSERT(!SsaFunction::isTerminator(BC::e_Call));
+
+        bslma::TestAllocator ta;
+        {
+            SsaFunction f(&ta);
+            ASSERT(0 == f.numBlocks());
+            ASSERT(0 == f.numInstructions());
+            ASSERT(0 == f.numParameters());
+
+            ASSERT(0 == f.addBlock());
+            ASSERT(1 == f.addBlock(4));
+            ASSERT(-1 == f.firstCode(0));
+            ASSERT(4 == f.firstCode(1));
+            f.addEdge(0, 1);
+            ASSERT(1 == f.successors(0).size());
+            ASSERT(1 == f.successors(0)[0]);
+            ASSERT(1 == f.predecessors(1).size());
+            ASSERT(0 == f.predecessors(1)[0]);
+            ASSERT(f.predecessors(0).empty());
+
+            ASSERT(0 == f.addInstruction(0, SsaFunction::e_Parameter,
+                                         code(BC::e_Load, 0)));
+            ASSERT(1 == f.addInstruction(0, SsaFunction::e_Parameter,
+                                         code(BC::e_Load, 1)));
+            ASSERT(2 == f.addInstruction(0, SsaFunction::e_Operation,
+                                         code(BC::e_Jump)));
+            ASSERT(3 == f.addInstruction(1, SsaFunction::e_Operation,
+                                         code(BC::e_AddInts)));
+            f.addOperand(3, 0);
+            f.addOperand(3, 0);
+            f.setOperand(3, 1, 1);
+            ASSERT(4 == f.addInstruction(1, SsaFunction::e_Operation,
+                                         code(BC::e_Exit)));
+            f.addOperand(4, 3);
+
+            ASSERT(2 == f.numBlocks());
+            ASSERT(5 == f.numInstructions());
+            ASSERT(2 == f.numParameters());
+            ASSERT(SsaFunction::e_Parameter == f.kind(1));
+            ASSERT(SsaFunction::e_Operation == f.kind(3));
+            ASSERT(code(BC::e_AddInts) == f.code(3));
+            ASSERT(1 == f.block(3));
+            ASSERT(2 == f.operands(3).size());
+            ASSERT(0 == f.operands(3)[0]);
+            ASSERT(1 == f.operands(3)[1]);
+            ASSERT(f.hasValue(1));
+            ASSERT(f.hasValue(3));
+            ASSERT(!f.hasValue(4));
+            ASSERT(3 == f.instructions(0).size());
+            ASSERT(2 == f.instructions(1).size());
+            ASSERT(4 == f.instructions(1)[1]);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
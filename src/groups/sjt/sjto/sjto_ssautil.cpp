@@ -0,0 +1,843 @@
+// sjto_ssautil.cpp
+#include <sjto_ssautil.h>
+
+#include <bsls_assert.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_sstream.h>
+#include <bsl_utility.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjto_ssafunction.h>
+
+using namespace BloombergLP;
+
+namespace sjto {
+namespace {
+
+typedef sjtt::Bytecode BC;
+
+int fail(bsl::string *errorMessage, const char *description, int index)
+    // Load into the specified 'errorMessage' the specified 'description' of
+    // an error at the code at the specified 'index', and return a non-zero
+    // value.
+{
+    bsl::ostringstream stream;
+    stream << description << " at code " << index;
+    *errorMessage = stream.str();
+    return 1;
+}
+
+bool isBranch(BC::Opcode opcode)
+    // Return 'true' if the specified 'opcode' jumps to the index stored with
+    // it, always or conditionally, and 'false' otherwise.
+{
+    return BC::e_Jump == opcode ||
+           BC::e_If == opcode ||
+           BC::e_IfEqInts == opcode;
+}
+
+bool endsPath(BC::Opcode opcode)
+    // Return 'true' if evaluation never continues at the code following one
+    // having the specified 'opcode', and 'false' otherwise.
+{
+    return BC::e_Jump == opcode ||
+           BC::e_Exit == opcode ||
+           BC::e_TailCall == opcode ||
+           BC::e_Throw == opcode;
+}
+
+bool isConstant(const SsaFunction& function, int instruction)
+    // Return 'true' if the specified 'instruction' of the specified
+    // 'function' is an 'e_Push', and 'false' otherwise.
+{
+    return SsaFunction::e_Operation == function.kind(instruction) &&
+           BC::e_Push == function.code(instruction).opcode();
+}
+
+void successorCodes(bsl::vector<int>        *result,
+                    const bsl::vector<BC>&   codes,
+                    const bsl::vector<char>& isLeader,
+                    int                      first)
+    // Load into the specified 'result' the indices of the first codes of the
+    // successors of the block beginning at the specified 'first' index of
+    // the specified 'codes', whose blocks begin at the indices for which the
+    // specified 'isLeader' is set, in the order described by 'SsaFunction'.
+{
+    int last = first;
+    while (!SsaFunction::isTerminator(codes[last].opcode()) &&
+           !isLeader[last + 1]) {
+        ++last;
+    }
+
+    result->clear();
+    const BC::Opcode opcode = codes[last].opcode();
+    if (isBranch(opcode)) {
+        result->push_back(codes[last].data().theInteger());
+    }
+    if (!endsPath(opcode)) {
+        result->push_back(last + 1);
+    }
+}
+
+bool popCount(int                *result,
+              bsl::vector<int>   *state,
+              const SsaFunction&  function)
+    // Pop, from the specified 'state' of the slots of the specified
+    // 'function', the number of arguments of a call, load it into the
+    // specified 'result', and return 'true' if it is an integer pushed by
+    // 'e_Push'; otherwise, return 'false'.
+{
+    if (state->empty()) {
+        return false;                                                 // RETURN
+    }
+    const int value = state->back();
+    if (!isConstant(function, value) ||
+        !function.code(value).data().isInteger() ||
+        0 > function.code(value).data().theInteger()) {
+        return false;                                                 // RETURN
+    }
+    *result = function.code(value).data().theInteger();
+    state->pop_back();
+    return true;
+}
+
+int simulate(SsaFunction              *function,
+             bsl::vector<int>         *state,
+             bsl::vector<int>         *heights,
+             bsl::string              *errorMessage,
+             const bsl::vector<BC>&    codes,
+             const bsl::vector<char>&  isLeader,
+             int                       block)
+    // Append to the specified 'block' of the specified 'function' the
+    // instructions evaluating its codes, among the specified 'codes', whose
+    // blocks begin at the indices for which the specified 'isLeader' is set,
+    // given the specified 'state' of the slots of the frame when the block
+    // begins, and load into 'state' their values when it ends, and into the
+    // elements of the specified 'heights' for its codes the number of values
+    // before each.  Return 0 on success, and a non-zero value, with a
+    // description loaded into the specified 'errorMessage', otherwise.
+{
+    bsl::vector<int> operands;
+    for (int index = function->firstCode(block); true; ++index) {
+        const BC&        code      = codes[index];
+        const BC::Opcode opcode    = code.opcode();
+        const int        height    = static_cast<int>(state->size());
+        (*heights)[index] = height;
+        const bool       isSlot    = code.data().isInteger() &&
+                                     0 <= code.data().theInteger() &&
+                                     code.data().theInteger() < height;
+        bool             isMoved   = false;  // only moves values
+        int              numPopped = 0;
+        int              callee    = -1;     // function of an 'e_Execute'
+
+        switch (opcode) {
+          case BC::e_Load: {
+            if (!isSlot) {
+                return fail(errorMessage, "invalid slot", index);     // RETURN
+            }
+            state->push_back((*state)[code.data().theInteger()]);
+            isMoved = true;
+          } break;
+          case BC::e_Store: {
+            if (!isSlot) {
+                return fail(errorMessage, "invalid slot", index);     // RETURN
+            }
+            (*state)[code.data().theInteger()] = state->back();
+            state->pop_back();
+            isMoved = true;
+          } break;
+          case BC::e_Resize: {
+            if (!code.data().isInteger() || 0 > code.data().theInteger()) {
+                return fail(errorMessage, "invalid size", index);     // RETURN
+            }
+            const int size = code.data().theInteger();
+            if (size > height) {
+                const int undefined = function->addInstruction(
+                    block,
+                    SsaFunction::e_Operation,
+                    BC::createOpcode(BC::e_Push,
+                                     sjtd::DatumUdtUtil::s_Undefined));
+                state->resize(size, undefined);
+            }
+            else {
+                state->resize(size);
+            }
+            isMoved = true;
+          } break;
+          case BC::e_IncInt: {
+            if (!isSlot) {
+                return fail(errorMessage, "invalid slot", index);     // RETURN
+            }
+            int& slot = (*state)[code.data().theInteger()];
+            const int instruction = function->addInstruction(
+                                             block,
+                                             SsaFunction::e_Operation,
+                                             BC::createOpcode(BC::e_IncInt));
+            function->addOperand(instruction, slot);
+            slot    = instruction;
+            isMoved = true;
+          } break;
+          case BC::e_Execute: {
+            if (state->empty()) {
+                return fail(errorMessage, "stack underflow", index);  // RETURN
+            }
+            callee = state->back();
+            state->pop_back();
+            if (!popCount(&numPopped, state, *function)) {
+                return fail(errorMessage,                             // RETURN
+                            "argument count is not a constant",
+                            index);
+            }
+          } break;
+          case BC::e_Call:
+          case BC::e_TailCall:
+          case BC::e_CallValue: {
+            if (!popCount(&numPopped, state, *function)) {
+                return fail(errorMessage,                             // RETURN
+                            "argument count is not a constant",
+                            index);
+            }
+            if (BC::e_CallValue == opcode) {
+                ++numPopped;
+            }
+          } break;
+          case BC::e_MakeClosure: {
+            if (!code.data().isInteger() || 0 > code.data().theInteger()) {
+                return fail(errorMessage, "invalid count", index);    // RETURN
+            }
+            numPopped = code.data().theInteger() + 1;
+          } break;
+          case BC::e_Push:
+          case BC::e_Jump:
+          case BC::e_NewObject:
+          case BC::e_PushCode:
+          case BC::e_LoadCaptured: {
+          } break;
+          case BC::e_If:
+          case BC::e_Exit:
+          case BC::e_Throw:
+          case BC::e_GetSlot:
+          case BC::e_GetProp:
+          case BC::e_NewTypedArray:
+          case BC::e_ArrayLength:
+          case BC::e_ArraySum:
+          case BC::e_ArrayMin:
+          case BC::e_ArrayMax: {
+            numPopped = 1;
+          } break;
+          case BC::e_IfEqInts:
+          case BC::e_EqInts:
+          case BC::e_AddDoubles:
+          case BC::e_AddInts:
+          case BC::e_SetSlot:
+          case BC::e_SetProp:
+          case BC::e_GetElement:
+          case BC::e_ArrayDot:
+          case BC::e_ArrayScale:
+          case BC::e_ArrayAdd: {
+            numPopped = 2;
+          } break;
+          case BC::e_SetElement: {
+            numPopped = 3;
+          } break;
+        }
+
+        if (!isMoved) {
+            if (numPopped > static_cast<int>(state->size())) {
+                return fail(errorMessage, "stack underflow", index);  // RETURN
+            }
+            operands.assign(state->end() - numPopped, state->end());
+            state->resize(state->size() - numPopped);
+            if (0 <= callee) {
+                operands.push_back(callee);
+            }
+
+            const int instruction = function->addInstruction(
+                                    block,
+                                    SsaFunction::e_Operation,
+                                    isBranch(opcode) ? BC::createOpcode(opcode)
+                                                     : code);
+            for (bsl::size_t i = 0; i < operands.size(); ++i) {
+                function->addOperand(instruction, operands[i]);
+            }
+            if (SsaFunction::hasValue(opcode)) {
+                state->push_back(instruction);
+            }
+            else if (!SsaFunction::isTerminator(opcode)) {
+                // The object modified is left on the stack.
+
+                state->push_back(operands[0]);
+            }
+        }
+
+        if (SsaFunction::isTerminator(opcode)) {
+            return 0;                                                 // RETURN
+        }
+        if (isLeader[index + 1]) {
+            function->addInstruction(block,
+                                     SsaFunction::e_Operation,
+                                     BC::createOpcode(BC::e_Jump));
+            return 0;                                                 // RETURN
+        }
+    }
+}
+
+int resolve(const bsl::vector<int>& replacements, int value)
+    // Return the value replacing the specified 'value' as described by the
+    // specified 'replacements', where a negative element means the value of
+    // that index is not replaced.
+{
+    while (0 <= replacements[value]) {
+        value = replacements[value];
+    }
+    return value;
+}
+
+void pushValue(bsl::vector<BC>         *codes,
+               const SsaFunction&       function,
+               const bsl::vector<int>&  slots,
+               int                      value)
+    // Append to the specified 'codes' a code pushing the specified 'value' of
+    // the specified 'function', whose values are held in the specified
+    // 'slots'.
+{
+    if (isConstant(function, value)) {
+        codes->push_back(function.code(value));
+    }
+    else {
+        codes->push_back(BC::createOpcode(
+                                    BC::e_Load,
+                                    bdld::Datum::createInteger(slots[value])));
+    }
+}
+
+void pushCount(bsl::vector<BC> *codes, int count)
+    // Append to the specified 'codes' a code pushing the specified 'count'
+    // of arguments of a call.
+{
+    codes->push_back(BC::createOpcode(BC::e_Push,
+                                      bdld::Datum::createInteger(count)));
+}
+
+void store(bsl::vector<BC> *codes, int slot)
+    // Append to the specified 'codes' a code storing the top of the stack in
+    // the specified 'slot'.
+{
+    codes->push_back(BC::createOpcode(BC::e_Store,
+                                      bdld::Datum::createInteger(slot)));
+}
+
+bool isCopied(const SsaFunction& function, int phi, int predecessor)
+    // Return 'true' if the operand of the specified 'phi' of the specified
+    // 'function' for the specified 'predecessor' index is not 'phi' itself,
+    // and so must be copied to its slot, and 'false' otherwise.
+{
+    return phi != function.operands(phi)[predecessor];
+}
+
+int predecessorIndex(const SsaFunction& function, int from, int to)
+    // Return the index of the specified 'from' block among the predecessors
+    // of the specified 'to' block of the specified 'function'.
+{
+    const bsl::vector<int>& predecessors = function.predecessors(to);
+    const int index = static_cast<int>(
+                                bsl::find(predecessors.begin(),
+                                          predecessors.end(),
+                                          from) - predecessors.begin());
+    BSLS_ASSERT(index < static_cast<int>(predecessors.size()));
+    return index;
+}
+
+bool hasCopies(const SsaFunction& function, int from, int to)
+    // Return 'true' if the edge from the specified 'from' block to the
+    // specified 'to' block of the specified 'function' copies any value to
+    // the slot of a phi, and 'false' otherwise.
+{
+    const int predecessor = predecessorIndex(function, from, to);
+    const bsl::vector<int>& instructions = function.instructions(to);
+    for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+        if (SsaFunction::e_Phi == function.kind(instructions[i]) &&
+            isCopied(function, instructions[i], predecessor)) {
+            return true;                                              // RETURN
+        }
+    }
+    return false;
+}
+
+void copyToPhis(bsl::vector<BC>         *codes,
+                const SsaFunction&       function,
+                const bsl::vector<int>&  slots,
+                int                      from,
+                int                      to)
+    // Append to the specified 'codes' codes copying, into the slot of each
+    // phi of the specified 'to' block of the specified 'function', whose
+    // values are held in the specified 'slots', its operand for the
+    // specified 'from' block.  The operands are all pushed before any is
+    // stored, so a phi may be the operand of another.
+{
+    const int predecessor = predecessorIndex(function, from, to);
+    const bsl::vector<int>& instructions = function.instructions(to);
+    for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+        const int phi = instructions[i];
+        if (SsaFunction::e_Phi == function.kind(phi) &&
+            isCopied(function, phi, predecessor)) {
+            pushValue(codes,
+                      function,
+                      slots,
+                      function.operands(phi)[predecessor]);
+        }
+    }
+    for (bsl::size_t i = instructions.size(); 0 < i--; ) {
+        const int phi = instructions[i];
+        if (SsaFunction::e_Phi == function.kind(phi) &&
+            isCopied(function, phi, predecessor)) {
+            store(codes, slots[phi]);
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+                              // --------------
+                              // struct SsaUtil
+                              // --------------
+
+// CLASS METHODS
+int SsaUtil::build(SsaFunction                        *result,
+                   bsl::string                        *errorMessage,
+                   const bsl::vector<sjtt::Bytecode>&  codes,
+                   int                                 entry,
+                   int                                 numArguments,
+                   bsl::vector<int>                   *heights)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 == result->numBlocks());
+    BSLS_ASSERT(0 != errorMessage);
+    BSLS_ASSERT(0 <= numArguments);
+
+    const int numCodes = static_cast<int>(codes.size());
+    if (0 > entry || entry >= numCodes) {
+        return fail(errorMessage, "invalid entry", entry);            // RETURN
+    }
+
+    // Find the codes of the function, and the first code of each block.
+
+    bsl::vector<char> isReached(numCodes + 1, 0);
+    bsl::vector<char> isLeader(numCodes + 1, 0);
+    bsl::vector<int>  work;
+    isReached[entry] = 1;
+    isLeader[entry]  = 1;
+    work.push_back(entry);
+    while (!work.empty()) {
+        const int        index  = work.back();
+        const BC::Opcode opcode = codes[index].opcode();
+        int              next[2];
+        int              numNext = 0;
+        work.pop_back();
+
+        if (isBranch(opcode)) {
+            const bdld::Datum& data = codes[index].data();
+            if (!data.isInteger() ||
+                0 > data.theInteger() ||
+                data.theInteger() >= numCodes) {
+                return fail(errorMessage, "invalid target", index);   // RETURN
+            }
+            isLeader[data.theInteger()] = 1;
+            next[numNext++] = data.theInteger();
+        }
+        if (!endsPath(opcode)) {
+            if (index + 1 == numCodes) {
+                return fail(errorMessage, "missing exit", index);     // RETURN
+            }
+            if (isBranch(opcode)) {
+                isLeader[index + 1] = 1;
+            }
+            next[numNext++] = index + 1;
+        }
+        for (int i = 0; i < numNext; ++i) {
+            if (!isReached[next[i]]) {
+                isReached[next[i]] = 1;
+                work.push_back(next[i]);
+            }
+        }
+    }
+
+    // Order the blocks in reverse postorder, after the block of parameters.
+
+    bsl::vector<int>                   postorder;
+    bsl::vector<int>                   successors;
+    bsl::vector<bsl::pair<int, int> >  path;  // block and next successor
+    bsl::vector<char>                  isVisited(numCodes, 0);
+    isVisited[entry] = 1;
+    path.push_back(bsl::make_pair(entry, 0));
+    while (!path.empty()) {
+        const int first = path.back().first;
+        const int next  = path.back().second;
+        successorCodes(&successors, codes, isLeader, first);
+        if (next < static_cast<int>(successors.size())) {
+            ++path.back().second;
+            if (!isVisited[successors[next]]) {
+                isVisited[successors[next]] = 1;
+                path.push_back(bsl::make_pair(successors[next], 0));
+            }
+        }
+        else {
+            postorder.push_back(first);
+            path.pop_back();
+        }
+    }
+
+    SsaFunction      draft;
+    bsl::vector<int> blockAt(numCodes, -1);
+    draft.addBlock();
+    for (bsl::size_t i = postorder.size(); 0 < i--; ) {
+        blockAt[postorder[i]] = draft.addBlock(postorder[i]);
+    }
+    draft.addEdge(0, 1);
+    for (int b = 1; b < draft.numBlocks(); ++b) {
+        successorCodes(&successors, codes, isLeader, draft.firstCode(b));
+        for (bsl::size_t i = 0; i < successors.size(); ++i) {
+            draft.addEdge(b, blockAt[successors[i]]);
+        }
+    }
+
+    // Evaluate each block on the values of the slots of the frame, creating
+    // a phi for every slot of a block having several predecessors.
+
+    const int numParameters =
+                         numArguments > BC::s_MinInitialStackSize
+                         ? numArguments
+                         : static_cast<int>(BC::s_MinInitialStackSize);
+    bsl::vector<bsl::vector<int> > states(draft.numBlocks());
+    bsl::vector<bsl::size_t>       entryHeights(draft.numBlocks(), 0);
+    bsl::vector<int>               codeHeights(numCodes, -1);
+    for (int i = 0; i < numParameters; ++i) {
+        states[0].push_back(draft.addInstruction(
+                      0,
+                      SsaFunction::e_Parameter,
+                      BC::createOpcode(BC::e_Load,
+                                       bdld::Datum::createInteger(i))));
+    }
+    draft.addInstruction(0,
+                         SsaFunction::e_Operation,
+                         BC::createOpcode(BC::e_Jump));
+
+    for (int b = 1; b < draft.numBlocks(); ++b) {
+        const bsl::vector<int>& predecessors = draft.predecessors(b);
+        bsl::vector<int>&       state        = states[b];
+        if (1 == predecessors.size()) {
+            BSLS_ASSERT(predecessors[0] < b);
+
+            state = states[predecessors[0]];
+        }
+        else {
+            // Some predecessor precedes the block in reverse postorder.
+
+            bsl::size_t height = 0;
+            for (bsl::size_t i = 0; i < predecessors.size(); ++i) {
+                if (predecessors[i] < b) {
+                    height = states[predecessors[i]].size();
+                    break;                                             // BREAK
+                }
+            }
+            for (bsl::size_t i = 0; i < height; ++i) {
+                state.push_back(draft.addInstruction(
+                      b,
+                      SsaFunction::e_Phi,
+                      BC::createOpcode(BC::e_Load,
+                                       bdld::Datum::createInteger(i))));
+            }
+        }
+        entryHeights[b] = state.size();
+        const int rc = simulate(&draft,
+                                &state,
+                                &codeHeights,
+                                errorMessage,
+                                codes,
+                                isLeader,
+                                b);
+        if (0 != rc) {
+            return rc;                                                // RETURN
+        }
+    }
+
+    // Check that every path to a block has the same number of values, and
+    // give each phi its operands.
+
+    for (int b = 1; b < draft.numBlocks(); ++b) {
+        const bsl::vector<int>& predecessors = draft.predecessors(b);
+        if (1 == predecessors.size()) {
+            continue;                                               // CONTINUE
+        }
+        for (bsl::size_t j = 0; j < predecessors.size(); ++j) {
+            if (states[predecessors[j]].size() != entryHeights[b]) {
+                return fail(errorMessage,                             // RETURN
+                            "inconsistent stack height",
+                            draft.firstCode(b));
+            }
+        }
+        const bsl::vector<int>& instructions = draft.instructions(b);
+        for (bsl::size_t i = 0; i < entryHeights[b]; ++i) {
+            const int phi = instructions[i];
+            for (bsl::size_t j = 0; j < predecessors.size(); ++j) {
+                draft.addOperand(phi, states[predecessors[j]][i]);
+            }
+        }
+    }
+
+    // Replace each phi whose operands, other than itself, are all one value
+    // with that value, until none remains.
+
+    bsl::vector<int> replacements(draft.numInstructions(), -1);
+    for (bool isChanged = true; isChanged; ) {
+        isChanged = false;
+        for (int phi = 0; phi < draft.numInstructions(); ++phi) {
+            if (SsaFunction::e_Phi != draft.kind(phi) ||
+                0 <= replacements[phi]) {
+                continue;                                           // CONTINUE
+            }
+            const bsl::vector<int>& operands = draft.operands(phi);
+            int                     value    = -1;
+            bool                    isUnique = true;
+            for (bsl::size_t i = 0; i < operands.size(); ++i) {
+                const int operand = resolve(replacements, operands[i]);
+                if (operand == phi || operand == value) {
+                    continue;                                       // CONTINUE
+                }
+                if (0 <= value) {
+                    isUnique = false;
+                    break;                                             // BREAK
+                }
+                value = operand;
+            }
+            if (isUnique) {
+                BSLS_ASSERT(0 <= value);
+
+                replacements[phi] = value;
+                isChanged         = true;
+            }
+        }
+    }
+
+    // Keep only the phis whose values are used by an operation, directly or
+    // through other phis.
+
+    bsl::vector<char> isKept(draft.numInstructions(), 0);
+    work.clear();
+    for (int i = 0; i < draft.numInstructions(); ++i) {
+        if (SsaFunction::e_Phi != draft.kind(i)) {
+            isKept[i] = 1;
+            work.push_back(i);
+        }
+    }
+    while (!work.empty()) {
+        const bsl::vector<int>& operands = draft.operands(work.back());
+        work.pop_back();
+        for (bsl::size_t i = 0; i < operands.size(); ++i) {
+            const int operand = resolve(replacements, operands[i]);
+            if (!isKept[operand]) {
+                isKept[operand] = 1;
+                work.push_back(operand);
+            }
+        }
+    }
+
+    // Copy the instructions kept to 'result', renumbering them.
+
+    bsl::vector<int> numbers(draft.numInstructions(), -1);
+    int              numKept = 0;
+    for (int b = 0; b < draft.numBlocks(); ++b) {
+        const bsl::vector<int>& instructions = draft.instructions(b);
+        for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+            if (isKept[instructions[i]]) {
+                numbers[instructions[i]] = numKept++;
+            }
+        }
+    }
+    for (int b = 0; b < draft.numBlocks(); ++b) {
+        result->addBlock(draft.firstCode(b));
+    }
+    for (int b = 0; b < draft.numBlocks(); ++b) {
+        const bsl::vector<int>& successors = draft.successors(b);
+        for (bsl::size_t i = 0; i < successors.size(); ++i) {
+            result->addEdge(b, successors[i]);
+        }
+
+        const bsl::vector<int>& instructions = draft.instructions(b);
+        for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+            const int instruction = instructions[i];
+            if (!isKept[instruction]) {
+                continue;                                           // CONTINUE
+            }
+            const int number = result->addInstruction(
+                                                    b,
+                                                    draft.kind(instruction),
+                                                    draft.code(instruction));
+            BSLS_ASSERT(numbers[instruction] == number);
+
+            const bsl::vector<int>& operands = draft.operands(instruction);
+            for (bsl::size_t j = 0; j < operands.size(); ++j) {
+                const int operand = resolve(replacements, operands[j]);
+                result->addOperand(number, numbers[operand]);
+            }
+        }
+    }
+    if (heights) {
+        heights->swap(codeHeights);
+    }
+    return 0;
+}
+
+int SsaUtil::lower(bsl::vector<sjtt::Bytecode> *codes,
+                   const SsaFunction&           function)
+{
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 < function.numBlocks());
+
+    const int first = static_cast<int>(codes->size());
+
+    // Give a slot to each value that is not a constant, and one more to
+    // discard the objects left on the stack by operations modifying them.
+
+    bsl::vector<int> slots(function.numInstructions(), -1);
+    int              numSlots = function.numParameters();
+    for (int i = 0; i < function.numInstructions(); ++i) {
+        if (SsaFunction::e_Parameter == function.kind(i)) {
+            slots[i] = function.code(i).data().theInteger();
+        }
+        else if (function.hasValue(i) && !isConstant(function, i)) {
+            slots[i] = numSlots++;
+        }
+    }
+    const int discard = numSlots++;
+    codes->push_back(BC::createOpcode(BC::e_Resize,
+                                      bdld::Datum::createInteger(numSlots)));
+
+    // Lay out the blocks in order, recording the jumps and branches whose
+    // targets are blocks, to be set once every block is placed.
+
+    bsl::vector<int>                  starts(function.numBlocks(), -1);
+    bsl::vector<bsl::pair<int, int> > targets;  // code and block
+    bsl::vector<bsl::pair<int, int> > stubs;    // branch and its block
+    for (int b = 0; b < function.numBlocks(); ++b) {
+        starts[b] = static_cast<int>(codes->size());
+
+        const bsl::vector<int>& successors   = function.successors(b);
+        const bsl::vector<int>& instructions = function.instructions(b);
+        for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+            const int instruction = instructions[i];
+            if (SsaFunction::e_Operation != function.kind(instruction) ||
+                isConstant(function, instruction)) {
+                continue;                                           // CONTINUE
+            }
+
+            const BC&               code     = function.code(instruction);
+            const BC::Opcode        opcode   = code.opcode();
+            const bsl::vector<int>& operands = function.operands(instruction);
+            const int               numOperands =
+                                           static_cast<int>(operands.size());
+            switch (opcode) {
+              case BC::e_Jump: {
+                copyToPhis(codes, function, slots, b, successors[0]);
+                if (b + 1 != successors[0]) {
+                    targets.push_back(bsl::make_pair(
+                                         static_cast<int>(codes->size()),
+                                         successors[0]));
+                    codes->push_back(code);
+                }
+              } break;
+              case BC::e_If:
+              case BC::e_IfEqInts: {
+                for (int j = 0; j < numOperands; ++j) {
+                    pushValue(codes, function, slots, operands[j]);
+                }
+                const int branch = static_cast<int>(codes->size());
+                codes->push_back(code);
+                if (hasCopies(function, b, successors[0])) {
+                    stubs.push_back(bsl::make_pair(branch, b));
+                }
+                else {
+                    targets.push_back(bsl::make_pair(branch, successors[0]));
+                }
+
+                copyToPhis(codes, function, slots, b, successors[1]);
+                if (b + 1 != successors[1]) {
+                    targets.push_back(bsl::make_pair(
+                                         static_cast<int>(codes->size()),
+                                         successors[1]));
+                    codes->push_back(BC::createOpcode(BC::e_Jump));
+                }
+              } break;
+              case BC::e_IncInt: {
+                pushValue(codes, function, slots, operands[0]);
+                store(codes, slots[instruction]);
+                codes->push_back(BC::createOpcode(
+                              opcode,
+                              bdld::Datum::createInteger(slots[instruction])));
+              } break;
+              case BC::e_Call:
+              case BC::e_TailCall:
+              case BC::e_CallValue: {
+                for (int j = 0; j < numOperands; ++j) {
+                    pushValue(codes, function, slots, operands[j]);
+                }
+                pushCount(codes,
+                          BC::e_CallValue == opcode ? numOperands - 1
+                                                    : numOperands);
+                codes->push_back(code);
+                if (BC::e_TailCall != opcode) {
+                    store(codes, slots[instruction]);
+                }
+              } break;
+              case BC::e_Execute: {
+                for (int j = 0; j + 1 < numOperands; ++j) {
+                    pushValue(codes, function, slots, operands[j]);
+                }
+                pushCount(codes, numOperands - 1);
+                pushValue(codes, function, slots, operands.back());
+                codes->push_back(code);
+                store(codes, slots[instruction]);
+              } break;
+              default: {
+                for (int j = 0; j < numOperands; ++j) {
+                    pushValue(codes, function, slots, operands[j]);
+                }
+                codes->push_back(code);
+                if (function.hasValue(instruction)) {
+                    store(codes, slots[instruction]);
+                }
+                else if (!SsaFunction::isTerminator(opcode)) {
+                    store(codes, discard);
+                }
+              } break;
+            }
+        }
+    }
+
+    // A branch taken to a block having phis goes through a stub copying
+    // their operands, placed after every block.
+
+    for (bsl::size_t i = 0; i < stubs.size(); ++i) {
+        const int branch = stubs[i].first;
+        const int from   = stubs[i].second;
+        const int to     = function.successors(from)[0];
+        (*codes)[branch] = BC::createOpcode(
+                         (*codes)[branch].opcode(),
+                         bdld::Datum::createInteger(
+                                          static_cast<int>(codes->size())));
+        copyToPhis(codes, function, slots, from, to);
+        targets.push_back(bsl::make_pair(static_cast<int>(codes->size()),
+                                         to));
+        codes->push_back(BC::createOpcode(BC::e_Jump));
+    }
+
+    for (bsl::size_t i = 0; i < targets.size(); ++i) {
+        BC&       code   = (*codes)[targets[i].first];
+        const int target = starts[targets[i].second];
+        code = BC::createOpcode(code.opcode(),
+                                bdld::Datum::createInteger(target));
+    }
+    return first;
+}
+}
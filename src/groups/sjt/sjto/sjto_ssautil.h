@@ -0,0 +1,81 @@
+// sjto_ssautil.h
+
+#ifndef INCLUDED_SJTO_SSAUTIL
+#define INCLUDED_SJTO_SSAUTIL
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+namespace sjto {
+
+class SsaFunction;
+
+                              // ==============
+                              // struct SsaUtil
+                              // ==============
+
+struct SsaUtil {
+    // This 'struct' provides a namespace for functions that convert a
+    // function of Scramjet bytecode to static single assignment form (see
+    // 'SsaFunction'), and back.
+    //
+    // A function is the code reachable from its entry by jumps, branches and
+    // falling through; a call continues at the code following it, and
+    // 'e_Exit', 'e_TailCall' and 'e_Throw' end a path.  Its blocks begin at
+    // its entry, at the targets of its jumps and branches, and after its
+    // branches.  The value of every slot of the frame is tracked through
+    // each block, so the number of values in the frame must be the same on
+    // every path to a code, and the number of arguments of every call must
+    // be pushed by an 'e_Push' of an integer.  The exception handlers of the
+    // function, if any, are not represented.
+
+    // CLASS METHODS
+    static int build(SsaFunction                        *result,
+                     bsl::string                        *errorMessage,
+                     const bsl::vector<sjtt::Bytecode>&  codes,
+                     int                                 entry,
+                     int                                 numArguments = 0,
+                     bsl::vector<int>                   *heights = 0);
+        // Load into the specified 'result', which must be empty, the function
+        // of the specified 'codes' beginning at the specified 'entry' index,
+        // and return 0 if the function can be represented; otherwise, return
+        // a non-zero value and load a description into the specified
+        // 'errorMessage'.  Optionally specify 'numArguments', the largest
+        // number of arguments with which the function is called; the
+        // function has one parameter per slot of its frame when it starts,
+        // i.e., the larger of 'numArguments' and
+        // 'sjtt::Bytecode::s_MinInitialStackSize'.  Jump and branch targets
+        // are indices in 'codes'.  Block 0 of 'result' holds the parameters
+        // and jumps to the block beginning at 'entry', and the blocks are in
+        // reverse postorder.  A phi is created only for a slot whose values
+        // differ on the paths to its block.  Optionally specify 'heights',
+        // loaded, on success, with one element per code: the number of values
+        // in the frame before the code is evaluated, or -1 if the code is not
+        // part of the function.  Note that the state of 'result' after a
+        // failure is undefined.
+
+    static int lower(bsl::vector<sjtt::Bytecode> *codes,
+                     const SsaFunction&           function);
+        // Append to the specified 'codes' bytecode evaluating the specified
+        // 'function', and return the index of its first code.  The targets of
+        // its jumps and branches are indices in 'codes', and the targets of
+        // its calls are those of 'function'; so the result may be appended to
+        // the codes 'function' was built from, and called or jumped to in
+        // place of its original entry.  Each value other than a constant
+        // pushed by 'e_Push' is given a slot of the frame, beginning with the
+        // parameters, and constants are pushed where they are used.  The
+        // behavior is undefined unless 'function' is well formed, as
+        // described by 'SsaFunction'.
+};
+}
+
+#endif
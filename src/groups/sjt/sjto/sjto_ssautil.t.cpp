@@ -0,0 +1,475 @@
+// sjto_ssautil.t.cpp                                             -*-C++-*-
+
+#include <sjto_ssautil.h>
+
+#include <bdls_testutil.h>
+
+#include <bsl_sstream.h>
+
+#include <sjto_ssafunction.h>
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjto;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef sjtt::Bytecode BC;
+
+BC code(BC::Opcode opcode)
+    // Return a code having the specified 'opcode' and null data.
+{
+    return BC::createOpcode(opcode);
+}
+
+BC code(BC::Opcode opcode, int data)
+    // Return a code having the specified 'opcode' and integer 'data'.
+{
+    return BC::createOpcode(opcode, bdld::Datum::createInteger(data));
+}
+
+bsl::string print(const SsaFunction& function)
+    // Return the description of the specified 'function' written by
+    // 'print'.
+{
+    bsl::ostringstream stream;
+    function.print(stream);
+    return stream.str();
+}
+
+void sumLoop(bsl::vector<BC> *codes)
+    // Append to the specified 'codes' a function returning the sum of the
+    // integers less than its argument.
+{
+    codes->push_back(code(BC::e_Push, 0));                            //  0
+    codes->push_back(code(BC::e_Store, 1));                           //  1
+    codes->push_back(code(BC::e_Push, 0));                            //  2
+    codes->push_back(code(BC::e_Store, 2));                           //  3
+    codes->push_back(code(BC::e_Load, 1));                            //  4
+    codes->push_back(code(BC::e_Load, 0));                            //  5
+    codes->push_back(code(BC::e_IfEqInts, 13));                       //  6
+    codes->push_back(code(BC::e_Load, 2));                            //  7
+    codes->push_back(code(BC::e_Load, 1));                            //  8
+    codes->push_back(code(BC::e_AddInts));                            //  9
+    codes->push_back(code(BC::e_Store, 2));                           // 10
+    codes->push_back(code(BC::e_IncInt, 1));                          // 11
+    codes->push_back(code(BC::e_Jump, 4));                            // 12
+    codes->push_back(code(BC::e_Load, 2));                            // 13
+    codes->push_back(code(BC::e_Exit));                               // 14
+}
+
+const char PARAMETERS[] = "b0:\n"
+                          "    v0 = param 0\n"
+                          "    v1 = param 1\n"
+                          "    v2 = param 2\n"
+                          "    v3 = param 3\n"
+                          "    v4 = param 4\n"
+                          "    v5 = param 5\n"
+                          "    v6 = param 6\n"
+                          "    v7 = param 7\n"
+                          "    J b1\n";
+    // The description of the first block of a function called with at most
+    // 'BC::s_MinInitialStackSize' arguments.
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "errors" << endl
+                          << "======" << endl;
+
+        // Functions that cannot be represented are reported with the index
+        // of the offending code.
+
+        bsl::string errorMessage;
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 1));
+            codes.push_back(code(BC::e_Exit));
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 2));
+            ASSERTV(errorMessage, "invalid entry at code 2" == errorMessage);
+        }
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Jump, 5));
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 0));
+            ASSERTV(errorMessage, "invalid target at code 0" == errorMessage);
+        }
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Push, 1));
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 0));
+            ASSERTV(errorMessage, "missing exit at code 0" == errorMessage);
+        }
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 8));
+            codes.push_back(code(BC::e_Exit));
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 0));
+            ASSERTV(errorMessage, "invalid slot at code 0" == errorMessage);
+
+            // A function called with more arguments has more slots.
+
+            SsaFunction wider;
+            ASSERT(0 == SsaUtil::build(&wider, &errorMessage, codes, 0, 9));
+            ASSERT(9 == wider.numParameters());
+        }
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Resize, 1));
+            codes.push_back(code(BC::e_AddInts));
+            codes.push_back(code(BC::e_Exit));
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 0));
+            ASSERTV(errorMessage,
+                    "stack underflow at code 1" == errorMessage);
+        }
+        {
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 0));
+            codes.push_back(code(BC::e_Call, 3));
+            codes.push_back(code(BC::e_Exit));
+            codes.push_back(code(BC::e_Load, 0));
+            codes.push_back(code(BC::e_Exit));
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 0));
+            ASSERTV(errorMessage,
+                    "argument count is not a constant at code 1" ==
+                                                                errorMessage);
+        }
+        {
+            // The branch at 1 reaches 4 with one more value than the path
+            // through 2.
+
+            bsl::vector<BC> codes;
+            codes.push_back(code(BC::e_Load, 0));                     // 0
+            codes.push_back(code(BC::e_If, 4));                       // 1
+            codes.push_back(code(BC::e_Push, 1));                     // 2
+            codes.push_back(code(BC::e_Push, 2));                     // 3
+            codes.push_back(code(BC::e_Exit));                        // 4
+            SsaFunction function;
+            ASSERT(0 != SsaUtil::build(&function, &errorMessage, codes, 0));
+            ASSERTV(errorMessage,
+                    "inconsistent stack height at code 4" == errorMessage);
+        }
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "lower" << endl
+                          << "=====" << endl;
+
+        // Each value has a slot, constants are pushed where used, and the
+        // operands of phis are copied by their predecessors through the
+        // stack.
+
+        bsl::vector<BC> codes;
+        sumLoop(&codes);
+        bsl::string errorMessage;
+        SsaFunction function;
+        ASSERT(0 == SsaUtil::build(&function, &errorMessage, codes, 0));
+
+        bsl::vector<BC> lowered;
+        lowered.push_back(code(BC::e_Exit));
+        ASSERT(1 == SsaUtil::lower(&lowered, function));
+
+        // v12 to v16 are in slots 8 to 11, and slot 12 is for discarded
+        // objects.
+
+        const BC EXPECTED[] = {
+            code(BC::e_Exit),
+            code(BC::e_Resize, 13),
+            code(BC::e_Push, 0),                  // b1
+            code(BC::e_Push, 0),
+            code(BC::e_Store, 9),
+            code(BC::e_Store, 8),
+            code(BC::e_Load, 8),                  // b2
+            code(BC::e_Load, 0),
+            code(BC::e_IfEqInts, 21),
+            code(BC::e_Load, 9),                  // b3
+            code(BC::e_Load, 8),
+            code(BC::e_AddInts),
+            code(BC::e_Store, 10),
+            code(BC::e_Load, 8),
+            code(BC::e_Store, 11),
+            code(BC::e_IncInt, 11),
+            code(BC::e_Load, 11),
+            code(BC::e_Load, 10),
+            code(BC::e_Store, 9),
+            code(BC::e_Store, 8),
+            code(BC::e_Jump, 6),
+            code(BC::e_Load, 9),                  // b4
+            code(BC::e_Exit),
+        };
+        const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+        ASSERTV(lowered.size(), NUM_EXPECTED == lowered.size());
+        for (int i = 0;
+             i < NUM_EXPECTED && i < static_cast<int>(lowered.size());
+             ++i) {
+            ASSERTV(i, EXPECTED[i] == lowered[i]);
+        }
+
+        // A branch taken to a block having phis goes through a stub placed
+        // after every block.
+
+        codes.clear();
+        codes.push_back(code(BC::e_Push, 0));                         // 0
+        codes.push_back(code(BC::e_Store, 1));                        // 1
+        codes.push_back(code(BC::e_Load, 0));                         // 2
+        codes.push_back(code(BC::e_If, 6));                           // 3
+        codes.push_back(code(BC::e_Push, 1));                         // 4
+        codes.push_back(code(BC::e_Store, 1));                        // 5
+        codes.push_back(code(BC::e_Load, 1));                         // 6
+        codes.push_back(code(BC::e_Exit));                            // 7
+        SsaFunction branch;
+        ASSERT(0 == SsaUtil::build(&branch, &errorMessage, codes, 0));
+        ASSERTV(print(branch),
+                bsl::string(PARAMETERS) +
+                "b1: <- b0\n"
+                "    v9 = P 0\n"
+                "    I v0 b3 b2\n"
+                "b2: <- b1\n"
+                "    v11 = P 1\n"
+                "    J b3\n"
+                "b3: <- b1 b2\n"
+                "    v13 = phi v9 v11\n"
+                "    X v13\n" == print(branch));
+
+        lowered.clear();
+        ASSERT(0 == SsaUtil::lower(&lowered, branch));
+        const BC BRANCH[] = {
+            code(BC::e_Resize, 10),
+            code(BC::e_Load, 0),                  // b1
+            code(BC::e_If, 7),
+            code(BC::e_Push, 1),                  // b2
+            code(BC::e_Store, 8),
+            code(BC::e_Load, 8),                  // b3
+            code(BC::e_Exit),
+            code(BC::e_Push, 0),                  // stub for b1 to b3
+            code(BC::e_Store, 8),
+            code(BC::e_Jump, 5),
+        };
+        const int NUM_BRANCH = sizeof(BRANCH) / sizeof(*BRANCH);
+
+        ASSERTV(lowered.size(), NUM_BRANCH == lowered.size());
+        for (int i = 0;
+             i < NUM_BRANCH && i < static_cast<int>(lowered.size());
+             ++i) {
+            ASSERTV(i, BRANCH[i] == lowered[i]);
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "build loops" << endl
+                          << "===========" << endl;
+
+        // A phi is created for each slot assigned in a loop, and the phis of
+        // the slots it does not assign are removed.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Exit));
+        sumLoop(&codes);
+        for (bsl::size_t i = 0; i < codes.size(); ++i) {
+            if (BC::e_IfEqInts == codes[i].opcode() ||
+                BC::e_Jump == codes[i].opcode()) {
+                codes[i] = code(codes[i].opcode(),
+                                codes[i].data().theInteger() + 1);
+            }
+        }
+
+        bsl::string errorMessage;
+        SsaFunction function;
+        ASSERT(0 == SsaUtil::build(&function, &errorMessage, codes, 1));
+        ASSERTV(print(function),
+                bsl::string(PARAMETERS) +
+                "b1: <- b0\n"
+                "    v9 = P 0\n"
+                "    v10 = P 0\n"
+                "    J b2\n"
+                "b2: <- b1 b3\n"
+                "    v12 = phi v9 v16\n"
+                "    v13 = phi v10 v15\n"
+                "    I=i v12 v0 b4 b3\n"
+                "b3: <- b2\n"
+                "    v15 = +i v13 v12\n"
+                "    v16 = ++i v12\n"
+                "    J b2\n"
+                "b4: <- b2\n"
+                "    X v13\n" == print(function));
+        ASSERT(5 == function.numBlocks());
+        ASSERT(1 == function.firstCode(1));
+        ASSERT(5 == function.firstCode(2));
+        ASSERT(8 == function.firstCode(3));
+        ASSERT(14 == function.firstCode(4));
+
+        // Phis of phis are kept.
+
+        codes.clear();
+        codes.push_back(code(BC::e_Load, 1));                         // 0
+        codes.push_back(code(BC::e_Load, 0));                         // 1
+        codes.push_back(code(BC::e_Store, 1));                        // 2
+        codes.push_back(code(BC::e_Store, 0));                        // 3
+        codes.push_back(code(BC::e_Load, 2));                         // 4
+        codes.push_back(code(BC::e_If, 0));                           // 5
+        codes.push_back(code(BC::e_Load, 0));                         // 6
+        codes.push_back(code(BC::e_Exit));                            // 7
+        SsaFunction swap;
+        ASSERT(0 == SsaUtil::build(&swap, &errorMessage, codes, 0));
+        ASSERTV(print(swap),
+                bsl::string(PARAMETERS) +
+                "b1: <- b0 b1\n"
+                "    v9 = phi v0 v10\n"
+                "    v10 = phi v1 v9\n"
+                "    I v2 b1 b2\n"
+                "b2: <- b1\n"
+                "    X v10\n" == print(swap));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        // 'e_Load' and 'e_Store' disappear, and calls take their arguments
+        // as operands.
+
+        bsl::vector<BC> codes;
+        codes.push_back(code(BC::e_Push, 2));                         // 0
+        codes.push_back(code(BC::e_Load, 0));                         // 1
+        codes.push_back(code(BC::e_AddInts));                         // 2
+        codes.push_back(code(BC::e_Store, 1));                        // 3
+        codes.push_back(code(BC::e_Load, 1));                         // 4
+        codes.push_back(code(BC::e_Push, 1));                         // 5
+        codes.push_back(code(BC::e_Call, 8));                         // 6
+        codes.push_back(code(BC::e_Exit));                            // 7
+        codes.push_back(code(BC::e_Load, 0));                         // 8
+        codes.push_back(code(BC::e_Exit));                            // 9
+
+        bsl::string errorMessage;
+        SsaFunction function;
+        ASSERT(0 == SsaUtil::build(&function, &errorMessage, codes, 0));
+        ASSERTV(print(function),
+                bsl::string(PARAMETERS) +
+                "b1: <- b0\n"
+                "    v9 = P 2\n"
+                "    v10 = +i v9 v0\n"
+                "    v11 = P 1\n"
+                "    v12 = C8 v10\n"
+                "    X v12\n" == print(function));
+
+        // The number of values before each code may be reported.
+
+        SsaFunction      again;
+        bsl::vector<int> heights;
+        ASSERT(0 == SsaUtil::build(&again,
+                                   &errorMessage,
+                                   codes,
+                                   0,
+                                   0,
+                                   &heights));
+        const int HEIGHTS[] = { 8, 9, 10, 9, 8, 9, 10, 9, -1, -1 };
+        ASSERTV(heights.size(), 10 == heights.size());
+        for (int i = 0; i < 10 && i < static_cast<int>(heights.size()); ++i) {
+            ASSERTV(i, heights[i], HEIGHTS[i] == heights[i]);
+        }
+
+        bsl::vector<BC> lowered;
+        ASSERT(0 == SsaUtil::lower(&lowered, function));
+
+        const BC EXPECTED[] = {
+            code(BC::e_Resize, 11),
+            code(BC::e_Push, 2),
+            code(BC::e_Load, 0),
+            code(BC::e_AddInts),
+            code(BC::e_Store, 8),
+            code(BC::e_Load, 8),
+            code(BC::e_Push, 1),
+            code(BC::e_Call, 8),
+            code(BC::e_Store, 9),
+            code(BC::e_Load, 9),
+            code(BC::e_Exit),
+        };
+        const int NUM_EXPECTED = sizeof(EXPECTED) / sizeof(*EXPECTED);
+
+        ASSERTV(lowered.size(), NUM_EXPECTED == lowered.size());
+        for (int i = 0;
+             i < NUM_EXPECTED && i < static_cast<int>(lowered.size());
+             ++i) {
+            ASSERTV(i, EXPECTED[i] == lowered[i]);
+        }
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
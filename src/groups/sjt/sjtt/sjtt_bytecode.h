@@ -45,6 +45,34 @@ class Bytecode {
     // all values pertaining to the existing frame are popped off, then the
     // saved value is pushed back onto the stack as the return value of the
     // function.
+    //
+    // # Function values
+    //
+    // A function may also be called through a value: a code value (see
+    // `DatumUdtUtil::datumFromCode`) referring to its first code, or a
+    // closure (see `sjtm::ClosureUtil`) of such a code value and the values
+    // it captures.  The callee is pushed before the arguments, and stays on
+    // the stack just below the frame of the call, whose `e_Exit` pops it
+    // with the arguments.  The indices of the jumps and calls of a function
+    // called through a value are relative to its first code.
+    //
+    // # Tail calls
+    //
+    // A call in tail position, i.e., whose result the calling function
+    // returns at once, may be made by `e_TailCall`, which replaces the frame
+    // of the calling function rather than adding one, so that a recursion
+    // made entirely of tail calls runs in constant space.  The callee of a
+    // frame called through a value is kept when the frame is reused.
+    //
+    // # Exceptions
+    //
+    // An exception is thrown by `e_Throw`, or by an external function (see
+    // `ExecutionContext::throwException`), and handled as described by the
+    // `ExceptionTable` of the program, which is consulted only when an
+    // exception is thrown.  Evaluation continues at the handler of the
+    // innermost `try` block covering the current code of a frame, searching
+    // from the current frame outward, with the exception pushed on the
+    // stack.
 
   public:
         // Signature for functions provided by the user.
@@ -124,6 +152,122 @@ class Bytecode {
             // Set the stack for the current frame to the size specified by the
             // integer stored with this opcode, popping excess values and
             // populating new values with 'DatumUdtUtil::e_Undefined'.
+
+        e_NewObject,
+            // Push a new heap object having the number of slots specified by
+            // the integer stored with this opcode, each holding
+            // 'DatumUdtUtil::s_Undefined'.
+
+        e_GetSlot,
+            // Replace the object on the top of the stack with the value of
+            // its slot at the index specified by the integer stored with this
+            // opcode.
+
+        e_SetSlot,
+            // Pop the value from the top of the stack and store it in the
+            // slot, at the index specified by the integer stored with this
+            // opcode, of the object then on the top of the stack, which is
+            // left there.
+
+        e_GetProp,
+            // Replace the object on the top of the stack with the value of
+            // its property named by the string stored with this opcode, or
+            // with 'DatumUdtUtil::s_Undefined' if it has no such property.
+
+        e_SetProp,
+            // Pop the value from the top of the stack and store it in the
+            // property, named by the string stored with this opcode, of the
+            // object then on the top of the stack, which is left there,
+            // adding the property if the object does not have it.
+
+        e_NewTypedArray,
+            // Replace the integer on the top of the stack with a new typed
+            // array having that many elements, each 0, of the type specified
+            // by the integer stored with this opcode: 0 for 32-bit integers
+            // and 1 for doubles (see 'sjtm::TypedArrayUtil').
+
+        e_GetElement,
+            // Pop the integer index from the top of the stack, and replace the
+            // typed array then on the top of the stack with its element at
+            // that index.
+
+        e_SetElement,
+            // Pop the value and then the integer index from the top of the
+            // stack, and store the value in the element at that index of the
+            // typed array then on the top of the stack, which is left there.
+
+        e_ArrayLength,
+            // Replace the typed array on the top of the stack with the number
+            // of its elements.
+
+        e_ArraySum,
+            // Replace the typed array on the top of the stack with the sum of
+            // its elements.
+
+        e_ArrayDot,
+            // Pop the typed array from the top of the stack, and replace the
+            // typed array then on the top of the stack, which has the same
+            // element type and length, with the sum of the products of their
+            // corresponding elements.
+
+        e_ArrayMin,
+            // Replace the typed array on the top of the stack with its
+            // smallest element, or 'DatumUdtUtil::s_Undefined' if it is
+            // empty.
+
+        e_ArrayMax,
+            // Replace the typed array on the top of the stack with its
+            // largest element, or 'DatumUdtUtil::s_Undefined' if it is empty.
+
+        e_ArrayScale,
+            // Pop the number from the top of the stack and multiply each
+            // element of the typed array then on the top of the stack, which
+            // is left there, by it.
+
+        e_ArrayAdd,
+            // Pop the typed array from the top of the stack, and add each of
+            // its elements to the corresponding element of the typed array
+            // then on the top of the stack, which has the same element type
+            // and length and is left there.
+
+        e_PushCode,
+            // Push a code value referring to the code at the index, in the
+            // code of the current frame, specified by the integer stored with
+            // this opcode.
+
+        e_MakeClosure,
+            // Pop the number of values specified by the integer stored with
+            // this opcode from the top of the stack, and replace the code
+            // value then on the top of the stack with a closure of it that
+            // captures those values, in order.
+
+        e_LoadCaptured,
+            // Push the value captured, at the index specified by the integer
+            // stored with this opcode, by the closure that is the callee of
+            // the current frame.
+
+        e_CallValue,
+            // The top value on the stack is an integer with the number of
+            // arguments for the call, which are below it, and below them is
+            // the callee: a code value or a closure.  Create, and begin
+            // evaluating, a new frame starting at the first code of the
+            // callee, passing a pointer to the arguments.  The behavior is
+            // undefined unless that code is part of the program being
+            // evaluated.
+
+        e_TailCall,
+            // Call, as 'e_Call' does, the code at the index specified by the
+            // integer stored with this opcode, reusing the current frame:
+            // the arguments are moved down to its bottom, replacing its
+            // values, and the frame continues at the called code, so that
+            // the called function returns directly to the caller of the
+            // current one.  'e_Call' immediately followed by 'e_Exit' has the
+            // same result, but uses an additional frame until the call
+            // returns.
+
+        e_Throw,
+            // Pop the value from the top of the stack and throw it as an
+            // exception (see 'ExceptionTable').
     };
 
     static const int s_MinInitialStackSize = 8;
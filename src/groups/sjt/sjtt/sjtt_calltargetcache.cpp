@@ -0,0 +1,5 @@
+// sjtt_calltargetcache.cpp
+#include <sjtt_calltargetcache.h>
+
+namespace sjtt {
+}
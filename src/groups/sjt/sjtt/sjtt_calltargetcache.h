@@ -0,0 +1,161 @@
+// sjtt_calltargetcache.h
+
+#ifndef INCLUDED_SJTT_CALLTARGETCACHE
+#define INCLUDED_SJTT_CALLTARGETCACHE
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace sjtt {
+
+class Bytecode;
+
+                           // =====================
+                           // class CallTargetCache
+                           // =====================
+
+class CallTargetCache {
+    // This class is an in-core, value-semantic type implementing the inline
+    // cache of a single indirect call site.  It remembers each of up to
+    // 'k_MAX_ENTRIES' targets -- the first code of the functions called from
+    // the site -- and the number of calls made to it.  As for
+    // 'sjtm::PropertyCache', a cache with no entries is uninitialized, one
+    // with a single entry is monomorphic, and one with several is
+    // polymorphic; once more targets than it can hold have been seen the
+    // cache is megamorphic and stops recording.  The targets of a
+    // monomorphic site are those a compiler may call directly, or inline,
+    // after checking the callee.
+
+  public:
+    // CONSTANTS
+    enum { k_MAX_ENTRIES = 4 };
+
+  private:
+    // TYPES
+    struct Entry {
+        const Bytecode *d_target_p;    // held, not owned
+        int             d_numCalls;
+    };
+
+    // DATA
+    Entry d_entries[k_MAX_ENTRIES];
+    int   d_numEntries;                // -1 if megamorphic
+
+  public:
+    // CREATORS
+    CallTargetCache();
+        // Create an uninitialized cache.
+
+    //! CallTargetCache(const CallTargetCache& original) = default;
+    //! ~CallTargetCache() = default;
+
+    // MANIPULATORS
+    //! CallTargetCache& operator=(const CallTargetCache& rhs) = default;
+
+    void record(const Bytecode *target);
+        // Remember a call from this site to the function whose first code is
+        // the specified 'target'.  If 'target' is new and this cache is full
+        // it becomes megamorphic.
+
+    // ACCESSORS
+    bool isMegamorphic() const;
+        // Return 'true' if this cache has stopped recording, and 'false'
+        // otherwise.
+
+    const Bytecode *monomorphicTarget() const;
+        // Return the only target remembered by this cache, or 0 unless this
+        // cache is monomorphic.
+
+    int numCalls(int index) const;
+        // Return the number of calls recorded to the target at the specified
+        // 'index'.  The behavior is undefined unless
+        // '0 <= index < numEntries()'.
+
+    int numEntries() const;
+        // Return the number of targets remembered by this cache.
+
+    const Bytecode *target(int index) const;
+        // Return the target at the specified 'index', in the order in which
+        // targets were first seen.  The behavior is undefined unless
+        // '0 <= index < numEntries()'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                           // ---------------------
+                           // class CallTargetCache
+                           // ---------------------
+
+// CREATORS
+inline
+CallTargetCache::CallTargetCache()
+: d_entries()
+, d_numEntries(0)
+{
+}
+
+// MANIPULATORS
+inline
+void CallTargetCache::record(const Bytecode *target)
+{
+    BSLS_ASSERT(0 != target);
+
+    for (int i = 0; i < d_numEntries; ++i) {
+        if (target == d_entries[i].d_target_p) {
+            ++d_entries[i].d_numCalls;
+            return;                                                   // RETURN
+        }
+    }
+    if (k_MAX_ENTRIES == d_numEntries) {
+        d_numEntries = -1;
+    }
+    if (0 > d_numEntries) {
+        return;                                                       // RETURN
+    }
+    Entry& entry = d_entries[d_numEntries++];
+    entry.d_target_p = target;
+    entry.d_numCalls = 1;
+}
+
+// ACCESSORS
+inline
+bool CallTargetCache::isMegamorphic() const
+{
+    return 0 > d_numEntries;
+}
+
+inline
+const Bytecode *CallTargetCache::monomorphicTarget() const
+{
+    return 1 == d_numEntries ? d_entries[0].d_target_p : 0;
+}
+
+inline
+int CallTargetCache::numCalls(int index) const
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numEntries());
+
+    return d_entries[index].d_numCalls;
+}
+
+inline
+int CallTargetCache::numEntries() const
+{
+    return 0 > d_numEntries ? 0 : d_numEntries;
+}
+
+inline
+const Bytecode *CallTargetCache::target(int index) const
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numEntries());
+
+    return d_entries[index].d_target_p;
+}
+}
+
+#endif
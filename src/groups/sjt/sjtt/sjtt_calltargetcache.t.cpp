@@ -0,0 +1,133 @@
+// sjtt_calltargetcache.t.cpp                                     -*-C++-*-
+
+#include <sjtt_calltargetcache.h>
+
+#include <bdls_testutil.h>
+
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "polymorphic and megamorphic" << endl
+                          << "===========================" << endl;
+
+        Bytecode codes[CallTargetCache::k_MAX_ENTRIES + 1];
+
+        CallTargetCache cache;
+        for (int i = 0; i < CallTargetCache::k_MAX_ENTRIES; ++i) {
+            cache.record(codes + i);
+            cache.record(codes + i);
+            LOOP_ASSERT(i, i + 1 == cache.numEntries());
+        }
+        ASSERT(!cache.isMegamorphic());
+        ASSERT(0 == cache.monomorphicTarget());
+        for (int i = 0; i < CallTargetCache::k_MAX_ENTRIES; ++i) {
+            LOOP_ASSERT(i, codes + i == cache.target(i));
+            LOOP_ASSERT(i, 2 == cache.numCalls(i));
+        }
+
+        // One target too many makes the cache stop recording.
+
+        cache.record(codes + CallTargetCache::k_MAX_ENTRIES);
+        ASSERT(cache.isMegamorphic());
+        ASSERT(0 == cache.numEntries());
+        ASSERT(0 == cache.monomorphicTarget());
+        cache.record(codes);
+        ASSERT(0 == cache.numEntries());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        Bytecode codes[2];
+
+        CallTargetCache cache;
+        ASSERT(0 == cache.numEntries());
+        ASSERT(!cache.isMegamorphic());
+        ASSERT(0 == cache.monomorphicTarget());
+
+        cache.record(codes);
+        cache.record(codes);
+        ASSERT(1 == cache.numEntries());
+        ASSERT(codes == cache.monomorphicTarget());
+        ASSERT(codes == cache.target(0));
+        ASSERT(2 == cache.numCalls(0));
+
+        cache.record(codes + 1);
+        ASSERT(2 == cache.numEntries());
+        ASSERT(0 == cache.monomorphicTarget());
+        ASSERT(codes + 1 == cache.target(1));
+        ASSERT(1 == cache.numCalls(1));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,108 @@
+// sjtt_constantpool.cpp
+#include <sjtt_constantpool.h>
+
+#include <bslma_default.h>
+
+#include <bsl_cstring.h>
+
+using namespace BloombergLP;
+
+namespace sjtt {
+namespace {
+
+bsl::size_t hashBytes(bsl::size_t hash, const void *data, bsl::size_t length)
+    // Return the specified 'hash' combined with the specified 'length' bytes
+    // at the specified 'data' using FNV-1a.
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (bsl::size_t i = 0; i < length; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+}
+
+                      // ------------------------------
+                      // struct ConstantPool::DatumHash
+                      // ------------------------------
+
+bsl::size_t ConstantPool::DatumHash::operator()(const Datum& value) const
+{
+    const int type = value.type();
+    bsl::size_t hash = hashBytes(14695981039346656037ULL, &type, sizeof type);
+    if (value.isInteger()) {
+        const int i = value.theInteger();
+        hash = hashBytes(hash, &i, sizeof i);
+    }
+    else if (value.isDouble()) {
+        const double d = value.theDouble();
+        hash = hashBytes(hash, &d, sizeof d);
+    }
+    else if (value.isBoolean()) {
+        const bool b = value.theBoolean();
+        hash = hashBytes(hash, &b, sizeof b);
+    }
+    else if (value.isString()) {
+        const bslstl::StringRef s = value.theString();
+        hash = hashBytes(hash, s.data(), s.length());
+    }
+    else if (value.isUdt()) {
+        const void *data = value.theUdt().data();
+        const int   udtType = value.theUdt().type();
+        hash = hashBytes(hash, &data, sizeof data);
+        hash = hashBytes(hash, &udtType, sizeof udtType);
+    }
+    return hash;
+}
+
+                    // -----------------------------------
+                    // struct ConstantPool::DatumIdentical
+                    // -----------------------------------
+
+bool ConstantPool::DatumIdentical::operator()(const Datum& lhs,
+                                              const Datum& rhs) const
+{
+    if (lhs.isDouble() && rhs.isDouble()) {
+        const double l = lhs.theDouble();
+        const double r = rhs.theDouble();
+        return 0 == bsl::memcmp(&l, &r, sizeof l);                    // RETURN
+    }
+    return lhs == rhs;
+}
+
+                            // ------------------
+                            // class ConstantPool
+                            // ------------------
+
+// CREATORS
+ConstantPool::ConstantPool(Allocator *basicAllocator)
+: d_constants(basicAllocator)
+, d_indices(basicAllocator)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+}
+
+ConstantPool::~ConstantPool()
+{
+    for (bsl::size_t i = 0; i < d_constants.size(); ++i) {
+        Datum::destroy(d_constants[i], d_allocator_p);
+    }
+}
+
+// MANIPULATORS
+int ConstantPool::intern(const Datum& value)
+{
+    const bsl::unordered_map<Datum,
+                             int,
+                             DatumHash,
+                             DatumIdentical>::const_iterator it =
+                                                      d_indices.find(value);
+    if (d_indices.end() != it) {
+        return it->second;                                            // RETURN
+    }
+    const int index = numConstants();
+    d_constants.push_back(value.clone(d_allocator_p));
+    d_indices.emplace(d_constants.back(), index);
+    return index;
+}
+}
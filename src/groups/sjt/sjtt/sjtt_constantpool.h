@@ -0,0 +1,135 @@
+// sjtt_constantpool.h
+
+#ifndef INCLUDED_SJTT_CONSTANTPOOL
+#define INCLUDED_SJTT_CONSTANTPOOL
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_UNORDERED_MAP
+#include <bsl_unordered_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                            // ==================
+                            // class ConstantPool
+                            // ==================
+
+class ConstantPool {
+    // This class is a mechanism that owns the constant values used by a block
+    // of code, storing each distinct value exactly once.  Interning a value
+    // that is already in the pool returns the existing copy, so code that
+    // pushes the same constant many times shares a single copy of its data.
+    // Two values are considered identical if they have the same type and
+    // representation; in particular '0.0' and '-0.0' are distinct, and a NaN
+    // is identical only to a NaN having the same bits.  Note that 'Datum'
+    // objects returned by a pool remain valid until the pool is destroyed.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    struct DatumHash {
+        // Functor hashing the representation of a 'Datum'.
+
+        bsl::size_t operator()(const Datum& value) const;
+            // Return a hash of the specified 'value'.
+    };
+
+    struct DatumIdentical {
+        // Functor comparing the representation of two 'Datum' objects.
+
+        bool operator()(const Datum& lhs, const Datum& rhs) const;
+            // Return 'true' if the specified 'lhs' and 'rhs' have the same
+            // type and representation, and 'false' otherwise.
+    };
+
+  private:
+    // DATA
+    bsl::vector<Datum>                  d_constants;   // owned values
+    bsl::unordered_map<Datum,
+                       int,
+                       DatumHash,
+                       DatumIdentical>  d_indices;     // value to index
+    Allocator                          *d_allocator_p; // held, not owned
+
+    // NOT IMPLEMENTED
+    ConstantPool(const ConstantPool&) = delete;
+    ConstantPool& operator=(const ConstantPool&) = delete;
+
+  public:
+    // CREATORS
+    explicit ConstantPool(Allocator *basicAllocator = 0);
+        // Create an empty pool.  Optionally specify a 'basicAllocator' used to
+        // supply memory.  If 'basicAllocator' is 0, the currently installed
+        // default allocator is used.
+
+    ~ConstantPool();
+        // Destroy this object and release the memory of every value in it.
+
+    // MANIPULATORS
+    int intern(const Datum& value);
+        // Return the index of the constant identical to the specified 'value'
+        // in this pool, first adding a deep copy of 'value' to the pool if
+        // there is no such constant.
+
+    // ACCESSORS
+    Allocator *allocator() const;
+        // Return the allocator used by this pool to supply memory.
+
+    const Datum& constant(int index) const;
+        // Return a reference providing non-modifiable access to the constant
+        // at the specified 'index'.  The behavior is undefined unless
+        // '0 <= index < numConstants()'.
+
+    int numConstants() const;
+        // Return the number of distinct constants in this pool.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // ------------------
+                            // class ConstantPool
+                            // ------------------
+
+// ACCESSORS
+inline
+BloombergLP::bslma::Allocator *ConstantPool::allocator() const
+{
+    return d_allocator_p;
+}
+
+inline
+const BloombergLP::bdld::Datum& ConstantPool::constant(int index) const
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numConstants());
+
+    return d_constants[index];
+}
+
+inline
+int ConstantPool::numConstants() const
+{
+    return static_cast<int>(d_constants.size());
+}
+}
+
+#endif
@@ -0,0 +1,165 @@
+// sjtt_constantpool.t.cpp                                        -*-C++-*-
+
+#include <sjtt_constantpool.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_limits.h>
+
+#include <sjtd_datumudtutil.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    typedef bdld::Datum Datum;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "intern strings" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta;
+        bslma::TestAllocator sa;
+        {
+            ConstantPool pool(&ta);
+            const Datum hello = Datum::copyString("hello", 5, &sa);
+            const Datum world = Datum::copyString("world", 5, &sa);
+            const Datum hello2 = Datum::copyString("hello", 5, &sa);
+
+            ASSERT(0 == pool.intern(hello));
+            ASSERT(1 == pool.intern(world));
+            ASSERT(0 == pool.intern(hello2));
+            ASSERT(2 == pool.numConstants());
+
+            // The pool owns its own copy of each string.
+
+            ASSERT(hello.theString().data() !=
+                                        pool.constant(0).theString().data());
+            Datum::destroy(hello, &sa);
+            Datum::destroy(world, &sa);
+            Datum::destroy(hello2, &sa);
+            ASSERT(0 == sa.numBlocksInUse());
+            ASSERT("hello" == pool.constant(0).theString());
+            ASSERT("world" == pool.constant(1).theString());
+            ASSERT(0 < ta.numBlocksInUse());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "intern identical values" << endl
+                          << "=======================" << endl;
+
+        bslma::TestAllocator ta;
+        ConstantPool pool(&ta);
+
+        const double nan = bsl::numeric_limits<double>::quiet_NaN();
+
+        const Datum values[] = {
+            Datum::createInteger(1),
+            Datum::createInteger(2),
+            Datum::createDouble(1.),
+            Datum::createDouble(0.),
+            Datum::createDouble(-0.),
+            Datum::createDouble(nan),
+            Datum::createBoolean(true),
+            Datum::createBoolean(false),
+            Datum::createNull(),
+            sjtd::DatumUdtUtil::s_Undefined,
+        };
+        const int NUM_VALUES = sizeof(values) / sizeof(values[0]);
+
+        for (int i = 0; i < NUM_VALUES; ++i) {
+            LOOP_ASSERT(i, i == pool.intern(values[i]));
+        }
+        ASSERT(NUM_VALUES == pool.numConstants());
+        for (int i = 0; i < NUM_VALUES; ++i) {
+            LOOP_ASSERT(i, i == pool.intern(values[i]));
+            LOOP_ASSERT(i, values[i].type() == pool.constant(i).type());
+        }
+        ASSERT(NUM_VALUES == pool.numConstants());
+        ASSERT(0 == pool.intern(Datum::createInteger(1)));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        ConstantPool pool(&ta);
+        ASSERT(&ta == pool.allocator());
+        ASSERT(0 == pool.numConstants());
+        ASSERT(0 == pool.intern(Datum::createInteger(3)));
+        ASSERT(1 == pool.numConstants());
+        ASSERT(Datum::createInteger(3) == pool.constant(0));
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,87 @@
+// sjtt_deopttable.cpp
+#include <sjtt_deopttable.h>
+
+namespace sjtt {
+
+                             // ----------------
+                             // class DeoptTable
+                             // ----------------
+
+// CREATORS
+DeoptTable::DeoptTable(Allocator *basicAllocator)
+: d_points(basicAllocator)
+, d_states(basicAllocator)
+, d_numPoints(0)
+{
+}
+
+// MANIPULATORS
+void DeoptTable::addPoint(int index, const FrameState *frames, int numFrames)
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(0 != frames);
+    BSLS_ASSERT(0 < numFrames);
+    BSLS_ASSERT(0 == frames[0].d_bottom);
+
+    if (static_cast<int>(d_points.size()) <= index) {
+        const Point none = { 0, 0 };
+        d_points.resize(index + 1, none);
+    }
+    Point& point = d_points[index];
+    BSLS_ASSERT(point.d_begin == point.d_end);
+
+    point.d_begin = static_cast<int>(d_states.size());
+    for (int i = 0; i < numFrames; ++i) {
+        BSLS_ASSERT(0 == i || frames[i - 1].d_bottom <= frames[i].d_bottom);
+        d_states.push_back(frames[i]);
+    }
+    point.d_end = static_cast<int>(d_states.size());
+    ++d_numPoints;
+}
+
+// ACCESSORS
+const DeoptTable::FrameState *DeoptTable::findPoint(int *numFrames,
+                                                    int  index) const
+{
+    BSLS_ASSERT(0 != numFrames);
+
+    if (0 > index || static_cast<int>(d_points.size()) <= index) {
+        return 0;                                                     // RETURN
+    }
+    const Point& point = d_points[index];
+    if (point.d_begin == point.d_end) {
+        return 0;                                                     // RETURN
+    }
+    *numFrames = point.d_end - point.d_begin;
+    return &d_states[point.d_begin];
+}
+
+int DeoptTable::rebuild(bsl::vector<Frame> *frames,
+                        const Bytecode     *optimized,
+                        const Bytecode     *original) const
+{
+    BSLS_ASSERT(0 != frames);
+    BSLS_ASSERT(!frames->empty());
+    BSLS_ASSERT(0 != optimized);
+    BSLS_ASSERT(0 != original);
+
+    const Frame       frame = frames->back();
+    int               numFrames;
+    const FrameState *states = findPoint(
+                                 &numFrames,
+                                 static_cast<int>(frame.pc() - optimized));
+    if (0 == states) {
+        return 1;                                                     // RETURN
+    }
+
+    frames->pop_back();
+    for (int i = 0; i < numFrames; ++i) {
+        const FrameState& state = states[i];
+        frames->emplace_back(frame.bottom() + state.d_bottom,
+                             original + state.d_firstCode,
+                             original + state.d_pc,
+                             0 == i && frame.hasCallee());
+    }
+    return 0;
+}
+}
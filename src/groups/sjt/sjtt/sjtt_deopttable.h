@@ -0,0 +1,134 @@
+// sjtt_deopttable.h
+
+#ifndef INCLUDED_SJTT_DEOPTTABLE
+#define INCLUDED_SJTT_DEOPTTABLE
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_SJTT_FRAME
+#include <sjtt_frame.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                             // ================
+                             // class DeoptTable
+                             // ================
+
+class DeoptTable {
+    // This class is a mechanism describing how to deoptimize a frame
+    // evaluating a block of optimized code: for each code at which it may
+    // bail out, a point, the frames evaluating the block of code it was
+    // optimized from that are in the same state before evaluating their
+    // next code, outermost first.  A frame having evaluated several
+    // functions inlined into one another is thus rebuilt as the frames of
+    // those functions.  The values of the frame are kept in place: each
+    // rebuilt frame begins at an offset from the bottom of the frame it
+    // replaces, and has the values above it, up to the next rebuilt frame,
+    // or the top of the stack for the innermost one.  Like an
+    // 'ExceptionTable', the table is a side table, consulted only when a
+    // frame is deoptimized, so optimized code pays nothing for its points.
+    // Indices are positions in the whole block, including the code of the
+    // functions it contains.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    struct FrameState {
+        // This 'struct' describes one frame rebuilt at a point.
+
+        int d_firstCode;  // index of the first code of the frame
+        int d_pc;         // index of the code the frame evaluates next, or
+                          // of the call it is evaluating if it is not the
+                          // innermost
+        int d_bottom;     // offset of the bottom of the frame from that of
+                          // the frame deoptimized
+    };
+
+  private:
+    // PRIVATE TYPES
+    struct Point {
+        // This 'struct' locates, in 'd_states', the frames of one point.
+
+        int d_begin;  // index of the outermost frame
+        int d_end;    // index one past the innermost frame
+    };
+
+    // DATA
+    bsl::vector<Point>      d_points;     // per code index, empty if none
+    bsl::vector<FrameState> d_states;     // in the order added
+    int                     d_numPoints;
+
+    // NOT IMPLEMENTED
+    DeoptTable(const DeoptTable&) = delete;
+    DeoptTable& operator=(const DeoptTable&) = delete;
+
+  public:
+    // CREATORS
+    explicit DeoptTable(Allocator *basicAllocator = 0);
+        // Create an empty table.  Optionally specify a 'basicAllocator' used
+        // to supply memory.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.
+
+    // MANIPULATORS
+    void addPoint(int index, const FrameState *frames, int numFrames);
+        // Add a point at the code at the specified 'index' of the optimized
+        // code, rebuilding the specified 'numFrames' 'frames', outermost
+        // first.  The behavior is undefined unless '0 <= index', there is no
+        // point at 'index', '0 < numFrames', the 'd_bottom' of the first of
+        // 'frames' is 0, and those of the others are in increasing order.
+
+    // ACCESSORS
+    const FrameState *findPoint(int *numFrames, int index) const;
+        // Return the address of the first of the frames rebuilt at the point
+        // at the specified 'index', and load their number into the specified
+        // 'numFrames', or return 0 if there is no point at 'index'.
+
+    int numPoints() const;
+        // Return the number of points in this table.
+
+    int rebuild(bsl::vector<Frame> *frames,
+                const Bytecode     *optimized,
+                const Bytecode     *original) const;
+        // Replace the last of the specified 'frames', evaluating the block of
+        // code beginning at the specified 'optimized', with the frames of the
+        // point at its next code, evaluating the block beginning at the
+        // specified 'original', and return 0; return a non-zero value, with
+        // no effect, if there is no such point.  The outermost frame rebuilt
+        // has a callee if the frame replaced has one.  The behavior is
+        // undefined unless 'frames' is not empty, and the next code of its
+        // last frame is in the block beginning at 'optimized'.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                             // ----------------
+                             // class DeoptTable
+                             // ----------------
+
+// ACCESSORS
+inline
+int DeoptTable::numPoints() const
+{
+    return d_numPoints;
+}
+}
+
+#endif
@@ -0,0 +1,203 @@
+// sjtt_deopttable.t.cpp                                          -*-C++-*-
+
+#include <sjtt_deopttable.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef DeoptTable::FrameState State;
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "rebuild" << endl
+                          << "=======" << endl;
+
+        // A frame evaluating a callee inlined at a call is rebuilt as the
+        // frame of the caller, evaluating the call, and that of the callee,
+        // above the values of the caller below the arguments.
+
+        const Bytecode OPTIMIZED[12] = {};
+        const Bytecode ORIGINAL[10]  = {};
+
+        bslma::TestAllocator ta;
+        DeoptTable           table(&ta);
+        const State INLINED[] = { { 0, 3, 0 }, { 0, 7, 2 } };
+        table.addPoint(10, INLINED, 2);
+        const State CALLER[] = { { 0, 4, 0 } };
+        table.addPoint(11, CALLER, 1);
+
+        const struct {
+            int d_line;
+            int d_bottom;
+            int d_pc;               // index in 'OPTIMIZED'
+            int d_hasCallee;
+            int d_numExpected;      // 0 if not rebuilt
+        } DATA[] = {
+            { L_,  0, 10, 0, 2 },
+            { L_,  5, 10, 1, 2 },
+            { L_,  5, 11, 1, 1 },
+            { L_,  5,  9, 1, 0 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int  LINE       = DATA[i].d_line;
+            const int  BOTTOM     = DATA[i].d_bottom;
+            const bool HAS_CALLEE = DATA[i].d_hasCallee;
+            const int  NUM_EXP    = DATA[i].d_numExpected;
+
+            bsl::vector<Frame> frames(&ta);
+            frames.emplace_back(0, OPTIMIZED, OPTIMIZED + 1);
+            const Frame FRAME(BOTTOM,
+                              OPTIMIZED,
+                              OPTIMIZED + DATA[i].d_pc,
+                              HAS_CALLEE);
+            frames.push_back(FRAME);
+
+            const int rc = table.rebuild(&frames, OPTIMIZED, ORIGINAL);
+            if (0 == NUM_EXP) {
+                LOOP_ASSERT(LINE, 0 != rc);
+                LOOP_ASSERT(LINE, 2 == frames.size());
+                LOOP_ASSERT(LINE, FRAME == frames.back());
+                continue;                                           // CONTINUE
+            }
+            LOOP_ASSERT(LINE, 0 == rc);
+            LOOP_ASSERT(LINE, 1 + NUM_EXP == static_cast<int>(frames.size()));
+            if (1 + NUM_EXP != static_cast<int>(frames.size())) {
+                continue;                                           // CONTINUE
+            }
+            LOOP_ASSERT(LINE, Frame(0, OPTIMIZED, OPTIMIZED + 1) == frames[0]);
+            if (2 == NUM_EXP) {
+                LOOP_ASSERT(LINE,
+                            Frame(BOTTOM, ORIGINAL, ORIGINAL + 3, HAS_CALLEE)
+                                                               == frames[1]);
+                LOOP_ASSERT(LINE,
+                            Frame(BOTTOM + 2, ORIGINAL, ORIGINAL + 7)
+                                                               == frames[2]);
+            }
+            else {
+                LOOP_ASSERT(LINE,
+                            Frame(BOTTOM, ORIGINAL, ORIGINAL + 4, HAS_CALLEE)
+                                                               == frames[1]);
+            }
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        {
+            DeoptTable table(&ta);
+            int        numFrames = -1;
+            ASSERT(0 == table.numPoints());
+            ASSERT(0 == table.findPoint(&numFrames, 0));
+
+            const State STATES[] = { { 0, 3, 0 }, { 5, 6, 4 } };
+            table.addPoint(2, STATES, 2);
+            ASSERT(1 == table.numPoints());
+            ASSERT(0 == table.findPoint(&numFrames, 1));
+            ASSERT(0 == table.findPoint(&numFrames, 3));
+
+            const State *states = table.findPoint(&numFrames, 2);
+            ASSERT(0 != states);
+            ASSERT(2 == numFrames);
+            ASSERT(0 == states[0].d_firstCode);
+            ASSERT(3 == states[0].d_pc);
+            ASSERT(0 == states[0].d_bottom);
+            ASSERT(5 == states[1].d_firstCode);
+            ASSERT(6 == states[1].d_pc);
+            ASSERT(4 == states[1].d_bottom);
+
+            // Points may be added in any order.
+
+            table.addPoint(0, STATES, 1);
+            ASSERT(2 == table.numPoints());
+            ASSERT(0 != table.findPoint(&numFrames, 0));
+            ASSERT(1 == numFrames);
+            ASSERT(0 != table.findPoint(&numFrames, 2));
+            ASSERT(2 == numFrames);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,39 @@
+// sjtt_exceptiontable.cpp
+#include <sjtt_exceptiontable.h>
+
+namespace sjtt {
+
+                           // --------------------
+                           // class ExceptionTable
+                           // --------------------
+
+// CREATORS
+ExceptionTable::ExceptionTable(Allocator *basicAllocator)
+: d_handlers(basicAllocator)
+{
+}
+
+// MANIPULATORS
+void ExceptionTable::addHandler(int begin, int end, int target, int depth)
+{
+    BSLS_ASSERT(0 <= begin);
+    BSLS_ASSERT(begin <= end);
+    BSLS_ASSERT(0 <= target);
+    BSLS_ASSERT(0 <= depth);
+
+    const Handler handler = { begin, end, target, depth };
+    d_handlers.push_back(handler);
+}
+
+// ACCESSORS
+const ExceptionTable::Handler *ExceptionTable::findHandler(int index) const
+{
+    for (bsl::size_t i = 0; i < d_handlers.size(); ++i) {
+        const Handler& handler = d_handlers[i];
+        if (handler.d_begin <= index && index < handler.d_end) {
+            return &handler;                                          // RETURN
+        }
+    }
+    return 0;
+}
+}
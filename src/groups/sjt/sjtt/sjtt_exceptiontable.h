@@ -0,0 +1,114 @@
+// sjtt_exceptiontable.h
+
+#ifndef INCLUDED_SJTT_EXCEPTIONTABLE
+#define INCLUDED_SJTT_EXCEPTIONTABLE
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt {
+
+                           // ====================
+                           // class ExceptionTable
+                           // ====================
+
+class ExceptionTable {
+    // This class is a mechanism describing the exception handlers of a block
+    // of code: for each 'try' block, the range of code indices it covers, the
+    // index of the code of its handler, and the depth of the value stack,
+    // relative to the bottom of the frame, at which the handler begins.  The
+    // table is a side table: it is consulted only when an exception is
+    // thrown, so code that does not throw pays nothing for its handlers.
+    // Indices are positions in the whole block, including the code of the
+    // functions it contains.
+    //
+    // The handlers of nested 'try' blocks must be added innermost first:
+    // 'findHandler' returns the first handler added whose range covers an
+    // index.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    struct Handler {
+        // This 'struct' describes the handler of one 'try' block.
+
+        int d_begin;    // index of the first code covered
+        int d_end;      // index one past the last code covered
+        int d_target;   // index of the first code of the handler
+        int d_depth;    // number of values of the frame kept on entry
+    };
+
+  private:
+    // DATA
+    bsl::vector<Handler> d_handlers;   // in the order added
+
+    // NOT IMPLEMENTED
+    ExceptionTable(const ExceptionTable&) = delete;
+    ExceptionTable& operator=(const ExceptionTable&) = delete;
+
+  public:
+    // CREATORS
+    explicit ExceptionTable(Allocator *basicAllocator = 0);
+        // Create an empty table.  Optionally specify a 'basicAllocator' used
+        // to supply memory.  If 'basicAllocator' is 0, the currently
+        // installed default allocator is used.
+
+    // MANIPULATORS
+    void addHandler(int begin, int end, int target, int depth);
+        // Add a handler, beginning at the specified 'target' index with the
+        // specified 'depth' values in its frame, for exceptions thrown by the
+        // codes having indices in the range '[begin, end)', including by the
+        // functions those codes call.  The behavior is undefined unless
+        // '0 <= begin <= end', '0 <= target', and '0 <= depth'.
+
+    // ACCESSORS
+    const Handler *findHandler(int index) const;
+        // Return the address of the first handler added whose range covers
+        // the specified 'index', or 0 if there is no such handler.
+
+    const Handler& handler(int index) const;
+        // Return a reference providing non-modifiable access to the handler
+        // at the specified 'index', in the order in which the handlers were
+        // added.  The behavior is undefined unless
+        // '0 <= index < numHandlers()'.
+
+    int numHandlers() const;
+        // Return the number of handlers in this table.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                           // --------------------
+                           // class ExceptionTable
+                           // --------------------
+
+// ACCESSORS
+inline
+const ExceptionTable::Handler& ExceptionTable::handler(int index) const
+{
+    BSLS_ASSERT(0 <= index);
+    BSLS_ASSERT(index < numHandlers());
+
+    return d_handlers[index];
+}
+
+inline
+int ExceptionTable::numHandlers() const
+{
+    return static_cast<int>(d_handlers.size());
+}
+}
+
+#endif
@@ -0,0 +1,154 @@
+// sjtt_exceptiontable.t.cpp                                      -*-C++-*-
+
+#include <sjtt_exceptiontable.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtt;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "nested handlers" << endl
+                          << "===============" << endl;
+
+        // The innermost handler, added first, covering an index is found.
+
+        bslma::TestAllocator ta;
+        ExceptionTable table(&ta);
+        table.addHandler(4, 6, 20, 1);                  // inner
+        table.addHandler(2, 10, 30, 0);                 // outer
+        table.addHandler(12, 14, 40, 2);                // disjoint
+
+        const struct {
+            int d_line;
+            int d_index;
+            int d_expectedTarget;                       // -1 if none
+        } DATA[] = {
+            { L_,  0, -1 },
+            { L_,  2, 30 },
+            { L_,  3, 30 },
+            { L_,  4, 20 },
+            { L_,  5, 20 },
+            { L_,  6, 30 },
+            { L_,  9, 30 },
+            { L_, 10, -1 },
+            { L_, 12, 40 },
+            { L_, 14, -1 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            const ExceptionTable::Handler *handler =
+                                           table.findHandler(DATA[i].d_index);
+            if (0 > DATA[i].d_expectedTarget) {
+                LOOP_ASSERT(LINE, 0 == handler);
+            }
+            else {
+                LOOP_ASSERT(LINE, 0 != handler);
+                LOOP_ASSERT(LINE,
+                            DATA[i].d_expectedTarget == handler->d_target);
+            }
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        {
+            ExceptionTable table(&ta);
+            ASSERT(0 == table.numHandlers());
+            ASSERT(0 == table.findHandler(0));
+
+            table.addHandler(1, 3, 5, 2);
+            ASSERT(1 == table.numHandlers());
+            ASSERT(1 == table.handler(0).d_begin);
+            ASSERT(3 == table.handler(0).d_end);
+            ASSERT(5 == table.handler(0).d_target);
+            ASSERT(2 == table.handler(0).d_depth);
+            ASSERT(0 == table.findHandler(0));
+            ASSERT(&table.handler(0) == table.findHandler(1));
+            ASSERT(&table.handler(0) == table.findHandler(2));
+            ASSERT(0 == table.findHandler(3));
+
+            // An empty range covers nothing.
+
+            table.addHandler(7, 7, 9, 0);
+            ASSERT(0 == table.findHandler(7));
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -19,7 +19,9 @@ namespace sjtt {
                            // ======================
 class ExecutionContext {
     // This class is an in-core, value-semantic type representing the context
-    // of an external function execution.
+    // of an external function execution.  An external function called by the
+    // interpreter may throw a script exception by returning the result of
+    // 'throwException'.
 
   public:
     // TYPES
@@ -31,25 +33,42 @@ class ExecutionContext {
     Allocator    *d_allocator_p;
     const Datum  *d_args_p;
     int           d_numArgs;
+    bool         *d_thrown_p;    // set when an exception is thrown, or 0
 
   public:
     // CREATORS
-    ExecutionContext(Allocator *allocator, const Datum *args, int numArgs);
+    ExecutionContext(Allocator   *allocator,
+                     const Datum *args,
+                     int          numArgs,
+                     bool        *thrown = 0);
         // Create a new 'ExecutionContext' having the specified 'allocator',
-        // 'args', and 'numArgs'.  Note that 'args' may be 0 if '0 == numArgs'.
+        // 'args', and 'numArgs'.  Optionally specify the address of a
+        // 'thrown' flag that 'throwException' sets to 'true'; if 'thrown' is
+        // 0, the external function may not throw.  Note that 'args' may be 0
+        // if '0 == numArgs'.
 
     ExecutionContext(const ExecutionContext&) = default;
     ExecutionContext& operator=(const ExecutionContext&) = default;
 
     // ACCESSORS
     Allocator *allocator() const;
-        // Return the allocator associated with this object.
+        // Return the allocator associated with this object.  Note that the
+        // interpreter supplies an arena that lives only as long as the current
+        // evaluation, so an external function should allocate its result and
+        // any temporaries from it, and must not retain memory from it.
 
     const Datum *args() const;
         // Return the address of the first argument.
 
     int numArgs() const;
         // Return the number of argumetns.
+
+    const Datum& throwException(const Datum& exception) const;
+        // Record that the external function throws the specified
+        // 'exception', and return 'exception', which the function must then
+        // return.  The interpreter unwinds to the handler of the call, rather
+        // than pushing the returned value.  The behavior is undefined if
+        // this context was created without a 'thrown' flag.
 };
 
 // ============================================================================
@@ -64,10 +83,12 @@ class ExecutionContext {
 inline
 ExecutionContext::ExecutionContext(Allocator   *allocator,
                                    const Datum *args,
-                                   int          numArgs)
+                                   int          numArgs,
+                                   bool        *thrown)
 : d_allocator_p(allocator)
 , d_args_p(args)
-, d_numArgs(numArgs) {
+, d_numArgs(numArgs)
+, d_thrown_p(thrown) {
     BSLS_ASSERT(0 != allocator);
     BSLS_ASSERT(0 != args || 0 == numArgs);
 }
@@ -87,5 +108,14 @@ inline
 int ExecutionContext::numArgs() const {
     return d_numArgs;
 }
+
+inline
+const BloombergLP::bdld::Datum&
+ExecutionContext::throwException(const Datum& exception) const {
+    BSLS_ASSERT(0 != d_thrown_p);
+
+    *d_thrown_p = true;
+    return exception;
+}
 }
 #endif
@@ -2,6 +2,7 @@
 
 #include <sjtt_executioncontext.h>
 
+#include <bdld_datum.h>
 #include <bdls_testutil.h>
 #include <bdlma_localsequentialallocator.h>
 
@@ -65,6 +66,19 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "throwException" << endl
+                          << "==============" << endl;
+
+        bdlma::LocalSequentialAllocator<256> alloc;
+        const bdld::Datum ARGS[] = { bdld::Datum::createInteger(3) };
+        bool thrown = false;
+        sjtt::ExecutionContext context(&alloc, ARGS, 1, &thrown);
+        ASSERT(!thrown);
+        ASSERT(&ARGS[0] == &context.throwException(ARGS[0]));
+        ASSERT(thrown);
+      } break;
       case 1: {
         if (verbose) cout << endl
                           << "breathing" << endl
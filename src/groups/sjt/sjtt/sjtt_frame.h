@@ -42,7 +42,10 @@ class Bytecode;
 
 class Frame {
     // This class is an in-core, value-semantic type describing a frame of
-    // evaluation.
+    // evaluation.  The frame of a function called as a value, e.g., by
+    // 'Bytecode::e_CallValue', has a callee: the code value or closure that
+    // was called, held on the value stack just below the bottom of the
+    // frame.
 
   public:
     // TYPES
@@ -53,6 +56,7 @@ class Frame {
     const sjtt::Bytecode *d_firstCode_p;       // held, not owned
     const sjtt::Bytecode *d_pc_p;              // held, not owned
     int                   d_bottom;
+    bool                  d_hasCallee;         // callee below 'd_bottom'
 
   public:
     // TRAITS
@@ -62,11 +66,14 @@ class Frame {
     // CREATORS
     Frame(int                   bottom,
           const sjtt::Bytecode *firstCode,
-          const sjtt::Bytecode *pc);
+          const sjtt::Bytecode *pc,
+          bool                  hasCallee = false);
         // Create a new 'Frame' object whose stack begins at the specified
         // 'bottom' index.  The bytecode from this frame starts at the
         // specified 'firstCode', beginning with the specified 'pc' program
-        // counter.  The behavior is undefined unless '0 <= bottom'.
+        // counter.  Optionally specify 'hasCallee' if the value at index
+        // 'bottom - 1' is the callee of this frame.  The behavior is
+        // undefined unless '0 <= bottom', and '0 < bottom' if 'hasCallee'.
 
     Frame(const Frame& rhs) = default;
         // Create a new 'Frame' object copied from the specified 'rhs' using
@@ -97,6 +104,10 @@ class Frame {
     const sjtt::Bytecode *firstCode() const;
         // Return the address of the first byte code in this frame.
 
+    bool hasCallee() const;
+        // Return 'true' if the value just below the bottom of the stack for
+        // this frame is its callee, and 'false' otherwise.
+
     const sjtt::Bytecode *pc() const;
         // Return the program counter for this frame.
 };
@@ -128,12 +139,15 @@ bool operator!=(const Frame& lhs, const Frame& rhs);
 inline
 Frame::Frame(int                   bottom,
              const sjtt::Bytecode *firstCode,
-             const sjtt::Bytecode *pc)
+             const sjtt::Bytecode *pc,
+             bool                  hasCallee)
 : d_firstCode_p(firstCode)
 , d_pc_p(pc)
 , d_bottom(bottom)
+, d_hasCallee(hasCallee)
 {
     BSLS_ASSERT(0 <= bottom);
+    BSLS_ASSERT(0 < bottom || !hasCallee);
     BSLS_ASSERT(0 != firstCode);
     BSLS_ASSERT(0 != pc);
 }
@@ -172,6 +186,12 @@ const sjtt::Bytecode *Frame::firstCode() const
     return d_firstCode_p;
 }
 
+inline
+bool Frame::hasCallee() const
+{
+    return d_hasCallee;
+}
+
 inline
 const sjtt::Bytecode *Frame::pc() const
 {
@@ -185,7 +205,8 @@ bool sjtt::operator==(const Frame& lhs, const Frame& rhs)
 {
     return lhs.firstCode() == rhs.firstCode() &&
         lhs.pc() == rhs.pc() &&
-        lhs.bottom() == rhs.bottom();
+        lhs.bottom() == rhs.bottom() &&
+        lhs.hasCallee() == rhs.hasCallee();
 }
 
 inline
@@ -138,6 +138,14 @@ int main(int argc, char *argv[])
             Frame b(0, &code, &code1);
             ASSERT(a != b);
         }
+
+        // diff callee
+        {
+            Frame a(1, &code, &code1, true);
+            Frame b(1, &code, &code1);
+            ASSERT(a != b);
+            ASSERT(a == Frame(1, &code, &code1, true));
+        }
       } break;
       case 1: {
         if (verbose) cout << endl
@@ -148,6 +156,10 @@ int main(int argc, char *argv[])
         ASSERT(1 == frame.bottom());
         ASSERT(&code == frame.firstCode());
         ASSERT(&code + 1 == frame.pc());
+        ASSERT(!frame.hasCallee());
+
+        Frame called(1, &code, &code, true);
+        ASSERT(called.hasCallee());
       } break;
       default: {
         cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
@@ -0,0 +1,867 @@
+// sjtu_baselineutil.cpp
+#include <sjtu_baselineutil.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstring.h>
+#include <bslma_default.h>
+#include <bslmf_assert.h>
+#include <bsls_assert.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtd_tracer.h>
+#include <sjtm_codespace.h>
+#include <sjto_functionutil.h>
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+
+#if defined(__x86_64__) && defined(__linux__)
+#define SJTU_BASELINEUTIL_GENERATES 1
+
+extern "C" void __register_frame(void *begin);
+extern "C" void __deregister_frame(void *begin);
+    // Register with the unwinder of the GCC runtime, or deregister, the
+    // '.eh_frame' data at the specified 'begin', ending with a terminator.
+#endif
+
+namespace sjtu {
+
+                        // -------------------------
+                        // struct BaselineUtil::State
+                        // -------------------------
+
+struct BaselineUtil::State {
+    // This 'struct' holds the value stack, as a contiguous array grown on
+    // demand, and the frame stack of an evaluation.  The addresses into the
+    // value stack are moved when it grows.
+
+    struct Return {
+        // This 'struct' describes the frame of a caller.
+
+        int                d_bottom;  // offset of its frame from 'd_base'
+        const Instruction *d_next;    // instruction following the call
+    };
+
+    Datum               *d_base;         // first value
+    Datum               *d_top;          // one past the last value
+    Datum               *d_end;          // one past the last value allocated
+    Datum               *d_frame;        // bottom of the current frame
+    bsl::vector<Return>  d_returns;      // callers, outermost first
+    Datum                d_result;       // value of the last 'e_Exit'
+    Allocator           *d_allocator_p;  // held, not owned
+};
+
+namespace {
+
+typedef BaselineUtil::Datum       Datum;
+typedef BaselineUtil::Handler     Handler;
+typedef BaselineUtil::Instruction Instruction;
+typedef BaselineUtil::State       State;
+
+const int k_GENERIC = -1;  // handler reading the slot from its operand
+
+void grow(State *state, int numValues)
+    // Make room in the value stack of the specified 'state' for at least the
+    // specified 'numValues' more values.
+{
+    const int size     = static_cast<int>(state->d_top - state->d_base);
+    const int capacity = static_cast<int>(state->d_end - state->d_base);
+    if (capacity - size >= numValues) {
+        return;                                                       // RETURN
+    }
+    const int newCapacity = bsl::max(2 * capacity, size + numValues);
+    Datum    *base        = static_cast<Datum *>(
+                 state->d_allocator_p->allocate(newCapacity * sizeof(Datum)));
+    bsl::copy(state->d_base, state->d_top, base);
+    state->d_allocator_p->deallocate(state->d_base);
+
+    state->d_frame = base + (state->d_frame - state->d_base);
+    state->d_top   = base + size;
+    state->d_end   = base + newCapacity;
+    state->d_base  = base;
+}
+
+struct ValueStackProctor {
+    // This 'struct' returns the value stack of a 'State' to its allocator
+    // when destroyed, so that the stack is not leaked if a handler throws.
+
+    State *d_state_p;  // held, not owned
+
+    ~ValueStackProctor()
+    {
+        d_state_p->d_allocator_p->deallocate(d_state_p->d_base);
+    }
+};
+
+inline
+void pad(State *state, int numValues)
+    // Append to the values of the current frame of the specified 'state'
+    // undefined values, until it has at least the specified 'numValues'.
+{
+    Datum *const top = state->d_frame + numValues;
+    if (top > state->d_top) {
+        grow(state, static_cast<int>(top - state->d_top));
+        bsl::fill(state->d_top,
+                  state->d_frame + numValues,
+                  sjtd::DatumUdtUtil::s_Undefined);
+        state->d_top = state->d_frame + numValues;
+    }
+}
+
+inline
+int slotOf(const Instruction *instruction, int slot)
+    // Return the specified 'slot' if it is not 'k_GENERIC', and the slot in
+    // the operand of the specified 'instruction' otherwise.
+{
+    return k_GENERIC == slot ? instruction->d_immediate.theInteger() : slot;
+}
+
+// The handlers.  Each evaluates one code as 'InterpretUtil' does, and
+// returns the instruction to evaluate next.
+
+const Instruction *trap(State *, const Instruction *)
+    // Evaluate a code that no path reaches.
+{
+    BSLS_ASSERT_OPT(!"unreachable code evaluated");
+    return 0;
+}
+
+const Instruction *push(State *state, const Instruction *instruction)
+{
+    if (state->d_top == state->d_end) {
+        grow(state, 1);
+    }
+    *state->d_top++ = instruction->d_immediate;
+    return instruction + 1;
+}
+
+template <int SLOT>
+const Instruction *load(State *state, const Instruction *instruction)
+{
+    if (state->d_top == state->d_end) {
+        grow(state, 1);
+    }
+    *state->d_top++ = state->d_frame[slotOf(instruction, SLOT)];
+    return instruction + 1;
+}
+
+template <int SLOT>
+const Instruction *store(State *state, const Instruction *instruction)
+{
+    state->d_frame[slotOf(instruction, SLOT)] = *--state->d_top;
+    return instruction + 1;
+}
+
+template <int SLOT>
+const Instruction *incInt(State *state, const Instruction *instruction)
+{
+    Datum& value = state->d_frame[slotOf(instruction, SLOT)];
+    value = Datum::createInteger(value.theInteger() + 1);
+    return instruction + 1;
+}
+
+const Instruction *jump(State *, const Instruction *instruction)
+{
+    return instruction->d_target;
+}
+
+const Instruction *branch(State *state, const Instruction *instruction)
+{
+    const bool cond = (--state->d_top)->theBoolean();
+    return cond ? instruction->d_target : instruction + 1;
+}
+
+const Instruction *branchEqInts(State *state, const Instruction *instruction)
+{
+    state->d_top -= 2;
+    const bool cond = state->d_top[0].theInteger() ==
+                      state->d_top[1].theInteger();
+    return cond ? instruction->d_target : instruction + 1;
+}
+
+const Instruction *eqInts(State *state, const Instruction *instruction)
+{
+    const int l    = (--state->d_top)->theInteger();
+    Datum&    back = state->d_top[-1];
+    back = Datum::createBoolean(l == back.theInteger());
+    return instruction + 1;
+}
+
+const Instruction *addDoubles(State *state, const Instruction *instruction)
+{
+    const double l    = (--state->d_top)->theDouble();
+    Datum&       back = state->d_top[-1];
+    back = Datum::createDouble(l + back.theDouble());
+    return instruction + 1;
+}
+
+const Instruction *addInts(State *state, const Instruction *instruction)
+{
+    const int l    = (--state->d_top)->theInteger();
+    Datum&    back = state->d_top[-1];
+    back = Datum::createInteger(l + back.theInteger());
+    return instruction + 1;
+}
+
+const Instruction *call(State *state, const Instruction *instruction)
+{
+    const int           argCount = (--state->d_top)->theInteger();
+    const State::Return caller   = {
+                          static_cast<int>(state->d_frame - state->d_base),
+                          instruction + 1 };
+    state->d_returns.push_back(caller);
+    state->d_frame = state->d_top - argCount;
+    pad(state, sjtt::Bytecode::s_MinInitialStackSize);
+    return instruction->d_target;
+}
+
+const Instruction *exitFrame(State *state, const Instruction *instruction)
+{
+    const Datum value = state->d_top[-1];
+    if (state->d_returns.empty()) {
+        state->d_result = value;
+        return 0;                                                     // RETURN
+    }
+    const State::Return caller = state->d_returns.back();
+    state->d_returns.pop_back();
+    state->d_top    = state->d_frame;
+    state->d_frame  = state->d_base + caller.d_bottom;
+    *state->d_top++ = value;
+    return caller.d_next;
+}
+
+const Instruction *resize(State *state, const Instruction *instruction)
+{
+    const int numValues = instruction->d_immediate.theInteger();
+    pad(state, numValues);
+    state->d_top = state->d_frame + numValues;
+    return instruction + 1;
+}
+
+const Instruction *tailCall(State *state, const Instruction *instruction)
+{
+    const int argCount = (--state->d_top)->theInteger();
+    bsl::copy(state->d_top - argCount, state->d_top, state->d_frame);
+    state->d_top = state->d_frame + argCount;
+    pad(state, sjtt::Bytecode::s_MinInitialStackSize);
+    return instruction->d_target;
+}
+
+template <int SLOT>
+struct LoadHandler {
+    // This 'struct' names the 'e_Load' handler for 'SLOT'.
+
+    static Handler handler() { return &load<SLOT>; }
+};
+
+template <int SLOT>
+struct StoreHandler {
+    // This 'struct' names the 'e_Store' handler for 'SLOT'.
+
+    static Handler handler() { return &store<SLOT>; }
+};
+
+template <int SLOT>
+struct IncIntHandler {
+    // This 'struct' names the 'e_IncInt' handler for 'SLOT'.
+
+    static Handler handler() { return &incInt<SLOT>; }
+};
+
+template <template <int> class HANDLER>
+Handler slotHandler(const Datum& slot)
+    // Return the handler named by 'HANDLER' for the specified 'slot' if it
+    // is one of the specialized slots, and the generic one otherwise.
+{
+    BSLMF_ASSERT(8 == BaselineUtil::s_NumSpecializedSlots);
+
+    switch (slot.isInteger() ? slot.theInteger() : k_GENERIC) {
+      case 0: return HANDLER<0>::handler();                           // RETURN
+      case 1: return HANDLER<1>::handler();                           // RETURN
+      case 2: return HANDLER<2>::handler();                           // RETURN
+      case 3: return HANDLER<3>::handler();                           // RETURN
+      case 4: return HANDLER<4>::handler();                           // RETURN
+      case 5: return HANDLER<5>::handler();                           // RETURN
+      case 6: return HANDLER<6>::handler();                           // RETURN
+      case 7: return HANDLER<7>::handler();                           // RETURN
+    }
+    return HANDLER<k_GENERIC>::handler();
+}
+
+Handler findHandler(bool *hasTarget, const sjtt::Bytecode& code)
+    // Return the handler of the specified 'code', and load into the
+    // specified 'hasTarget' whether its data is the index of the code it
+    // transfers control to; return 0 if 'code' is not compiled.
+{
+    typedef sjtt::Bytecode Bytecode;
+
+    *hasTarget = false;
+    switch (code.opcode()) {
+      case Bytecode::e_Push: {
+        return &push;                                                 // RETURN
+      }
+      case Bytecode::e_Load: {
+        return slotHandler<LoadHandler>(code.data());                 // RETURN
+      }
+      case Bytecode::e_Store: {
+        return slotHandler<StoreHandler>(code.data());                // RETURN
+      }
+      case Bytecode::e_IncInt: {
+        return slotHandler<IncIntHandler>(code.data());               // RETURN
+      }
+      case Bytecode::e_EqInts: {
+        return &eqInts;                                               // RETURN
+      }
+      case Bytecode::e_AddDoubles: {
+        return &addDoubles;                                           // RETURN
+      }
+      case Bytecode::e_AddInts: {
+        return &addInts;                                              // RETURN
+      }
+      case Bytecode::e_Exit: {
+        return &exitFrame;                                            // RETURN
+      }
+      case Bytecode::e_Resize: {
+        return &resize;                                               // RETURN
+      }
+      default: {
+      } break;
+    }
+
+    *hasTarget = true;
+    switch (code.opcode()) {
+      case Bytecode::e_Jump: {
+        return &jump;                                                 // RETURN
+      }
+      case Bytecode::e_If: {
+        return &branch;                                               // RETURN
+      }
+      case Bytecode::e_IfEqInts: {
+        return &branchEqInts;                                         // RETURN
+      }
+      case Bytecode::e_Call: {
+        return &call;                                                 // RETURN
+      }
+      case Bytecode::e_TailCall: {
+        return &tailCall;                                             // RETURN
+      }
+      default: {
+      } break;
+    }
+    return 0;
+}
+
+#if defined(SJTU_BASELINEUTIL_GENERATES)
+// The stencils of the machine code, in the System V ABI.  The machine code of
+// a function is 'k_PROLOGUE', the stencils of its instructions reached, in
+// the order of the instructions, and 'k_EPILOGUE'; the state of the
+// evaluation is kept in 'rbx', which the handlers preserve.  The stencil of
+// an instruction is 'k_CALL', followed by 'k_JUMP' for an 'e_Call' or
+// 'e_TailCall', by 'k_BRANCH' for an 'e_If' or 'e_IfEqInts', and by
+// 'k_RETURN' for an 'e_Exit'; that of an 'e_Jump' is 'k_JUMP' alone.  A hole
+// is either an absolute address, of 8 bytes, or the displacement of a jump,
+// of 4 bytes, from the end of the hole.
+
+const unsigned char k_PROLOGUE[] = {
+    // Link a frame, so that a profiler can walk the stack through it by
+    // frame pointers, save 'rbx', keeping the stack aligned to 16 bytes for
+    // the calls, load the state from 'rdi' into 'rbx', and jump to the
+    // entry.
+
+    0x55,                    // push %rbp
+    0x48, 0x89, 0xE5,        // mov  %rsp, %rbp
+    0x53,                    // push %rbx
+    0x48, 0x83, 0xEC, 0x08,  // sub  $8, %rsp
+    0x48, 0x89, 0xFB,        // mov  %rdi, %rbx
+    0xE9, 0, 0, 0, 0         // jmp  <entry>
+};
+
+const int k_PROLOGUE_ENTRY = 13;
+
+const unsigned char k_EPILOGUE[] = {
+    // Unlink the frame linked by 'k_PROLOGUE', and return.
+
+    0x48, 0x83, 0xC4, 0x08,  // add  $8, %rsp
+    0x5B,                    // pop  %rbx
+    0x5D,                    // pop  %rbp
+    0xC3                     // ret
+};
+
+const unsigned char k_CALL[] = {
+    // Call the handler of an instruction, which returns the instruction to
+    // evaluate next in 'rax'.
+
+    0x48, 0x89, 0xDF,        // mov  %rbx, %rdi
+    0x48, 0xBE, 0, 0, 0, 0, 0, 0, 0, 0,
+                             // mov  $<instruction>, %rsi
+    0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0,
+                             // mov  $<handler>, %rax
+    0xFF, 0xD0               // call *%rax
+};
+
+const int k_CALL_INSTRUCTION = 5;
+const int k_CALL_HANDLER     = 15;
+
+const unsigned char k_JUMP[] = {
+    // Jump to the stencil of the instruction transferred to.
+
+    0xE9, 0, 0, 0, 0         // jmp  <target>
+};
+
+const int k_JUMP_TARGET = 1;
+
+const unsigned char k_BRANCH[] = {
+    // Jump to the stencil of the instruction transferred to if the handler
+    // returned it, and fall through otherwise.
+
+    0x48, 0xB9, 0, 0, 0, 0, 0, 0, 0, 0,
+                             // mov  $<target instruction>, %rcx
+    0x48, 0x39, 0xC8,        // cmp  %rcx, %rax
+    0x0F, 0x84, 0, 0, 0, 0   // je   <target>
+};
+
+const int k_BRANCH_INSTRUCTION = 2;
+const int k_BRANCH_TARGET      = 15;
+
+const unsigned char k_RETURN[] = {
+    // Jump to the epilogue if the handler returned 0, ending the evaluation,
+    // and to the machine code of the instruction it returned otherwise.
+
+    0x48, 0x85, 0xC0,        // test %rax, %rax
+    0x0F, 0x84, 0, 0, 0, 0,  // je   <epilogue>
+    0xFF, 0xA0, 0, 0, 0, 0   // jmp  *<offset of 'd_native'>(%rax)
+};
+
+const int k_RETURN_EPILOGUE = 5;
+const int k_RETURN_NATIVE   = 11;
+
+const unsigned char k_FRAME[] = {
+    // The description of the frame of the machine code of a function to the
+    // unwinder, in the '.eh_frame' format of the System V ABI: a CIE, an FDE
+    // whose code address, code size and offset of the epilogue are patched
+    // at 'k_FRAME_CODE_OFFSET', 'k_FRAME_SIZE_OFFSET' and
+    // 'k_FRAME_EPILOGUE_OFFSET', and a terminator.
+
+    // CIE
+    20, 0, 0, 0,             // length
+    0, 0, 0, 0,              // CIE id
+    1,                       // version
+    'z', 'R', 0,             // augmentation
+    1,                       // code alignment factor
+    0x78,                    // data alignment factor, -8
+    16,                      // return address register, rip
+    1,                       // augmentation data length
+    0x00,                    // FDE pointer encoding, DW_EH_PE_absptr
+    0x0C, 7, 8,              // DW_CFA_def_cfa:            rsp + 8
+    0x90, 1,                 // DW_CFA_offset:             rip at cfa - 8
+    0, 0,                    // DW_CFA_nop
+
+    // FDE
+    48, 0, 0, 0,             // length
+    28, 0, 0, 0,             // distance back to the CIE
+    0, 0, 0, 0, 0, 0, 0, 0,  // code address
+    0, 0, 0, 0, 0, 0, 0, 0,  // code size
+    0,                       // augmentation data length
+    0x41,                    // DW_CFA_advance_loc:        1, after push
+    0x0E, 16,                // DW_CFA_def_cfa_offset:     16
+    0x86, 2,                 // DW_CFA_offset:             rbp at cfa - 16
+    0x43,                    // DW_CFA_advance_loc:        3, after mov
+    0x0D, 6,                 // DW_CFA_def_cfa_register:   rbp
+    0x41,                    // DW_CFA_advance_loc:        1, after push
+    0x83, 3,                 // DW_CFA_offset:             rbx at cfa - 24
+    0x04, 0, 0, 0, 0,        // DW_CFA_advance_loc4:       to the last pop
+    0x0C, 7, 8,              // DW_CFA_def_cfa:            rsp + 8
+    0xC3,                    // DW_CFA_restore:            rbx
+    0xC6,                    // DW_CFA_restore:            rbp
+    0, 0, 0, 0, 0, 0,        // DW_CFA_nop
+
+    0, 0, 0, 0               // terminator
+};
+
+const int k_FRAME_CODE_OFFSET = 32;
+    // The offset in 'k_FRAME' of the address of the code it describes.
+
+const int k_FRAME_SIZE_OFFSET = 40;
+    // The offset in 'k_FRAME' of the size of the code it describes.
+
+const int k_FRAME_EPILOGUE_OFFSET = 61;
+    // The offset in 'k_FRAME' of the distance from the end of the prologue
+    // to the instruction following the last pop of the epilogue.
+
+const int k_PROLOGUE_LINKED = 5;
+    // The offset in 'k_PROLOGUE' following the last instruction changing
+    // the frame.
+
+const int k_EPILOGUE_UNLINKED = 6;
+    // The offset in 'k_EPILOGUE' following the last instruction changing the
+    // frame.
+
+inline
+void patchAddress(unsigned char *hole, const void *address)
+    // Load into the specified 'hole' the specified 'address'.
+{
+    bsl::memcpy(hole, &address, sizeof address);
+}
+
+inline
+void patchJump(unsigned char *code, bsl::size_t hole, bsl::size_t target)
+    // Load into the specified 'hole' offset of the specified 'code' the
+    // displacement of a jump to the specified 'target' offset.
+{
+    const int displacement = static_cast<int>(target) -
+                             static_cast<int>(hole + 4);
+    bsl::memcpy(code + hole, &displacement, sizeof displacement);
+}
+
+bsl::size_t stencilSize(sjtt::Bytecode::Opcode opcode)
+    // Return the number of bytes of the stencil of an instruction compiled
+    // from a code having the specified 'opcode'.
+{
+    typedef sjtt::Bytecode Bytecode;
+
+    switch (opcode) {
+      case Bytecode::e_Jump: {
+        return sizeof k_JUMP;                                         // RETURN
+      }
+      case Bytecode::e_Call:
+      case Bytecode::e_TailCall: {
+        return sizeof k_CALL + sizeof k_JUMP;                         // RETURN
+      }
+      case Bytecode::e_If:
+      case Bytecode::e_IfEqInts: {
+        return sizeof k_CALL + sizeof k_BRANCH;                       // RETURN
+      }
+      case Bytecode::e_Exit: {
+        return sizeof k_CALL + sizeof k_RETURN;                       // RETURN
+      }
+      default: {
+      } break;
+    }
+    return sizeof k_CALL;
+}
+
+bsl::size_t layOut(bsl::vector<bsl::size_t>       *offsets,
+                   const bsl::vector<Instruction>&  instructions,
+                   const sjtt::Bytecode            *codes)
+    // Load into the specified 'offsets' the offset, in the machine code of
+    // their function, of the stencil of each of the specified
+    // 'instructions', compiled from the specified 'codes', that is reached,
+    // and return the offset of the epilogue.
+{
+    bsl::size_t offset = sizeof k_PROLOGUE;
+    offsets->resize(instructions.size());
+    for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+        (*offsets)[i] = offset;
+        if (&trap != instructions[i].d_handler) {
+            offset += stencilSize(codes[i].opcode());
+        }
+    }
+    return offset;
+}
+
+void generate(bsl::vector<unsigned char>      *result,
+              bsl::vector<Instruction>        *instructions,
+              const bsl::vector<bsl::size_t>&  offsets,
+              const sjtt::Bytecode            *codes,
+              int                              entry,
+              const unsigned char             *address)
+    // Load into the specified 'result' the machine code of the specified
+    // 'instructions', compiled from the specified 'codes' and entered at the
+    // specified 'entry' index, with their stencils at the specified
+    // 'offsets', to be placed at the specified 'address', and set the
+    // address of the machine code of each instruction reached.
+{
+    typedef sjtt::Bytecode Bytecode;
+
+    const Instruction& first        = instructions->front();
+    const int          nativeOffset = static_cast<int>(
+                              reinterpret_cast<const char *>(&first.d_native)
+                            - reinterpret_cast<const char *>(&first));
+
+    result->resize(sizeof k_PROLOGUE);
+    bsl::memcpy(result->data(), k_PROLOGUE, sizeof k_PROLOGUE);
+    patchJump(result->data(), k_PROLOGUE_ENTRY, offsets[entry]);
+
+    // The epilogue follows the last stencil, and the jumps to it are patched
+    // once it is placed.
+
+    bsl::vector<bsl::size_t> exits;
+    for (bsl::size_t i = 0; i < instructions->size(); ++i) {
+        Instruction& instruction = (*instructions)[i];
+        if (&trap == instruction.d_handler) {
+            continue;                                               // CONTINUE
+        }
+        BSLS_ASSERT(offsets[i] == result->size());
+
+        instruction.d_native = address + offsets[i];
+
+        const Bytecode::Opcode opcode = codes[i].opcode();
+        bsl::size_t            offset = result->size();
+        if (Bytecode::e_Jump != opcode) {
+            result->insert(result->end(), k_CALL, k_CALL + sizeof k_CALL);
+            patchAddress(result->data() + offset + k_CALL_INSTRUCTION,
+                         &instruction);
+            patchAddress(result->data() + offset + k_CALL_HANDLER,
+                         reinterpret_cast<const void *>(
+                                                      instruction.d_handler));
+            offset += sizeof k_CALL;
+        }
+        const bsl::size_t target = instruction.d_target
+                                 ? offsets[instruction.d_target - &first]
+                                 : 0;
+        switch (opcode) {
+          case Bytecode::e_Jump:
+          case Bytecode::e_Call:
+          case Bytecode::e_TailCall: {
+            result->insert(result->end(), k_JUMP, k_JUMP + sizeof k_JUMP);
+            patchJump(result->data(), offset + k_JUMP_TARGET, target);
+          } break;
+          case Bytecode::e_If:
+          case Bytecode::e_IfEqInts: {
+            result->insert(result->end(),
+                           k_BRANCH,
+                           k_BRANCH + sizeof k_BRANCH);
+            patchAddress(result->data() + offset + k_BRANCH_INSTRUCTION,
+                         instruction.d_target);
+            patchJump(result->data(), offset + k_BRANCH_TARGET, target);
+          } break;
+          case Bytecode::e_Exit: {
+            result->insert(result->end(),
+                           k_RETURN,
+                           k_RETURN + sizeof k_RETURN);
+            bsl::memcpy(result->data() + offset + k_RETURN_NATIVE,
+                        &nativeOffset,
+                        sizeof nativeOffset);
+            exits.push_back(offset + k_RETURN_EPILOGUE);
+          } break;
+          default: {
+          } break;
+        }
+    }
+
+    const bsl::size_t epilogue = result->size();
+    for (bsl::size_t i = 0; i < exits.size(); ++i) {
+        patchJump(result->data(), exits[i], epilogue);
+    }
+    result->insert(result->end(), k_EPILOGUE, k_EPILOGUE + sizeof k_EPILOGUE);
+}
+
+unsigned char *describeFrame(const void              *code,
+                             bsl::size_t              size,
+                             bsl::size_t              epilogue,
+                             BaselineUtil::Allocator *allocator)
+    // Return the description, allocated from the specified 'allocator' and
+    // registered with the unwinder, of the frame of the machine code of the
+    // specified 'size' at the specified 'code', whose epilogue is at the
+    // specified 'epilogue' offset.
+{
+    const unsigned int delta = static_cast<unsigned int>(
+                      epilogue + k_EPILOGUE_UNLINKED - k_PROLOGUE_LINKED);
+
+    unsigned char *frame = static_cast<unsigned char *>(
+                                          allocator->allocate(sizeof k_FRAME));
+    bsl::memcpy(frame, k_FRAME, sizeof k_FRAME);
+    bsl::memcpy(frame + k_FRAME_CODE_OFFSET, &code, sizeof code);
+    bsl::memcpy(frame + k_FRAME_SIZE_OFFSET, &size, sizeof size);
+    bsl::memcpy(frame + k_FRAME_EPILOGUE_OFFSET, &delta, sizeof delta);
+    __register_frame(frame);
+    return frame;
+}
+#endif
+
+}  // close unnamed namespace
+
+                        // ------------------------
+                        // class BaselineUtil::Code
+                        // ------------------------
+
+// PRIVATE MANIPULATORS
+void BaselineUtil::Code::releaseNative()
+{
+    if (0 == d_native_p) {
+        return;                                                       // RETURN
+    }
+#if defined(SJTU_BASELINEUTIL_GENERATES)
+    __deregister_frame(d_frame_p);
+#endif
+    d_allocator_p->deallocate(d_frame_p);
+    d_space_p->deallocate(d_native_p);
+    d_native_p   = 0;
+    d_nativeSize = 0;
+    d_frame_p    = 0;
+    d_space_p    = 0;
+}
+
+// CREATORS
+BaselineUtil::Code::Code(Allocator *basicAllocator)
+: d_instructions(basicAllocator)
+, d_entry(0)
+, d_native_p(0)
+, d_nativeSize(0)
+, d_frame_p(0)
+, d_space_p(0)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+}
+
+BaselineUtil::Code::~Code()
+{
+    releaseNative();
+}
+
+                           // -------------------
+                           // struct BaselineUtil
+                           // -------------------
+
+// CLASS METHODS
+int BaselineUtil::compile(Code                 *result,
+                          const sjtt::Bytecode *codes,
+                          int                   entry,
+                          sjtm::CodeSpace      *space)
+{
+    BSLS_ASSERT(0 != result);
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= entry);
+
+    SJTD_TRACER_SCOPE("compile", "baseline");
+
+    const int numCodes = sjto::FunctionUtil::findNumCodes(codes);
+    BSLS_ASSERT(entry < numCodes);
+
+    result->releaseNative();
+    bsl::vector<Instruction>& instructions = result->d_instructions;
+    instructions.clear();
+    result->d_entry = entry;
+
+    // The instructions are laid out first, so that the operands of jumps
+    // forward can be patched when the jump is compiled.  The codes are
+    // compiled as they are reached from 'entry', so an instruction still
+    // holding 'trap' is one not compiled yet.
+
+    const Instruction trapped = { &trap, Datum::createNull(), 0, 0 };
+    instructions.resize(numCodes, trapped);
+    bsl::vector<int> reached(1, entry);
+    while (!reached.empty()) {
+        const int index = reached.back();
+        reached.pop_back();
+        Instruction& instruction = instructions[index];
+        if (&trap != instruction.d_handler) {
+            continue;                                               // CONTINUE
+        }
+        const sjtt::Bytecode& code = codes[index];
+        bool                  hasTarget;
+        const Handler         handler = findHandler(&hasTarget, code);
+        if (0 == handler) {
+            instructions.clear();
+            return 1;                                                 // RETURN
+        }
+        instruction.d_handler   = handler;
+        instruction.d_immediate = code.data();
+        if (hasTarget) {
+            const int target = code.data().theInteger();
+            BSLS_ASSERT(0 <= target && target < numCodes);
+
+            instruction.d_target = &instructions[target];
+            reached.push_back(target);
+        }
+        if (sjtt::Bytecode::e_Jump != code.opcode() &&
+            sjtt::Bytecode::e_Exit != code.opcode() &&
+            sjtt::Bytecode::e_TailCall != code.opcode()) {
+            BSLS_ASSERT(index + 1 < numCodes);
+
+            reached.push_back(index + 1);
+        }
+    }
+
+#if defined(SJTU_BASELINEUTIL_GENERATES)
+    if (0 == space) {
+        return 0;                                                     // RETURN
+    }
+
+    // The stencils are laid out first, so that the displacements of jumps
+    // forward can be patched as they are copied.  A function whose machine
+    // code cannot be written keeps its call-threaded code.
+
+    bsl::vector<bsl::size_t> offsets;
+    const bsl::size_t        size = layOut(&offsets, instructions, codes)
+                                  + sizeof k_EPILOGUE;
+    void *const block = space->allocate(size);
+    if (0 == block) {
+        return 0;                                                     // RETURN
+    }
+    bsl::vector<unsigned char> native;
+    generate(&native,
+             &instructions,
+             offsets,
+             codes,
+             entry,
+             static_cast<unsigned char *>(block));
+    BSLS_ASSERT(size == native.size());
+
+    if (0 != space->write(block, 0, native.data(), size)) {
+        space->deallocate(block);
+        for (bsl::size_t i = 0; i < instructions.size(); ++i) {
+            instructions[i].d_native = 0;
+        }
+        return 0;                                                     // RETURN
+    }
+    result->d_native_p   = block;
+    result->d_nativeSize = size;
+    result->d_space_p    = space;
+    result->d_frame_p    = describeFrame(block,
+                                         size,
+                                         size - sizeof k_EPILOGUE,
+                                         result->d_allocator_p);
+#else
+    (void)space;
+#endif
+    return 0;
+}
+
+BaselineUtil::Datum BaselineUtil::execute(Allocator   *allocator,
+                                          const Code&  code,
+                                          const Datum *arguments,
+                                          int          numArguments,
+                                          Allocator   *scratchAllocator)
+{
+    BSLS_ASSERT(0 != allocator);
+    BSLS_ASSERT(!code.isEmpty());
+    BSLS_ASSERT(0 <= numArguments);
+    BSLS_ASSERT(0 != scratchAllocator);
+
+    State state = { 0, 0, 0, 0,
+                    bsl::vector<State::Return>(scratchAllocator),
+                    Datum::createNull(),
+                    scratchAllocator };
+    const ValueStackProctor proctor = { &state };
+    grow(&state, bsl::max(64, numArguments));
+    state.d_frame = state.d_base;
+    state.d_top   = bsl::copy(arguments,
+                              arguments + numArguments,
+                              state.d_base);
+    pad(&state, sjtt::Bytecode::s_MinInitialStackSize);
+
+    if (0 != code.d_native_p) {
+        typedef void (*Function)(State *state);
+
+        reinterpret_cast<Function>(code.d_native_p)(&state);
+    }
+    else {
+        const Instruction *instruction = code.d_instructions.data()
+                                       + code.d_entry;
+        while (instruction) {
+            instruction = instruction->d_handler(&state, instruction);
+        }
+    }
+    return state.d_result.clone(allocator);
+}
+
+bool BaselineUtil::isNativeSupported()
+{
+#if defined(SJTU_BASELINEUTIL_GENERATES)
+    return true;
+#else
+    return false;
+#endif
+}
+}
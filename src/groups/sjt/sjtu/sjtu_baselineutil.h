@@ -0,0 +1,234 @@
+// sjtu_baselineutil.h
+
+#ifndef INCLUDED_SJTU_BASELINEUTIL
+#define INCLUDED_SJTU_BASELINEUTIL
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_CSTDDEF
+#include <bsl_cstddef.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm { class CodeSpace; }
+namespace sjtt { class Bytecode; }
+
+namespace sjtu {
+
+                           // ===================
+                           // struct BaselineUtil
+                           // ===================
+
+struct BaselineUtil {
+    // This 'struct' provides a namespace for functions that compile the
+    // functions of Scramjet bytecode into call-threaded code and, where
+    // supported, into machine code by copy and patch, the baseline tier of
+    // 'InterpretUtil', and evaluate the compiled code.
+    //
+    // Each code becomes one instruction: the address of the handler of its
+    // opcode, a C++ function compiled with this component, and its operands,
+    // which are the data of the code and the address of the instruction
+    // that a jump, branch or call transfers control to.  The handlers of
+    // 'e_Load', 'e_Store' and 'e_IncInt' are instantiated, from a function
+    // template, for each of the first 's_NumSpecializedSlots' slots, whose
+    // index is then part of the handler rather than an operand.  Compiling
+    // is a single pass over the codes, and evaluation calls the handler of
+    // each instruction in turn, each returning the address of the next, so
+    // that no code is decoded, no opcode dispatched through a 'switch', and
+    // no index checked.
+    //
+    // If an 'sjtm::CodeSpace' is supplied on x86-64 Linux, the instructions
+    // are also compiled into machine code: for each instruction reached, in
+    // order, a stencil, a fixed sequence of hand-assembled bytes, is copied
+    // into a block of the code space, and its holes patched with the
+    // addresses of the instruction and of its handler and the displacements
+    // of its jumps.  The stencil of an instruction calls its handler
+    // through a patched address, then falls through to the next stencil or
+    // jumps to the stencil of the instruction transferred to, so that every
+    // call and jump of the machine code but that returning from a function
+    // has a single target, which the branch predictor learns.  The handlers
+    // remain C++ functions: only the dispatch is machine code.  The frame of
+    // the machine code is described to the unwinder, so that an exception
+    // thrown by a handler, such as 'bsl::bad_alloc', propagates through it.
+    // On other platforms, or if the code space cannot supply executable
+    // memory, the call-threaded code is evaluated.
+    //
+    // A function is compiled if each code reached from its first code,
+    // following jumps, branches, falling through and calls, is an 'e_Push',
+    // 'e_Load', 'e_Store', 'e_Jump', 'e_If', 'e_IfEqInts', 'e_EqInts',
+    // 'e_IncInt', 'e_AddDoubles', 'e_AddInts', 'e_Call', 'e_Exit',
+    // 'e_Resize' or 'e_TailCall': it creates no objects, calls no code
+    // values or external functions, and throws no exceptions, so that its
+    // evaluation needs neither a heap nor exception handlers.  Its result is
+    // that 'InterpretUtil::interpretBytecode' would return.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+    struct State;
+        // The state of an evaluation, defined in the implementation.
+
+    struct Instruction;
+
+    typedef const Instruction *(*Handler)(State             *state,
+                                          const Instruction *instruction);
+        // The type of a handler: a function evaluating the specified
+        // 'instruction' in the specified 'state', and returning the address
+        // of the instruction to evaluate next, or 0 when evaluation ends.
+
+    struct Instruction {
+        // This 'struct' describes one compiled code.
+
+        Handler            d_handler;    // of the opcode
+        Datum              d_immediate;  // data of the code
+        const Instruction *d_target;     // instruction transferred to, or 0
+        const void        *d_native;     // its machine code, or 0
+    };
+
+    class Code {
+        // This class holds the instructions of a compiled function, and
+        // their machine code if any.  The instructions refer to one another
+        // by address, so a 'Code' can be neither copied nor assigned.
+
+        // DATA
+        bsl::vector<Instruction>  d_instructions;  // one per code
+        int                       d_entry;         // index of the first
+                                                   // instruction evaluated
+        void                     *d_native_p;      // block of machine code,
+                                                   // or 0
+        bsl::size_t               d_nativeSize;    // bytes of machine code
+        unsigned char            *d_frame_p;       // description of its
+                                                   // frame, owned, or 0
+        sjtm::CodeSpace          *d_space_p;       // of the machine code,
+                                                   // held, not owned
+        Allocator                *d_allocator_p;   // held, not owned
+
+        // FRIENDS
+        friend struct BaselineUtil;
+
+        // NOT IMPLEMENTED
+        Code(const Code&) = delete;
+        Code& operator=(const Code&) = delete;
+
+        // PRIVATE MANIPULATORS
+        void releaseNative();
+            // Return the machine code of this object, if any, to its code
+            // space.
+
+      public:
+        // CREATORS
+        explicit Code(Allocator *basicAllocator = 0);
+            // Create an empty 'Code'.  Optionally specify a 'basicAllocator'
+            // used to supply memory.  If 'basicAllocator' is 0, the currently
+            // installed default allocator is used.
+
+        ~Code();
+            // Return the machine code of this object, if any, to the code
+            // space it was compiled into, and destroy this object.
+
+        // ACCESSORS
+        bool isEmpty() const;
+            // Return 'true' if this object holds no instructions, and
+            // 'false' otherwise.
+
+        const void *nativeCode() const;
+            // Return the address of the machine code of this object, or 0 if
+            // it has none.
+
+        bsl::size_t nativeSize() const;
+            // Return the number of bytes of the machine code of this object,
+            // or 0 if it has none.
+
+        int numInstructions() const;
+            // Return the number of instructions held by this object.
+    };
+
+    // CONSTANTS
+    static const int s_NumSpecializedSlots = 8;
+        // The number of slots for which the handlers of 'e_Load', 'e_Store'
+        // and 'e_IncInt' hold the index of the slot.
+
+    // CLASS METHODS
+    static int compile(Code                 *result,
+                       const sjtt::Bytecode *codes,
+                       int                   entry = 0,
+                       sjtm::CodeSpace      *space = 0);
+        // Load into the specified 'result' the compiled form of the function
+        // whose first code is at the optionally specified 'entry' index of
+        // the program beginning at the specified byte 'codes', evaluated by
+        // frames beginning at 'codes', and return 0; return a non-zero
+        // value, with 'result' empty, if the function is not compiled as
+        // described above.  If 'entry' is not specified, the function at
+        // index 0 is compiled.  Optionally specify a code 'space' into which
+        // the function is also compiled into machine code if supported.  The
+        // behavior is undefined unless 'space' outlives 'result', 'entry' is
+        // 0 or the target of an 'e_Call' or 'e_TailCall' reached from index
+        // 0, and every path from index 0 of 'codes' ends in an 'e_Exit',
+        // 'e_TailCall', 'e_Throw' or 'e_Jump', and reaches only valid
+        // indices.
+
+    static Datum execute(Allocator   *allocator,
+                         const Code&  code,
+                         const Datum *arguments,
+                         int          numArguments,
+                         Allocator   *scratchAllocator);
+        // Evaluate the function of the specified compiled 'code' as called
+        // with the specified 'numArguments' 'arguments', as
+        // 'InterpretUtil::interpretBytecode' does, running its machine code
+        // if it has any, and return the result, allocated from the specified
+        // 'allocator'.  The value stack and the frame stack are allocated
+        // from the specified 'scratchAllocator'.
+        // The behavior is undefined unless 'code' is not empty,
+        // '0 <= numArguments', and the function that 'code' was compiled
+        // from can be evaluated.
+
+    static bool isNativeSupported();
+        // Return 'true' if functions are compiled into machine code for the
+        // platform, and 'false' otherwise.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                        // ------------------------
+                        // class BaselineUtil::Code
+                        // ------------------------
+
+// ACCESSORS
+inline
+bool BaselineUtil::Code::isEmpty() const
+{
+    return d_instructions.empty();
+}
+
+inline
+const void *BaselineUtil::Code::nativeCode() const
+{
+    return d_native_p;
+}
+
+inline
+bsl::size_t BaselineUtil::Code::nativeSize() const
+{
+    return d_nativeSize;
+}
+
+inline
+int BaselineUtil::Code::numInstructions() const
+{
+    return static_cast<int>(d_instructions.size());
+}
+}
+
+#endif
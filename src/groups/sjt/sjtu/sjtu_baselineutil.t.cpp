@@ -0,0 +1,482 @@
+// sjtu_baselineutil.t.cpp                                        -*-C++-*-
+
+#include <sjtu_baselineutil.h>
+
+#include <bdlma_sequentialallocator.h>
+#include <bdls_testutil.h>
+
+#include <bslma_defaultallocatorguard.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+#include <sjtd_datumfactory.h>
+#include <sjtd_datumudtutil.h>
+#include <sjtm_codespace.h>
+#include <sjtt_bytecode.h>
+#include <sjtu_bytecodedslutil.h>
+#include <sjtu_interpretutil.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef BaselineUtil::Code Code;
+
+struct Failure {
+    // This 'struct' is the C++ exception thrown by a 'FailingAllocator'.
+};
+
+class FailingAllocator : public bslma::Allocator {
+    // This class is an allocator supplying memory from another allocator
+    // until a given number of allocations, and throwing a 'Failure' after.
+
+    // DATA
+    int               d_numAllocations;  // before failing
+    bslma::Allocator *d_allocator_p;     // held, not owned
+
+  public:
+    // CREATORS
+    FailingAllocator(int numAllocations, bslma::Allocator *allocator)
+        // Create an allocator supplying memory from the specified
+        // 'allocator' for the specified 'numAllocations' allocations.
+    : d_numAllocations(numAllocations)
+    , d_allocator_p(allocator)
+    {
+    }
+
+    // MANIPULATORS
+    void *allocate(size_type size)
+    {
+        if (0 == d_numAllocations) {
+            throw Failure();
+        }
+        --d_numAllocations;
+        return d_allocator_p->allocate(size);
+    }
+
+    void deallocate(void *address)
+    {
+        d_allocator_p->deallocate(address);
+    }
+};
+
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 5: {
+        // A function compiled into a code space has machine code where
+        // supported, returned to the code space when the function is
+        // compiled again or destroyed, and an exception thrown by a handler
+        // propagates through it, leaking nothing.
+
+        bslma::TestAllocator ta("test", false);
+        {
+            bdlma::SequentialAllocator alloc(&ta);
+            const sjtd::DatumFactory f(&alloc);
+            BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+            // The sum of 1 to the argument, recursively.
+
+            bsl::vector<sjtt::Bytecode> codes(&alloc);
+            bsl::string errorMessage;
+            ASSERT(0 == BytecodeDSLUtil::readDSL(
+                                 &codes,
+                                 &errorMessage,
+                                 "L0|Pi1|C4|X|L0|Pi0|I=i15|L0|Pi-1|+i|Pi1|C4|"
+                                 "L0|+i|X|Pi0|X",
+                                 functions));
+
+            sjtm::CodeSpace space(sjtm::CodeSpace::s_SlabSize, &ta);
+            {
+                Code code(&ta);
+                ASSERT(0 == BaselineUtil::compile(&code,
+                                                  &codes[0],
+                                                  0,
+                                                  &space));
+                ASSERT(!code.isEmpty());
+                ASSERT(BaselineUtil::isNativeSupported() ==
+                                                     (0 != code.nativeCode()));
+                ASSERT(BaselineUtil::isNativeSupported() ==
+                                                      (0 < code.nativeSize()));
+                ASSERT(code.nativeSize() <= space.numBytesUsed());
+
+                // Compiling again replaces the machine code.
+
+                const bsl::size_t numBytesUsed = space.numBytesUsed();
+                ASSERT(0 == BaselineUtil::compile(&code,
+                                                  &codes[0],
+                                                  0,
+                                                  &space));
+                ASSERTV(numBytesUsed, space.numBytesUsed(),
+                        numBytesUsed == space.numBytesUsed());
+
+                // The value stack is allocated before the machine code runs,
+                // and the frame stack, and the value stack again as it
+                // grows, by the handlers it calls.
+
+                const bdld::Datum argument = f(20);
+                int               limit    = 0;
+                for (bool isThrown = true; isThrown; ++limit) {
+                    bdlma::SequentialAllocator scratch(&ta);
+                    FailingAllocator           failing(limit, &scratch);
+                    isThrown = false;
+                    try {
+                        const bdld::Datum result = BaselineUtil::execute(
+                                                                     &alloc,
+                                                                     code,
+                                                                     &argument,
+                                                                     1,
+                                                                     &failing);
+                        LOOP2_ASSERT(limit, result, f(210) == result);
+                    }
+                    catch (const Failure&) {
+                        isThrown = true;
+                    }
+                }
+                ASSERTV(limit, 3 < limit);
+
+                // Compiling without a code space discards the machine code.
+
+                ASSERT(0 == BaselineUtil::compile(&code, &codes[0]));
+                ASSERT(0 == code.nativeCode());
+                ASSERT(0 == code.nativeSize());
+                ASSERT(0 == space.numBytesUsed());
+
+                ASSERT(0 == BaselineUtil::compile(&code,
+                                                  &codes[0],
+                                                  0,
+                                                  &space));
+            }
+            ASSERT(0 == space.numBytesUsed());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 4: {
+        // A function is compiled at its first code, whether or not the
+        // functions not reached from it are compiled, and returns what it
+        // returns when called with the same arguments.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_dsl;
+            int         d_entry;
+            int         d_argument;
+            bool        d_isCompiled;
+            int         d_expected;
+        } DATA[] = {
+            // LINE  PROGRAM                            ENT  ARG  COMP  EXP
+            // ----  ---------------------------------  ---  ---  ----  ---
+            { L_,    "N1|Pi3|Pi1|C5|X|L0|Pi2|+i|X",       5,   3, true,    5 },
+            { L_,    "N1|Pi3|Pi1|C5|X|L0|Pi2|+i|X",       0,   3, false,   0 },
+            { L_,    "N1|Pi3|Pi1|C5|X|L0|Pi1|C10|X|X|"
+                     "L0|Pi2|+i|X",                       5,   4, true,    6 },
+            { L_,    "Pi3|Pi1|C4|X|L0|Pi1|C9|X|X|N1|X",   4,   3, false,   0 },
+
+            // The sum of 1 to the argument, recursively.
+
+            { L_,    "L0|Pi1|C4|X|L0|Pi0|I=i15|L0|Pi-1|"
+                     "+i|Pi1|C4|L0|+i|X|Pi0|X",           4,  20, true,  210 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int  LINE        = DATA[i].d_line;
+            const bool IS_COMPILED = DATA[i].d_isCompiled;
+
+            bsl::vector<sjtt::Bytecode> codes(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&codes,
+                                                     &errorMessage,
+                                                     DATA[i].d_dsl,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            Code      code(&alloc);
+            const int rc = BaselineUtil::compile(&code,
+                                                 &codes[0],
+                                                 DATA[i].d_entry);
+            LOOP_ASSERT(LINE, IS_COMPILED == (0 == rc));
+            LOOP_ASSERT(LINE, IS_COMPILED == !code.isEmpty());
+            if (!IS_COMPILED) {
+                continue;                                           // CONTINUE
+            }
+
+            const bdld::Datum argument = f(DATA[i].d_argument);
+
+            bdlma::SequentialAllocator scratch;
+            const bdld::Datum result = BaselineUtil::execute(&alloc,
+                                                             code,
+                                                             &argument,
+                                                             1,
+                                                             &scratch);
+            LOOP2_ASSERT(LINE, result, f(DATA[i].d_expected) == result);
+        }
+      } break;
+      case 3: {
+        // A compiled program returns what 'InterpretUtil' returns for the
+        // same program and arguments, in slots specialized or not, through
+        // loops, calls and tail calls, with or without machine code.
+
+        bdlma::SequentialAllocator alloc;
+        sjtm::CodeSpace            space;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_dsl;
+            int         d_numArguments;
+            int         d_arguments[2];
+        } DATA[] = {
+            // LINE  PROGRAM                                 NUM  ARGUMENTS
+            // ----  --------------------------------------  ---  ---------
+            { L_,    "Pi3|X",                                 0,  { 0, 0 } },
+            { L_,    "Pd3|Pd1|+d|X",                          0,  { 0, 0 } },
+            { L_,    "Pi4|Pi4|=i|X",                          0,  { 0, 0 } },
+            { L_,    "Pi2|Pi4|=i|X",                          0,  { 0, 0 } },
+            { L_,    "Pi3|S0|++i0|L0|X",                      0,  { 0, 0 } },
+            { L_,    "Pi1|S3|Pi2|L3|X",                       0,  { 0, 0 } },
+            { L_,    "Pi1|S7|++i7|L7|X",                      0,  { 0, 0 } },
+            { L_,    "V16|Pi5|S12|++i12|L12|X",               0,  { 0, 0 } },
+            { L_,    "Pi3|V80|Pi4|L79|X",                     0,  { 0, 0 } },
+            { L_,    "J3|Pi1|X|Pi3|X",                        0,  { 0, 0 } },
+            { L_,    "PT|I3|X|Pi8|X",                         0,  { 0, 0 } },
+            { L_,    "PF|I4|Pi2|X|Pi8|X",                     0,  { 0, 0 } },
+            { L_,    "Pi2|Pi2|I=i4|X|Pi8|X",                  0,  { 0, 0 } },
+            { L_,    "Pi1|Pi2|I=i5|Pi2|X|Pi8|X",              0,  { 0, 0 } },
+            { L_,    "L0|L1|+i|X",                            2,  { 2, 3 } },
+            { L_,    "L1|X",                                  1,  { 2, 0 } },
+            { L_,    "Pd8|Pi2|Pi4|Pi2|C8|+d|X|Pi3|Pd6|X",     0,  { 0, 0 } },
+            { L_,    "Pd8|Pi0|C6|+d|X|Pi3|J8|X|Pd6|X",        0,  { 0, 0 } },
+            { L_,    "Pi3|Pi1|C4|X|L0|Pi2|+i|X",              0,  { 0, 0 } },
+            { L_,    "Pi3|Pi1|C4|X|L0|X",                     0,  { 0, 0 } },
+
+            // The sum of 0 to 99, in a loop.
+
+            { L_,    "Pi0|S0|Pi0|S1|L0|Pi100|I=i13|L1|L0|+i|S1|++i0|J4|"
+                     "L1|X",                                  0,  { 0, 0 } },
+
+            // The sum of 1 to the argument, in a loop of tail calls.
+
+            { L_,    "L0|Pi0|Pi2|C5|X|L0|Pi0|I=i16|L0|Pi-1|+i|L1|L0|+i|"
+                     "Pi2|T5|L1|X",                           1,  { 50, 0 } },
+
+            // The same, recursively.
+
+            { L_,    "L0|Pi1|C4|X|L0|Pi0|I=i15|L0|Pi-1|+i|Pi1|C4|L0|+i|X|"
+                     "Pi0|X",                                 1,  { 20, 0 } },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> codes(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&codes,
+                                                     &errorMessage,
+                                                     DATA[i].d_dsl,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            bsl::vector<bdld::Datum> arguments(&alloc);
+            for (int j = 0; j < DATA[i].d_numArguments; ++j) {
+                arguments.push_back(f(DATA[i].d_arguments[j]));
+            }
+
+            bdlma::SequentialAllocator scratch;
+            const bdld::Datum EXPECTED = InterpretUtil::interpretBytecode(
+                                                     &alloc,
+                                                     &codes[0],
+                                                     arguments.data(),
+                                                     DATA[i].d_numArguments,
+                                                     &scratch);
+
+            for (int native = 0; native < 2; ++native) {
+                Code      code(&alloc);
+                const int rc = BaselineUtil::compile(&code,
+                                                     &codes[0],
+                                                     0,
+                                                     native ? &space : 0);
+                LOOP2_ASSERT(LINE, native, 0 == rc);
+                LOOP2_ASSERT(LINE, native,
+                             static_cast<int>(codes.size()) ==
+                                                      code.numInstructions());
+                LOOP2_ASSERT(LINE, native,
+                             (native && BaselineUtil::isNativeSupported()) ==
+                                                     (0 != code.nativeCode()));
+
+                const bdld::Datum result = BaselineUtil::execute(
+                                                     &alloc,
+                                                     code,
+                                                     arguments.data(),
+                                                     DATA[i].d_numArguments,
+                                                     &scratch);
+                LOOP4_ASSERT(LINE, native, EXPECTED, result,
+                             EXPECTED == result);
+            }
+        }
+      } break;
+      case 2: {
+        // A program reaching a code that is not compiled -- one creating
+        // objects, calling code values or external functions, or throwing --
+        // is not compiled, leaving the result empty; such a code that is not
+        // reached does not prevent compiling.
+
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_dsl;
+            bool        d_isCompiled;
+        } DATA[] = {
+            // LINE  PROGRAM                          COMPILED
+            // ----  -------------------------------  --------
+            { L_,    "N1|G0|X",                        false },
+            { L_,    "N0|Pi5|.=x|.x|X",                false },
+            { L_,    "Pi1|!",                          false },
+            { L_,    "Pi0|L0|E|X",                     false },
+            { L_,    "F3|Pi0|@|Pi1|X",                 false },
+            { L_,    "PT|I4|Pi1|X|N1|G0|X",            false },
+            { L_,    "J2|N1|Pi3|X",                    true  },
+            { L_,    "Pi3|X|Pi1|!",                    true  },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int  LINE        = DATA[i].d_line;
+            const bool IS_COMPILED = DATA[i].d_isCompiled;
+
+            bsl::vector<sjtt::Bytecode> codes(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&codes,
+                                                     &errorMessage,
+                                                     DATA[i].d_dsl,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            // A failed compilation discards what the result held.
+
+            const sjtt::Bytecode exit[] = {
+                sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Exit)
+            };
+            Code code(&alloc);
+            ASSERT(0 == BaselineUtil::compile(&code, exit));
+            ASSERT(!code.isEmpty());
+
+            const int rc = BaselineUtil::compile(&code, &codes[0]);
+            LOOP_ASSERT(LINE, IS_COMPILED == (0 == rc));
+            LOOP_ASSERT(LINE, IS_COMPILED == !code.isEmpty());
+        }
+      } break;
+      case 1: {
+        // BREATHING TEST
+
+        bslma::TestAllocator         ta("test", false);
+        bslma::TestAllocator         da("default", false);
+        bslma::DefaultAllocatorGuard guard(&da);
+        {
+            bdlma::SequentialAllocator alloc(&ta);
+            BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+            bsl::vector<sjtt::Bytecode> codes(&alloc);
+            bsl::string errorMessage;
+            ASSERT(0 == BytecodeDSLUtil::readDSL(&codes,
+                                                 &errorMessage,
+                                                 "Pi3|Pi1|C4|X|L0|Pi2|+i|X",
+                                                 functions));
+
+            Code code(&ta);
+            ASSERT(code.isEmpty());
+            ASSERT(0 == BaselineUtil::compile(&code, &codes[0]));
+            ASSERT(8 == code.numInstructions());
+
+            bdlma::SequentialAllocator scratch(&ta);
+            const bdld::Datum result = BaselineUtil::execute(&alloc,
+                                                             code,
+                                                             0,
+                                                             0,
+                                                             &scratch);
+            ASSERTV(result, result.isInteger());
+            ASSERTV(result, 5 == result.theInteger());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+        ASSERT(0 == da.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,400 @@
+// sjtu_batchinterpretutil.cpp
+#include <sjtu_batchinterpretutil.h>
+
+#include <bdlma_sequentialallocator.h>
+
+#include <bsls_assert.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstring.h>
+
+#include <sjtd_datumudtutil.h>
+#include <sjtm_heap.h>
+#include <sjtm_vectorutil.h>
+#include <sjtt_bytecode.h>
+#include <sjtu_inlinecachetable.h>
+#include <sjtu_interpretutil.h>
+
+using namespace BloombergLP;
+
+namespace sjtu {
+namespace {
+
+typedef BatchInterpretUtil::Column Column;
+using sjtt::Bytecode;
+
+struct Operand {
+    // This 'struct' describes, while a straight-line program is compiled,
+    // the column of values in one position of its value stack.
+
+    enum Kind {
+        e_Undefined,   // no value
+        e_Argument,    // a column of arguments
+        e_Temporary,   // a temporary column of a block of rows
+        e_Constant     // the same value in every row
+    };
+
+    Kind   d_kind;
+    bool   d_isDouble;   // 'true' for doubles and 'false' for integers
+    int    d_index;      // index of the argument or temporary column
+    int    d_int;        // value of an integer constant
+    double d_double;     // value of a double constant
+};
+
+struct Step {
+    // This 'struct' describes an addition performed on a block of rows.
+
+    Operand d_lhs;
+    Operand d_rhs;
+    int     d_result;    // temporary column receiving 'd_lhs + d_rhs'
+};
+
+struct Fill {
+    // This 'struct' describes a temporary column holding a constant.
+
+    Operand d_constant;
+    int     d_temporary;
+};
+
+struct Plan {
+    // This 'struct' describes how a straight-line program is evaluated
+    // column at a time.
+
+    bsl::vector<Step> d_steps;           // in order of evaluation
+    bsl::vector<Fill> d_fills;           // constant columns
+    Operand           d_result;          // the value returned
+    int               d_numTemporaries;
+
+    explicit Plan(bslma::Allocator *allocator)
+    : d_steps(allocator)
+    , d_fills(allocator)
+    , d_numTemporaries(0)
+    {
+    }
+};
+
+Operand makeOperand(Operand::Kind kind, bool isDouble, int index)
+    // Return an operand of the specified 'kind', of doubles if the specified
+    // 'isDouble' is 'true' and of integers otherwise, having the specified
+    // 'index'.
+{
+    Operand result;
+    result.d_kind     = kind;
+    result.d_isDouble = isDouble;
+    result.d_index    = index;
+    result.d_int      = 0;
+    result.d_double   = 0;
+    return result;
+}
+
+Operand materialize(Plan *plan, const Operand& operand)
+    // Return the specified 'operand' if it is a column, and otherwise a new
+    // temporary column of the specified 'plan', holding the value of the
+    // constant 'operand' in every row.
+{
+    if (Operand::e_Constant != operand.d_kind) {
+        return operand;                                               // RETURN
+    }
+    Fill fill;
+    fill.d_constant  = operand;
+    fill.d_temporary = plan->d_numTemporaries++;
+    plan->d_fills.push_back(fill);
+    return makeOperand(Operand::e_Temporary,
+                       operand.d_isDouble,
+                       fill.d_temporary);
+}
+
+bool compile(Plan                 *plan,
+             const Bytecode       *codes,
+             const Column         *columns,
+             int                   numColumns,
+             bslma::Allocator     *allocator)
+    // Load into the specified 'plan' the column-at-a-time evaluation of the
+    // specified byte 'codes' with arguments of the types of the specified
+    // 'numColumns' 'columns', and return 'true' if 'codes' is straight-line
+    // typed arithmetic, and 'false' otherwise.  Use the specified 'allocator'
+    // to supply memory.  Note that the value stack is simulated exactly as
+    // the interpreter would evaluate it, with a column in place of each
+    // value.
+{
+    bsl::vector<Operand> stack(allocator);
+    for (int i = 0; i < numColumns; ++i) {
+        stack.push_back(makeOperand(
+                                Operand::e_Argument,
+                                BatchInterpretUtil::e_Float64 ==
+                                                           columns[i].d_type,
+                                i));
+    }
+    if (numColumns < Bytecode::s_MinInitialStackSize) {
+        stack.resize(Bytecode::s_MinInitialStackSize,
+                     makeOperand(Operand::e_Undefined, false, 0));
+    }
+
+    for (const Bytecode *code = codes;; ++code) {
+        const bdld::Datum& data = code->data();
+        switch (code->opcode()) {
+          case Bytecode::e_Push: {
+            Operand value = makeOperand(Operand::e_Constant,
+                                        data.isDouble(),
+                                        0);
+            if (data.isInteger()) {
+                value.d_int = data.theInteger();
+            }
+            else if (data.isDouble()) {
+                value.d_double = data.theDouble();
+            }
+            else {
+                return false;                                         // RETURN
+            }
+            stack.push_back(value);
+          } break;
+
+          case Bytecode::e_Load: {
+            if (!data.isInteger() ||
+                0 > data.theInteger() ||
+                static_cast<int>(stack.size()) <= data.theInteger() ||
+                Operand::e_Undefined == stack[data.theInteger()].d_kind) {
+                return false;                                         // RETURN
+            }
+            const Operand value = stack[data.theInteger()];
+            stack.push_back(value);
+          } break;
+
+          case Bytecode::e_Store: {
+            if (!data.isInteger() ||
+                0 > data.theInteger() ||
+                static_cast<int>(stack.size()) <= data.theInteger()) {
+                return false;                                         // RETURN
+            }
+            stack[data.theInteger()] = stack.back();
+            stack.pop_back();
+          } break;
+
+          case Bytecode::e_Resize: {
+            if (!data.isInteger() || 0 > data.theInteger()) {
+                return false;                                         // RETURN
+            }
+            stack.resize(data.theInteger(),
+                         makeOperand(Operand::e_Undefined, false, 0));
+          } break;
+
+          case Bytecode::e_AddInts:
+          case Bytecode::e_AddDoubles: {
+            const bool isDouble = Bytecode::e_AddDoubles == code->opcode();
+            if (2 > stack.size()) {
+                return false;                                         // RETURN
+            }
+            const Operand rhs = stack.back();
+            stack.pop_back();
+            const Operand lhs = stack.back();
+            stack.pop_back();
+            if (Operand::e_Undefined == lhs.d_kind ||
+                Operand::e_Undefined == rhs.d_kind ||
+                isDouble != lhs.d_isDouble ||
+                isDouble != rhs.d_isDouble) {
+                return false;                                         // RETURN
+            }
+            Step step;
+            step.d_lhs    = materialize(plan, lhs);
+            step.d_rhs    = materialize(plan, rhs);
+            step.d_result = plan->d_numTemporaries++;
+            plan->d_steps.push_back(step);
+            stack.push_back(makeOperand(Operand::e_Temporary,
+                                        isDouble,
+                                        step.d_result));
+          } break;
+
+          case Bytecode::e_Exit: {
+            if (stack.empty() ||
+                Operand::e_Undefined == stack.back().d_kind) {
+                return false;                                         // RETURN
+            }
+            plan->d_result = stack.back();
+            return true;                                              // RETURN
+          } break;
+
+          default: {
+            return false;                                             // RETURN
+          } break;
+        }
+    }
+}
+
+template <class TYPE>
+const TYPE *columnFor(const Operand&  operand,
+                      const Column   *columns,
+                      void *const    *temporaries,
+                      int             firstRow)
+    // Return the address of the values, starting at the specified
+    // 'firstRow', of the specified column 'operand', which refers to the
+    // specified 'columns' or 'temporaries'.
+{
+    if (Operand::e_Argument == operand.d_kind) {
+        return static_cast<const TYPE *>(columns[operand.d_index].d_values) +
+                                                                     firstRow;
+                                                                      // RETURN
+    }
+    return static_cast<const TYPE *>(temporaries[operand.d_index]);
+}
+
+void run(bsl::vector<bdld::Datum> *results,
+         const Plan&               plan,
+         const Column             *columns,
+         int                       numRows,
+         bslma::Allocator         *allocator)
+    // Append to the specified 'results' the result of evaluating the
+    // specified 'plan' for each of the specified 'numRows' rows of the
+    // specified 'columns', using the specified 'allocator' to supply
+    // temporary memory.
+{
+    const int blockSize = BatchInterpretUtil::s_BlockSize;
+
+    bdlma::SequentialAllocator scratch(allocator);
+    bsl::vector<void *>        temporaries(allocator);
+    for (int i = 0; i < plan.d_numTemporaries; ++i) {
+        temporaries.push_back(scratch.allocate(blockSize * sizeof(double)));
+    }
+    for (bsl::size_t i = 0; i < plan.d_fills.size(); ++i) {
+        const Operand& constant = plan.d_fills[i].d_constant;
+        void           *values  = temporaries[plan.d_fills[i].d_temporary];
+        if (constant.d_isDouble) {
+            bsl::fill_n(static_cast<double *>(values),
+                        blockSize,
+                        constant.d_double);
+        }
+        else {
+            bsl::fill_n(static_cast<int *>(values), blockSize, constant.d_int);
+        }
+    }
+
+    const Operand& result = plan.d_result;
+    for (int firstRow = 0; firstRow < numRows; firstRow += blockSize) {
+        const int n = bsl::min(blockSize, numRows - firstRow);
+        for (bsl::size_t i = 0; i < plan.d_steps.size(); ++i) {
+            const Step& step = plan.d_steps[i];
+            void *sum = temporaries[step.d_result];
+            if (step.d_lhs.d_isDouble) {
+                bsl::memcpy(sum,
+                            columnFor<double>(step.d_lhs,
+                                              columns,
+                                              temporaries.data(),
+                                              firstRow),
+                            n * sizeof(double));
+                sjtm::VectorUtil::addFloat64(
+                                          static_cast<double *>(sum),
+                                          columnFor<double>(step.d_rhs,
+                                                            columns,
+                                                            temporaries.data(),
+                                                            firstRow),
+                                          n);
+            }
+            else {
+                bsl::memcpy(sum,
+                            columnFor<int>(step.d_lhs,
+                                           columns,
+                                           temporaries.data(),
+                                           firstRow),
+                            n * sizeof(int));
+                sjtm::VectorUtil::addInt32(static_cast<int *>(sum),
+                                           columnFor<int>(step.d_rhs,
+                                                          columns,
+                                                          temporaries.data(),
+                                                          firstRow),
+                                           n);
+            }
+        }
+
+        if (Operand::e_Constant == result.d_kind) {
+            results->insert(results->end(),
+                            n,
+                            result.d_isDouble
+                            ? bdld::Datum::createDouble(result.d_double)
+                            : bdld::Datum::createInteger(result.d_int));
+        }
+        else if (result.d_isDouble) {
+            const double *values = columnFor<double>(result,
+                                                     columns,
+                                                     temporaries.data(),
+                                                     firstRow);
+            for (int i = 0; i < n; ++i) {
+                results->push_back(bdld::Datum::createDouble(values[i]));
+            }
+        }
+        else {
+            const int *values = columnFor<int>(result,
+                                               columns,
+                                               temporaries.data(),
+                                               firstRow);
+            for (int i = 0; i < n; ++i) {
+                results->push_back(bdld::Datum::createInteger(values[i]));
+            }
+        }
+    }
+}
+}
+
+                         // -------------------------
+                         // struct BatchInterpretUtil
+                         // -------------------------
+
+// CLASS METHODS
+void BatchInterpretUtil::interpretBatch(bsl::vector<Datum>   *results,
+                                        const sjtt::Bytecode *codes,
+                                        const Column         *columns,
+                                        int                   numColumns,
+                                        int                   numRows)
+{
+    BSLS_ASSERT(0 != results);
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= numColumns);
+    BSLS_ASSERT(0 <= numRows);
+
+    bslma::Allocator *allocator = results->get_allocator().mechanism();
+    results->reserve(results->size() + numRows);
+
+    Plan plan(allocator);
+    if (compile(&plan, codes, columns, numColumns, allocator)) {
+        run(results, plan, columns, numRows, allocator);
+        return;                                                       // RETURN
+    }
+
+    // Evaluate each row in turn, rewinding the scratch memory between rows;
+    // results are copied out of it by the interpreter.  The rows share a
+    // heap, so the inline caches filled by one row serve the next.
+
+    bdlma::SequentialAllocator scratch(allocator);
+    sjtm::Heap                 heap(allocator);
+    InlineCacheTable           caches(allocator);
+    bsl::vector<Datum>         arguments(allocator);
+    arguments.resize(numColumns);
+    for (int row = 0; row < numRows; ++row) {
+        for (int i = 0; i < numColumns; ++i) {
+            arguments[i] = e_Int32 == columns[i].d_type
+                ? Datum::createInteger(
+                           static_cast<const int *>(columns[i].d_values)[row])
+                : Datum::createDouble(
+                       static_cast<const double *>(columns[i].d_values)[row]);
+        }
+        results->push_back(InterpretUtil::interpretBytecode(allocator,
+                                                            codes,
+                                                            arguments.data(),
+                                                            numColumns,
+                                                            &scratch,
+                                                            &heap,
+                                                            &caches));
+        scratch.rewind();
+    }
+}
+
+bool BatchInterpretUtil::isVectorizable(const sjtt::Bytecode *codes,
+                                        const Column         *columns,
+                                        int                   numColumns)
+{
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= numColumns);
+
+    bdlma::SequentialAllocator allocator;
+    Plan plan(&allocator);
+    return compile(&plan, codes, columns, numColumns, &allocator);
+}
+}
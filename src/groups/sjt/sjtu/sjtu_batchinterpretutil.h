@@ -0,0 +1,119 @@
+// sjtu_batchinterpretutil.h
+
+#ifndef INCLUDED_SJTU_BATCHINTERPRETUTIL
+#define INCLUDED_SJTU_BATCHINTERPRETUTIL
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+namespace sjtt { class Bytecode; }
+
+namespace sjtu {
+
+                         // =========================
+                         // struct BatchInterpretUtil
+                         // =========================
+
+struct BatchInterpretUtil {
+    // This 'struct' provides a namespace for functions that evaluate one
+    // program over many rows of arguments, such as when scoring a table of
+    // inputs.  The arguments are supplied by column: for each parameter of
+    // the program, an array holding the integer or double argument of every
+    // row.  The cost of setting up evaluation is paid once per batch rather
+    // than once per row.
+    //
+    // A program that is straight-line typed arithmetic -- a sequence of
+    // 'e_Push' of integers and doubles, 'e_Load', 'e_Store', 'e_Resize',
+    // 'e_AddInts' and 'e_AddDoubles' codes, whose operands have the types
+    // those codes expect, ending with 'e_Exit' -- is evaluated column at a
+    // time: each addition is performed on 's_BlockSize' rows at once with
+    // 'sjtm::VectorUtil'.  Any other program is evaluated by
+    // 'InterpretUtil' for each row in turn, reusing one scratch allocator
+    // and one heap for the whole batch.  Either way, the results are those
+    // 'InterpretUtil::interpretBytecode' would return for each row, except
+    // that integer additions that overflow wrap.
+
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+
+    enum ColumnType {
+        // Enumeration of the types of the values of a column.
+
+        e_Int32,
+        e_Float64
+    };
+
+    struct Column {
+        // This 'struct' describes a column of arguments: the address of an
+        // array, not owned, holding one argument per row.
+
+        ColumnType  d_type;     // type of the values
+        const void *d_values;   // 'const int *' or 'const double *'
+    };
+
+    // CONSTANTS
+    static const int s_BlockSize = 1024;
+        // The number of rows evaluated at a time by a straight-line program,
+        // chosen so that the temporary columns of a block stay in cache.
+
+    // CLASS METHODS
+    static Column float64Column(const double *values);
+        // Return a column holding the specified 'values'.
+
+    static Column int32Column(const int *values);
+        // Return a column holding the specified 'values'.
+
+    static void interpretBatch(bsl::vector<Datum>   *results,
+                               const sjtt::Bytecode *codes,
+                               const Column         *columns,
+                               int                   numColumns,
+                               int                   numRows);
+        // Append to the specified 'results' the result of evaluating the
+        // specified byte 'codes' for each of the specified 'numRows' rows of
+        // the specified 'numColumns' 'columns', where the arguments of a row
+        // are its values in 'columns', in order, as passed to
+        // 'InterpretUtil::interpretBytecode'.  Use the allocator of 'results'
+        // to supply memory.  The behavior is undefined unless
+        // '0 <= numColumns', '0 <= numRows', each column holds at least
+        // 'numRows' values, and 'codes' can be evaluated for every row
+        // without returning an object.
+
+    static bool isVectorizable(const sjtt::Bytecode *codes,
+                               const Column         *columns,
+                               int                   numColumns);
+        // Return 'true' if the specified byte 'codes' are evaluated column
+        // at a time by 'interpretBatch' given the specified 'numColumns'
+        // 'columns', and 'false' otherwise.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                         // -------------------------
+                         // struct BatchInterpretUtil
+                         // -------------------------
+
+// CLASS METHODS
+inline
+BatchInterpretUtil::Column
+BatchInterpretUtil::float64Column(const double *values)
+{
+    Column result = { e_Float64, values };
+    return result;
+}
+
+inline
+BatchInterpretUtil::Column BatchInterpretUtil::int32Column(const int *values)
+{
+    Column result = { e_Int32, values };
+    return result;
+}
+}
+
+#endif
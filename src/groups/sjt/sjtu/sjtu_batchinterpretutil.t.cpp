@@ -0,0 +1,296 @@
+// sjtu_batchinterpretutil.t.cpp                                  -*-C++-*-
+
+#include <sjtu_batchinterpretutil.h>
+
+#include <bdlma_sequentialallocator.h>
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_vector.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtu_bytecodedslutil.h>
+#include <sjtu_interpretutil.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    typedef bdld::Datum        Datum;
+    typedef BatchInterpretUtil Obj;
+
+    // Four columns, of integers 'a' and 'b' and of doubles 'c' and 'd', of
+    // 'NUM_ROWS' rows.
+
+    enum { NUM_ROWS = 3 * Obj::s_BlockSize + 17 };
+
+    bsl::vector<int>    a(NUM_ROWS);
+    bsl::vector<int>    b(NUM_ROWS);
+    bsl::vector<double> c(NUM_ROWS);
+    bsl::vector<double> d(NUM_ROWS);
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        a[i] = 7 * i - 1000;
+        b[i] = i % 13;
+        c[i] = i * 0.5;
+        d[i] = 1.0 / (i + 1);
+    }
+    const Obj::Column COLUMNS[] = {
+        Obj::int32Column(a.data()),
+        Obj::int32Column(b.data()),
+        Obj::float64Column(c.data()),
+        Obj::float64Column(d.data()),
+    };
+    const int NUM_COLUMNS = sizeof(COLUMNS) / sizeof(*COLUMNS);
+
+    BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+    switch (test) { case 0:
+      case 3: {
+        if (verbose) cout << endl
+                          << "agreement with 'InterpretUtil'" << endl
+                          << "==============================" << endl;
+
+        // The result of each row is that of evaluating the program with the
+        // row as its arguments, for numbers of rows that end within, at and
+        // just after the end of a block, whether or not the program is
+        // evaluated column at a time.
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            bool        d_vectorizable;
+        } DATA[] = {
+            { L_, "L0|L1|+i|X",                                   true  },
+            { L_, "L2|L3|+d|Pd1.5|+d|X",                          true  },
+            { L_, "L0|Pi5|+i|L1|+i|S4|L4|L4|+i|X",                true  },
+            { L_, "Pd2|L2|+d|L3|+d|L2|+d|X",                      true  },
+            { L_, "Pi3|Pi4|+i|X",                                 true  },
+            { L_, "Pi42|X",                                       true  },
+            { L_, "L2|X",                                         true  },
+            { L_, "V2|L1|X",                                      true  },
+            { L_, "Pi0|S4|Pi0|S5|L5|L0|+i|S5|++i4|L4|Pi3|I=i13|J4|"
+                  "L5|X",                                         false },
+            { L_, "L0|L1|=i|X",                                   false },
+            { L_, "N1|L0|W0|G0|X",                                false },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        const int ROWS[] = {
+            0, 1, 2, Obj::s_BlockSize - 1, Obj::s_BlockSize,
+            Obj::s_BlockSize + 1, NUM_ROWS
+        };
+        const int NUM_ROWS_DATA = sizeof(ROWS) / sizeof(*ROWS);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bdlma::SequentialAllocator alloc;
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+            LOOP_ASSERT(LINE,
+                        DATA[i].d_vectorizable ==
+                             Obj::isVectorizable(&code[0],
+                                                 COLUMNS,
+                                                 NUM_COLUMNS));
+
+            for (int j = 0; j < NUM_ROWS_DATA; ++j) {
+                const int N = ROWS[j];
+
+                bslma::TestAllocator ta;
+                {
+                    bsl::vector<Datum> results(&ta);
+                    results.push_back(Datum::createInteger(-1));
+                    Obj::interpretBatch(&results,
+                                        &code[0],
+                                        COLUMNS,
+                                        NUM_COLUMNS,
+                                        N);
+                    const int NUM_RESULTS = static_cast<int>(results.size());
+                    LOOP2_ASSERT(LINE, N, N + 1 == NUM_RESULTS);
+                    ASSERT(Datum::createInteger(-1) == results[0]);
+
+                    for (int row = 0; row < N && row + 1 < NUM_RESULTS;
+                                                                      ++row) {
+                        const Datum ARGUMENTS[] = {
+                            Datum::createInteger(a[row]),
+                            Datum::createInteger(b[row]),
+                            Datum::createDouble(c[row]),
+                            Datum::createDouble(d[row]),
+                        };
+                        bdlma::SequentialAllocator scratch;
+                        const Datum EXPECTED =
+                                   InterpretUtil::interpretBytecode(
+                                                                &alloc,
+                                                                &code[0],
+                                                                ARGUMENTS,
+                                                                NUM_COLUMNS,
+                                                                &scratch);
+                        LOOP5_ASSERT(LINE,
+                                     N,
+                                     row,
+                                     EXPECTED,
+                                     results[row + 1],
+                                     EXPECTED == results[row + 1]);
+                    }
+                }
+                LOOP2_ASSERT(LINE, N, 0 == ta.numBlocksInUse());
+            }
+        }
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "isVectorizable" << endl
+                          << "==============" << endl;
+
+        // Only straight-line typed additions, whose operands are defined and
+        // have the types the additions expect, are evaluated column at a
+        // time.
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            bool        d_expected;
+        } DATA[] = {
+            { L_, "L0|L1|+i|X",          true  },
+            { L_, "L2|L3|+d|X",          true  },
+            { L_, "L3|X",                true  },
+            { L_, "Pi1|S5|L5|X",         true  },
+            { L_, "Pd1|Pd2|+d|X",        true  },
+            { L_, "V9|Pi1|S8|L8|X",      true  },
+            { L_, "L0|L2|+i|X",          false },
+            { L_, "L0|L2|+d|X",          false },
+            { L_, "Pi1|Pd2|+i|X",        false },
+            { L_, "L5|X",                false },
+            { L_, "V2|L2|X",             false },
+            { L_, "J1|L0|X",             false },
+            { L_, "Psabc|X",             false },
+            { L_, "L0|L1|=i|X",          false },
+            { L_, "N1|X",                false },
+            { L_, "PT|I3|L0|X",          false },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bdlma::SequentialAllocator alloc;
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+            LOOP_ASSERT(LINE,
+                        DATA[i].d_expected ==
+                             Obj::isVectorizable(&code[0],
+                                                 COLUMNS,
+                                                 NUM_COLUMNS));
+        }
+
+        // Without columns, the arguments are undefined.
+
+        bdlma::SequentialAllocator alloc;
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        ASSERT(0 == BytecodeDSLUtil::readDSL(&code,
+                                             &errorMessage,
+                                             "L0|X",
+                                             functions));
+        ASSERT(!Obj::isVectorizable(&code[0], 0, 0));
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "BREATHING TEST" << endl
+                          << "==============" << endl;
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        ASSERT(0 == BytecodeDSLUtil::readDSL(&code,
+                                             &errorMessage,
+                                             "L0|L1|+i|X",
+                                             functions));
+        {
+            bsl::vector<Datum> results(&ta);
+            Obj::interpretBatch(&results, &code[0], COLUMNS, 2, 3);
+            ASSERT(3 == results.size());
+            ASSERT(Datum::createInteger(-1000) == results[0]);
+            ASSERT(Datum::createInteger(-992)  == results[1]);
+            ASSERT(Datum::createInteger(-984)  == results[2]);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -0,0 +1,184 @@
+// sjtu_bytecodedslreader.cpp
+#include <sjtu_bytecodedslreader.h>
+
+#include <algorithm>
+
+#include <bslma_default.h>
+#include <bsls_assert.h>
+
+#include <bsl_vector.h>
+
+#include <sjtd_tracer.h>
+#include <sjtt_constantpool.h>
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace BloombergLP;
+
+namespace sjtu {
+
+                          // -----------------------
+                          // class BytecodeDSLReader
+                          // -----------------------
+
+// PRIVATE MANIPULATORS
+int BytecodeDSLReader::readToken(const StringRef& token, bsl::size_t position)
+{
+    sjtt::Bytecode code;
+    d_status = BytecodeDSLUtil::readBytecode(&code,
+                                             &d_errorMessage,
+                                             d_datumAllocator_p,
+                                             token,
+                                             position,
+                                             *d_functions_p,
+                                             d_constants_p);
+    if (0 == d_status) {
+        d_sink(code);
+    }
+    return d_status;
+}
+
+// CREATORS
+BytecodeDSLReader::BytecodeDSLReader(
+                                const Sink&                     sink,
+                                const FunctionNameToAddressMap *functions,
+                                Allocator                      *datumAllocator,
+                                Allocator                      *basicAllocator)
+: d_sink(sink)
+, d_functions_p(functions)
+, d_datumAllocator_p(datumAllocator)
+, d_constants_p(0)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+, d_partial(basicAllocator)
+, d_position(0)
+, d_errorMessage(basicAllocator)
+, d_status(0)
+{
+    BSLS_ASSERT(0 != functions);
+    BSLS_ASSERT(0 != datumAllocator);
+}
+
+BytecodeDSLReader::BytecodeDSLReader(
+                                const Sink&                     sink,
+                                const FunctionNameToAddressMap *functions,
+                                sjtt::ConstantPool             *constants,
+                                Allocator                      *basicAllocator)
+: d_sink(sink)
+, d_functions_p(functions)
+, d_datumAllocator_p(0)
+, d_constants_p(constants)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+, d_partial(basicAllocator)
+, d_position(0)
+, d_errorMessage(basicAllocator)
+, d_status(0)
+{
+    BSLS_ASSERT(0 != functions);
+    BSLS_ASSERT(0 != constants);
+
+    d_datumAllocator_p = constants->allocator();
+}
+
+// MANIPULATORS
+int BytecodeDSLReader::write(const StringRef& text)
+{
+    const char *next = text.begin();
+    while (0 == d_status && text.end() != next) {
+        const char *end = std::find(next, text.end(), '|');
+        if (text.end() == end) {
+            // The last bytecode in 'text' may be continued by the next write.
+
+            d_partial.append(next, end);
+            d_position += end - next;
+            break;                                                 // BREAK
+        }
+        if (d_partial.empty()) {
+            // The whole bytecode is in 'text'; read it without copying.
+
+            readToken(StringRef(next, end), d_position);
+        }
+        else {
+            const bsl::size_t start = d_position - d_partial.size();
+            d_partial.append(next, end);
+            readToken(d_partial, start);
+            d_partial.clear();
+        }
+        d_position += end - next + 1;
+        next = end + 1;
+    }
+    return d_status;
+}
+
+int BytecodeDSLReader::finish()
+{
+    // Drop the whitespace ending the stream, as files usually end with a
+    // newline.
+
+    bsl::size_t length = d_partial.size();
+    while (0 < length && (' '  == d_partial[length - 1] ||
+                          '\t' == d_partial[length - 1] ||
+                          '\r' == d_partial[length - 1] ||
+                          '\n' == d_partial[length - 1])) {
+        --length;
+    }
+    const bsl::size_t start = d_position - d_partial.size();
+    d_partial.resize(length);
+    if (0 == d_status && !d_partial.empty()) {
+        readToken(d_partial, start);
+        d_partial.clear();
+    }
+    return d_status;
+}
+
+int BytecodeDSLReader::readFileDescriptor(int fd)
+{
+    SJTD_TRACER_SCOPE("parse", "readFileDescriptor");
+
+    bsl::vector<char> buffer(s_ReadBufferSize, 0, d_allocator_p);
+    while (0 == d_status) {
+        const ssize_t numRead = ::read(fd, buffer.data(), buffer.size());
+        if (0 > numRead) {
+            if (EINTR == errno) {
+                continue;                                          // CONTINUE
+            }
+            d_errorMessage = "failed to read input";
+            d_status = -1;
+            break;                                                 // BREAK
+        }
+        if (0 == numRead) {
+            break;                                                 // BREAK
+        }
+        write(StringRef(buffer.data(), buffer.data() + numRead));
+    }
+    return finish();
+}
+
+int BytecodeDSLReader::readMappedFile(int fd)
+{
+    SJTD_TRACER_SCOPE("parse", "readMappedFile");
+
+    struct stat info;
+    if (0 != ::fstat(fd, &info) || !S_ISREG(info.st_mode)) {
+        d_errorMessage = "input is not a regular file";
+        d_status = -1;
+        return d_status;                                              // RETURN
+    }
+    if (0 == info.st_size) {
+        return finish();                                              // RETURN
+    }
+    void *address = ::mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == address) {
+        d_errorMessage = "failed to map input";
+        d_status = -1;
+        return d_status;                                              // RETURN
+    }
+    ::madvise(address, info.st_size, MADV_SEQUENTIAL);
+    const char *begin = static_cast<const char *>(address);
+    write(StringRef(begin, begin + info.st_size));
+    ::munmap(address, info.st_size);
+    return finish();
+}
+}
@@ -0,0 +1,172 @@
+// sjtu_bytecodedslreader.h
+
+#ifndef INCLUDED_SJTU_BYTECODEDSLREADER
+#define INCLUDED_SJTU_BYTECODEDSLREADER
+
+#ifndef INCLUDED_BSL_FUNCTIONAL
+#include <bsl_functional.h>
+#endif
+
+#ifndef INCLUDED_BSL_STRING
+#include <bsl_string.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_SJTT_BYTECODE
+#include <sjtt_bytecode.h>
+#endif
+
+#ifndef INCLUDED_SJTU_BYTECODEDSLUTIL
+#include <sjtu_bytecodedslutil.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtt { class ConstantPool; }
+
+namespace sjtu {
+
+                          // =======================
+                          // class BytecodeDSLReader
+                          // =======================
+
+class BytecodeDSLReader {
+    // This class is a mechanism that incrementally parses the bytecode DSL
+    // described in 'sjtu_bytecodedslutil.h' from text supplied in arbitrarily
+    // sized pieces, passing each bytecode to a sink as soon as it has been
+    // read.  A bytecode may be split across pieces; only the text of the
+    // bytecode currently being read is buffered, so the memory used by a
+    // reader is bounded by the length of the longest bytecode rather than the
+    // length of the program.  Error messages report positions relative to
+    // the start of the stream and are identical to those produced by
+    // 'BytecodeDSLUtil::readDSL' for the same program.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+    typedef bsl::function<void(const sjtt::Bytecode&)> Sink;
+        // Describes a function that is invoked with each bytecode, in order.
+
+    typedef BytecodeDSLUtil::FunctionNameToAddressMap FunctionNameToAddressMap;
+
+    static const int s_ReadBufferSize = 64 * 1024;
+        // The number of bytes read at a time by 'readFileDescriptor'.
+
+  private:
+    // DATA
+    Sink                            d_sink;
+    const FunctionNameToAddressMap *d_functions_p;    // held, not owned
+    Allocator                      *d_datumAllocator_p;  // held, not owned
+    sjtt::ConstantPool             *d_constants_p;    // held, not owned, or 0
+    Allocator                      *d_allocator_p;    // held, not owned
+    bsl::string                     d_partial;    // text of a split bytecode
+    bsl::size_t                     d_position;   // stream offset of the
+                                                  // next unread character
+    bsl::string                     d_errorMessage;
+    int                             d_status;     // 0 unless an error occurred
+
+    // PRIVATE MANIPULATORS
+    int readToken(const StringRef& token, bsl::size_t position);
+        // Parse the specified 'token', that begins at the specified 'position'
+        // of the stream, and pass the resulting bytecode to the sink.  Return
+        // 0 on success, and a non-zero value (recording the error) otherwise.
+
+    // NOT IMPLEMENTED
+    BytecodeDSLReader(const BytecodeDSLReader&) = delete;
+    BytecodeDSLReader& operator=(const BytecodeDSLReader&) = delete;
+
+  public:
+    // CREATORS
+    BytecodeDSLReader(const Sink&                     sink,
+                      const FunctionNameToAddressMap *functions,
+                      Allocator                      *datumAllocator,
+                      Allocator                      *basicAllocator = 0);
+        // Create a reader that passes each bytecode it reads to the specified
+        // 'sink', translating function names using the specified 'functions'
+        // and allocating the data of bytecodes from the specified
+        // 'datumAllocator'.  Optionally specify a 'basicAllocator' used to
+        // supply memory for the reader itself.  If 'basicAllocator' is 0, the
+        // currently installed default allocator is used.  The behavior is
+        // undefined unless 'functions' and 'datumAllocator' remain valid for
+        // the lifetime of this object.
+
+    BytecodeDSLReader(const Sink&                     sink,
+                      const FunctionNameToAddressMap *functions,
+                      sjtt::ConstantPool             *constants,
+                      Allocator                      *basicAllocator = 0);
+        // Create a reader that passes each bytecode it reads to the specified
+        // 'sink', translating function names using the specified 'functions'
+        // and interning the value of every push into the specified
+        // 'constants', which then owns the data of the bytecode.  Optionally
+        // specify a 'basicAllocator' used to supply memory for the reader
+        // itself.  If 'basicAllocator' is 0, the currently installed default
+        // allocator is used.  The behavior is undefined unless 'functions'
+        // and 'constants' remain valid for the lifetime of this object.
+
+    // MANIPULATORS
+    int write(const StringRef& text);
+        // Read the bytecodes in the specified 'text', that continues the text
+        // previously supplied to this reader, and return 0 on success.  Return
+        // a non-zero value, without reading further, if an error has been
+        // found.  Note that the last bytecode in 'text' is not read until the
+        // delimiter following it is written or 'finish' is called.
+
+    int finish();
+        // Read the last bytecode of the stream, if any, and return 0 if the
+        // entire stream was valid and a non-zero value otherwise.  Whitespace
+        // at the end of the stream, e.g., the newline ending a file, is
+        // ignored.  The behavior is undefined if this method is called more
+        // than once.
+
+    int readFileDescriptor(int fd);
+        // Read, 's_ReadBufferSize' bytes at a time, all the text from the
+        // specified 'fd' until end of file, then call 'finish', and return 0
+        // on success and a non-zero value otherwise.  Note that 'fd' may
+        // refer to a pipe or terminal, e.g., standard input.
+
+    int readMappedFile(int fd);
+        // Map the regular file referred to by the specified 'fd' into memory,
+        // read it as if by 'write', call 'finish', unmap the file and return 0
+        // on success and a non-zero value otherwise.  Note that the pages of
+        // the file are faulted in, and may be dropped, by the operating
+        // system on demand, so the file need not fit in memory.
+
+    // ACCESSORS
+    const bsl::string& errorMessage() const;
+        // Return a description of the first error found, or an empty string
+        // if no error has been found.
+
+    bsl::size_t position() const;
+        // Return the number of characters of the stream consumed so far.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                          // -----------------------
+                          // class BytecodeDSLReader
+                          // -----------------------
+
+// ACCESSORS
+inline
+const bsl::string& BytecodeDSLReader::errorMessage() const
+{
+    return d_errorMessage;
+}
+
+inline
+bsl::size_t BytecodeDSLReader::position() const
+{
+    return d_position;
+}
+}
+
+#endif
@@ -0,0 +1,341 @@
+// sjtu_bytecodedslreader.t.cpp                                   -*-C++-*-
+
+#include <sjtu_bytecodedslreader.h>
+
+#include <bdlma_sequentialallocator.h>
+#include <bdls_testutil.h>
+
+#include <bsl_vector.h>
+
+#include <sjtt_bytecode.h>
+#include <sjtu_bytecodedslutil.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+namespace {
+bdld::Datum testFun(const sjtt::ExecutionContext& context) {
+    return bdld::Datum::createNull();
+}
+
+struct Collector {
+    // Sink that appends every bytecode to a vector.
+
+    bsl::vector<sjtt::Bytecode> *d_codes_p;
+
+    void operator()(const sjtt::Bytecode& code) const {
+        d_codes_p->push_back(code);
+    }
+};
+
+const char *const s_Programs[] = {
+    "",
+    "|",
+    "X",
+    "X|",
+    "X||",
+    "Pd2|Pd4|+d|X",
+    "Pi1|S3|Pi2|L3|X",
+    "Pi2|Pi2|I=i4|X|Pi8|X",
+    "Pi0|Pefoo|E|X",
+    "Pi1|Pefoo|Pi2|++i3|=i|+i",
+    "Pi1|Pebar|X",
+    "Pi1|Q|X",
+    "Pi1|Pi2|I=x|X",
+};
+}
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    BytecodeDSLUtil::FunctionNameToAddressMap functions;
+    functions["foo"] = testFun;
+
+    const int NUM_PROGRAMS = sizeof(s_Programs) / sizeof(s_Programs[0]);
+
+    switch (test) { case 0:
+      case 5: {
+        if (verbose) cout << endl
+                          << "trailing whitespace" << endl
+                          << "===================" << endl;
+
+        // Whitespace ending a file, e.g., a newline, is ignored wherever the
+        // pieces of the stream are split, and does not move the positions
+        // reported in errors.
+
+        static const struct {
+            int         d_line;
+            const char *d_program;
+            const char *d_trimmed;
+        } DATA[] = {
+            { L_, "X\n",                "X"            },
+            { L_, "Pi1|X\n",            "Pi1|X"        },
+            { L_, "Pi1|X \r\n",         "Pi1|X"        },
+            { L_, "Pi1|X|\n",           "Pi1|X|"       },
+            { L_, "Pd2|Pd4|+d|X\t\n\n", "Pd2|Pd4|+d|X" },
+            { L_, "\n",                 ""             },
+            { L_, "Pi1|Q\n",            "Pi1|Q"        },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        bdlma::SequentialAllocator alloc;
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int               LINE    = DATA[i].d_line;
+            const bslstl::StringRef program = DATA[i].d_program;
+
+            bsl::vector<sjtt::Bytecode> expected(&alloc);
+            bsl::string expectedError;
+            const int expectedRet = BytecodeDSLUtil::readDSL(
+                                                           &expected,
+                                                           &expectedError,
+                                                           DATA[i].d_trimmed,
+                                                           functions);
+
+            for (bsl::size_t j = 0; j <= program.length(); ++j) {
+                bsl::vector<sjtt::Bytecode> result(&alloc);
+                const Collector collector = { &result };
+                BytecodeDSLReader reader(collector, &functions, &alloc);
+                const char *begin = program.begin();
+                reader.write(bslstl::StringRef(begin, begin + j));
+                reader.write(bslstl::StringRef(begin + j, program.end()));
+                const int ret = reader.finish();
+                LOOP2_ASSERT(LINE, j, (0 == ret) == (0 == expectedRet));
+                LOOP3_ASSERT(LINE,
+                             j,
+                             reader.errorMessage(),
+                             reader.errorMessage() == expectedError);
+                if (0 == expectedRet) {
+                    LOOP2_ASSERT(LINE, j, result == expected);
+                }
+            }
+
+            FILE *file = tmpfile();
+            ASSERT(0 != file);
+            ASSERT(program.length() ==
+                          fwrite(program.data(), 1, program.length(), file));
+            fflush(file);
+
+            bsl::vector<sjtt::Bytecode> result(&alloc);
+            const Collector collector = { &result };
+            BytecodeDSLReader reader(collector, &functions, &alloc);
+            const int ret = reader.readMappedFile(fileno(file));
+            fclose(file);
+
+            LOOP_ASSERT(LINE, (0 == ret) == (0 == expectedRet));
+            LOOP2_ASSERT(LINE,
+                         reader.errorMessage(),
+                         reader.errorMessage() == expectedError);
+            if (0 == expectedRet) {
+                LOOP_ASSERT(LINE, result == expected);
+            }
+        }
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "readMappedFile" << endl
+                          << "==============" << endl;
+
+        bdlma::SequentialAllocator alloc;
+
+        for (int i = 0; i < NUM_PROGRAMS; ++i) {
+            const bsl::string program = s_Programs[i];
+
+            bsl::vector<sjtt::Bytecode> expected(&alloc);
+            bsl::string expectedError;
+            const int expectedRet = BytecodeDSLUtil::readDSL(&expected,
+                                                             &expectedError,
+                                                             program,
+                                                             functions);
+
+            FILE *file = tmpfile();
+            ASSERT(0 != file);
+            ASSERT(program.size() ==
+                          fwrite(program.data(), 1, program.size(), file));
+            fflush(file);
+
+            bsl::vector<sjtt::Bytecode> result(&alloc);
+            const Collector collector = { &result };
+            BytecodeDSLReader reader(collector, &functions, &alloc);
+            const int ret = reader.readMappedFile(fileno(file));
+            fclose(file);
+
+            LOOP_ASSERT(program, (0 == ret) == (0 == expectedRet));
+            LOOP2_ASSERT(program,
+                         reader.errorMessage(),
+                         reader.errorMessage() == expectedError);
+            if (0 == expectedRet) {
+                LOOP_ASSERT(program, result == expected);
+            }
+        }
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "readFileDescriptor" << endl
+                          << "==================" << endl;
+
+        bdlma::SequentialAllocator alloc;
+
+        // Read a program several times larger than the read buffer, so that
+        // bytecodes are split across reads.
+
+        bsl::string program;
+        while (program.size() < BytecodeDSLReader::s_ReadBufferSize * 3) {
+            program += "Pi12345|Pd2.5|L3|S7|";
+        }
+        program += "X";
+
+        bsl::vector<sjtt::Bytecode> expected(&alloc);
+        bsl::string expectedError;
+        ASSERT(0 == BytecodeDSLUtil::readDSL(&expected,
+                                             &expectedError,
+                                             program,
+                                             functions));
+
+        FILE *file = tmpfile();
+        ASSERT(0 != file);
+        ASSERT(program.size() ==
+                              fwrite(program.data(), 1, program.size(), file));
+        fflush(file);
+        rewind(file);
+
+        bsl::vector<sjtt::Bytecode> result(&alloc);
+        const Collector collector = { &result };
+        BytecodeDSLReader reader(collector, &functions, &alloc);
+        ASSERT(0 == reader.readFileDescriptor(fileno(file)));
+        fclose(file);
+
+        ASSERT(program.size() == reader.position());
+        ASSERT(result == expected);
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "write, split everywhere" << endl
+                          << "=======================" << endl;
+
+        bdlma::SequentialAllocator alloc;
+
+        for (int i = 0; i < NUM_PROGRAMS; ++i) {
+            const bslstl::StringRef program = s_Programs[i];
+
+            bsl::vector<sjtt::Bytecode> expected(&alloc);
+            bsl::string expectedError;
+            const int expectedRet = BytecodeDSLUtil::readDSL(&expected,
+                                                             &expectedError,
+                                                             program,
+                                                             functions);
+
+            // Split the program at every pair of positions into three
+            // pieces.
+
+            for (bsl::size_t j = 0; j <= program.length(); ++j) {
+                for (bsl::size_t k = j; k <= program.length(); ++k) {
+                    bsl::vector<sjtt::Bytecode> result(&alloc);
+                    const Collector collector = { &result };
+                    BytecodeDSLReader reader(collector, &functions, &alloc);
+                    const char *begin = program.begin();
+                    reader.write(bslstl::StringRef(begin, begin + j));
+                    reader.write(bslstl::StringRef(begin + j, begin + k));
+                    reader.write(bslstl::StringRef(begin + k, program.end()));
+                    const int ret = reader.finish();
+                    LOOP3_ASSERT(program,
+                                 j,
+                                 k,
+                                 (0 == ret) == (0 == expectedRet));
+                    LOOP3_ASSERT(program,
+                                 j,
+                                 reader.errorMessage(),
+                                 reader.errorMessage() == expectedError);
+                    if (0 == expectedRet) {
+                        LOOP3_ASSERT(program, j, k, result == expected);
+                    }
+                }
+            }
+        }
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bdlma::SequentialAllocator alloc;
+        bsl::vector<sjtt::Bytecode> result(&alloc);
+        const Collector collector = { &result };
+        BytecodeDSLReader reader(collector, &functions, &alloc);
+        ASSERT(0 == reader.write("Pd2|P"));
+        ASSERT(1 == result.size());
+        ASSERT(5 == reader.position());
+        ASSERT(0 == reader.write("d4|+d|X"));
+        ASSERT(3 == result.size());
+        ASSERT(0 == reader.finish());
+        ASSERT(4 == result.size());
+        ASSERT(reader.errorMessage().empty());
+        ASSERT(sjtt::Bytecode::e_Exit == result.back().opcode());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -3,11 +3,19 @@
 
 #include <algorithm>
 
-#include <bdlb_stringrefutil.h>
+#include <bdlma_localsequentialallocator.h>
+#include <bdlmt_threadpool.h>
+
+#include <bslmt_latch.h>
 
 #include <bslstl_ostringstream.h>
 #include <bslstl_istringstream.h>
 
+#include <bsls_assert.h>
+
+#include <sjtd_tracer.h>
+#include <sjtt_constantpool.h>
+
 using namespace BloombergLP;
 
 namespace sjtu {
@@ -203,6 +211,36 @@ int parseCall(Bytecode                        *result,
     return 0;
 }
 
+int parseThrow(Bytecode                        *result,
+               bsl::string                     *errorMessage,
+               bslma::Allocator                *alloc,
+               const StringRef&                 data,
+               const FunctionNameToAddressMap&  functions)
+{
+    if (!data.empty()) {
+        *errorMessage = "trailing data";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_Throw);
+    return 0;
+}
+
+int parseTailCall(Bytecode                        *result,
+                  bsl::string                     *errorMessage,
+                  bslma::Allocator                *alloc,
+                  const StringRef&                 data,
+                  const FunctionNameToAddressMap&  functions)
+{
+    const int addr = parseInt(data);
+    if (0 > addr) {
+        *errorMessage = "invalid index";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_TailCall,
+                                     Datum::createInteger(addr));
+    return 0;
+}
+
 int parseExecute(Bytecode                        *result,
                  bsl::string                     *errorMessage,
                  bslma::Allocator                *alloc,
@@ -247,6 +285,226 @@ int parseResize(Bytecode                        *result,
     return 0;
 }
 
+int parseNewObject(Bytecode                        *result,
+                   bsl::string                     *errorMessage,
+                   bslma::Allocator                *alloc,
+                   const StringRef&                 data,
+                   const FunctionNameToAddressMap&  functions)
+{
+    const int numSlots = parseInt(data);
+    if (0 > numSlots) {
+        *errorMessage = "invalid slot count";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_NewObject,
+                                     Datum::createInteger(numSlots));
+    return 0;
+}
+
+int parseGetSlot(Bytecode                        *result,
+                 bsl::string                     *errorMessage,
+                 bslma::Allocator                *alloc,
+                 const StringRef&                 data,
+                 const FunctionNameToAddressMap&  functions)
+{
+    const int slot = parseInt(data);
+    if (0 > slot) {
+        *errorMessage = "invalid index";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_GetSlot,
+                                     Datum::createInteger(slot));
+    return 0;
+}
+
+int parseSetSlot(Bytecode                        *result,
+                 bsl::string                     *errorMessage,
+                 bslma::Allocator                *alloc,
+                 const StringRef&                 data,
+                 const FunctionNameToAddressMap&  functions)
+{
+    const int slot = parseInt(data);
+    if (0 > slot) {
+        *errorMessage = "invalid index";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_SetSlot,
+                                     Datum::createInteger(slot));
+    return 0;
+}
+
+int parseGetProp(Bytecode                        *result,
+                 bsl::string                     *errorMessage,
+                 bslma::Allocator                *alloc,
+                 const StringRef&                 data,
+                 const FunctionNameToAddressMap&  functions)
+{
+    if (data.empty()) {
+        *errorMessage = "empty property name";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(
+                      Bytecode::e_GetProp,
+                      Datum::copyString(data.data(), data.length(), alloc));
+    return 0;
+}
+
+int parseSetProp(Bytecode                        *result,
+                 bsl::string                     *errorMessage,
+                 bslma::Allocator                *alloc,
+                 const StringRef&                 data,
+                 const FunctionNameToAddressMap&  functions)
+{
+    if (data.empty()) {
+        *errorMessage = "empty property name";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(
+                      Bytecode::e_SetProp,
+                      Datum::copyString(data.data(), data.length(), alloc));
+    return 0;
+}
+
+int parseNewTypedArray(Bytecode                        *result,
+                       bsl::string                     *errorMessage,
+                       bslma::Allocator                *alloc,
+                       const StringRef&                 data,
+                       const FunctionNameToAddressMap&  functions)
+{
+    int type;
+    if ("i" == data) {
+        type = 0;
+    }
+    else if ("d" == data) {
+        type = 1;
+    }
+    else {
+        *errorMessage = "invalid element type";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_NewTypedArray,
+                                     Datum::createInteger(type));
+    return 0;
+}
+
+int parseGetElement(Bytecode                        *result,
+                    bsl::string                     *errorMessage,
+                    bslma::Allocator                *alloc,
+                    const StringRef&                 data,
+                    const FunctionNameToAddressMap&  functions)
+{
+    if (!data.empty()) {
+        *errorMessage = "trailing data";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_GetElement);
+    return 0;
+}
+
+int parseSetElement(Bytecode                        *result,
+                    bsl::string                     *errorMessage,
+                    bslma::Allocator                *alloc,
+                    const StringRef&                 data,
+                    const FunctionNameToAddressMap&  functions)
+{
+    if (!data.empty()) {
+        *errorMessage = "trailing data";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_SetElement);
+    return 0;
+}
+
+int parseArrayOperation(Bytecode                        *result,
+                        bsl::string                     *errorMessage,
+                        bslma::Allocator                *alloc,
+                        const StringRef&                 data,
+                        const FunctionNameToAddressMap&  functions)
+{
+    static const struct {
+        const char       *d_name;
+        Bytecode::Opcode  d_opcode;
+    } OPERATIONS[] = {
+        { "len",   Bytecode::e_ArrayLength },
+        { "sum",   Bytecode::e_ArraySum },
+        { "dot",   Bytecode::e_ArrayDot },
+        { "min",   Bytecode::e_ArrayMin },
+        { "max",   Bytecode::e_ArrayMax },
+        { "scale", Bytecode::e_ArrayScale },
+        { "add",   Bytecode::e_ArrayAdd },
+    };
+    for (bsl::size_t i = 0; i < sizeof OPERATIONS / sizeof *OPERATIONS; ++i) {
+        if (OPERATIONS[i].d_name == data) {
+            *result = Bytecode::createOpcode(OPERATIONS[i].d_opcode);
+            return 0;
+        }
+    }
+    *errorMessage = "unknown array operation";
+    return -1;
+}
+
+int parsePushCode(Bytecode                        *result,
+                  bsl::string                     *errorMessage,
+                  bslma::Allocator                *alloc,
+                  const StringRef&                 data,
+                  const FunctionNameToAddressMap&  functions)
+{
+    const int addr = parseInt(data);
+    if (0 > addr) {
+        *errorMessage = "invalid index";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_PushCode,
+                                     Datum::createInteger(addr));
+    return 0;
+}
+
+int parseMakeClosure(Bytecode                        *result,
+                     bsl::string                     *errorMessage,
+                     bslma::Allocator                *alloc,
+                     const StringRef&                 data,
+                     const FunctionNameToAddressMap&  functions)
+{
+    const int count = parseInt(data);
+    if (0 > count) {
+        *errorMessage = "invalid count";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_MakeClosure,
+                                     Datum::createInteger(count));
+    return 0;
+}
+
+int parseLoadCaptured(Bytecode                        *result,
+                      bsl::string                     *errorMessage,
+                      bslma::Allocator                *alloc,
+                      const StringRef&                 data,
+                      const FunctionNameToAddressMap&  functions)
+{
+    const int index = parseInt(data);
+    if (0 > index) {
+        *errorMessage = "invalid index";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_LoadCaptured,
+                                     Datum::createInteger(index));
+    return 0;
+}
+
+int parseCallValue(Bytecode                        *result,
+                   bsl::string                     *errorMessage,
+                   bslma::Allocator                *alloc,
+                   const StringRef&                 data,
+                   const FunctionNameToAddressMap&  functions)
+{
+    if (!data.empty()) {
+        *errorMessage = "trailing data";
+        return -1;
+    }
+    *result = Bytecode::createOpcode(Bytecode::e_CallValue);
+    return 0;
+}
+
 typedef int (*ParserFunction)(Bytecode *,
                               bsl::string *,
                               bslma::Allocator *,
@@ -258,37 +516,196 @@ const struct ParserEntry {
     const char     *code;
     ParserFunction  parser;
 } s_Parsers[] = {
-    { "P", parsePush },
-    { "L", parseLoad },
-    { "S", parseStore },
-    { "J", parseJump },
+    { "P",   parsePush },
+    { "L",   parseLoad },
+    { "S",   parseStore },
+    { "J",   parseJump },
     { "I=i", parseIfIntsEq },
-    { "=i", parseEqInts },
-    { "I", parseIf },
+    { "=i",  parseEqInts },
+    { "I",   parseIf },
     { "++i", parseIncInt },
-    { "+d", parseAddDoubles },
-    { "+i", parseAddInts },
-    { "C", parseCall },
-    { "E", parseExecute },
-    { "X", parseExit },
-    { "V", parseResize },
+    { "+d",  parseAddDoubles },
+    { "+i",  parseAddInts },
+    { "C",   parseCall },
+    { "E",   parseExecute },
+    { "X",   parseExit },
+    { "V",   parseResize },
+    { "N",   parseNewObject },
+    { "G",   parseGetSlot },
+    { "W",   parseSetSlot },
+    { ".",   parseGetProp },
+    { ".=",  parseSetProp },
+    { "A",   parseNewTypedArray },
+    { "[",   parseGetElement },
+    { "[=",  parseSetElement },
+    { "#",   parseArrayOperation },
+    { "F",   parsePushCode },
+    { "Fc",  parseMakeClosure },
+    { "Lc",  parseLoadCaptured },
+    { "@",   parseCallValue },
+    { "T",   parseTailCall },
+    { "!",   parseThrow },
+};
+
+class ParserTrie {
+    // This class is a mechanism recognizing the opcode mnemonics of
+    // 's_Parsers'.  Each node of the trie is a prefix of a mnemonic, having a
+    // child for each character extending it to a longer prefix, and the
+    // entry whose mnemonic it is, if any.  Matching examines each character
+    // of the mnemonic at most once and does not depend on the order of
+    // 's_Parsers'.
+
+    // PRIVATE TYPES
+    enum { k_MAX_NODES = 64 };
+
+    struct Node {
+        unsigned char      d_children[256];  // index per character, or 0
+        const ParserEntry *d_entry_p;        // held, not owned, or 0
+    };
+
+    // DATA
+    Node d_nodes[k_MAX_NODES];               // the root first
+    int  d_numNodes;
+
+  public:
+    // CREATORS
+    ParserTrie();
+        // Create a trie of the mnemonics of 's_Parsers'.
+
+    // ACCESSORS
+    const ParserEntry *find(StringRef *data) const;
+        // Return the address of the entry for the longest opcode mnemonic
+        // that is a prefix of the specified 'data', or 0 if there is no such
+        // mnemonic.  If a match is found, set 'data' to be the remainder of
+        // the text.
 };
 
-int findParser(StringRef* data)
-    // Return the index of the parser that matches the specified 'data', or
-    // a negative value if there is no such parser.  If a match is found, set
-    // 'data' to be the remainder of the text.
-{
-    for (int i = 0; i != sizeof(s_Parsers) / sizeof(s_Parsers[0]); ++i) {
-        const ParserEntry& e = s_Parsers[i];
-        const StringRef match = bdlb::StringRefUtil::strstr(*data, e.code);
-        if(match == e.code && match.data() == data->data()) {
-            *data = StringRef(data->begin() + match.size(), data->end());
-            return i;
+ParserTrie::ParserTrie()
+: d_nodes()
+, d_numNodes(1)
+{
+    const int numParsers = sizeof(s_Parsers) / sizeof(*s_Parsers);
+    for (int i = 0; i < numParsers; ++i) {
+        int node = 0;
+        for (const char *next = s_Parsers[i].code; *next; ++next) {
+            unsigned char& child =
+                 d_nodes[node].d_children[static_cast<unsigned char>(*next)];
+            if (0 == child) {
+                BSLS_ASSERT(d_numNodes < k_MAX_NODES);
+                child = static_cast<unsigned char>(d_numNodes++);
+            }
+            node = child;
         }
+        BSLS_ASSERT(0 == d_nodes[node].d_entry_p);
+        d_nodes[node].d_entry_p = &s_Parsers[i];
     }
-    return -1;
 }
+
+const ParserEntry *ParserTrie::find(StringRef *data) const
+{
+    const char        *next     = data->begin();
+    const char *const  end      = data->end();
+    const ParserEntry *result   = 0;
+    const char        *matchEnd = next;
+
+    const Node *node = d_nodes;
+    while (end != next) {
+        const int child =
+                     node->d_children[static_cast<unsigned char>(*next++)];
+        if (0 == child) {
+            break;                                                 // BREAK
+        }
+        node = &d_nodes[child];
+        if (0 != node->d_entry_p) {
+            result   = node->d_entry_p;
+            matchEnd = next;
+        }
+    }
+    if (0 != result) {
+        *data = StringRef(matchEnd, end);
+    }
+    return result;
+}
+
+const ParserTrie s_ParserTrie;
+    // The trie of 's_Parsers', built before 'main' is entered, and then only
+    // read, so that threads parsing in parallel share it.
+
+const ParserEntry *findParser(StringRef *data)
+    // Return the address of the entry for the longest opcode mnemonic that is
+    // a prefix of the specified 'data', or 0 if there is no such mnemonic.  If
+    // a match is found, set 'data' to be the remainder of the text.
+{
+    return s_ParserTrie.find(data);
+}
+
+int readRange(bsl::vector<Bytecode>           *result,
+              bsl::string                     *errorMessage,
+              bslma::Allocator                *alloc,
+              const StringRef&                 dsl,
+              const char                      *begin,
+              const char                      *end,
+              const FunctionNameToAddressMap&  functions,
+              sjtt::ConstantPool              *constants)
+    // Append, to the specified 'result', the bytecodes described by the text
+    // of the specified 'dsl' in the range '[begin, end)' and return 0 if that
+    // text is valid; otherwise return a non-zero value and load a description
+    // into the specified 'errorMessage'.  Use the specified 'alloc' to
+    // allocate the data of returned bytecodes and the specified 'functions'
+    // to translate function names into addresses.  If the specified
+    // 'constants' is not 0, intern the data of pushed values into it instead
+    // of allocating it from 'alloc'.  Positions in error
+    // messages are reported relative to the start of 'dsl'.  The behavior is
+    // undefined unless '[begin, end)' lies within 'dsl' and 'end' is either
+    // the end of 'dsl' or the address of a '|' delimiter.
+{
+    SJTD_TRACER_SCOPE("parse", "readRange");
+
+    const char *next = begin;
+    while (next != end) {
+        const char *tokenEnd = std::find(next, end, '|');
+        const StringRef token(next, tokenEnd);
+        Bytecode code;
+        const int res = BytecodeDSLUtil::readBytecode(&code,
+                                                      errorMessage,
+                                                      alloc,
+                                                      token,
+                                                      next - dsl.begin(),
+                                                      functions,
+                                                      constants);
+        if (0 != res) {
+            return res;                                               // RETURN
+        }
+        result->push_back(code);
+        next = tokenEnd;
+        if (end != next) {
+            // If 'next' isn't the end, it points to '|' and we need to
+            // increment it.
+
+            ++next;
+        }
+    }
+    return 0;
+}
+
+struct Chunk {
+    // This 'struct' describes a contiguous range of a DSL program that is
+    // parsed independently of the rest of the program.
+
+    const char                  *d_begin;    // first character of the range
+    const char                  *d_end;      // end of the range
+    bsl::vector<sjtt::Bytecode>  d_codes;    // parsed codes
+    bsl::string                  d_error;    // error message, if any
+    int                          d_status;   // result of parsing
+
+    explicit Chunk(bslma::Allocator *allocator)
+    : d_begin(0)
+    , d_end(0)
+    , d_codes(allocator)
+    , d_status(0)
+    {
+    }
+};
 }
 
 int BytecodeDSLUtil::readDatum(Datum                           *result,
@@ -346,6 +763,11 @@ int BytecodeDSLUtil::readDatum(Datum                           *result,
         }
         *result = sjtd::DatumUdtUtil::datumFromExternalFunction(i->second);
       } break;
+      case 's': {
+        *result = Datum::copyString(source.data() + 1,
+                                    source.length() - 1,
+                                    allocator);
+      } break;
       default: {
         *errorMessage = "unknown datum type '";
         *errorMessage += source[0];
@@ -356,52 +778,174 @@ int BytecodeDSLUtil::readDatum(Datum                           *result,
     return 0;
 }
 
+int BytecodeDSLUtil::readBytecode(
+                                 sjtt::Bytecode                  *result,
+                                 bsl::string                     *errorMessage,
+                                 Allocator                       *allocator,
+                                 const StringRef&                 source,
+                                 bsl::size_t                      position,
+                                 const FunctionNameToAddressMap&  functions,
+                                 sjtt::ConstantPool              *constants) {
+    if (source.empty()) {
+        bsl::ostringstream txt;
+        txt << "empty bytecode beginning at position: " << position;
+        *errorMessage = txt.str();
+        return -1;                                                    // RETURN
+    }
+    StringRef data = source;
+    const ParserEntry *entry = findParser(&data);
+    if (0 == entry) {
+        bsl::ostringstream txt;
+        txt << "invalid opcode at position: " << position << " -- '" << data
+            << "'";
+        *errorMessage = txt.str();
+        return -1;                                                    // RETURN
+    }
+    bsl::string parserError;
+
+    // When interning, parse into a scratch arena: the pool keeps its own copy
+    // of each distinct constant, so the parsed copy is garbage.
+
+    bdlma::LocalSequentialAllocator<s_ScratchSize> scratch(allocator);
+    const int res = entry->parser(result,
+                                  &parserError,
+                                  0 == constants ? allocator : &scratch,
+                                  data,
+                                  functions);
+    if (0 != res) {
+        bsl::ostringstream txt;
+        txt << "failed to parse code '" << entry->code << "' from '" << data
+            << "' at position: " << position << " -- " << parserError;
+        *errorMessage = txt.str();
+        return -1;                                                    // RETURN
+    }
+    if (0 != constants && (Bytecode::e_Push    == result->opcode() ||
+                           Bytecode::e_GetProp == result->opcode() ||
+                           Bytecode::e_SetProp == result->opcode())) {
+        const int index = constants->intern(result->data());
+        *result = Bytecode::createOpcode(result->opcode(),
+                                         constants->constant(index));
+    }
+    return 0;
+}
+
 int BytecodeDSLUtil::readDSL(bsl::vector<sjtt::Bytecode>     *result,
                              bsl::string                     *errorMessage,
                              const StringRef&                 dsl,
                              const FunctionNameToAddressMap&  functions) {
+    return readRange(result,
+                     errorMessage,
+                     result->get_allocator().mechanism(),
+                     dsl,
+                     dsl.begin(),
+                     dsl.end(),
+                     functions,
+                     0);
+}
+
+int BytecodeDSLUtil::readDSL(bsl::vector<sjtt::Bytecode>     *result,
+                             bsl::string                     *errorMessage,
+                             const StringRef&                 dsl,
+                             const FunctionNameToAddressMap&  functions,
+                             sjtt::ConstantPool              *constants) {
+    BSLS_ASSERT(0 != constants);
+
+    return readRange(result,
+                     errorMessage,
+                     constants->allocator(),
+                     dsl,
+                     dsl.begin(),
+                     dsl.end(),
+                     functions,
+                     constants);
+}
+
+int BytecodeDSLUtil::readDSLParallel(
+                               bsl::vector<sjtt::Bytecode>     *result,
+                               bsl::string                     *errorMessage,
+                               const StringRef&                 dsl,
+                               const FunctionNameToAddressMap&  functions,
+                               bdlmt::ThreadPool               *threadPool,
+                               int                              numChunks) {
+    BSLS_ASSERT(0 != threadPool);
+    BSLS_ASSERT(0 < numChunks);
+
+    SJTD_TRACER_SCOPE("parse", "readDSLParallel");
+
     Allocator *alloc = result->get_allocator().mechanism();
-    const char *next = dsl.begin();
-    while (next != dsl.end()) {
-        const char *end = std::find(next, dsl.end(), '|');
-        if (end == next) {
-            bsl::ostringstream txt;
-            txt << "empty bytecode beginning at position: "
-                << (next - dsl.begin());
-            *errorMessage = txt.str();
-            return -1;                                                // RETURN
-        }
-        const int pos = (next - dsl.begin());
-        StringRef data = StringRef(next, end);
-        const int parserIndex = findParser(&data);
-        if (0 > parserIndex) {
-            bsl::ostringstream txt;
-            txt << "invalid opcode at position: " << pos << " -- '" << data
-                << "'";
-            *errorMessage = txt.str();
-            return -1;                                                // RETURN
+
+    if (1 == numChunks || dsl.length() < s_MinParallelChunkSize * 2) {
+        return readDSL(result, errorMessage, dsl, functions);         // RETURN
+    }
+    if (dsl.length() / numChunks < s_MinParallelChunkSize) {
+        numChunks = dsl.length() / s_MinParallelChunkSize;
+    }
+
+    // Split 'dsl' into chunks ending at '|' delimiters (or at the end of
+    // 'dsl').  Every chunk is non-empty, so an empty bytecode at the start of
+    // a chunk is reported by the chunk that contains it, exactly as in
+    // 'readDSL'.
+
+    bsl::vector<Chunk> chunks(alloc);
+    chunks.reserve(numChunks);
+    const char *begin = dsl.begin();
+    for (int i = 1; i <= numChunks && dsl.end() != begin; ++i) {
+        const char *target = i == numChunks
+                           ? dsl.end()
+                           : dsl.begin() + dsl.length() / numChunks * i;
+        if (target <= begin) {
+            target = begin + 1;
         }
-        const ParserEntry& entry = s_Parsers[parserIndex];
-        bsl::string parserError;
-        Bytecode code;
-        const int res =
-                     entry.parser(&code, &parserError, alloc, data, functions);
-        if (0 != res) {
-            bsl::ostringstream txt;
-            txt << "failed to parse code '" << entry.code << "' from '"
-                << data << "' at position: " << pos << " -- "
-                << parserError;
-            *errorMessage = txt.str();
-            return -1;                                                // RETURN
+        const char *end = std::find(target, dsl.end(), '|');
+        chunks.emplace_back(alloc);
+        chunks.back().d_begin = begin;
+        chunks.back().d_end   = end;
+        begin = dsl.end() == end ? end : end + 1;
+    }
+
+    bslmt::Latch latch(static_cast<int>(chunks.size()));
+    for (bsl::size_t i = 0; i < chunks.size(); ++i) {
+        Chunk *chunk = &chunks[i];
+        const bdlmt::ThreadPool::Job job = [chunk,
+                                            alloc,
+                                            &dsl,
+                                            &functions,
+                                            &latch]() {
+            chunk->d_status = readRange(&chunk->d_codes,
+                                        &chunk->d_error,
+                                        alloc,
+                                        dsl,
+                                        chunk->d_begin,
+                                        chunk->d_end,
+                                        functions,
+                                        0);
+            latch.arrive();
+        };
+        if (0 != threadPool->enqueueJob(job)) {
+            // The pool will not run the job (e.g., it is stopped), so parse
+            // the chunk on this thread instead.
+
+            job();
         }
-        result->push_back(code);
-        next = end;
-        if (dsl.end() != next) {
-            // If 'next' isn't the end, it points to '|' and we need to
-            // increment it.
+    }
+    latch.wait();
 
-            ++next;
+    // Report the error from the first failing chunk; every chunk before it
+    // parsed successfully, so this is the error that 'readDSL' would report.
+
+    bsl::size_t numCodes = 0;
+    for (bsl::size_t i = 0; i < chunks.size(); ++i) {
+        if (0 != chunks[i].d_status) {
+            *errorMessage = chunks[i].d_error;
+            return chunks[i].d_status;                                // RETURN
         }
+        numCodes += chunks[i].d_codes.size();
+    }
+    result->reserve(result->size() + numCodes);
+    for (bsl::size_t i = 0; i < chunks.size(); ++i) {
+        result->insert(result->end(),
+                       chunks[i].d_codes.begin(),
+                       chunks[i].d_codes.end());
     }
     return 0;
 }
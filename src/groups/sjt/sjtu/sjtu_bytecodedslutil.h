@@ -11,6 +11,10 @@
 #include <bsl_vector.h>
 #endif
 
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
 #ifndef INCLUDED_SJTT_BYTECODE
 #include <sjtt_bytecode.h>
 #endif
@@ -19,6 +23,12 @@
 #include <sjtd_datumudtutil.h>
 #endif
 
+namespace BloombergLP {
+namespace bdlmt { class ThreadPool; }
+}
+
+namespace sjtt { class ConstantPool; }
+
 namespace sjtu {
 
 struct BytecodeDSLUtil {
@@ -38,7 +48,22 @@ struct BytecodeDSLUtil {
     //                 <call> |
     //                 <execute> |
     //                 <exit> |
-    //                 <resive>
+    //                 <resive> |
+    //                 <new object> |
+    //                 <get slot> |
+    //                 <set slot> |
+    //                 <get property> |
+    //                 <set property> |
+    //                 <new typed array> |
+    //                 <get element> |
+    //                 <set element> |
+    //                 <array operation> |
+    //                 <push code> |
+    //                 <make closure> |
+    //                 <load captured> |
+    //                 <call value> |
+    //                 <tail call> |
+    //                 <throw>
     // push          = 'P'<datum>
     // load          = 'L'<int>
     // store         = 'S'<int>
@@ -51,13 +76,43 @@ struct BytecodeDSLUtil {
     // call          = 'C'<int>
     // execute       = 'E'
     // exit          = 'X'
-    // datum         = 'd'<double> | 'i'<int> | 'e'<external function name>
+    // datum         = 'd'<double> | 'i'<int> | 'e'<external function name> |
+    //                 's'<string> | 'T' | 'F'
     // resize        = 'V'<int>
+    // new object    = 'N'<int>
+    // get slot      = 'G'<int>
+    // set slot      = 'W'<int>
+    // get property  = '.'<name>
+    // set property  = '.='<name>
+    // new typed array = 'A'('i' | 'd')
+    // get element   = '['
+    // set element   = '[='
+    // array operation = '#'('len' | 'sum' | 'dot' | 'min' | 'max' |
+    //                       'scale' | 'add')
+    // push code     = 'F'<int>
+    // make closure  = 'Fc'<int>
+    // load captured = 'Lc'<int>
+    // call value    = '@'
+    // tail call     = 'T'<int>
+    // throw         = '!'
     //
     // Example:
     //     "Pd2|Pd3|+d|X"
     // Means to push 2.0, push 3.0, add the values, then return the result.
     //
+    // Note that a string datum, like a property name, extends to the end of
+    // its bytecode, and so cannot contain '|'; a property whose name begins
+    // with '=' cannot be read.
+    //
+    // Note that a new typed array holds 32-bit integers ('Ai') or doubles
+    // ('Ad'), and that each array operation is a distinct opcode; e.g.,
+    // '#sum' is 'sjtt::Bytecode::e_ArraySum'.
+    //
+    // Note that a function called through a value is written at the index
+    // given by its 'F' code, and its own jumps and calls are relative to
+    // that index; e.g., in "F4|Pi0|@|X|Pi5|X" the function is "Pi5|X", and
+    // the program returns 5.
+    //
     // Note that more capabilities will be added as needed.
     //
     // Note also that these utilities are intended for testing purposes; if
@@ -74,6 +129,15 @@ struct BytecodeDSLUtil {
         // Describes a map used to associated the names of functions in the DSL
         // with the addresses of actual functions.
 
+    // CONSTANTS
+    static const int s_MinParallelChunkSize = 4096;
+        // The minimum number of characters of DSL that 'readDSLParallel' will
+        // hand to a thread as one chunk.
+
+    static const int s_ScratchSize = 256;
+        // The number of bytes of stack used to parse a constant that is then
+        // interned into a 'sjtt::ConstantPool'.
+
     // CLASS METHODS
     static int readDatum(Datum                           *result,
                          bsl::string                     *errorMessage,
@@ -88,6 +152,26 @@ struct BytecodeDSLUtil {
         // 'errorMessage', a string describing the problem and return a
         // non-zero value.
 
+    static int readBytecode(sjtt::Bytecode                  *result,
+                            bsl::string                     *errorMessage,
+                            Allocator                       *allocator,
+                            const StringRef&                 source,
+                            bsl::size_t                      position,
+                            const FunctionNameToAddressMap&  functions,
+                            sjtt::ConstantPool              *constants = 0);
+        // Read, into the specified 'result', the single bytecode described by
+        // the specified 'source', using the specified 'allocator' to allocate
+        // memory and the specified 'functions' to translate function names
+        // into addresses, and return 0.  If 'source' does not encode a valid
+        // bytecode, load, into the specified 'errorMessage', a string
+        // describing the problem that reports the specified 'position' as the
+        // location of 'source' and return a non-zero value.  Optionally
+        // specify 'constants' into which the value of a push, or the name of
+        // a property, is interned; if 'constants' is specified, the data of
+        // 'result' is owned by 'constants' and 'allocator' supplies only
+        // temporary memory.  Note that 'source' must not contain the '|'
+        // delimiter.
+
     static int readDSL(bsl::vector<sjtt::Bytecode>     *result,
                        bsl::string                     *errorMessage,
                        const StringRef&                 dsl,
@@ -100,6 +184,42 @@ struct BytecodeDSLUtil {
         // failed parse is undefined.  Note also that the allocator associated
         // with 'result' is used to allocate memory for any returned 'Datum'
         // objects.
+
+    static int readDSL(bsl::vector<sjtt::Bytecode>     *result,
+                       bsl::string                     *errorMessage,
+                       const StringRef&                 dsl,
+                       const FunctionNameToAddressMap&  functions,
+                       sjtt::ConstantPool              *constants);
+        // Load, into the specified 'result', the bytecodes described in the
+        // specified 'dsl' and return 0 if 'dsl' is valid; otherwise return a
+        // non-zero value and load a description into the specified
+        // 'errorMessage'.  Translate function names to addresses using the
+        // specified 'functions' map.  Intern the value of every push into the
+        // specified 'constants', so that the data of each returned push is
+        // owned by 'constants' and identical values share one copy.  The
+        // state of 'result' after a failed parse is undefined.
+
+    static int readDSLParallel(
+                               bsl::vector<sjtt::Bytecode>     *result,
+                               bsl::string                     *errorMessage,
+                               const StringRef&                 dsl,
+                               const FunctionNameToAddressMap&  functions,
+                               BloombergLP::bdlmt::ThreadPool  *threadPool,
+                               int                              numChunks);
+        // Load, into the specified 'result', the bytecodes described in the
+        // specified 'dsl' and return 0 if 'dsl' is valid; otherwise return a
+        // non-zero value and load a description into the specified
+        // 'errorMessage'.  Translate function names to addresses using the
+        // specified 'functions' map.  Split 'dsl' at '|' delimiters into at
+        // most the specified 'numChunks' chunks of at least
+        // 's_MinParallelChunkSize' characters, and parse them concurrently
+        // using the specified 'threadPool', blocking until all chunks are
+        // parsed.  The value loaded into 'result' or 'errorMessage' is the
+        // same as would be loaded by 'readDSL'.  The behavior is undefined
+        // unless '0 < numChunks', and the allocator associated with 'result'
+        // can be used concurrently from multiple threads.  Note that if
+        // 'threadPool' declines a job, its chunk is parsed on the calling
+        // thread.
 };
 }
 
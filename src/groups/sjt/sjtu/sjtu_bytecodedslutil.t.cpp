@@ -3,12 +3,18 @@
 #include <sjtu_bytecodedslutil.h>
 
 #include <bdlma_sequentialallocator.h>
+#include <bdlmt_threadpool.h>
 #include <bdls_testutil.h>
 
+#include <bslma_testallocator.h>
+#include <bslmt_threadattributes.h>
+#include <bsls_types.h>
+
 #include <bsl_vector.h>
 
 #include <sjtd_datumfactory.h>
 #include <sjtt_bytecode.h>
+#include <sjtt_constantpool.h>
 
 using namespace BloombergLP;
 using namespace bsl;
@@ -77,6 +83,155 @@ int main(int argc, char *argv[])
     cout << "TEST " << __FILE__ << " CASE " << test << endl;
 
     switch (test) { case 0:
+      case 4: {
+        if (verbose) cout << endl
+                          << "readDSL with constants" << endl
+                          << "======================" << endl;
+
+        bslma::TestAllocator ta;
+        bslma::TestAllocator pa;
+
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+        functions["foo"] = testFun;
+
+        {
+            sjtt::ConstantPool constants(&pa);
+            bsl::vector<sjtt::Bytecode> result(&ta);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(
+                                   &result,
+                                   &errorMessage,
+                                   "Pshello|Pi1|Pshello|L0|Pi1|Psworld|Pefoo",
+                                   functions,
+                                   &constants);
+            LOOP_ASSERT(errorMessage, 0 == ret);
+            ASSERT(7 == result.size());
+            ASSERT(4 == constants.numConstants());
+
+            // Identical strings share the pool's copy.
+
+            ASSERT("hello" == result[0].data().theString());
+            ASSERT(result[0].data().theString().data() ==
+                   result[2].data().theString().data());
+            ASSERT(result[0].data().theString().data() ==
+                   constants.constant(0).theString().data());
+            ASSERT(result[1] == result[4]);
+            ASSERT("world" == result[5].data().theString());
+            ASSERT(sjtt::Bytecode::createOpcode(sjtt::Bytecode::e_Load,
+                                                bdld::Datum::createInteger(0))
+                                                                == result[3]);
+
+            // Property names are interned as well.
+
+            bsl::vector<sjtt::Bytecode> props(&ta);
+            ASSERT(0 == BytecodeDSLUtil::readDSL(&props,
+                                                 &errorMessage,
+                                                 ".hello|.=hello",
+                                                 functions,
+                                                 &constants));
+            ASSERT(4 == constants.numConstants());
+            ASSERT(result[0].data().theString().data() ==
+                   props[0].data().theString().data());
+            ASSERT(result[0].data().theString().data() ==
+                   props[1].data().theString().data());
+            ASSERT(sjtt::Bytecode::e_SetProp == props[1].opcode());
+
+            // Only the pool holds the data of constants.
+
+            ASSERT(static_cast<bsls::Types::Int64>(
+                         (result.capacity() + props.capacity()) *
+                         sizeof(sjtt::Bytecode)) == ta.numBytesInUse());
+
+            // Bad input is reported as usual.
+
+            bsl::vector<sjtt::Bytecode> bad(&ta);
+            ASSERT(0 != BytecodeDSLUtil::readDSL(&bad,
+                                                 &errorMessage,
+                                                 "Psx|Pq",
+                                                 functions,
+                                                 &constants));
+            ASSERT("failed to parse code 'P' from 'q' at position: 4 -- "
+                   "invalid datum" == errorMessage);
+        }
+        ASSERT(0 == pa.numBlocksInUse());
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "readDSLParallel" << endl
+                          << "===============" << endl;
+
+        bslma::TestAllocator alloc;    // thread-safe
+
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+        functions["foo"] = testFun;
+
+        bslmt::ThreadAttributes attributes;
+        bdlmt::ThreadPool pool(attributes, 1, 4, 100);
+        ASSERT(0 == pool.start());
+
+        bsl::string program;
+        for (int i = 0; i < 5000; ++i) {
+            program += "Pi1|Pd2.5|+d|L3|S4|I=i7|Pefoo|";
+        }
+        bsl::string almostX = program;
+        almostX += "X";
+
+        const int MID = program.size() / 2;
+
+        bsl::string emptyMid = program;
+        emptyMid.insert(MID - MID % 31 + 1, "|");
+
+        bsl::string badMid = program;
+        badMid[MID] = 'Q';
+
+        bsl::string badTwice = badMid;
+        badTwice[badTwice.size() - 4] = 'Q';
+
+        const struct Case {
+            const char  *name;
+            bsl::string  dsl;
+        } cases[] = {
+            { "empty", "" },
+            { "small", "Pi1|Pi2|+i|X" },
+            { "large", almostX },
+            { "large with trailing '|'", program },
+            { "leading empty", "|" + program },
+            { "empty in the middle", emptyMid },
+            { "bad in the middle", badMid },
+            { "two errors", badTwice },
+            { "empty at the end", program + "|" },
+        };
+        for (int i = 0; i < (sizeof(cases) / sizeof(cases[0])); ++i) {
+            const Case& c = cases[i];
+
+            bsl::vector<sjtt::Bytecode> expected(&alloc);
+            bsl::string expectedError;
+            const int expectedRet = BytecodeDSLUtil::readDSL(&expected,
+                                                             &expectedError,
+                                                             c.dsl,
+                                                             functions);
+            for (int numChunks = 1; numChunks <= 9; ++numChunks) {
+                bsl::vector<sjtt::Bytecode> result(&alloc);
+                bsl::string errorMessage;
+                const int ret = BytecodeDSLUtil::readDSLParallel(&result,
+                                                                 &errorMessage,
+                                                                 c.dsl,
+                                                                 functions,
+                                                                 &pool,
+                                                                 numChunks);
+                LOOP2_ASSERT(c.name, numChunks, ret == expectedRet);
+                LOOP3_ASSERT(c.name,
+                             numChunks,
+                             errorMessage,
+                             errorMessage == expectedError);
+                if (0 == expectedRet) {
+                    LOOP2_ASSERT(c.name, numChunks, result == expected);
+                }
+            }
+        }
+        pool.stop();
+      } break;
       case 2: {
         if (verbose) cout << endl
                           << "readDSL" << endl
@@ -177,10 +332,39 @@ int main(int argc, char *argv[])
                 "failed to parse code 'I=i' from 'i' at position: 0 -- "
                 "invalid index",
             },
+            {
+                "if, longest match falls back",
+                "I=8",
+                true,
+                {},
+                "failed to parse code 'I' from '=8' at position: 0 -- "
+                "invalid index",
+            },
             { "= ints", "=i", false, { BC::createOpcode(BC::e_EqInts)}},
+            {
+                "bad = ints",
+                "=d",
+                true,
+                {},
+                "invalid opcode at position: 0 -- '=d'",
+            },
             { "++int", "++i1", false, { BC::createOpcode(BC::e_IncInt, f(1))}},
             { "+ doubles", "+d", false, { BC::createOpcode(BC::e_AddDoubles)}},
             { "+ ints", "+i", false, { BC::createOpcode(BC::e_AddInts)}},
+            {
+                "bad +",
+                "+q",
+                true,
+                {},
+                "invalid opcode at position: 0 -- '+q'",
+            },
+            {
+                "bad ++",
+                "++d",
+                true,
+                {},
+                "invalid opcode at position: 0 -- '++d'",
+            },
             { "call", "C8", false, { BC::createOpcode(BC::e_Call, f(8)) } },
             {
                 "bad call",
@@ -222,6 +406,173 @@ int main(int argc, char *argv[])
                 "failed to parse code 'V' from 'i' at position: 0 -- invalid "
                 "index",
             },
+            {
+                "new object",
+                "N3",
+                false,
+                { BC::createOpcode(BC::e_NewObject, f(3)) },
+            },
+            {
+                "bad new object",
+                "N",
+                true,
+                {},
+                "failed to parse code 'N' from '' at position: 0 -- invalid "
+                "slot count",
+            },
+            {
+                "get slot",
+                "G1",
+                false,
+                { BC::createOpcode(BC::e_GetSlot, f(1)) },
+            },
+            {
+                "set slot",
+                "W2",
+                false,
+                { BC::createOpcode(BC::e_SetSlot, f(2)) },
+            },
+            {
+                "bad set slot",
+                "Wx",
+                true,
+                {},
+                "failed to parse code 'W' from 'x' at position: 0 -- invalid "
+                "index",
+            },
+            {
+                "get property",
+                ".x",
+                false,
+                {
+                    BC::createOpcode(BC::e_GetProp,
+                                     bdld::Datum::copyString("x", 1, &alloc)),
+                },
+            },
+            {
+                "set property",
+                ".=xy",
+                false,
+                {
+                    BC::createOpcode(BC::e_SetProp,
+                                     bdld::Datum::copyString("xy", 2, &alloc)),
+                },
+            },
+            {
+                "bad get property",
+                ".",
+                true,
+                {},
+                "failed to parse code '.' from '' at position: 0 -- empty "
+                "property name",
+            },
+            {
+                "bad set property",
+                ".=",
+                true,
+                {},
+                "failed to parse code '.=' from '' at position: 0 -- empty "
+                "property name",
+            },
+            {
+                "new typed arrays",
+                "Ai|Ad",
+                false,
+                {
+                    BC::createOpcode(BC::e_NewTypedArray, f(0)),
+                    BC::createOpcode(BC::e_NewTypedArray, f(1)),
+                },
+            },
+            {
+                "bad new typed array",
+                "Ax",
+                true,
+                {},
+                "failed to parse code 'A' from 'x' at position: 0 -- invalid "
+                "element type",
+            },
+            {
+                "elements",
+                "[|[=",
+                false,
+                {
+                    BC::createOpcode(BC::e_GetElement),
+                    BC::createOpcode(BC::e_SetElement),
+                },
+            },
+            {
+                "bad set element",
+                "[=1",
+                true,
+                {},
+                "failed to parse code '[=' from '1' at position: 0 -- "
+                "trailing data",
+            },
+            {
+                "array operations",
+                "#len|#sum|#dot|#min|#max|#scale|#add",
+                false,
+                {
+                    BC::createOpcode(BC::e_ArrayLength),
+                    BC::createOpcode(BC::e_ArraySum),
+                    BC::createOpcode(BC::e_ArrayDot),
+                    BC::createOpcode(BC::e_ArrayMin),
+                    BC::createOpcode(BC::e_ArrayMax),
+                    BC::createOpcode(BC::e_ArrayScale),
+                    BC::createOpcode(BC::e_ArrayAdd),
+                },
+            },
+            {
+                "bad array operation",
+                "#mean",
+                true,
+                {},
+                "failed to parse code '#' from 'mean' at position: 0 -- "
+                "unknown array operation",
+            },
+            {
+                "function values",
+                "F3|Fc2|Lc1|@|L4",
+                false,
+                {
+                    BC::createOpcode(BC::e_PushCode, f(3)),
+                    BC::createOpcode(BC::e_MakeClosure, f(2)),
+                    BC::createOpcode(BC::e_LoadCaptured, f(1)),
+                    BC::createOpcode(BC::e_CallValue),
+                    BC::createOpcode(BC::e_Load, f(4)),
+                },
+            },
+            {
+                "bad make closure",
+                "Fcx",
+                true,
+                {},
+                "failed to parse code 'Fc' from 'x' at position: 0 -- "
+                "invalid count",
+            },
+            {
+                "tail call",
+                "T5",
+                false,
+                { BC::createOpcode(BC::e_TailCall, f(5)) },
+            },
+            { "throw", "!", false, { BC::createOpcode(BC::e_Throw) } },
+            {
+                "bad tail call",
+                "T",
+                true,
+                {},
+                "failed to parse code 'T' from '' at position: 0 -- invalid "
+                "index",
+            },
+            {
+                "bad call value",
+                "@1",
+                true,
+                {},
+                "failed to parse code '@' from '1' at position: 0 -- "
+                "trailing data",
+            },
 
             // combinations
             { "sequence term", "X|", false, { BC::createOpcode(BC::e_Exit) } },
@@ -306,6 +657,20 @@ int main(int argc, char *argv[])
                 "unknown function name 'bar'" },
             { "good fun name", "efoo", false, f(testFun), 0 },
             { "true", "T", false, f(true) },
+            {
+                "string",
+                "sa b",
+                false,
+                bdld::Datum::copyString("a b", 3, &alloc),
+                0
+            },
+            {
+                "empty string",
+                "s",
+                false,
+                bdld::Datum::copyString("", 0, &alloc),
+                0
+            },
             { "false", "F", false, f(false) },
         };
         for (int i = 0; i < (sizeof(cases) / sizeof(cases[0])); ++i) {
@@ -0,0 +1,28 @@
+// sjtu_inlinecachetable.cpp
+#include <sjtu_inlinecachetable.h>
+
+namespace sjtu {
+
+                          // ----------------------
+                          // class InlineCacheTable
+                          // ----------------------
+
+// CREATORS
+InlineCacheTable::InlineCacheTable(Allocator *basicAllocator)
+: d_propertyCaches(basicAllocator)
+, d_callCaches(basicAllocator)
+, d_heap_p(0)
+{
+}
+
+// MANIPULATORS
+void InlineCacheTable::setHeap(const sjtm::Heap *heap)
+{
+    // Each local heap is new, even if it has the address of the last one.
+
+    if (0 == heap || heap != d_heap_p) {
+        d_propertyCaches.clear();
+    }
+    d_heap_p = heap;
+}
+}
@@ -0,0 +1,147 @@
+// sjtu_inlinecachetable.h
+
+#ifndef INCLUDED_SJTU_INLINECACHETABLE
+#define INCLUDED_SJTU_INLINECACHETABLE
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLS_ASSERT
+#include <bsls_assert.h>
+#endif
+
+#ifndef INCLUDED_SJTM_PROPERTYCACHE
+#include <sjtm_propertycache.h>
+#endif
+
+#ifndef INCLUDED_SJTT_CALLTARGETCACHE
+#include <sjtt_calltargetcache.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm { class Heap; }
+
+namespace sjtu {
+
+                          // ======================
+                          // class InlineCacheTable
+                          // ======================
+
+class InlineCacheTable {
+    // This class is a mechanism holding the inline caches of a block of code:
+    // an 'sjtm::PropertyCache' for each property access and an
+    // 'sjtt::CallTargetCache' for each indirect call, indexed by the position
+    // of the site in the block and created the first time they are used.
+    // Like an 'sjtt::ExceptionTable', the table is kept alongside the code,
+    // so that the shapes and targets seen by one evaluation are known to the
+    // next.
+    //
+    // The shapes remembered by the property caches are owned by the heap of
+    // the objects accessed, so the property caches are kept only while the
+    // evaluations using the table allocate objects from the same heap; the
+    // call target caches, which remember only codes of the block, are kept
+    // regardless.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bslma::Allocator Allocator;
+
+  private:
+    // DATA
+    bsl::vector<sjtm::PropertyCache>   d_propertyCaches;  // per site
+    bsl::vector<sjtt::CallTargetCache> d_callCaches;      // per site
+    const sjtm::Heap                  *d_heap_p;  // of the shapes in the
+                                                  // property caches, or 0
+
+    // NOT IMPLEMENTED
+    InlineCacheTable(const InlineCacheTable&) = delete;
+    InlineCacheTable& operator=(const InlineCacheTable&) = delete;
+
+  public:
+    // CREATORS
+    explicit InlineCacheTable(Allocator *basicAllocator = 0);
+        // Create a table having no caches.  Optionally specify a
+        // 'basicAllocator' used to supply memory.  If 'basicAllocator' is 0,
+        // the currently installed default allocator is used.
+
+    // MANIPULATORS
+    sjtt::CallTargetCache& callCache(int index);
+        // Return a reference providing modifiable access to the inline cache
+        // of the indirect call at the specified 'index' in the block,
+        // creating it if needed.  The behavior is undefined unless
+        // '0 <= index'.
+
+    sjtm::PropertyCache& propertyCache(int index);
+        // Return a reference providing modifiable access to the inline cache
+        // of the property access at the specified 'index' in the block,
+        // creating it if needed.  The behavior is undefined unless
+        // '0 <= index'.
+
+    void setHeap(const sjtm::Heap *heap);
+        // Prepare this table for an evaluation allocating objects from the
+        // specified 'heap', or from a heap local to the evaluation if 'heap'
+        // is 0, by forgetting the property caches unless they were filled by
+        // evaluations allocating objects from 'heap'.  The behavior is
+        // undefined unless every heap with which this table is used outlives
+        // it.
+
+    // ACCESSORS
+    int numCallCaches() const;
+        // Return one more than the greatest index of a call target cache
+        // created, or 0 if there is none.
+
+    int numPropertyCaches() const;
+        // Return one more than the greatest index of a property cache
+        // created, or 0 if there is none.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                          // ----------------------
+                          // class InlineCacheTable
+                          // ----------------------
+
+// MANIPULATORS
+inline
+sjtt::CallTargetCache& InlineCacheTable::callCache(int index)
+{
+    BSLS_ASSERT(0 <= index);
+
+    if (numCallCaches() <= index) {
+        d_callCaches.resize(index + 1);
+    }
+    return d_callCaches[index];
+}
+
+inline
+sjtm::PropertyCache& InlineCacheTable::propertyCache(int index)
+{
+    BSLS_ASSERT(0 <= index);
+
+    if (numPropertyCaches() <= index) {
+        d_propertyCaches.resize(index + 1);
+    }
+    return d_propertyCaches[index];
+}
+
+// ACCESSORS
+inline
+int InlineCacheTable::numCallCaches() const
+{
+    return static_cast<int>(d_callCaches.size());
+}
+
+inline
+int InlineCacheTable::numPropertyCaches() const
+{
+    return static_cast<int>(d_propertyCaches.size());
+}
+}
+
+#endif
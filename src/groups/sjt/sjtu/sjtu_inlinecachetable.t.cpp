@@ -0,0 +1,154 @@
+// sjtu_inlinecachetable.t.cpp                                    -*-C++-*-
+
+#include <sjtu_inlinecachetable.h>
+
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <sjtm_heap.h>
+#include <sjtm_shape.h>
+#include <sjtt_bytecode.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 2: {
+        if (verbose) cout << endl
+                          << "setHeap" << endl
+                          << "=======" << endl;
+
+        // The property caches are kept only while the heap stays the same,
+        // and the call target caches are kept regardless.
+
+        bslma::TestAllocator ta;
+        sjtm::Heap           heap(&ta);
+        sjtm::Heap           otherHeap(&ta);
+        sjtt::Bytecode       target;
+        {
+            InlineCacheTable table(&ta);
+            table.setHeap(&heap);
+            table.propertyCache(1).insert(heap.emptyShape(), 0);
+            table.callCache(2).record(&target);
+
+            table.setHeap(&heap);
+            ASSERT(2 == table.numPropertyCaches());
+            ASSERT(1 == table.propertyCache(1).numEntries());
+
+            table.setHeap(&otherHeap);
+            ASSERT(0 == table.numPropertyCaches());
+            ASSERT(0 == table.propertyCache(1).numEntries());
+            ASSERT(1 == table.callCache(2).numCalls(0));
+
+            // Nothing learnt with a local heap is kept.
+
+            table.propertyCache(1).insert(otherHeap.emptyShape(), 0);
+            table.setHeap(0);
+            ASSERT(0 == table.numPropertyCaches());
+            table.propertyCache(1).insert(otherHeap.emptyShape(), 0);
+            table.setHeap(0);
+            ASSERT(0 == table.numPropertyCaches());
+            ASSERT(3 == table.numCallCaches());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing" << endl
+                          << "=========" << endl;
+
+        bslma::TestAllocator ta;
+        sjtm::Heap           heap(&ta);
+        sjtt::Bytecode       target;
+        {
+            InlineCacheTable table(&ta);
+            ASSERT(0 == table.numPropertyCaches());
+            ASSERT(0 == table.numCallCaches());
+
+            // Caches are created, uninitialized, as their sites are used.
+
+            sjtm::PropertyCache& cache = table.propertyCache(3);
+            ASSERT(4 == table.numPropertyCaches());
+            ASSERT(0 == cache.numEntries());
+            cache.insert(heap.emptyShape(), -1);
+            ASSERT(1 == table.propertyCache(3).numEntries());
+            ASSERT(0 == table.propertyCache(0).numEntries());
+            ASSERT(0 == table.numCallCaches());
+
+            table.callCache(1).record(&target);
+            table.callCache(1).record(&target);
+            ASSERT(2 == table.numCallCaches());
+            ASSERT(&target == table.callCache(1).monomorphicTarget());
+            ASSERT(2 == table.callCache(1).numCalls(0));
+            ASSERT(0 == table.callCache(0).numEntries());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}
@@ -3,29 +3,597 @@
 
 #include <bdlma_localsequentialallocator.h>
 
+#include <bsl_algorithm.h>
+#include <bsl_deque.h>
+#include <bsl_unordered_map.h>
 #include <bsl_vector.h>
 #include <bsls_assert.h>
 
+#include <sjtu_baselineutil.h>
+#include <sjtu_inlinecachetable.h>
+
 #include <sjtt_bytecode.h>
+#include <sjtt_calltargetcache.h>
+#include <sjtt_exceptiontable.h>
 #include <sjtt_executioncontext.h>
 #include <sjtd_datumudtutil.h>
+#include <sjtd_tracer.h>
+#include <sjtm_closureutil.h>
+#include <sjtm_codespace.h>
+#include <sjtm_heap.h>
+#include <sjtm_object.h>
+#include <sjtm_perfmap.h>
+#include <sjtm_propertycache.h>
+#include <sjtm_shape.h>
+#include <sjtm_typedarray.h>
+#include <sjto_compilequeue.h>
 #include <sjtt_frame.h>
 
 using namespace BloombergLP;
 
 namespace sjtu {
+namespace {
+
+const int s_InitialStackCapacity = 64;
+    // The number of values for which space is reserved on the value stack
+    // before evaluation begins.
+
+const int s_InitialFrameCapacity = 8;
+    // The number of frames for which space is reserved on the frame stack
+    // before evaluation begins.
+
+bool isBackwardJump(const sjtt::Frame& frame, int target)
+    // Return 'true' if a jump from the current code of the specified 'frame'
+    // to the code at the specified 'target' index does not go forward, and
+    // 'false' otherwise.
+{
+    return frame.firstCode() + target <= frame.pc();
+}
+
+class OsrState {
+    // This class counts the calls and backward jumps to each code, requests
+    // from a 'sjto::CompileQueue' the versions of functions compiled by
+    // 'sjto::OsrUtil' to be entered at the codes whose count reaches a
+    // threshold, and holds the inline caches of the codes of the versions
+    // installed.
+
+    // PRIVATE TYPES
+    struct Program {
+        // This 'struct' describes one installed version.
+
+        const sjtt::Bytecode *d_codes;     // held, not owned
+        int                   d_numCodes;
+        InlineCacheTable      d_caches;
+
+        explicit Program(bslma::Allocator *allocator)
+            // Create an empty version using the specified 'allocator' to
+            // supply memory.
+        : d_codes(0)
+        , d_numCodes(0)
+        , d_caches(allocator)
+        {
+        }
+    };
+
+    typedef sjto::CompileQueue::Entry Entry;
+
+    typedef bsl::unordered_map<const sjtt::Bytecode *, int>           Counts;
+    typedef bsl::unordered_map<const sjtt::Bytecode *, const Entry *> Entries;
+
+    // DATA
+    int                  d_threshold;   // 0 if no frame is replaced
+    Counts               d_counts;      // per code called or jumped to
+    Entries              d_entries;     // per entered code requested
+    bsl::deque<Program>  d_storage;     // per version installed
+    sjto::CompileQueue   d_localQueue;  // compiling on this thread
+    sjto::CompileQueue  *d_queue_p;     // held, not owned
+    bslma::Allocator    *d_allocator_p; // held, not owned
+
+    // PRIVATE MANIPULATORS
+    Program *find(const sjtt::Bytecode *code);
+        // Return the address of the installed version containing the
+        // specified 'code', or 0 if there is none.
+
+    const sjtt::Bytecode *findVersion(const sjtt::Bytecode *firstCode,
+                                      int                   target,
+                                      int                   height);
+        // Count a call or a backward jump, by a frame having the specified
+        // 'height' number of values, to the code at the specified 'target'
+        // index from the specified 'firstCode', and return the first code of
+        // the version of its function entered at that code if it is
+        // installed, requesting it if it is now hot, or 0 otherwise.
+
+  public:
+    // CREATORS
+    OsrState(int                 threshold,
+             sjto::CompileQueue *queue,
+             bslma::Allocator   *allocator);
+        // Create an object replacing a frame when a backward jump to a code
+        // is taken for the specified 'threshold'th time, and entering a
+        // callee when a call to a code is made for the 'threshold'th time,
+        // or never if 'threshold' is 0, with versions compiled by the
+        // specified 'queue', or on this thread if 'queue' is 0, using the
+        // specified 'allocator' to allocate memory.
+
+    // MANIPULATORS
+    sjtt::CallTargetCache& callCache(InlineCacheTable     *caches,
+                                     const sjtt::Bytecode *codes,
+                                     const sjtt::Bytecode *code);
+        // Return a reference providing modifiable access to the inline cache
+        // of the indirect call at the specified 'code': in the specified
+        // 'caches' of the program beginning at the specified 'codes', unless
+        // 'code' is part of a compiled version.
+
+    const sjtt::Bytecode *enter(const sjtt::Frame& caller,
+                                int                target,
+                                int                height);
+        // Count a call by the specified 'caller' to the code at the specified
+        // 'target' index, whose frame has the specified 'height' number of
+        // values, and return the first code of a version of the callee
+        // entered at that code, if one is installed, and 0 otherwise.  A
+        // call from a compiled version is not counted.
+
+    sjtm::PropertyCache& propertyCache(InlineCacheTable     *caches,
+                                       const sjtt::Bytecode *codes,
+                                       const sjtt::Bytecode *code);
+        // Return a reference providing modifiable access to the inline cache
+        // of the property access at the specified 'code': in the specified
+        // 'caches' of the program beginning at the specified 'codes', unless
+        // 'code' is part of a compiled version.
+
+    bool replace(sjtt::Frame *frame, int target, int height);
+        // Count a backward jump of the specified 'frame', having the
+        // specified 'height' number of values, to the code at the specified
+        // 'target' index, and, if a version of its function entered at that
+        // code is installed, continue 'frame' in it and return 'true';
+        // otherwise, return 'false'.  A frame already evaluating a compiled
+        // version is not replaced.
+};
+
+                               // --------------
+                               // class OsrState
+                               // --------------
+
+// PRIVATE MANIPULATORS
+OsrState::Program *OsrState::find(const sjtt::Bytecode *code)
+{
+    for (bsl::size_t i = 0; i < d_storage.size(); ++i) {
+        const Program& program = d_storage[i];
+        if (program.d_codes <= code &&
+            code < program.d_codes + program.d_numCodes) {
+            return &d_storage[i];                                     // RETURN
+        }
+    }
+    return 0;
+}
+
+const sjtt::Bytecode *OsrState::findVersion(const sjtt::Bytecode *firstCode,
+                                            int                   target,
+                                            int                   height)
+{
+    const sjtt::Bytecode *header = firstCode + target;
+    Entries::iterator     it     = d_entries.find(header);
+    if (d_entries.end() == it) {
+        if (++d_counts[header] < d_threshold) {
+            return 0;                                                 // RETURN
+        }
+        it = d_entries.insert(bsl::make_pair(
+                                header,
+                                d_queue_p->request(firstCode, target, height)))
+                 .first;
+    }
+
+    // The entry is polled without a lock; once a version is installed, its
+    // codes are complete.
+
+    const Entry           *entry = it->second;
+    const sjtt::Bytecode  *codes = entry->codes();
+    if (0 == codes || height != entry->height()) {
+        return 0;                                                     // RETURN
+    }
+    if (0 == find(codes)) {
+        d_storage.emplace_back(d_allocator_p);
+        d_storage.back().d_codes    = codes;
+        d_storage.back().d_numCodes = entry->numCodes();
+    }
+    return codes;
+}
+
+// CREATORS
+OsrState::OsrState(int                 threshold,
+                   sjto::CompileQueue *queue,
+                   bslma::Allocator   *allocator)
+: d_threshold(threshold)
+, d_counts(allocator)
+, d_entries(allocator)
+, d_storage(allocator)
+, d_localQueue(0, allocator)
+, d_queue_p(0 == queue ? &d_localQueue : queue)
+, d_allocator_p(allocator)
+{
+    BSLS_ASSERT(0 <= threshold);
+}
+
+// MANIPULATORS
+sjtt::CallTargetCache& OsrState::callCache(InlineCacheTable     *caches,
+                                           const sjtt::Bytecode *codes,
+                                           const sjtt::Bytecode *code)
+{
+    Program *program = d_storage.empty() ? 0 : find(code);
+    return 0 == program
+           ? caches->callCache(static_cast<int>(code - codes))
+           : program->d_caches.callCache(
+                                 static_cast<int>(code - program->d_codes));
+}
+
+const sjtt::Bytecode *OsrState::enter(const sjtt::Frame& caller,
+                                      int                target,
+                                      int                height)
+{
+    if (0 == d_threshold || 0 != find(caller.pc())) {
+        return 0;                                                     // RETURN
+    }
+    return findVersion(caller.firstCode(), target, height);
+}
+
+sjtm::PropertyCache& OsrState::propertyCache(InlineCacheTable     *caches,
+                                             const sjtt::Bytecode *codes,
+                                             const sjtt::Bytecode *code)
+{
+    Program *program = d_storage.empty() ? 0 : find(code);
+    return 0 == program
+           ? caches->propertyCache(static_cast<int>(code - codes))
+           : program->d_caches.propertyCache(
+                                 static_cast<int>(code - program->d_codes));
+}
+
+bool OsrState::replace(sjtt::Frame *frame, int target, int height)
+{
+    if (0 == d_threshold || 0 != find(frame->pc())) {
+        return false;                                                 // RETURN
+    }
+
+    // The frame's values stay in place; only where its codes come from
+    // changes.
+
+    const sjtt::Bytecode *entry = findVersion(frame->firstCode(),
+                                              target,
+                                              height);
+    if (0 == entry) {
+        return false;                                                 // RETURN
+    }
+    *frame = sjtt::Frame(frame->bottom(), entry, entry, frame->hasCallee());
+    return true;
+}
+
+class BaselineState {
+    // This class counts the calls to each code, and compiles, with
+    // 'BaselineUtil', into machine code in a code space of its own where
+    // supported, the functions called at the codes whose count reaches a
+    // threshold, recording their machine code in a perf map if any.
+
+    // PRIVATE TYPES
+    typedef bsl::unordered_map<const sjtt::Bytecode *, int> Counts;
+    typedef bsl::unordered_map<const sjtt::Bytecode *,
+                               const BaselineUtil::Code *>  Functions;
+
+    // DATA
+    int                            d_threshold;   // 0 if nothing is compiled
+    Counts                         d_counts;      // per code called
+    Functions                      d_functions;   // per hot code called; 0
+                                                  // if not compiled
+    sjtm::CodeSpace                d_space;       // of the machine code
+    bsl::deque<BaselineUtil::Code> d_storage;     // per function compiled
+    sjtm::PerfMap                 *d_perfMap_p;   // held, not owned, or 0
+    bslma::Allocator              *d_allocator_p; // held, not owned
+
+  public:
+    // CREATORS
+    BaselineState(int               threshold,
+                  sjtm::PerfMap    *perfMap,
+                  bslma::Allocator *allocator);
+        // Create an object compiling the function called at a code when a
+        // call to it is made for the specified 'threshold'th time, or never
+        // if 'threshold' is 0, recording its machine code in the specified
+        // 'perfMap' unless it is 0, and using the specified 'allocator' to
+        // allocate memory.
+
+    // MANIPULATORS
+    const BaselineUtil::Code *enter(const sjtt::Frame& caller, int target);
+        // Count a call by the specified 'caller' to the code at the
+        // specified 'target' index, and return the compiled callee if it is
+        // compiled, compiling it if it is now hot, or 0 otherwise.  A
+        // function that is not compiled once hot is not compiled again.
+};
+
+                             // -------------------
+                             // class BaselineState
+                             // -------------------
+
+// CREATORS
+BaselineState::BaselineState(int               threshold,
+                             sjtm::PerfMap    *perfMap,
+                             bslma::Allocator *allocator)
+: d_threshold(threshold)
+, d_counts(allocator)
+, d_functions(allocator)
+, d_space(sjtm::CodeSpace::s_SlabSize, allocator)
+, d_storage(allocator)
+, d_perfMap_p(perfMap)
+, d_allocator_p(allocator)
+{
+    BSLS_ASSERT(0 <= threshold);
+}
+
+// MANIPULATORS
+const BaselineUtil::Code *BaselineState::enter(const sjtt::Frame& caller,
+                                               int                target)
+{
+    if (0 == d_threshold) {
+        return 0;                                                     // RETURN
+    }
+    const sjtt::Bytecode *callee = caller.firstCode() + target;
+    Functions::iterator   it     = d_functions.find(callee);
+    if (d_functions.end() != it) {
+        return it->second;                                            // RETURN
+    }
+    if (++d_counts[callee] < d_threshold) {
+        return 0;                                                     // RETURN
+    }
+    d_storage.emplace_back(d_allocator_p);
+    BaselineUtil::Code *code = &d_storage.back();
+    if (0 != BaselineUtil::compile(code,
+                                   caller.firstCode(),
+                                   target,
+                                   &d_space)) {
+        d_storage.pop_back();
+        code = 0;
+    }
+    else if (0 != d_perfMap_p && 0 != code->nativeCode()) {
+        d_perfMap_p->add(code->nativeCode(),
+                         code->nativeSize(),
+                         sjtm::PerfMap::symbolName(bslstl::StringRef(),
+                                                   target) + " [baseline]");
+    }
+    d_functions[callee] = code;
+    return code;
+}
+
+const sjtt::Bytecode *targetOf(const bdld::Datum& callee)
+    // Return the address of the first code of the function of the specified
+    // 'callee', which is a code value or a closure.
+{
+    if (sjtd::DatumUdtUtil::isCode(callee)) {
+        return sjtd::DatumUdtUtil::getCode(callee);                   // RETURN
+    }
+    BSLS_ASSERT(sjtm::ClosureUtil::isClosure(callee));
+    return sjtm::ClosureUtil::code(sjtd::DatumUdtUtil::getObject(callee));
+}
+
+bool unwind(bsl::vector<bdld::Datum>    *stack,
+            bsl::vector<sjtt::Frame>    *frames,
+            const sjtt::Bytecode        *codes,
+            const sjtt::ExceptionTable  *handlers,
+            const bdld::Datum&           exception)
+    // Transfer control to the handler, in the specified 'handlers', of the
+    // specified 'exception' thrown by the current code of the last of the
+    // specified 'frames', evaluating the program beginning at the specified
+    // 'codes' with the specified value 'stack', and return 'true'; return
+    // 'false' if there is no such handler.  Frames whose current code is not
+    // covered by a handler are popped, with their values; the values of the
+    // frame of the handler are truncated to its depth, and 'exception' is
+    // pushed.  Note that no memory is allocated from the heap, so
+    // 'exception' need not be a root.
+{
+    if (0 == handlers) {
+        return false;                                                 // RETURN
+    }
+    while (!frames->empty()) {
+        sjtt::Frame&                          frame   = frames->back();
+        const sjtt::ExceptionTable::Handler *handler =
+                              handlers->findHandler(frame.pc() - codes);
+        if (0 != handler) {
+            BSLS_ASSERT(frame.bottom() + handler->d_depth <= stack->size());
+
+            stack->resize(frame.bottom() + handler->d_depth);
+            stack->push_back(exception);
+            frame.jump(handler->d_target - (frame.firstCode() - codes));
+            return true;                                              // RETURN
+        }
+        stack->erase(stack->begin() + frame.bottom()
+                                    - (frame.hasCallee() ? 1 : 0),
+                     stack->end());
+        frames->pop_back();
+    }
+    return false;
+}
+}
 
 bdld::Datum
 InterpretUtil::interpretBytecode(Allocator            *allocator,
                                  const sjtt::Bytecode *codes) {
+    return interpretBytecodeLocal<s_DefaultLocalBufferSize>(allocator, codes);
+}
+
+bdld::Datum
+InterpretUtil::interpretBytecode(Allocator            *allocator,
+                                 const sjtt::Bytecode *codes,
+                                 Allocator            *scratchAllocator,
+                                 sjtm::Heap           *heap) {
+    return interpretBytecode(allocator, codes, 0, 0, scratchAllocator, heap);
+}
+
+bdld::Datum
+InterpretUtil::interpretBytecode(Allocator            *allocator,
+                                 const sjtt::Bytecode *codes,
+                                 const Datum          *arguments,
+                                 int                   numArguments,
+                                 Allocator            *scratchAllocator,
+                                 sjtm::Heap           *heap,
+                                 InlineCacheTable     *caches) {
+    Datum     result;
+    const int rc = interpretBytecode(&result,
+                                     allocator,
+                                     codes,
+                                     0,
+                                     arguments,
+                                     numArguments,
+                                     scratchAllocator,
+                                     heap,
+                                     0,
+                                     0,
+                                     0,
+                                     caches);
+    BSLS_ASSERT(0 == rc);
+    (void)rc;
+    return result;
+}
+
+int
+InterpretUtil::interpretBytecode(Datum                      *result,
+                                 Allocator                  *allocator,
+                                 const sjtt::Bytecode       *codes,
+                                 const sjtt::ExceptionTable *handlers,
+                                 const Datum                *arguments,
+                                 int                         numArguments,
+                                 Allocator                  *scratchAllocator,
+                                 sjtm::Heap                 *heap,
+                                 int                         osrThreshold,
+                                 sjto::CompileQueue         *compiler,
+                                 int                         baselineThreshold,
+                                 InlineCacheTable           *caches,
+                                 sjtm::PerfMap              *perfMap)
+{
+    BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(0 <= numArguments);
+
+    // The arguments are padded as 'e_Call' pads them, which the stack built
+    // by 'resumeBytecode' is not.
+
+    const bsl::vector<sjtt::Frame> frames(1,
+                                          sjtt::Frame(0, codes, codes),
+                                          scratchAllocator);
+    if (numArguments < sjtt::Bytecode::s_MinInitialStackSize) {
+        bsl::vector<Datum> values(arguments,
+                                  arguments + numArguments,
+                                  scratchAllocator);
+        values.resize(sjtt::Bytecode::s_MinInitialStackSize,
+                      sjtd::DatumUdtUtil::s_Undefined);
+        return resumeBytecode(result,
+                              allocator,
+                              codes,
+                              handlers,
+                              frames,
+                              values.data(),
+                              static_cast<int>(values.size()),
+                              scratchAllocator,
+                              heap,
+                              osrThreshold,
+                              compiler,
+                              baselineThreshold,
+                              caches,
+                              perfMap);                               // RETURN
+    }
+    return resumeBytecode(result,
+                          allocator,
+                          codes,
+                          handlers,
+                          frames,
+                          arguments,
+                          numArguments,
+                          scratchAllocator,
+                          heap,
+                          osrThreshold,
+                          compiler,
+                          baselineThreshold,
+                          caches,
+                          perfMap);
+}
+
+int InterpretUtil::resumeBytecode(
+                            Datum                           *result,
+                            Allocator                       *allocator,
+                            const sjtt::Bytecode            *codes,
+                            const sjtt::ExceptionTable      *handlers,
+                            const bsl::vector<sjtt::Frame>&  activeFrames,
+                            const Datum                     *values,
+                            int                              numValues,
+                            Allocator                       *scratchAllocator,
+                            sjtm::Heap                      *heap,
+                            int                              osrThreshold,
+                            sjto::CompileQueue              *compiler,
+                            int                              baselineThreshold,
+                            InlineCacheTable                *caches,
+                            sjtm::PerfMap                   *perfMap)
+{
+    BSLS_ASSERT(0 != result);
     BSLS_ASSERT(0 != allocator);
     BSLS_ASSERT(0 != codes);
+    BSLS_ASSERT(!activeFrames.empty());
+    BSLS_ASSERT(0 <= numValues);
+    BSLS_ASSERT(activeFrames.back().bottom() <= numValues);
+    BSLS_ASSERT(0 != scratchAllocator);
+    BSLS_ASSERT(0 <= osrThreshold);
+    BSLS_ASSERT(0 <= baselineThreshold);
 
-    bsl::vector<Datum> stack(sjtt::Bytecode::s_MinInitialStackSize,
-                             sjtd::DatumUdtUtil::s_Undefined);
-    bsl::vector<sjtt::Frame> frames;
-    frames.emplace_back(0, codes, codes);
+    SJTD_TRACER_SCOPE("interpret", "resumeBytecode");
+
+    // The stacks and the results and temporaries of external functions are
+    // allocated from 'scratchAllocator', which is released wholesale after
+    // evaluation; only the final result is copied into 'allocator'.
+    // Reserving the stacks up front keeps short scripts from reallocating
+    // them.
+
+    bsl::vector<Datum> stack(scratchAllocator);
+    stack.reserve(bsl::max(s_InitialStackCapacity, numValues));
+    stack.assign(values, values + numValues);
+    bsl::vector<sjtt::Frame> frames(scratchAllocator);
+    frames.reserve(bsl::max(s_InitialFrameCapacity,
+                            static_cast<int>(activeFrames.size())));
+    frames.assign(activeFrames.begin(), activeFrames.end());
     sjtt::Frame *frame = &frames.back();
+
+    // The value stack is the root set of the heap; note that a local heap
+    // allocates no memory unless an object is created.  Backward jumps and
+    // calls are safe points, at which the heap may do a bounded amount of
+    // collection work.
+
+    sjtm::Heap localHeap(scratchAllocator);
+    if (0 == heap) {
+        heap = &localHeap;
+    }
+    sjtm::HeapRootGuard rootGuard(heap, &stack);
+
+    // Every property access has an inline cache, which maps the shapes of the
+    // objects it has seen to the index of the property, so that an access
+    // to an object of a known shape does not look up the property by name.
+    // Every indirect call has an inline cache too, recording the targets it
+    // has called for the benefit of a compiler.  The caches of 'codes' are
+    // kept in 'caches', if given, for later evaluations; the shapes in the
+    // property caches belong to 'heap', so those are dropped with it.
+
+    InlineCacheTable localCaches(scratchAllocator);
+    if (0 == caches) {
+        caches = &localCaches;
+    }
+    caches->setHeap(&localHeap == heap ? 0 : heap);
+
+    // A frame whose backward jumps to a code become hot continues in a
+    // version of its function optimized to be entered at that code, and a
+    // call to a hot code is evaluated in such a version.  The ranges of
+    // 'handlers' would not cover that version, so a program having exception
+    // handlers is never replaced.
+
+    OsrState osr(0 == handlers ? osrThreshold : 0,
+                 compiler,
+                 scratchAllocator);
+
+    // A call to a hot code not entered in such a version is evaluated in the
+    // code compiled by 'BaselineUtil' for the function called, if it can be,
+    // which neither allocates objects nor throws, so that nothing in it is a
+    // safe point or is covered by 'handlers'.
+
+    BaselineState baseline(baselineThreshold, perfMap, scratchAllocator);
     while (true) {
         const sjtt::Bytecode& code = *frame->pc();
         switch (code.opcode()) {
@@ -52,6 +620,14 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
           case sjtt::Bytecode::e_Jump: {
 
             BSLS_ASSERT(code.data().isInteger());
+            if (isBackwardJump(*frame, code.data().theInteger())) {
+                heap->safePoint();
+                if (osr.replace(frame,
+                                code.data().theInteger(),
+                                stack.size() - frame->bottom())) {
+                    continue;                     // skip past normal increment
+                }
+            }
             frame->jump(code.data().theInteger());
             continue;
           } break;
@@ -64,6 +640,14 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
             const bool cond = stack.back().theBoolean();
             stack.pop_back();
             if (cond) {
+                if (isBackwardJump(*frame, code.data().theInteger())) {
+                    heap->safePoint();
+                    if (osr.replace(frame,
+                                    code.data().theInteger(),
+                                    stack.size() - frame->bottom())) {
+                        continue;                 // skip past normal increment
+                    }
+                }
                 frame->jump(code.data().theInteger());
                 continue;
             }
@@ -80,6 +664,14 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
             const bool cond = stack.back().theInteger() == first;
             stack.pop_back();
             if (cond) {
+                if (isBackwardJump(*frame, code.data().theInteger())) {
+                    heap->safePoint();
+                    if (osr.replace(frame,
+                                    code.data().theInteger(),
+                                    stack.size() - frame->bottom())) {
+                        continue;                 // skip past normal increment
+                    }
+                }
                 frame->jump(code.data().theInteger());
                 continue;
             }
@@ -137,6 +729,8 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
             BSLS_ASSERT(stack.back().isInteger());
             BSLS_ASSERT(code.data().isInteger());
 
+            heap->safePoint();
+
             const int argCount = stack.back().theInteger();
             stack.pop_back();
             const int newBottom  = stack.size() - argCount;
@@ -148,9 +742,35 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
                              numToAdd,
                              sjtd::DatumUdtUtil::s_Undefined);
             }
-            frames.emplace_back(newBottom,
-                                frame->firstCode(),
-                                frame->firstCode() + code.data().theInteger());
+            const sjtt::Bytecode *version = osr.enter(
+                                                 *frame,
+                                                 code.data().theInteger(),
+                                                 stack.size() - newBottom);
+            if (0 != version) {
+                frames.emplace_back(newBottom, version, version);
+            }
+            else if (const BaselineUtil::Code *compiled = baseline.enter(
+                                                 *frame,
+                                                 code.data().theInteger())) {
+                Datum value;
+                {
+                    SJTD_TRACER_SCOPE("interpret", "baseline");
+                    value = BaselineUtil::execute(scratchAllocator,
+                                                  *compiled,
+                                                  stack.data() + newBottom,
+                                                  stack.size() - newBottom,
+                                                  scratchAllocator);
+                }
+                stack.resize(newBottom);
+                stack.push_back(value);
+                break;
+            }
+            else {
+                frames.emplace_back(newBottom,
+                                    frame->firstCode(),
+                                    frame->firstCode()
+                                                   + code.data().theInteger());
+            }
             frame = &frames.back();
             continue;                             // skip past normal increment
           } break;
@@ -169,10 +789,25 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
             BSLS_ASSERT(stack.size() - frame->bottom() >= numArgs);
             const Datum *end = stack.end();
             const Datum *firstArg = end - numArgs;
-            const Datum result =
-                       f(sjtt::ExecutionContext(allocator, firstArg, numArgs));
+            bool  thrown = false;
+            Datum value;
+            {
+                SJTD_TRACER_SCOPE("interpret", "execute");
+                value = f(sjtt::ExecutionContext(scratchAllocator,
+                                                 firstArg,
+                                                 numArgs,
+                                                 &thrown));
+            }
             stack.erase(firstArg, end);
-            stack.push_back(result);
+            if (thrown) {
+                if (!unwind(&stack, &frames, codes, handlers, value)) {
+                    *result = value.clone(allocator);
+                    return 1;                                         // RETURN
+                }
+                frame = &frames.back();
+                continue;                         // skip past normal increment
+            }
+            stack.push_back(value);
           } break;
 
           case sjtt::Bytecode::e_Exit: {
@@ -183,7 +818,8 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
             if (1 == frames.size()) {
                 // If last frame, return the value.
 
-                return value.clone(allocator);                // RETURN
+                *result = value.clone(allocator);
+                return 0;                                             // RETURN
             }
             else {
 
@@ -192,9 +828,12 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
                 BSLS_ASSERT(stack.size() > frame->bottom());
 
                 // pop back to the bottom of the current frame; this will
-                // remove the arguments pushed on before calling
+                // remove the arguments pushed on before calling, and the
+                // callee of a function called through a value
 
-                stack.erase(stack.begin() + frame->bottom(), stack.end());
+                stack.erase(stack.begin() + frame->bottom()
+                                          - (frame->hasCallee() ? 1 : 0),
+                            stack.end());
 
                 // pop the frame and set the last one as current
 
@@ -212,6 +851,308 @@ InterpretUtil::interpretBytecode(Allocator            *allocator,
             stack.resize(frame->bottom() + code.data().theInteger(),
                          sjtd::DatumUdtUtil::s_Undefined);
           } break;
+
+          case sjtt::Bytecode::e_NewObject: {
+            BSLS_ASSERT(code.data().isInteger());
+
+            // 'allocate' may move every young object referred to by the
+            // stack, so no reference to one may be held across it.
+
+            sjtm::Object *object = heap->allocate(code.data().theInteger());
+            stack.push_back(sjtd::DatumUdtUtil::datumFromObject(object));
+          } break;
+
+          case sjtt::Bytecode::e_GetSlot: {
+            BSLS_ASSERT(code.data().isInteger());
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(sjtd::DatumUdtUtil::isObject(stack.back()));
+
+            const sjtm::Object *object =
+                                sjtd::DatumUdtUtil::getObject(stack.back());
+            stack.back() = object->slot(code.data().theInteger());
+          } break;
+
+          case sjtt::Bytecode::e_SetSlot: {
+            BSLS_ASSERT(code.data().isInteger());
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 2);
+            BSLS_ASSERT(
+                    sjtd::DatumUdtUtil::isObject(stack[stack.size() - 2]));
+
+            const Datum value = stack.back();
+            stack.pop_back();
+            heap->setSlot(sjtd::DatumUdtUtil::getObject(stack.back()),
+                          code.data().theInteger(),
+                          value);
+          } break;
+
+          case sjtt::Bytecode::e_GetProp: {
+            BSLS_ASSERT(code.data().isString());
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(sjtd::DatumUdtUtil::isObject(stack.back()));
+
+            const sjtm::Object *object =
+                                sjtd::DatumUdtUtil::getObject(stack.back());
+            sjtm::PropertyCache& cache = osr.propertyCache(caches,
+                                                            codes,
+                                                            &code);
+            int                  index;
+            sjtm::Shape         *newShape;
+            if (!cache.find(&index, &newShape, object->shape())) {
+                index = object->shape()->find(code.data().theString());
+                cache.insert(object->shape(), index);
+            }
+            stack.back() = 0 > index ? sjtd::DatumUdtUtil::s_Undefined
+                                     : object->property(index);
+          } break;
+
+          case sjtt::Bytecode::e_SetProp: {
+            BSLS_ASSERT(code.data().isString());
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 2);
+            BSLS_ASSERT(
+                    sjtd::DatumUdtUtil::isObject(stack[stack.size() - 2]));
+
+            sjtm::Object *object =
+                       sjtd::DatumUdtUtil::getObject(stack[stack.size() - 2]);
+            sjtm::Shape         *shape = object->shape();
+            sjtm::PropertyCache& cache = osr.propertyCache(caches,
+                                                            codes,
+                                                            &code);
+            int                  index;
+            sjtm::Shape         *newShape;
+            if (!cache.find(&index, &newShape, shape)) {
+                index    = shape->find(code.data().theString());
+                newShape = 0;
+                if (0 > index) {
+                    newShape = shape->addProperty(code.data().theString());
+                    index    = newShape->numProperties() - 1;
+                }
+                cache.insert(shape, index, newShape);
+            }
+
+            // Adding a property may allocate, so the value stays on the stack
+            // until it is stored.
+
+            if (0 == newShape) {
+                heap->setPropertyAt(object, index, stack.back());
+            }
+            else {
+                heap->addProperty(object, newShape, stack.back());
+            }
+            stack.pop_back();
+          } break;
+
+          case sjtt::Bytecode::e_NewTypedArray: {
+            BSLS_ASSERT(code.data().isInteger());
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(stack.back().isInteger());
+
+            const int length = stack.back().theInteger();
+            stack.pop_back();
+            sjtm::Object *array = sjtm::TypedArrayUtil::create(
+                 heap,
+                 static_cast<sjtm::TypedArrayUtil::ElementType>(
+                                                   code.data().theInteger()),
+                 length);
+            stack.push_back(sjtd::DatumUdtUtil::datumFromObject(array));
+          } break;
+
+          case sjtt::Bytecode::e_GetElement: {
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 2);
+            BSLS_ASSERT(stack.back().isInteger());
+
+            const int index = stack.back().theInteger();
+            stack.pop_back();
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+            stack.back() = sjtm::TypedArrayUtil::element(
+                           sjtd::DatumUdtUtil::getObject(stack.back()), index);
+          } break;
+
+          case sjtt::Bytecode::e_SetElement: {
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 3);
+            BSLS_ASSERT(stack[stack.size() - 2].isInteger());
+
+            // Elements are unboxed, so storing one needs no write barrier.
+
+            const Datum value = stack.back();
+            stack.pop_back();
+            const int index = stack.back().theInteger();
+            stack.pop_back();
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+            sjtm::TypedArrayUtil::setElement(
+                                  sjtd::DatumUdtUtil::getObject(stack.back()),
+                                  index,
+                                  value);
+          } break;
+
+          case sjtt::Bytecode::e_ArrayLength: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+
+            stack.back() = Datum::createInteger(sjtm::TypedArrayUtil::length(
+                                sjtd::DatumUdtUtil::getObject(stack.back())));
+          } break;
+
+          case sjtt::Bytecode::e_ArraySum: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+
+            stack.back() = sjtm::TypedArrayUtil::sum(
+                                  sjtd::DatumUdtUtil::getObject(stack.back()));
+          } break;
+
+          case sjtt::Bytecode::e_ArrayDot: {
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 2);
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(
+                                                   stack[stack.size() - 2]));
+
+            const sjtm::Object *rhs =
+                                 sjtd::DatumUdtUtil::getObject(stack.back());
+            stack.pop_back();
+            stack.back() = sjtm::TypedArrayUtil::dot(
+                             sjtd::DatumUdtUtil::getObject(stack.back()), rhs);
+          } break;
+
+          case sjtt::Bytecode::e_ArrayMin: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+
+            stack.back() = sjtm::TypedArrayUtil::min(
+                                  sjtd::DatumUdtUtil::getObject(stack.back()));
+          } break;
+
+          case sjtt::Bytecode::e_ArrayMax: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+
+            stack.back() = sjtm::TypedArrayUtil::max(
+                                  sjtd::DatumUdtUtil::getObject(stack.back()));
+          } break;
+
+          case sjtt::Bytecode::e_ArrayScale: {
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 2);
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(
+                                                   stack[stack.size() - 2]));
+
+            const Datum factor = stack.back();
+            stack.pop_back();
+            sjtm::TypedArrayUtil::scale(
+                                  sjtd::DatumUdtUtil::getObject(stack.back()),
+                                  factor);
+          } break;
+
+          case sjtt::Bytecode::e_ArrayAdd: {
+            BSLS_ASSERT(stack.size() - frame->bottom() >= 2);
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(stack.back()));
+            BSLS_ASSERT(sjtm::TypedArrayUtil::isTypedArray(
+                                                   stack[stack.size() - 2]));
+
+            const sjtm::Object *values =
+                                 sjtd::DatumUdtUtil::getObject(stack.back());
+            stack.pop_back();
+            sjtm::TypedArrayUtil::add(
+                                  sjtd::DatumUdtUtil::getObject(stack.back()),
+                                  values);
+          } break;
+
+          case sjtt::Bytecode::e_PushCode: {
+            BSLS_ASSERT(code.data().isInteger());
+
+            stack.push_back(sjtd::DatumUdtUtil::datumFromCode(
+                              frame->firstCode() + code.data().theInteger()));
+          } break;
+
+          case sjtt::Bytecode::e_MakeClosure: {
+            BSLS_ASSERT(code.data().isInteger());
+
+            const int numCaptured = code.data().theInteger();
+            BSLS_ASSERT(stack.size() - frame->bottom() > numCaptured);
+
+            // The captured values stay on the stack, where the heap updates
+            // them, until they are copied into the allocated closure.
+
+            const int     first   = stack.size() - numCaptured;
+            sjtm::Object *closure = sjtm::ClosureUtil::create(
+                                                          heap,
+                                                          stack[first - 1],
+                                                          &stack[first],
+                                                          numCaptured);
+            stack.erase(stack.begin() + first, stack.end());
+            stack.back() = sjtd::DatumUdtUtil::datumFromObject(closure);
+          } break;
+
+          case sjtt::Bytecode::e_LoadCaptured: {
+            BSLS_ASSERT(code.data().isInteger());
+            BSLS_ASSERT(frame->hasCallee());
+
+            const Datum value = sjtm::ClosureUtil::captured(
+                   sjtd::DatumUdtUtil::getObject(stack[frame->bottom() - 1]),
+                   code.data().theInteger());
+            stack.push_back(value);
+          } break;
+
+          case sjtt::Bytecode::e_CallValue: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(stack.back().isInteger());
+
+            heap->safePoint();
+
+            const int argCount = stack.back().theInteger();
+            stack.pop_back();
+            BSLS_ASSERT(stack.size() - argCount > frame->bottom());
+            const int newBottom = stack.size() - argCount;
+            const sjtt::Bytecode *target = targetOf(stack[newBottom - 1]);
+            osr.callCache(caches, codes, &code).record(target);
+            const int numToAdd =
+                              sjtt::Bytecode::s_MinInitialStackSize - argCount;
+            if (0 < numToAdd) {
+                stack.insert(stack.end(),
+                             numToAdd,
+                             sjtd::DatumUdtUtil::s_Undefined);
+            }
+            frames.emplace_back(newBottom, target, target, true);
+            frame = &frames.back();
+            continue;                             // skip past normal increment
+          } break;
+
+          case sjtt::Bytecode::e_TailCall: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+            BSLS_ASSERT(stack.back().isInteger());
+            BSLS_ASSERT(code.data().isInteger());
+
+            heap->safePoint();
+
+            // Move the arguments down over the values of the current frame,
+            // then pad them as 'e_Call' does.
+
+            const int argCount = stack.back().theInteger();
+            stack.pop_back();
+            BSLS_ASSERT(stack.size() - argCount >= frame->bottom());
+            bsl::copy(stack.end() - argCount,
+                      stack.end(),
+                      stack.begin() + frame->bottom());
+            stack.resize(frame->bottom() + argCount);
+            if (argCount < sjtt::Bytecode::s_MinInitialStackSize) {
+                stack.resize(frame->bottom() +
+                                         sjtt::Bytecode::s_MinInitialStackSize,
+                             sjtd::DatumUdtUtil::s_Undefined);
+            }
+            frame->jump(code.data().theInteger());
+            continue;                             // skip past normal increment
+          } break;
+
+          case sjtt::Bytecode::e_Throw: {
+            BSLS_ASSERT(stack.size() > frame->bottom());
+
+            const Datum exception = stack.back();
+            stack.pop_back();
+            if (!unwind(&stack, &frames, codes, handlers, exception)) {
+                *result = exception.clone(allocator);
+                return 1;                                             // RETURN
+            }
+            frame = &frames.back();
+            continue;                             // skip past normal increment
+          } break;
         }
         frame->incrementPc();
     }
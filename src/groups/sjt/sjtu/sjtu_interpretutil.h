@@ -3,15 +3,36 @@
 #ifndef INCLUDED_SJTU_INTERPRETUTIL
 #define INCLUDED_SJTU_INTERPRETUTIL
 
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BDLMA_LOCALSEQUENTIALALLOCATOR
+#include <bdlma_localsequentialallocator.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_SJTT_FRAME
+#include <sjtt_frame.h>
+#endif
+
 namespace BloombergLP {
-namespace bdld  { class Datum; }
 namespace bslma { class Allocator; }
 }
 
+namespace sjtm { class Heap; }
+namespace sjtm { class PerfMap; }
+namespace sjto { class CompileQueue; }
 namespace sjtt { class Bytecode; }
+namespace sjtt { class ExceptionTable; }
 
 namespace sjtu {
 
+class InlineCacheTable;
+
 struct InterpretUtil {
     // This is class provides a namespace for functions to interpret Scramjet
     // bytecode.
@@ -20,6 +41,19 @@ struct InterpretUtil {
     typedef BloombergLP::bdld::Datum Datum;
     typedef BloombergLP::bslma::Allocator Allocator;
 
+    static const int s_DefaultLocalBufferSize = 4096;
+        // The number of bytes of the program stack used by
+        // 'interpretBytecode' before it allocates from the heap.
+
+    static const int s_DefaultOsrThreshold = 1000;
+        // A typical number of calls or backward jumps to the same code after
+        // which a frame continues in a version of its function optimized by
+        // 'sjto::OsrUtil'.
+
+    static const int s_DefaultBaselineThreshold = 100;
+        // A typical number of calls to the same code after which the
+        // function called is compiled by 'BaselineUtil'.
+
     // CLASS METHODS
     static Datum interpretBytecode(Allocator            *allocator,
                                    const sjtt::Bytecode *codes);
@@ -28,8 +62,167 @@ struct InterpretUtil {
         // allocate memory.  The behavior is undefined if the codes cannot be
         // evaluated e.g., if the interpreter is directed to execute a
         // non-function, or the interpreter would be directed to execute a code
-        // at an index not within the range of valid codes.
+        // at an index not within the range of valid codes.  Note that
+        // external functions are passed an allocator whose memory is released
+        // when evaluation completes, and the returned value is a deep copy
+        // allocated from 'allocator'.  Also note that this function is
+        // equivalent to 'interpretBytecodeLocal<s_DefaultLocalBufferSize>'
+        // and so allocates objects from a heap local to the evaluation.
+
+    static Datum interpretBytecode(Allocator            *allocator,
+                                   const sjtt::Bytecode *codes,
+                                   Allocator            *scratchAllocator,
+                                   sjtm::Heap           *heap = 0);
+        // Evaluate the specified byte 'codes' as above, allocating the
+        // returned value from the specified 'allocator', and the value stack,
+        // the frame stack and the memory passed to external functions from
+        // the specified 'scratchAllocator'.  Optionally specify a 'heap' from
+        // which objects are allocated, and whose roots include the value
+        // stack during evaluation; if 'heap' is 0, objects are allocated from
+        // a heap local to the evaluation, so an object must not be returned.
+        // Note that memory obtained from 'scratchAllocator' is not released
+        // individually, so 'scratchAllocator' is typically a sequential
+        // allocator that is released after evaluation.
+
+    static Datum interpretBytecode(Allocator            *allocator,
+                                   const sjtt::Bytecode *codes,
+                                   const Datum          *arguments,
+                                   int                   numArguments,
+                                   Allocator            *scratchAllocator,
+                                   sjtm::Heap           *heap = 0,
+                                   InlineCacheTable     *caches = 0);
+        // Evaluate the specified byte 'codes' as above, as a function called
+        // with the specified 'numArguments' 'arguments', i.e., with the value
+        // stack initially holding 'arguments' followed by enough
+        // 'DatumUdtUtil::s_Undefined' values that it has at least
+        // 'sjtt::Bytecode::s_MinInitialStackSize' elements.  Optionally
+        // specify the 'caches' of 'codes', in which the inline caches of its
+        // property accesses and indirect calls are kept for later
+        // evaluations; if 'caches' is 0, the caches are local to the
+        // evaluation.  The behavior is undefined unless '0 <= numArguments',
+        // 'caches', if not 0, is used only with 'codes', and no exception is
+        // thrown.
+
+    static int interpretBytecode(
+                            Datum                      *result,
+                            Allocator                  *allocator,
+                            const sjtt::Bytecode       *codes,
+                            const sjtt::ExceptionTable *handlers,
+                            const Datum                *arguments,
+                            int                         numArguments,
+                            Allocator                  *scratchAllocator,
+                            sjtm::Heap                 *heap = 0,
+                            int                         osrThreshold = 0,
+                            sjto::CompileQueue         *compiler = 0,
+                            int                         baselineThreshold = 0,
+                            InlineCacheTable           *caches = 0,
+                            sjtm::PerfMap              *perfMap = 0);
+        // Evaluate the specified byte 'codes' as above, handling exceptions
+        // with the specified 'handlers'.  Load into the specified 'result'
+        // the value returned and return 0, or, if an exception is thrown and
+        // not handled, load into 'result' the value thrown and return a
+        // non-zero value.  If 'handlers' is 0, no exception is handled.
+        // 'result' is allocated from 'allocator' either way.  When an
+        // exception is thrown, by 'sjtt::Bytecode::e_Throw' or by an external
+        // function, the frames are searched, from the current one outward,
+        // for the first whose current code is covered by a handler; the
+        // frames above it are popped, its values are truncated to the depth
+        // of the handler, the exception is pushed, and evaluation continues
+        // at the handler.  Note that 'handlers' is consulted only when an
+        // exception is thrown.  Optionally specify a positive 'osrThreshold'
+        // to replace, by on-stack replacement, a frame that jumps backward to
+        // the same code that number of times with a frame evaluating a
+        // version of its function compiled by 'sjto::OsrUtil' to be entered
+        // at that code, with the values of the frame kept in place, and to
+        // evaluate a call to the same code that number of times in such a
+        // version; the version is compiled once per code and number of
+        // values, and its frames are not replaced again.  If 'osrThreshold'
+        // is 0, or 'handlers' is not 0, no frame is replaced.  Optionally
+        // specify a 'compiler' that compiles the versions, possibly on
+        // background threads, in which case evaluation continues in the
+        // original codes until a version is installed, and enters it at the
+        // first call or backward jump to its code after that; if 'compiler'
+        // is 0, the versions are compiled on this thread, when requested.
+        // Optionally specify a positive 'baselineThreshold' to compile, with
+        // 'BaselineUtil', into machine code where supported, a function
+        // called that number of times from the same frames' codes, and to
+        // evaluate each later call to it, not entered in such a version, in
+        // the code compiled; a function that 'BaselineUtil' does not compile
+        // is interpreted.  If 'baselineThreshold' is 0, nothing is so
+        // compiled.  Optionally specify the 'caches' of 'codes', as above;
+        // the caches of the versions compiled are local to the evaluation.
+        // Optionally specify a 'perfMap' in which the machine code of each
+        // function so compiled is recorded, under the name
+        // 'sjtm::PerfMap::symbolName' gives the index of its first code in
+        // the codes of the calling frame followed by ' [baseline]', e.g.,
+        // 'sjt::4 [baseline]'.  The behavior is undefined unless
+        // '0 <= osrThreshold', '0 <= baselineThreshold', 'compiler' and
+        // 'perfMap', if not 0, outlive the evaluation, and 'caches', if not
+        // 0, is used only with 'codes'.
+
+    static int resumeBytecode(
+                       Datum                           *result,
+                       Allocator                       *allocator,
+                       const sjtt::Bytecode            *codes,
+                       const sjtt::ExceptionTable      *handlers,
+                       const bsl::vector<sjtt::Frame>&  activeFrames,
+                       const Datum                     *values,
+                       int                              numValues,
+                       Allocator                       *scratchAllocator,
+                       sjtm::Heap                      *heap = 0,
+                       int                              osrThreshold = 0,
+                       sjto::CompileQueue              *compiler = 0,
+                       int                              baselineThreshold = 0,
+                       InlineCacheTable                *caches = 0,
+                       sjtm::PerfMap                   *perfMap = 0);
+        // Continue evaluating the specified byte 'codes' as above from the
+        // specified 'activeFrames', outermost first, whose stack holds the
+        // specified 'numValues' 'values', e.g., the frames rebuilt by an
+        // 'sjtt::DeoptTable' for a frame deoptimized out of optimized code,
+        // evaluating the next code of the innermost frame first.  The
+        // behavior is undefined unless 'activeFrames' is not empty, its
+        // frames evaluate 'codes' and are ordered by their bottoms, the
+        // bottom of its innermost frame is at most 'numValues', the objects
+        // of 'values' are allocated from 'heap', '0 <= osrThreshold',
+        // '0 <= baselineThreshold', 'compiler' and 'perfMap', if not 0,
+        // outlive the evaluation, and 'caches', if not 0, is used only with
+        // 'codes'.
+        // Note that 'values' are copied, and are not padded: a frame that has
+        // fewer values than its codes access must not be resumed.
+
+    template <int BUFFER_SIZE>
+    static Datum interpretBytecodeLocal(Allocator            *allocator,
+                                        const sjtt::Bytecode *codes,
+                                        sjtm::Heap           *heap = 0);
+        // Evaluate the specified byte 'codes' as above, allocating the
+        // returned value from the specified 'allocator', objects from the
+        // optionally specified 'heap', and all other memory from a buffer of
+        // 'BUFFER_SIZE' bytes on the program stack, spilling to 'allocator'
+        // only if that buffer is exhausted.  Note that, if the buffer is not
+        // exhausted and the result does not need to allocate memory,
+        // evaluation allocates no memory from the heap.
 };
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                            // --------------------
+                            // struct InterpretUtil
+                            // --------------------
+
+// CLASS METHODS
+template <int BUFFER_SIZE>
+inline
+BloombergLP::bdld::Datum
+InterpretUtil::interpretBytecodeLocal(Allocator            *allocator,
+                                      const sjtt::Bytecode *codes,
+                                      sjtm::Heap           *heap)
+{
+    BloombergLP::bdlma::LocalSequentialAllocator<BUFFER_SIZE> scratch(
+                                                                    allocator);
+    return interpretBytecode(allocator, codes, &scratch, heap);
+}
 }
 
 #endif
@@ -5,12 +5,31 @@
 #include <bdlma_sequentialallocator.h>
 #include <bdls_testutil.h>
 
+#include <bslma_defaultallocatorguard.h>
+#include <bslma_testallocator.h>
+
+#include <bsl_algorithm.h>
+#include <bsl_cstring.h>
 #include <bsl_vector.h>
 
 #include <sjtd_datumfactory.h>
+#include <sjtd_datumudtutil.h>
+#include <sjtd_tracer.h>
+#include <sjtm_heap.h>
+#include <sjto_compilequeue.h>
+#include <sjto_constantfoldutil.h>
+#include <sjto_inlineutil.h>
+#include <sjto_looputil.h>
+#include <sjto_peepholeutil.h>
+#include <sjto_ssafunction.h>
+#include <sjto_ssautil.h>
 #include <sjtt_bytecode.h>
+#include <sjtt_deopttable.h>
+#include <sjtt_exceptiontable.h>
 #include <sjtt_executioncontext.h>
+#include <sjtt_frame.h>
 #include <sjtu_bytecodedslutil.h>
+#include <sjtu_inlinecachetable.h>
 #include <sjtu_interpretutil.h>
 
 using namespace BloombergLP;
@@ -71,19 +90,1295 @@ namespace {
         }
         return bdld::Datum::createDouble(result);
     }
+
+    bdld::Datum testRepeat(const sjtt::ExecutionContext& context) {
+        // Return a string containing 'x' repeated as many times as the
+        // integer argument, allocated from the context's allocator.
+
+        const bsl::string s(context.args()[0].theInteger(), 'x');
+        return bdld::Datum::copyString(s.data(),
+                                       s.length(),
+                                       context.allocator());
+    }
+
+    bdld::Datum testFail(const sjtt::ExecutionContext& context) {
+        // Throw the argument.
+
+        return context.throwException(context.args()[0]);
+    }
 }
 
 // ============================================================================
-//                               MAIN PROGRAM
+//                  GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
 // ----------------------------------------------------------------------------
 
-int main(int argc, char *argv[])
+namespace {
+
+bool isOptimizing = false;
+    // Whether 'readDSL' optimizes the programs it reads.
+
+int readDSL(bsl::vector<sjtt::Bytecode>                      *code,
+            bsl::string                                      *errorMessage,
+            const bsl::string&                                dsl,
+            const BytecodeDSLUtil::FunctionNameToAddressMap&  functions)
+    // Load into the specified 'code' the program written in the specified
+    // 'dsl', calling the specified 'functions', as 'BytecodeDSLUtil::readDSL'
+    // does, and, if 'isOptimizing' is set, optimize it with 'sjto::LoopUtil'
+    // and 'sjto::ConstantFoldUtil'.  Return 0 on success, and a non-zero
+    // value, with a description loaded into the specified 'errorMessage',
+    // otherwise.
 {
-    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const int ret = BytecodeDSLUtil::readDSL(code,
+                                             errorMessage,
+                                             dsl,
+                                             functions);
+    if (0 == ret && isOptimizing) {
+        sjto::LoopUtil::optimize(code);
+        sjto::ConstantFoldUtil::optimize(code);
+    }
+    return ret;
+}
 
-    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+void runTestCase(int test)
+    // Run the specified 'test' case.  Cases 1 to 9 read their programs with
+    // 'readDSL', so test the optimized programs if 'isOptimizing' is set.
+{
 
     switch (test) { case 0:
+      case 18: {
+        // The inline caches of a program, kept in a table alongside it, are
+        // reused by later evaluations allocating objects from the same heap.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // Call a function with an object 'o' with 'o.x == 5', returning
+        // 'o.x'.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        const int ret = BytecodeDSLUtil::readDSL(
+                      &code,
+                      &errorMessage,
+                      "F7|N1|Pi5|.=x|Pi1|@|X|"                  // 0
+                      "L0|.x|X",                                // 7
+                      functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+        {
+            sjtm::Heap       heap(1024, &ta);
+            InlineCacheTable caches(&ta);
+            for (int i = 1; i <= 3; ++i) {
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                &ta,
+                                                                &code[0],
+                                                                0,
+                                                                0,
+                                                                &scratch,
+                                                                &heap,
+                                                                &caches);
+                LOOP_ASSERT(i, 5 == result.theInteger());
+                LOOP_ASSERT(i, i == caches.callCache(5).numCalls(0));
+                LOOP_ASSERT(i, 1 == caches.propertyCache(3).numEntries());
+                LOOP_ASSERT(i, 1 == caches.propertyCache(8).numEntries());
+            }
+            ASSERT(1 == heap.emptyShape()->numTransitions());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 17: {
+        // Calls to a hot code are evaluated in the code compiled by
+        // 'BaselineUtil' for the function called, if it is compiled, alone
+        // or with versions compiled by 'sjto::OsrUtil', and the results are
+        // those of frames that are not.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_dsl;
+            int         d_expected;
+        } DATA[] = {
+            // The sum of '2 * i' for 'i' from 0 to 49, the double computed
+            // by a call.
+
+            { L_, "Pi0|S0|Pi0|S1|L0|Pi50|I=i15|"
+                  "L1|L0|Pi1|C17|+i|S1|++i0|J4|L1|X|"
+                  "L0|L0|+i|X",                                        2450 },
+
+            // The same, the callee creating an object, so not compiled.
+
+            { L_, "Pi0|S0|Pi0|S1|L0|Pi50|I=i15|"
+                  "L1|L0|Pi1|C17|+i|S1|++i0|J4|L1|X|"
+                  "N0|S1|L0|L0|+i|X",                                  2450 },
+
+            // The sum of 1 to 30, recursively.
+
+            { L_, "Pi30|Pi1|C4|X|L0|Pi0|I=i15|L0|Pi-1|+i|Pi1|C4|L0|+i|X|"
+                  "Pi0|X",                                              465 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        const int THRESHOLDS[] = { 0, 1, 2, 10 };
+        const int NUM_THRESHOLDS = sizeof(THRESHOLDS) / sizeof(*THRESHOLDS);
+
+        bslma::TestAllocator ta;
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            LOOP2_ASSERT(LINE,
+                         errorMessage,
+                         0 == BytecodeDSLUtil::readDSL(&code,
+                                                       &errorMessage,
+                                                       DATA[i].d_dsl,
+                                                       functions));
+
+            for (int j = 0; j < NUM_THRESHOLDS; ++j) {
+                for (int osrThreshold = 0; osrThreshold < 10;
+                                                          osrThreshold += 5) {
+                    bdlma::SequentialAllocator scratch(&ta);
+                    bdld::Datum result;
+                    const int status = InterpretUtil::interpretBytecode(
+                                                                &result,
+                                                                &ta,
+                                                                &code[0],
+                                                                0,
+                                                                0,
+                                                                0,
+                                                                &scratch,
+                                                                0,
+                                                                osrThreshold,
+                                                                0,
+                                                                THRESHOLDS[j]);
+                    LOOP3_ASSERT(LINE, j, status, 0 == status);
+                    LOOP3_ASSERT(LINE,
+                                 j,
+                                 result,
+                                 f(DATA[i].d_expected) == result);
+                    bdld::Datum::destroy(result, &ta);
+                }
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+#ifndef SJTD_TRACER_DISABLE
+        // The time spent in the compiled code is traced, so that a profile
+        // shows the calls evaluated in it: with a threshold of 1, every call
+        // of the first program, and none of the second.
+
+        for (int i = 0; i < 2; ++i) {
+            const int NUM_EXPECTED = 0 == i ? 50 : 0;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            ASSERT(0 == BytecodeDSLUtil::readDSL(&code,
+                                                 &errorMessage,
+                                                 DATA[i].d_dsl,
+                                                 functions));
+
+            sjtd::Tracer tracer(1024, &ta);
+            sjtd::Tracer::install(&tracer);
+            {
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum result;
+                ASSERT(0 == InterpretUtil::interpretBytecode(&result,
+                                                             &ta,
+                                                             &code[0],
+                                                             0,
+                                                             0,
+                                                             0,
+                                                             &scratch,
+                                                             0,
+                                                             0,
+                                                             0,
+                                                             1));
+                bdld::Datum::destroy(result, &ta);
+            }
+            sjtd::Tracer::install(0);
+
+            bsl::vector<sjtd::Tracer::Event> events;
+            tracer.events(&events);
+            int numEvaluated = 0;
+            for (bsl::size_t e = 0; e < events.size(); ++e) {
+                if (0 == bsl::strcmp("baseline", events[e].d_name_p) &&
+                    0 == bsl::strcmp("interpret", events[e].d_category_p)) {
+                    ++numEvaluated;
+                }
+            }
+            LOOP2_ASSERT(i, numEvaluated, NUM_EXPECTED == numEvaluated);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+#endif
+      } break;
+      case 16: {
+        // Calls to a hot code are evaluated in a version compiled by
+        // 'sjto::OsrUtil', as are frames jumping back to one, whether the
+        // versions are compiled on this thread or by a 'sjto::CompileQueue',
+        // on its own or on background threads, and the results are those
+        // of frames that are not.  A queue shared by several evaluations
+        // compiles each version once.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // The sum of '2 * i' for 'i' from 0 to 49, the double computed by a
+        // call.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        const int ret = readDSL(&code,
+                                &errorMessage,
+                                "Pi0|S0|Pi0|S1|L0|Pi50|I=i15|"
+                                "L1|L0|Pi1|C17|+i|S1|++i0|J4|L1|X|"
+                                "L0|L0|+i|X",
+                                functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        bslma::TestAllocator ta;
+        for (int numThreads = -1; numThreads < 3; ++numThreads) {
+            sjto::CompileQueue  queue(bsl::max(numThreads, 0), &ta);
+            sjto::CompileQueue *compiler = 0 > numThreads ? 0 : &queue;
+            for (int run = 0; run < 2; ++run) {
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum result;
+                const int status = InterpretUtil::interpretBytecode(&result,
+                                                                    &ta,
+                                                                    &code[0],
+                                                                    0,
+                                                                    0,
+                                                                    0,
+                                                                    &scratch,
+                                                                    0,
+                                                                    5,
+                                                                    compiler);
+                LOOP2_ASSERT(numThreads, status, 0 == status);
+                LOOP2_ASSERT(numThreads, result, f(2450) == result);
+                bdld::Datum::destroy(result, &ta);
+                queue.waitUntilIdle();
+            }
+            if (0 != compiler) {
+                LOOP2_ASSERT(numThreads,
+                             queue.numRequests(),
+                             0 < queue.numRequests());
+                LOOP3_ASSERT(numThreads,
+                             queue.numRequests(),
+                             queue.numInstalled(),
+                             queue.numRequests() == queue.numInstalled());
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        // A shared queue does not evaluate the versions of a program in
+        // another one read into the same memory: here, the sum for 'i' from
+        // 0 to 39.
+
+        const int   expected[] = { 2450, 1560, 2450 };
+        const char *bounds[]   = { "50", "40", "50" };
+
+        bsl::vector<bsl::vector<sjtt::Bytecode> > programs(3);
+        for (int run = 0; run < 3; ++run) {
+            const bsl::string dsl = bsl::string("Pi0|S0|Pi0|S1|L0|Pi") +
+                                    bounds[run] +
+                                    "|I=i15|"
+                                    "L1|L0|Pi1|C17|+i|S1|++i0|J4|L1|X|"
+                                    "L0|L0|+i|X";
+            LOOP_ASSERT(errorMessage,
+                        0 == BytecodeDSLUtil::readDSL(&programs[run],
+                                                      &errorMessage,
+                                                      dsl,
+                                                      functions));
+            ASSERT(programs[0].size() == programs[run].size());
+        }
+
+        bsl::vector<sjtt::Bytecode> memory(programs[0], &alloc);
+        for (int numThreads = 0; numThreads < 2; ++numThreads) {
+            sjto::CompileQueue queue(numThreads, &ta);
+            for (int run = 0; run < 3; ++run) {
+                bsl::copy(programs[run].begin(),
+                          programs[run].end(),
+                          memory.begin());
+
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum result;
+                const int status = InterpretUtil::interpretBytecode(&result,
+                                                                    &ta,
+                                                                    &memory[0],
+                                                                    0,
+                                                                    0,
+                                                                    0,
+                                                                    &scratch,
+                                                                    0,
+                                                                    5,
+                                                                    &queue);
+                LOOP2_ASSERT(run, status, 0 == status);
+                LOOP2_ASSERT(run, result, f(expected[run]) == result);
+                bdld::Datum::destroy(result, &ta);
+                queue.waitUntilIdle();
+            }
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 15: {
+        // A frame deoptimized out of a call inlined by 'sjto::InlineUtil' is
+        // rebuilt, by the points it records, as the frames of the caller and
+        // the callee, which resume evaluating the original program with the
+        // values the frame had, whatever they are.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        bsl::vector<sjtt::Bytecode> original(&alloc);
+        bsl::string errorMessage;
+        const int ret = BytecodeDSLUtil::readDSL(&original,
+                                                 &errorMessage,
+                                                 "Pi3|Pi1|C4|X|L0|Pi2|+i|X",
+                                                 functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        // The copy is 'V16|L8|Pi2|+i|S8|V9|J3', at index 8.
+
+        typedef sjto::InlineUtil Inline;
+
+        bsl::vector<sjtt::Bytecode> optimized(original, &alloc);
+        sjtt::DeoptTable            points(&alloc);
+        ASSERT(1 == Inline::inlineCalls(&optimized,
+                                        0,
+                                        Inline::s_DefaultMaxCalleeSize,
+                                        &points));
+        ASSERT(15 == optimized.size());
+
+        const int U = -1;  // an undefined value
+
+        const struct {
+            int d_line;
+            int d_index;
+            int d_numValues;
+            int d_values[18];
+            int d_expected;  // -1 if no frame is rebuilt
+        } DATA[] = {
+            // LINE  INDEX  NUM  VALUES                               EXP
+            // ----  -----  ---  -----------------------------------  ---
+            { L_,     8,     9,  { U,U,U,U,U,U,U,U, 3 },                5 },
+            { L_,     9,    16,  { U,U,U,U,U,U,U,U, 30,
+                                   U,U,U,U,U,U,U },                    32 },
+            { L_,    10,    17,  { U,U,U,U,U,U,U,U, 3,
+                                   U,U,U,U,U,U,U, 40 },                42 },
+            { L_,    11,    18,  { U,U,U,U,U,U,U,U, 3,
+                                   U,U,U,U,U,U,U, 40, 2 },             42 },
+            { L_,    12,    17,  { U,U,U,U,U,U,U,U, 3,
+                                   U,U,U,U,U,U,U, 6 },                  6 },
+            { L_,    13,     9,  { U,U,U,U,U,U,U,U, 6 },               -1 },
+            { L_,    14,     9,  { U,U,U,U,U,U,U,U, 7 },                7 },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<bdld::Datum> values(&alloc);
+            for (int j = 0; j < DATA[i].d_numValues; ++j) {
+                values.push_back(U == DATA[i].d_values[j]
+                                 ? sjtd::DatumUdtUtil::s_Undefined
+                                 : f(DATA[i].d_values[j]));
+            }
+
+            bsl::vector<sjtt::Frame> frames(&alloc);
+            frames.emplace_back(0,
+                                optimized.data(),
+                                optimized.data() + DATA[i].d_index);
+            const int rc = points.rebuild(&frames,
+                                          optimized.data(),
+                                          original.data());
+            if (0 > DATA[i].d_expected) {
+                LOOP_ASSERT(LINE, 0 != rc);
+                continue;                                           // CONTINUE
+            }
+            LOOP_ASSERT(LINE, 0 == rc);
+
+            bslma::TestAllocator ta;
+            {
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum result;
+                const int status = InterpretUtil::resumeBytecode(
+                                                     &result,
+                                                     &ta,
+                                                     original.data(),
+                                                     0,
+                                                     frames,
+                                                     values.data(),
+                                                     DATA[i].d_numValues,
+                                                     &scratch);
+                LOOP2_ASSERT(LINE, status, 0 == status);
+                LOOP3_ASSERT(LINE,
+                             DATA[i].d_expected,
+                             result,
+                             f(DATA[i].d_expected) == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 14: {
+        // Frames replaced, at a hot backward jump, by frames evaluating a
+        // version compiled by 'sjto::OsrUtil' give the same results as frames
+        // that are not, whether the loop is in the program, a called
+        // function, a code value or a closure, and whether its body calls.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            // LINE  PROGRAM                                         EXPECTED
+            // ----  ----------------------------------------------  --------
+
+            // in the program
+            { L_,    "Pi0|S1|Pi0|S2|L1|Pi100|I=i13|"
+                     "L2|L1|+i|S2|++i1|J4|L2|X",                     f(4950) },
+            { L_,    "Pi0|S0|++i0|++i0|L0|Pi40|I=i8|J2|L0|X",        f(40) },
+            { L_,    "Pi0|S0|Pi0|S1|++i1|L1|Pi3|I=i9|J4|"
+                     "++i0|L0|Pi2|I=i14|J2|L1|X",                    f(3) },
+
+            // in a called function
+            { L_,    "Pi30|Pi1|C4|X|Pi0|S1|"
+                     "L1|L0|I=i11|++i1|J6|L1|X",                     f(30) },
+
+            // in a code value, and a closure
+            { L_,    "F5|Pi25|Pi1|@|X|Pi0|S1|Pi0|S2|L1|L0|I=i13|"
+                     "L2|L1|+i|S2|++i1|J4|L2|X",                     f(300) },
+            { L_,    "F7|Pi10|Fc1|Pi5|Pi1|@|X|Pi0|S1|Pi0|S2|L1|L0|"
+                     "I=i13|L2|Lc0|+i|S2|++i1|J4|L2|X",              f(50) },
+
+            // calling a code value in the body
+            { L_,    "Pi0|S0|Pi0|S1|L0|Pi20|I=i14|F16|L1|Pi1|@|S1|"
+                     "++i0|J4|L1|X|L0|Pi2|+i|X",                     f(40) },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            bslma::TestAllocator ta;
+            for (int threshold = 0; threshold < 3; ++threshold) {
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum result;
+                const int status = InterpretUtil::interpretBytecode(&result,
+                                                                    &ta,
+                                                                    &code[0],
+                                                                    0,
+                                                                    0,
+                                                                    0,
+                                                                    &scratch,
+                                                                    0,
+                                                                    threshold);
+                LOOP3_ASSERT(LINE, threshold, status, 0 == status);
+                LOOP4_ASSERT(LINE,
+                             threshold,
+                             DATA[i].d_expected,
+                             result,
+                             DATA[i].d_expected == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 13: {
+        // Loops optimized by 'sjto::LoopUtil', then folded if 'isOptimizing'
+        // is set, give the same results as the loops they replace.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            int         d_numChanged;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            // LINE  PROGRAM                                CHANGED  EXPECTED
+            // ----  -------------------------------------  -------  --------
+
+            // unrolled by a factor, and fully
+            { L_,    "Pi0|S1|Pi0|S2|L1|Pi100|I=i13|"
+                     "L2|L1|+i|S2|++i1|J4|L2|X",            1,       f(4950) },
+            { L_,    "Pi0|S0|Pi0|S1|L1|L0|+i|S1|++i0|"
+                     "L0|Pi4|I=i13|J4|L1|X",                1,       f(6) },
+            { L_,    "Pi3|S0|L0|Pi3|I=i7|++i0|J2|L0|X",     1,       f(3) },
+
+            // invariant expressions hoisted, with a call in the body
+            { L_,    "Pi5|S2|Pi7|S3|Pi0|S1|L3|S0|L0|Pi10|I=i19|"
+                     "L1|L2|L3|+i|+i|S1|++i0|J8|L1|X",      1,       f(36) },
+            { L_,    "Pi0|S0|Pi0|S1|Pi5|S2|L0|Pi10|I=i19|"
+                     "L1|L2|L2|+i|Pi1|C21|+i|S1|++i0|J6|"
+                     "L1|X|L0|Pi1|+i|X",                    1,       f(110) },
+
+            // loops that do not count
+            { L_,    "Pi0|S0|++i0|++i0|L0|Pi4|I=i8|J2|L0|X",
+                                                            0,       f(4) },
+            { L_,    "Pi0|S0|Pi0|S1|++i1|L1|Pi3|I=i9|J4|"
+                     "++i0|L0|Pi2|I=i14|J2|L1|X",           1,       f(3) },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            bsl::vector<sjtt::Bytecode> optimized(code, &alloc);
+            const int numChanged = sjto::LoopUtil::optimize(&optimized);
+            LOOP2_ASSERT(LINE,
+                         numChanged,
+                         DATA[i].d_numChanged == numChanged);
+            if (isOptimizing) {
+                sjto::ConstantFoldUtil::optimize(&optimized);
+            }
+
+            bslma::TestAllocator ta;
+            for (int j = 0; j < 2; ++j) {
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                 &ta,
+                                                 j ? &optimized[0] : &code[0],
+                                                 &scratch);
+                LOOP4_ASSERT(LINE,
+                             j,
+                             DATA[i].d_expected,
+                             result,
+                             DATA[i].d_expected == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 12: {
+        // Calls inlined by 'sjto::InlineUtil', then folded if
+        // 'isOptimizing' is set, give the same results as the calls they
+        // replace.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            int         d_numInlined;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            // LINE  PROGRAM                                INLINED  EXPECTED
+            // ----  -------------------------------------  -------  --------
+
+            { L_,    "Pi5|Pi1|C4|X|L0|L0|+i|X",             1,       f(10) },
+            { L_,    "Pi2|Pi3|Pi2|C6|X|Pi0|L0|L1|+i|X",     1,       f(5) },
+            { L_,    "Pi7|Pi3|Pi4|Pi2|C8|+i|X|Pi0|L0|L1|+i|X",
+                                                            1,       f(14) },
+            { L_,    "Pi1|Pi1|C4|X|V1|X",                   1,       f(1) },
+
+            // a callee having branches, and whose entry follows other codes
+            { L_,    "PF|Pi1|C6|X|Pi7|X|L0|I4|Pi9|X",       1,       f(9) },
+            { L_,    "PT|Pi1|C6|X|Pi7|X|L0|I4|Pi9|X",       1,       f(7) },
+
+            // a callee making calls, inlined in turn into the caller
+            { L_,    "Pi3|Pi1|C4|X|L0|Pi1|C10|Pi1|+i|X|"
+                     "L0|L0|+i|X",                          2,       f(7) },
+
+            // calls that are not inlined, including one by a function called
+            // through a code value
+            { L_,    "F5|Pi0|@|X|X|Pi1|Pi1|C4|X|L0|X",      0,       f(1) },
+            { L_,    "Pi3|Pi1|T4|X|L0|L0|+i|X",             0,       f(6) },
+            { L_,    "Pi100|Pi0|Pi2|C5|X|"
+                     "L0|Pi0|I=i17|L0|Pi-1|+i|L1|L0|+i|"
+                     "Pi2|C5|X|L1|X",                       0,       f(5050) },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            bsl::vector<sjtt::Bytecode> inlined(code, &alloc);
+            const int numInlined = sjto::InlineUtil::inlineCalls(&inlined);
+            LOOP2_ASSERT(LINE,
+                         numInlined,
+                         DATA[i].d_numInlined == numInlined);
+            if (isOptimizing) {
+                sjto::ConstantFoldUtil::optimize(&inlined);
+            }
+
+            bslma::TestAllocator ta;
+            for (int j = 0; j < 2; ++j) {
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                 &ta,
+                                                 j ? &inlined[0] : &code[0],
+                                                 &scratch);
+                LOOP4_ASSERT(LINE,
+                             j,
+                             DATA[i].d_expected,
+                             result,
+                             DATA[i].d_expected == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 11: {
+        // A function converted to SSA form by 'sjto::SsaUtil' and lowered
+        // back to bytecode, which is jumped to in place of the original,
+        // gives the same result as the original.
+
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            int         d_entry;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            // LINE  PROGRAM                                ENTRY  EXPECTED
+            // ----  -------------------------------------  -----  --------
+
+            // straight line
+            { L_,    "Pi2|Pi3|+i|X",                        0,     f(5) },
+            { L_,    "Pi4|S0|V10|L0|X",                     0,     f(4) },
+            { L_,    "V10|L9|X",                            0,
+                                            sjtd::DatumUdtUtil::s_Undefined },
+            { L_,    "N2|Pi7|W1|G1|X",                      0,     f(7) },
+            { L_,    "Pi3|Ai|Pi1|Pi5|[=|#sum|X",            0,     f(5) },
+
+            // branches and loops
+            { L_,    "PT|I4|Pi1|X|Pi2|X",                   0,     f(2) },
+            { L_,    "Pi0|S1|PT|I6|Pi1|S1|L1|X",            0,     f(0) },
+            { L_,    "Pi0|S1|PF|I6|Pi1|S1|L1|X",            0,     f(1) },
+            { L_,    "Pi0|S1|Pi0|S2|L1|Pi100|I=i13|"
+                     "L2|L1|+i|S2|++i1|J4|L2|X",            0,     f(4950) },
+
+            // the values of two slots exchanged in a loop
+            { L_,    "Pi1|S1|Pi2|S2|Pi0|S3|L3|Pi3|I=i15|"
+                     "L1|L2|S1|S2|++i3|J6|L1|L1|+i|L2|+i|X",
+                                                            0,     f(5) },
+
+            // calls
+            { L_,    "Pi5|Pi1|C4|X|L0|L0|+i|X",             0,     f(10) },
+            { L_,    "Pi5|Pi1|C4|X|L0|L0|+i|X",             4,     f(10) },
+            { L_,    "Pi3|Pi1|T4|X|L0|L0|+i|X",             0,     f(6) },
+            { L_,    "Pi100|Pi0|Pi2|C5|X|"
+                     "L0|Pi0|I=i17|L0|Pi-1|+i|L1|L0|+i|"
+                     "Pi2|C5|X|L1|X",                       5,     f(5050) },
+            { L_,    "F6|Pi1|Fc1|Pi0|@|X|Lc0|X",            0,     f(1) },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            sjto::SsaFunction function(&alloc);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == sjto::SsaUtil::build(
+                                                             &function,
+                                                             &errorMessage,
+                                                             code,
+                                                             DATA[i].d_entry));
+
+            bsl::vector<sjtt::Bytecode> lowered(code, &alloc);
+            const int entry = sjto::SsaUtil::lower(&lowered, function);
+            lowered[DATA[i].d_entry] = sjtt::Bytecode::createOpcode(
+                                            sjtt::Bytecode::e_Jump,
+                                            bdld::Datum::createInteger(entry));
+
+            bslma::TestAllocator ta;
+            for (int j = 0; j < 2; ++j) {
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                 &ta,
+                                                 j ? &lowered[0] : &code[0],
+                                                 &scratch);
+                LOOP4_ASSERT(LINE,
+                             j,
+                             DATA[i].d_expected,
+                             result,
+                             DATA[i].d_expected == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 10: {
+        // Exceptions thrown by 'e_Throw' and by external functions are
+        // handled by the innermost covering handler of the nearest frame,
+        // with the stack truncated to the depth of the handler, and an
+        // exception that is not handled is returned with a non-zero status.
+        // The same holds once 'sjto::PeepholeUtil' has rewritten the programs
+        // given their handlers.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+        functions["fail"] = testFail;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            int         d_numHandlers;
+            int         d_handlers[2][4];   // begin, end, target, depth
+            int         d_expectedStatus;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            // LINE  PROGRAM                           HANDLERS  STAT  RESULT
+            // ----  --------------------------------  --------  ----  ------
+
+            // handled in the same frame, keeping a value
+            { L_,    "Pi1|Pi42|!|Pi0|X|Pi5|+i|X",      1,
+                                  { { 1, 4, 5, 9 } },            0,    f(47) },
+
+            // handled in the same frame, dropping a value
+            { L_,    "Pi1|Pi42|!|X|X|L8|X",            1,
+                                  { { 1, 4, 5, 8 } },            0,    f(42) },
+
+            // thrown by a callee and handled by the caller
+            { L_,    "Pi0|C6|X|Pi100|+i|X|Pi9|Pi7|!",  1,
+                                  { { 1, 2, 3, 8 } },            0,    f(107)},
+            { L_,    "Pi0|C4|X|X|Pi42|!",              1,
+                                  { { 1, 2, 3, 0 } },            0,    f(42) },
+
+            // thrown through a function called through a value
+            { L_,    "Pi1|F7|Pi0|@|X|+i|X|Pi4|!",      1,
+                                  { { 3, 4, 5, 9 } },            0,    f(5) },
+
+            // rethrown from an inner handler to an outer one
+            { L_,    "Pi1|!|X|Pi10|+i|!|X|Pi100|+i|X", 2,
+                                  { { 1, 2, 3, 8 }, { 1, 6, 7, 8 } },
+                                                                 0,    f(111)},
+
+            // thrown by an external function
+            { L_,    "Pi5|Pi1|Pefail|E|X|Pi1|+i|X",    1,
+                                  { { 3, 4, 5, 8 } },            0,    f(6) },
+
+            // not covered
+            { L_,    "Pi3|!|X",                        1,
+                                  { { 2, 3, 0, 0 } },            1,    f(3) },
+
+            // no handlers
+            { L_,    "Pi3|!",                          0, { },   1,    f(3) },
+            { L_,    "Pi5|Pi1|Pefail|E|X",             0, { },   1,    f(5) },
+
+            // not thrown
+            { L_,    "Pi3|X",                          1,
+                                  { { 0, 2, 0, 0 } },            0,    f(3) },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                     &errorMessage,
+                                                     DATA[i].d_program,
+                                                     functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            sjtt::ExceptionTable handlers(&alloc);
+            for (int j = 0; j < DATA[i].d_numHandlers; ++j) {
+                const int *h = DATA[i].d_handlers[j];
+                handlers.addHandler(h[0], h[1], h[2], h[3]);
+            }
+
+            for (int j = 0; j < 2; ++j) {
+                if (1 == j) {
+                    sjto::PeepholeUtil::optimize(&code, &handlers);
+                }
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum result;
+                const int status = InterpretUtil::interpretBytecode(
+                                                                 &result,
+                                                                 &ta,
+                                                                 &code[0],
+                                                                 &handlers,
+                                                                 0,
+                                                                 0,
+                                                                 &scratch);
+                LOOP3_ASSERT(LINE,
+                             j,
+                             status,
+                             DATA[i].d_expectedStatus == (0 != status));
+                LOOP4_ASSERT(LINE,
+                             j,
+                             DATA[i].d_expected,
+                             result,
+                             DATA[i].d_expected == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 9: {
+        // A recursive accumulator whose recursive call is a tail call runs in
+        // constant space, whether the tail call is written or found by
+        // 'sjto::PeepholeUtil', and gives the same result as with calls.
+
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // 'f(n, acc)' returns 'acc' if 'n == 0' and 'f(n - 1, acc + n)'
+        // otherwise.
+
+        const char *const PROGRAMS[] = {
+            "Pi60000|Pi0|Pi2|C5|X|"                     // 0
+            "L0|Pi0|I=i17|L0|Pi-1|+i|L1|L0|+i|"         // 5
+            "Pi2|C5|X|L1|X",                            // 14
+            "Pi60000|Pi0|Pi2|T5|X|"                     // 0
+            "L0|Pi0|I=i17|L0|Pi-1|+i|L1|L0|+i|"         // 5
+            "Pi2|T5|X|L1|X",                            // 14
+        };
+
+        for (int i = 0; i < 3; ++i) {
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = readDSL(&code,
+                                    &errorMessage,
+                                    PROGRAMS[i % 2],
+                                    functions);
+            LOOP2_ASSERT(i, errorMessage, 0 == ret);
+            if (2 == i) {
+                ASSERT(2 == sjto::PeepholeUtil::optimize(&code));
+            }
+
+            bslma::TestAllocator ta;
+            {
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                  &ta,
+                                                                  &code[0],
+                                                                  &scratch);
+                LOOP2_ASSERT(i, result, bdld::Datum::createInteger(
+                                                     1800030000) == result);
+            }
+            if (0 == i) {
+                LOOP2_ASSERT(i, ta.numBytesMax(),
+                             1024 * 1024 < ta.numBytesMax());
+            }
+            else {
+                LOOP2_ASSERT(i, ta.numBytesMax(),
+                             64 * 1024 > ta.numBytesMax());
+            }
+        }
+      } break;
+      case 8: {
+        // Functions called through code values and closures receive their
+        // arguments and captured values, jump relative to their first code,
+        // and leave the stack of the caller as a direct call does, while the
+        // allocation of other objects moves the closures.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            // code value with arguments
+            { L_, "F6|Pi2|Pi3|Pi2|@|X|L0|L1|+i|X",                  f(5)  },
+
+            // the callee is popped with the arguments
+            { L_, "Pi1|F6|Pi0|@|+i|X|Pi2|X",                        f(3)  },
+
+            // jumps are relative to the first code of the callee
+            { L_, "F5|Pi0|@|X|X|Pi1|J2|Pi7|X",                      f(7)  },
+
+            // closure capturing a value
+            { L_, "F7|Pi10|Fc1|Pi5|Pi1|@|X|Lc0|L0|+i|X",            f(15) },
+
+            // closure returned by a function, then called
+            { L_, "F8|Pi4|Pi1|@|Pi6|Pi1|@|X|F4|L0|Fc1|X|Lc0|L0|+i|X", f(10) },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = readDSL(&code,
+                                    &errorMessage,
+                                    DATA[i].d_program,
+                                    functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                  &ta,
+                                                                  &code[0]);
+            LOOP3_ASSERT(LINE,
+                         DATA[i].d_expected,
+                         result,
+                         DATA[i].d_expected == result);
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+
+        // Call, 100 times, a closure capturing an object 'o' with 'o[0] == 3'
+        // and returning 'o[0] + i', allocating garbage on each call.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        const int ret = readDSL(
+                      &code,
+                      &errorMessage,
+                      "Pi0|S0|Pi0|S1|"                          // 0
+                      "F24|N1|Pi3|W0|Fc1|S2|"                   // 4
+                      "L2|L0|Pi1|@|L1|+i|S1|"                   // 10
+                      "++i0|L0|Pi100|I=i22|J10|"                // 17
+                      "L1|X|"                                   // 22
+                      "N4|Lc0|G0|L0|+i|X",                      // 24
+                      functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+        {
+            sjtm::Heap heap(1024, &ta);
+            bdlma::SequentialAllocator scratch(&ta);
+            const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                &ta,
+                                                                &code[0],
+                                                                &scratch,
+                                                                &heap);
+            ASSERT(result.isInteger());
+            ASSERT(5250 == result.theInteger());
+            ASSERT(0 < heap.numScavenges());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 7: {
+        // Evaluating a program as a function called with arguments gives the
+        // same result as pushing the arguments first, and pads the value
+        // stack with undefined values.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        const sjtd::DatumFactory f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        const struct {
+            int         d_line;
+            const char *d_program;
+            int         d_numArguments;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            { L_, "Pi7|X",            0, f(7)   },
+            { L_, "L0|X",             1, f(3)   },
+            { L_, "L0|L1|+i|X",       2, f(7)   },
+            { L_, "L1|L0|+i|S0|L0|X", 2, f(7)   },
+            { L_, "L2|X",             2, f.u()  },
+            { L_, "L7|X",             3, f.u()  },
+            { L_, "L8|X",             9, f(99)  },
+        };
+        const int NUM_DATA = sizeof(DATA) / sizeof(*DATA);
+
+        bsl::vector<bdld::Datum> arguments(&alloc);
+        arguments.push_back(f(3));
+        arguments.push_back(f(4));
+        arguments.resize(8, f.u());
+        arguments.push_back(f(99));
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = readDSL(&code,
+                                    &errorMessage,
+                                    DATA[i].d_program,
+                                    functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+
+            {
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                      &ta,
+                                                      &code[0],
+                                                      arguments.data(),
+                                                      DATA[i].d_numArguments,
+                                                      &scratch);
+                LOOP3_ASSERT(LINE,
+                             DATA[i].d_expected,
+                             result,
+                             DATA[i].d_expected == result);
+                bdld::Datum::destroy(result, &ta);
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 6: {
+        // Typed arrays created and filled by a script, while the allocation
+        // of other objects moves them, give the expected results from the
+        // bulk operations.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // Create an array 'a' of 100 integers in local 1 and an array 'b' of
+        // 100 doubles in local 2, and set 'a[i]' and 'b[i]' to 'i'.
+
+        const bsl::string FILL =
+                      "Pi100|Ai|S1|Pi100|Ad|S2|Pi0|S0|"         // 0
+                      "L1|L0|L0|[=|S1|L2|L0|L0|[=|S2|"          // 8
+                      "N4|S3|++i0|L0|Pi100|I=i25|J8|";          // 18
+
+        const struct {
+            int         d_line;
+            const char *d_dsl;
+            bdld::Datum d_expected;
+        } DATA[] = {
+            { L_, "L1|#sum|X",            bdld::Datum::createInteger(4950) },
+            { L_, "L2|#sum|X",            bdld::Datum::createDouble(4950) },
+            { L_, "L1|L1|#dot|X",       bdld::Datum::createInteger(328350) },
+            { L_, "L2|L2|#dot|X",        bdld::Datum::createDouble(328350) },
+            { L_, "L1|#max|X",              bdld::Datum::createInteger(99) },
+            { L_, "L2|#min|X",               bdld::Datum::createDouble(0) },
+            { L_, "L2|#len|X",             bdld::Datum::createInteger(100) },
+            { L_, "L2|Pi7|[|X",              bdld::Datum::createDouble(7) },
+            { L_, "L1|Pi3|#scale|L1|#add|Pi7|[|X",
+                                              bdld::Datum::createInteger(42) },
+            { L_, "L2|Pd0.5|#scale|#sum|X",
+                                            bdld::Datum::createDouble(2475) },
+            { L_, "Pi0|Ad|#max|X",       sjtd::DatumUdtUtil::s_Undefined },
+        };
+        const int NUM_DATA = sizeof DATA / sizeof *DATA;
+
+        for (int i = 0; i < NUM_DATA; ++i) {
+            const int LINE = DATA[i].d_line;
+
+            bsl::vector<sjtt::Bytecode> code(&alloc);
+            bsl::string errorMessage;
+            const int ret = readDSL(&code,
+                                    &errorMessage,
+                                    FILL + DATA[i].d_dsl,
+                                    functions);
+            LOOP2_ASSERT(LINE, errorMessage, 0 == ret);
+            {
+                sjtm::Heap heap(4096, &ta);
+                bdlma::SequentialAllocator scratch(&ta);
+                const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                &ta,
+                                                                &code[0],
+                                                                &scratch,
+                                                                &heap);
+                LOOP2_ASSERT(LINE, result, DATA[i].d_expected == result);
+                LOOP_ASSERT(LINE, 0 < heap.numScavenges());
+            }
+            LOOP_ASSERT(LINE, 0 == ta.numBlocksInUse());
+        }
+      } break;
+      case 5: {
+        // Property accesses whose sites see objects of several shapes, as
+        // the properties are added in different orders, read and write the
+        // right properties, including after the objects are moved.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // For 'i' in '[0, 100)', create an object with 'x == i' and
+        // 'y == 1', adding 'x' first every other time, and sum 'x + y'.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        const int ret = readDSL(
+                      &code,
+                      &errorMessage,
+                      "Pi0|S0|Pi0|S1|Pi0|S3|"                   // 0
+                      "N1|S2|L3|Pi0|I=i20|"                     // 6
+                      "L2|Pi1|.=y|L0|.=x|S2|Pi0|S3|J28|"        // 11
+                      "L2|L0|.=x|Pi1|.=y|S2|Pi1|S3|"            // 20
+                      "L2|.x|L2|.y|+i|L1|+i|S1|"                // 28
+                      "++i0|L0|Pi100|I=i41|J6|"                 // 36
+                      "L1|X",                                   // 41
+                      functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        {
+            sjtm::Heap heap(1024, &ta);
+            bdlma::SequentialAllocator scratch(&ta);
+            const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                &ta,
+                                                                &code[0],
+                                                                &scratch,
+                                                                &heap);
+            ASSERT(result.isInteger());
+            ASSERT(5050 == result.theInteger());
+            ASSERT(0 < heap.numScavenges());
+            ASSERT(2 == heap.emptyShape()->numTransitions());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        const bdld::Datum result = InterpretUtil::interpretBytecode(&ta,
+                                                                   &code[0]);
+        ASSERT(5050 == result.theInteger());
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 4: {
+        // Objects created by a script survive the collections triggered by
+        // allocating them, while referenced only from the value stack.
+
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // Build a list of 1000 nodes, each holding its position and the
+        // previous node, and return the position of the third-last node.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        const int ret = readDSL(
+                      &code,
+                      &errorMessage,
+                      "Pi0|S1|"                                 // 0
+                      "N2|L0|W1|L1|W0|S0|++i1|"                 // 2
+                      "L1|Pi1000|I=i13|J2|"                     // 9
+                      "L0|G1|G1|G0|X",                          // 13
+                      functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        {
+            sjtm::Heap heap(1024, &ta);
+            bdlma::SequentialAllocator scratch(&ta);
+            const bdld::Datum result = InterpretUtil::interpretBytecode(
+                                                                &ta,
+                                                                &code[0],
+                                                                &scratch,
+                                                                &heap);
+            ASSERT(result.isInteger());
+            ASSERT(997 == result.theInteger());
+            ASSERT(0 < heap.numScavenges());
+            ASSERT(0 < heap.numOldObjects());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        // With a local heap, the same script leaves no memory behind.
+
+        const bdld::Datum result = InterpretUtil::interpretBytecode(&ta,
+                                                                   &code[0]);
+        ASSERT(997 == result.theInteger());
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 3: {
+        // Evaluating a short script allocates no memory, either from the
+        // supplied allocator or the default allocator, unless the local
+        // buffer is exhausted.
+
+        bdlma::SequentialAllocator alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        int ret = readDSL(&code,
+                          &errorMessage,
+                          "Pi3|Pi1|C4|X|L0|Pi2|+i|X",
+                          functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        bslma::TestAllocator da;
+        bslma::DefaultAllocatorGuard guard(&da);
+        bslma::TestAllocator ta;
+
+        bdld::Datum result = InterpretUtil::interpretBytecode(&ta, &code[0]);
+        ASSERT(result.isInteger());
+        ASSERT(5 == result.theInteger());
+        ASSERT(0 == ta.numAllocations());
+        ASSERT(0 == da.numAllocations());
+
+        result = InterpretUtil::interpretBytecodeLocal<8192>(&ta, &code[0]);
+        ASSERT(5 == result.theInteger());
+        ASSERT(0 == ta.numAllocations());
+        ASSERT(0 == da.numAllocations());
+
+        // A buffer too small for the stacks spills to the supplied
+        // allocator, which is released when evaluation completes.
+
+        result = InterpretUtil::interpretBytecodeLocal<16>(&ta, &code[0]);
+        ASSERT(5 == result.theInteger());
+        ASSERT(0 <  ta.numAllocations());
+        ASSERT(0 == ta.numBlocksInUse());
+        ASSERT(0 == da.numAllocations());
+      } break;
+      case 2: {
+        bslma::TestAllocator ta;
+        bdlma::SequentialAllocator alloc;
+
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+        functions["repeat"] = testRepeat;
+
+        // Call 'repeat' 100 times, discarding all but the last result.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string errorMessage;
+        const int ret = readDSL(
+                      &code,
+                      &errorMessage,
+                      "Pi0|S0|"                                 // 0
+                      "L0|Pi1|+i|S0|L0|Pi1|Perepeat|E|S1|"      // 2
+                      "L0|Pi100|I=i15|J2|"                      // 11
+                      "L1|X",                                   // 15
+                      functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        const bdld::Datum result = InterpretUtil::interpretBytecode(&ta,
+                                                                   &code[0]);
+        ASSERT(result.isString());
+        ASSERT(bsl::string(100, 'x') == result.theString());
+
+        // Only the result remains allocated from the caller's allocator.
+
+        ASSERT(1 == ta.numBlocksInUse());
+        bdld::Datum::destroy(result, &ta);
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
       case 1: {
         bdlma::SequentialAllocator alloc;
         const sjtd::DatumFactory f(&alloc);
@@ -97,6 +1392,11 @@ int main(int argc, char *argv[])
             bdld::Datum   expected;
         } cases[] = {
             { "push and return", "Pi3|X", f(3) },
+            {
+                "push string and return",
+                "Psabc|X",
+                bdld::Datum::copyString("abc", 3, &alloc)
+            },
             { "add doubles", "Pd3|Pd1|+d|X", f(4.) },
             { "add ints", "Pi3|Pi1|+i|X", f(4) },
             { "eq ints, true", "Pi4|Pi4|=i|X", f(true) },
@@ -137,15 +1437,25 @@ int main(int argc, char *argv[])
                 "Pi3|V80|Pi4|L79|X",
                 f.u(),
             },
+            { "new object, set and get slot", "N2|Pi5|W1|G1|X", f(5) },
+            { "new object, undefined slot", "N1|G0|X", f.u() },
+            { "set and get property", "N0|Pi5|.=x|.x|X", f(5) },
+            { "absent property", "N1|Pi5|.=x|.y|X", f.u() },
+            { "overwrite property", "N0|Pi5|.=x|Pi6|.=x|.x|X", f(6) },
+            {
+                "properties beyond the slots",
+                "N1|Pi1|.=a|Pi2|.=b|Pi3|.=c|Pi4|.=d|Pi5|.=e|Pi6|.=f|.e|X",
+                f(5),
+            },
         };
         for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
             const Case& c = cases[i];
             bsl::vector<sjtt::Bytecode> code(&alloc);
             bsl::string errorMessage;
-            const int ret = BytecodeDSLUtil::readDSL(&code,
-                                                     &errorMessage,
-                                                     c.input,
-                                                     functions);
+            const int ret = readDSL(&code,
+                                    &errorMessage,
+                                    c.input,
+                                    functions);
             LOOP2_ASSERT(c.name, errorMessage, 0 == ret);
             const bdld::Datum result = InterpretUtil::interpretBytecode(
                                                                      &alloc,
@@ -158,6 +1468,27 @@ int main(int argc, char *argv[])
         testStatus = -1;
       }
     }
+}
+}  // close unnamed namespace
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    // Run the case on the programs as written, then optimized by
+    // 'sjto::LoopUtil' and 'sjto::ConstantFoldUtil'.
+
+    runTestCase(test);
+    if (0 <= testStatus) {
+        isOptimizing = true;
+        runTestCase(test);
+    }
 
     if (testStatus > 0) {
         cerr << "Error, non-zero test status = " << testStatus << "." << endl;
@@ -0,0 +1,259 @@
+// sjtu_trampolinetable.cpp
+#include <sjtu_trampolinetable.h>
+
+#include <bslma_default.h>
+#include <bsls_assert.h>
+
+#include <bsl_cstring.h>
+
+#include <sjtm_perfmap.h>
+#include <sjtu_interpretutil.h>
+
+using namespace BloombergLP;
+
+#if defined(__x86_64__) && defined(__linux__)
+#define SJTU_TRAMPOLINETABLE_GENERATES 1
+
+extern "C" void __register_frame(void *begin);
+extern "C" void __deregister_frame(void *begin);
+    // Register with the unwinder of the GCC runtime, or deregister, the
+    // '.eh_frame' data at the specified 'begin', ending with a terminator.
+#endif
+
+namespace sjtu {
+namespace {
+
+#if defined(SJTU_TRAMPOLINETABLE_GENERATES)
+const unsigned char k_TRAMPOLINE[] = {
+    // The trampoline, called with the context in 'rdi' and the body in
+    // 'rsi', which are passed on to the body, as the System V ABI passes
+    // them.  It links a frame, so that the profiler can walk the stack
+    // through it by frame pointers, and keeps the stack aligned to 16 bytes
+    // for the call.
+
+    0x55,                    // push %rbp
+    0x48, 0x89, 0xE5,        // mov  %rsp, %rbp
+    0xFF, 0xD6,              // call *%rsi
+    0x5D,                    // pop  %rbp
+    0xC3                     // ret
+};
+
+const unsigned char k_FRAME[] = {
+    // The description of the frame of a trampoline to the unwinder, in the
+    // '.eh_frame' format of the System V ABI: a CIE, an FDE whose code
+    // address is patched at 'k_FRAME_CODE_OFFSET', and a terminator.  It lets
+    // an exception thrown by the body be propagated through the trampoline.
+
+    // CIE
+    20, 0, 0, 0,             // length
+    0, 0, 0, 0,              // CIE id
+    1,                       // version
+    'z', 'R', 0,             // augmentation
+    1,                       // code alignment factor
+    0x78,                    // data alignment factor, -8
+    16,                      // return address register, rip
+    1,                       // augmentation data length
+    0x00,                    // FDE pointer encoding, DW_EH_PE_absptr
+    0x0C, 7, 8,              // DW_CFA_def_cfa:            rsp + 8
+    0x90, 1,                 // DW_CFA_offset:             rip at cfa - 8
+    0, 0,                    // DW_CFA_nop
+
+    // FDE
+    36, 0, 0, 0,             // length
+    28, 0, 0, 0,             // distance back to the CIE
+    0, 0, 0, 0, 0, 0, 0, 0,  // code address
+    sizeof k_TRAMPOLINE, 0, 0, 0, 0, 0, 0, 0,
+                             // code size
+    0,                       // augmentation data length
+    0x41,                    // DW_CFA_advance_loc:        1, after push
+    0x0E, 16,                // DW_CFA_def_cfa_offset:     16
+    0x86, 2,                 // DW_CFA_offset:             rbp at cfa - 16
+    0x43,                    // DW_CFA_advance_loc:        3, after mov
+    0x0D, 6,                 // DW_CFA_def_cfa_register:   rbp
+    0x43,                    // DW_CFA_advance_loc:        3, after pop
+    0x0C, 7, 8,              // DW_CFA_def_cfa:            rsp + 8
+    0xC6,                    // DW_CFA_restore:            rbp
+    0, 0,                    // DW_CFA_nop
+
+    0, 0, 0, 0               // terminator
+};
+
+const int k_FRAME_CODE_OFFSET = 32;
+    // The offset in 'k_FRAME' of the address of the code it describes.
+#endif
+
+struct Interpretation {
+    // This 'struct' holds the arguments of an evaluation called through a
+    // trampoline.
+
+    TrampolineTable::Datum            *d_result_p;
+    TrampolineTable::Allocator        *d_allocator_p;
+    const sjtt::Bytecode              *d_codes_p;
+    const sjtt::ExceptionTable        *d_handlers_p;
+    const TrampolineTable::Datum      *d_arguments_p;
+    int                                d_numArguments;
+    TrampolineTable::Allocator        *d_scratchAllocator_p;
+    sjtm::Heap                        *d_heap_p;
+    int                                d_osrThreshold;
+    sjto::CompileQueue                *d_compiler_p;
+    int                                d_baselineThreshold;
+    sjtm::PerfMap                     *d_perfMap_p;
+};
+
+int interpret(void *context)
+    // Evaluate the 'Interpretation' at the specified 'context', and return
+    // the status of the evaluation.
+{
+    const Interpretation& i = *static_cast<Interpretation *>(context);
+    return InterpretUtil::interpretBytecode(i.d_result_p,
+                                            i.d_allocator_p,
+                                            i.d_codes_p,
+                                            i.d_handlers_p,
+                                            i.d_arguments_p,
+                                            i.d_numArguments,
+                                            i.d_scratchAllocator_p,
+                                            i.d_heap_p,
+                                            i.d_osrThreshold,
+                                            i.d_compiler_p,
+                                            i.d_baselineThreshold,
+                                            0,
+                                            i.d_perfMap_p);
+}
+
+}  // close unnamed namespace
+
+                           // ---------------------
+                           // class TrampolineTable
+                           // ---------------------
+
+// PRIVATE MANIPULATORS
+TrampolineTable::Trampoline TrampolineTable::trampolineFor(
+                                          const sjtt::Bytecode *firstCode,
+                                          int                   entryIndex,
+                                          const StringRef&      sourceName)
+{
+    const sjtt::Bytecode *entry = firstCode + entryIndex;
+
+    Trampolines::iterator it = d_trampolines.find(entry);
+    if (d_trampolines.end() != it) {
+        return it->second;                                            // RETURN
+    }
+
+    Trampoline trampoline = 0;
+#if defined(SJTU_TRAMPOLINETABLE_GENERATES)
+    void *block = d_space.allocate(sizeof k_TRAMPOLINE);
+    if (0 != block) {
+        if (0 == d_space.write(block,
+                               0,
+                               k_TRAMPOLINE,
+                               sizeof k_TRAMPOLINE)) {
+            trampoline = reinterpret_cast<Trampoline>(block);
+            ++d_numTrampolines;
+
+            d_frames.reserve(d_frames.size() + 1);
+            unsigned char *frame = static_cast<unsigned char *>(
+                                      d_allocator_p->allocate(sizeof k_FRAME));
+            bsl::memcpy(frame, k_FRAME, sizeof k_FRAME);
+            bsl::memcpy(frame + k_FRAME_CODE_OFFSET, &block, sizeof block);
+            d_frames.push_back(frame);
+            __register_frame(frame);
+
+            if (0 != d_perfMap_p) {
+                d_perfMap_p->add(block,
+                                 sizeof k_TRAMPOLINE,
+                                 sjtm::PerfMap::symbolName(sourceName,
+                                                           entryIndex));
+            }
+        }
+        else {
+            d_space.deallocate(block);
+        }
+    }
+#else
+    (void)sourceName;
+#endif
+
+    // An entry whose trampoline cannot be created is not tried again.
+
+    d_trampolines[entry] = trampoline;
+    return trampoline;
+}
+
+// CLASS METHODS
+bool TrampolineTable::isSupported()
+{
+#if defined(SJTU_TRAMPOLINETABLE_GENERATES)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// CREATORS
+TrampolineTable::TrampolineTable(sjtm::PerfMap *perfMap,
+                                 Allocator     *basicAllocator)
+: d_space(sjtm::CodeSpace::s_SlabSize, basicAllocator)
+, d_trampolines(basicAllocator)
+, d_frames(basicAllocator)
+, d_numTrampolines(0)
+, d_perfMap_p(perfMap)
+, d_allocator_p(bslma::Default::allocator(basicAllocator))
+{
+}
+
+TrampolineTable::~TrampolineTable()
+{
+    for (bsl::size_t i = 0; i < d_frames.size(); ++i) {
+#if defined(SJTU_TRAMPOLINETABLE_GENERATES)
+        __deregister_frame(d_frames[i]);
+#endif
+        d_allocator_p->deallocate(d_frames[i]);
+    }
+}
+
+// MANIPULATORS
+int TrampolineTable::call(const sjtt::Bytecode *firstCode,
+                          int                   entryIndex,
+                          const StringRef&      sourceName,
+                          Body                  body,
+                          void                 *context)
+{
+    BSLS_ASSERT(0 != firstCode);
+    BSLS_ASSERT(0 <= entryIndex);
+    BSLS_ASSERT(0 != body);
+
+    const Trampoline trampoline = trampolineFor(firstCode,
+                                                entryIndex,
+                                                sourceName);
+    return 0 != trampoline ? trampoline(context, body) : body(context);
+}
+
+int TrampolineTable::interpretBytecode(
+                                 Datum                      *result,
+                                 Allocator                  *allocator,
+                                 const sjtt::Bytecode       *codes,
+                                 const sjtt::ExceptionTable *handlers,
+                                 const Datum                *arguments,
+                                 int                         numArguments,
+                                 Allocator                  *scratchAllocator,
+                                 const StringRef&            sourceName,
+                                 sjtm::Heap                 *heap,
+                                 int                         osrThreshold,
+                                 sjto::CompileQueue         *compiler,
+                                 int                         baselineThreshold)
+{
+    Interpretation interpretation = { result,
+                                      allocator,
+                                      codes,
+                                      handlers,
+                                      arguments,
+                                      numArguments,
+                                      scratchAllocator,
+                                      heap,
+                                      osrThreshold,
+                                      compiler,
+                                      baselineThreshold,
+                                      d_perfMap_p };
+    return call(codes, 0, sourceName, &interpret, &interpretation);
+}
+}
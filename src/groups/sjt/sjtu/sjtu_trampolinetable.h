@@ -0,0 +1,186 @@
+// sjtu_trampolinetable.h
+
+#ifndef INCLUDED_SJTU_TRAMPOLINETABLE
+#define INCLUDED_SJTU_TRAMPOLINETABLE
+
+#ifndef INCLUDED_BDLD_DATUM
+#include <bdld_datum.h>
+#endif
+
+#ifndef INCLUDED_BSL_UNORDERED_MAP
+#include <bsl_unordered_map.h>
+#endif
+
+#ifndef INCLUDED_BSL_VECTOR
+#include <bsl_vector.h>
+#endif
+
+#ifndef INCLUDED_BSLSTL_STRINGREF
+#include <bslstl_stringref.h>
+#endif
+
+#ifndef INCLUDED_SJTM_CODESPACE
+#include <sjtm_codespace.h>
+#endif
+
+namespace BloombergLP {
+namespace bslma { class Allocator; }
+}
+
+namespace sjtm { class Heap; }
+namespace sjtm { class PerfMap; }
+namespace sjto { class CompileQueue; }
+namespace sjtt { class Bytecode; }
+namespace sjtt { class ExceptionTable; }
+
+namespace sjtu {
+
+                           // =====================
+                           // class TrampolineTable
+                           // =====================
+
+class TrampolineTable {
+    // This class is a mechanism tagging the evaluations of Scramjet functions
+    // with native frames, so that a profiler sampling the native stack, such
+    // as 'perf record --call-graph fp', attributes the time spent evaluating
+    // a function to that function rather than only to the interpreter.
+    //
+    // Each function entry, i.e., code at which a function is entered, has a
+    // trampoline of its own: a few instructions, copied into a code space,
+    // that set up a frame and call a given body.  A trampoline is created
+    // the first time its entry is called through the table, and is recorded
+    // in the perf map of the table, if any, under the name
+    // 'sjtm::PerfMap::symbolName' gives the entry, so that the profiler
+    // shows the body's frames under that symbol.  Note that the calls made
+    // within an evaluation are evaluated by the same loop, in the same
+    // native frame, and so are attributed to the entry the evaluation
+    // started at, except those evaluated in the machine code of the baseline
+    // tier, which is recorded in the perf map as it is compiled.
+    //
+    // Each trampoline is described to the unwinder of the GCC runtime, so
+    // that an exception thrown by a body propagates through it to the
+    // caller of the table.  Trampolines are generated for x86-64 Linux.
+    // Elsewhere, or if the code space is exhausted, a body is called
+    // directly, untagged.  A table must be used by one thread at a time.
+
+  public:
+    // TYPES
+    typedef BloombergLP::bdld::Datum Datum;
+    typedef BloombergLP::bslma::Allocator Allocator;
+    typedef BloombergLP::bslstl::StringRef StringRef;
+
+    typedef int (*Body)(void *context);
+        // The type of a function called through a trampoline with the
+        // specified 'context', returning a status.
+
+  private:
+    // PRIVATE TYPES
+    typedef int (*Trampoline)(void *context, Body body);
+
+    typedef bsl::unordered_map<const sjtt::Bytecode *, Trampoline>
+                                                                  Trampolines;
+        // The trampolines, by function entry, 0 for one that could not be
+        // created.
+
+    // DATA
+    sjtm::CodeSpace  d_space;            // of the trampolines
+    Trampolines      d_trampolines;
+    bsl::vector<void *>
+                     d_frames;           // descriptions of the trampolines
+                                         // registered with the unwinder
+    int              d_numTrampolines;
+    sjtm::PerfMap   *d_perfMap_p;        // held, not owned, or 0
+    Allocator       *d_allocator_p;      // held, not owned
+
+    // PRIVATE MANIPULATORS
+    Trampoline trampolineFor(const sjtt::Bytecode *firstCode,
+                             int                   entryIndex,
+                             const StringRef&      sourceName);
+        // Return the trampoline of the function entered at the specified
+        // 'entryIndex' from the specified 'firstCode' of the program read
+        // from the specified 'sourceName', creating it if it is not created
+        // yet, or 0 if it cannot be created.
+
+    // NOT IMPLEMENTED
+    TrampolineTable(const TrampolineTable&) = delete;
+    TrampolineTable& operator=(const TrampolineTable&) = delete;
+
+  public:
+    // CLASS METHODS
+    static bool isSupported();
+        // Return 'true' if trampolines are generated for the platform, and
+        // 'false' otherwise.
+
+    // CREATORS
+    explicit TrampolineTable(sjtm::PerfMap *perfMap = 0,
+                             Allocator     *basicAllocator = 0);
+        // Create a table having no trampolines, which records those it
+        // creates in the optionally specified 'perfMap'.  Optionally specify
+        // a 'basicAllocator' used to supply memory.  If 'basicAllocator' is
+        // 0, the currently installed default allocator is used.  The
+        // behavior is undefined unless 'perfMap', if not 0, outlives this
+        // object.
+
+    ~TrampolineTable();
+        // Unmap the trampolines and destroy this object.  The behavior is
+        // undefined if a trampoline is executing.
+
+    // MANIPULATORS
+    int call(const sjtt::Bytecode *firstCode,
+             int                   entryIndex,
+             const StringRef&      sourceName,
+             Body                  body,
+             void                 *context);
+        // Call the specified 'body' with the specified 'context' through the
+        // trampoline of the function entered at the specified 'entryIndex'
+        // from the specified 'firstCode' of the program read from the
+        // specified 'sourceName', which may be empty, and return the value
+        // 'body' returns.  An exception thrown by 'body' propagates to the
+        // caller.  The behavior is undefined unless '0 <= entryIndex'.
+
+    int interpretBytecode(Datum                      *result,
+                          Allocator                  *allocator,
+                          const sjtt::Bytecode       *codes,
+                          const sjtt::ExceptionTable *handlers,
+                          const Datum                *arguments,
+                          int                         numArguments,
+                          Allocator                  *scratchAllocator,
+                          const StringRef&            sourceName,
+                          sjtm::Heap                 *heap = 0,
+                          int                         osrThreshold = 0,
+                          sjto::CompileQueue         *compiler = 0,
+                          int                         baselineThreshold = 0);
+        // Evaluate the specified byte 'codes', as the function entered at
+        // their first code of the program read from the specified
+        // 'sourceName', through its trampoline, as
+        // 'InterpretUtil::interpretBytecode' does with the specified
+        // 'result', 'allocator', 'handlers', 'arguments', 'numArguments',
+        // 'scratchAllocator', and the optionally specified 'heap',
+        // 'osrThreshold', 'compiler' and 'baselineThreshold', and return the
+        // value it returns.  The machine code of the functions compiled by
+        // the baseline tier is recorded in the perf map of this table, if
+        // any.  An exception thrown by the evaluation, e.g., if memory
+        // cannot be allocated, propagates to the caller.
+
+    // ACCESSORS
+    int numTrampolines() const;
+        // Return the number of trampolines created.
+};
+
+// ============================================================================
+//                             INLINE DEFINITIONS
+// ============================================================================
+
+                           // ---------------------
+                           // class TrampolineTable
+                           // ---------------------
+
+// ACCESSORS
+inline
+int TrampolineTable::numTrampolines() const
+{
+    return d_numTrampolines;
+}
+}
+
+#endif
@@ -0,0 +1,441 @@
+// sjtu_trampolinetable.t.cpp                                     -*-C++-*-
+
+#include <sjtu_trampolinetable.h>
+
+#include <bdlma_sequentialallocator.h>
+#include <bdls_testutil.h>
+
+#include <bslma_testallocator.h>
+
+#include <bsl_cstdio.h>
+#include <bsl_cstring.h>
+#include <bsl_fstream.h>
+#include <bsl_sstream.h>
+#include <bsl_string.h>
+#include <bsl_vector.h>
+
+#include <sjtd_datumfactory.h>
+#include <sjtm_perfmap.h>
+#include <sjtt_bytecode.h>
+#include <sjtt_executioncontext.h>
+#include <sjtu_baselineutil.h>
+#include <sjtu_bytecodedslutil.h>
+#include <sjtu_interpretutil.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace BloombergLP;
+using namespace bsl;
+using namespace sjtu;
+
+// ============================================================================
+//                     STANDARD BDE ASSERT TEST FUNCTION
+// ----------------------------------------------------------------------------
+
+namespace {
+
+int testStatus = 0;
+
+void aSsErT(bool condition, const char *message, int line)
+{
+    if (condition) {
+        cout << "Error " __FILE__ "(" << line << "): " << message
+             << "    (failed)" << endl;
+
+        if (0 <= testStatus && testStatus <= 100) {
+            ++testStatus;
+        }
+    }
+}
+
+}  // close unnamed namespace
+
+// ============================================================================
+//               STANDARD BDE TEST DRIVER MACRO ABBREVIATIONS
+// ----------------------------------------------------------------------------
+
+#define ASSERT       BDLS_TESTUTIL_ASSERT
+#define ASSERTV      BDLS_TESTUTIL_ASSERTV
+
+#define LOOP_ASSERT  BDLS_TESTUTIL_LOOP_ASSERT
+#define LOOP0_ASSERT BDLS_TESTUTIL_LOOP0_ASSERT
+#define LOOP1_ASSERT BDLS_TESTUTIL_LOOP1_ASSERT
+#define LOOP2_ASSERT BDLS_TESTUTIL_LOOP2_ASSERT
+#define LOOP3_ASSERT BDLS_TESTUTIL_LOOP3_ASSERT
+#define LOOP4_ASSERT BDLS_TESTUTIL_LOOP4_ASSERT
+#define LOOP5_ASSERT BDLS_TESTUTIL_LOOP5_ASSERT
+#define LOOP6_ASSERT BDLS_TESTUTIL_LOOP6_ASSERT
+
+#define Q            BDLS_TESTUTIL_Q   // Quote identifier literally.
+#define P            BDLS_TESTUTIL_P   // Print identifier and value.
+#define P_           BDLS_TESTUTIL_P_  // P(X) without '\n'.
+#define T_           BDLS_TESTUTIL_T_  // Print a tab (w/o newline).
+#define L_           BDLS_TESTUTIL_L_  // current Line number
+
+// ============================================================================
+//                     GLOBAL TYPEDEFS/CONSTANTS FOR TESTING
+// ----------------------------------------------------------------------------
+
+namespace {
+
+typedef bsls::Types::UintPtr UintPtr;
+
+struct Call {
+    // This 'struct' records a call of 'body'.
+
+    int         d_numCalls;
+    const void *d_returnAddress_p;
+};
+
+int body(void *context)
+    // Record the call in the 'Call' at the specified 'context', and return
+    // the number of calls.
+{
+    Call *call = static_cast<Call *>(context);
+    call->d_returnAddress_p = __builtin_return_address(0);
+    return ++call->d_numCalls;
+}
+
+struct Failure {
+    // This 'struct' is the C++ exception thrown by the functions below.
+
+    int d_value;
+};
+
+int throwingBody(void *context)
+    // Throw a 'Failure' holding the 'int' at the specified 'context'.
+{
+    const Failure failure = { *static_cast<int *>(context) };
+    throw failure;
+}
+
+bdld::Datum throwingFunction(const sjtt::ExecutionContext& context)
+    // Throw a 'Failure' holding the integer argument of the specified
+    // 'context'.
+{
+    const Failure failure = { context.args()[0].theInteger() };
+    throw failure;
+}
+
+bsl::string readFile(const bsl::string& path)
+    // Return the contents of the file at the specified 'path', or an empty
+    // string if it cannot be read.
+{
+    bsl::ifstream     in(path.c_str());
+    bsl::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+}
+
+// ============================================================================
+//                               MAIN PROGRAM
+// ----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    const int         test = argc > 1 ? atoi(argv[1]) : 0;
+    const bool     verbose = argc > 2;
+
+    cout << "TEST " << __FILE__ << " CASE " << test << endl;
+
+    switch (test) { case 0:
+      case 5: {
+        if (verbose) cout << endl
+                          << "baseline code in the perf map" << endl
+                          << "=============================" << endl;
+
+        // The machine code of a function compiled by the baseline tier of an
+        // evaluation through the table is recorded in the perf map, after
+        // the trampoline of the evaluation, named for its entry.
+
+        bdlma::SequentialAllocator                alloc;
+        const sjtd::DatumFactory                  f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // The sum of 1 to 30, recursively.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string                 errorMessage;
+        const int ret = BytecodeDSLUtil::readDSL(
+                            &code,
+                            &errorMessage,
+                            "Pi30|Pi1|C4|X|L0|Pi0|I=i15|L0|Pi-1|+i|Pi1|C4|"
+                            "L0|+i|X|Pi0|X",
+                            functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        char directory[64];
+        bsl::strcpy(directory, "/tmp/sjtu_trampolinetable.XXXXXX");
+        ASSERT(0 != ::mkdtemp(directory));
+
+        const bool IS_NATIVE = TrampolineTable::isSupported() &&
+                               BaselineUtil::isNativeSupported();
+
+        bslma::TestAllocator ta;
+        bsl::string          path;
+        {
+            sjtm::PerfMap   map(sjtm::PerfMap::e_PERF_MAP, directory, &ta);
+            TrampolineTable table(&map, &ta);
+            path = map.perfMapPath();
+
+            bdlma::SequentialAllocator scratch(&ta);
+            bdld::Datum                result;
+            ASSERT(0 == table.interpretBytecode(&result,
+                                                &ta,
+                                                &code[0],
+                                                0,
+                                                0,
+                                                0,
+                                                &scratch,
+                                                "r.sjt",
+                                                0,
+                                                0,
+                                                0,
+                                                1));
+            ASSERTV(result, f(465) == result);
+            bdld::Datum::destroy(result, &ta);
+
+            ASSERTV(map.numRecords(), (IS_NATIVE ? 2 : 0) == map.numRecords());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        const bsl::string lines = readFile(path);
+        ::unlink(path.c_str());
+        ::rmdir(directory);
+
+        if (IS_NATIVE) {
+            const bsl::size_t trampoline = lines.find(" sjt::r.sjt:0\n");
+            const bsl::size_t baseline   = lines.find(" sjt::4 [baseline]\n");
+            ASSERT(bsl::string::npos != trampoline);
+            ASSERT(bsl::string::npos != baseline);
+            ASSERT(trampoline < baseline);
+        }
+      } break;
+      case 4: {
+        if (verbose) cout << endl
+                          << "exceptions through a trampoline" << endl
+                          << "===============================" << endl;
+
+        // A C++ exception thrown by a body, or by an external function during
+        // an evaluation, propagates through the trampoline to the caller of
+        // the table, rather than terminating the program, and the table
+        // remains usable.
+
+        bdlma::SequentialAllocator                alloc;
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+        functions["throwing"] = &throwingFunction;
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string                 errorMessage;
+        const int ret = BytecodeDSLUtil::readDSL(&code,
+                                                 &errorMessage,
+                                                 "Pi7|Pi1|Pethrowing|E|X",
+                                                 functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        sjtt::Bytecode CODES[2];
+
+        bslma::TestAllocator ta;
+        {
+            TrampolineTable table(0, &ta);
+            for (int i = 0; i < 3; ++i) {
+                int value  = 40 + i;
+                int caught = -1;
+                try {
+                    table.call(CODES, i % 2, "", &throwingBody, &value);
+                }
+                catch (const Failure& failure) {
+                    caught = failure.d_value;
+                }
+                LOOP2_ASSERT(i, caught, value == caught);
+
+                Call call = { 0, 0 };
+                LOOP_ASSERT(i, 1 == table.call(CODES, i % 2, "", &body,
+                                               &call));
+            }
+
+            bdlma::SequentialAllocator scratch(&ta);
+            bdld::Datum                result;
+            int                        caught = -1;
+            try {
+                table.interpretBytecode(&result,
+                                        &ta,
+                                        &code[0],
+                                        0,
+                                        0,
+                                        0,
+                                        &scratch,
+                                        "throwing.sjt");
+            }
+            catch (const Failure& failure) {
+                caught = failure.d_value;
+            }
+            ASSERTV(caught, 7 == caught);
+
+            ASSERT((TrampolineTable::isSupported() ? 3 : 0)
+                                                    == table.numTrampolines());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 3: {
+        if (verbose) cout << endl
+                          << "evaluation through a trampoline" << endl
+                          << "===============================" << endl;
+
+        bdlma::SequentialAllocator                alloc;
+        const sjtd::DatumFactory                  f(&alloc);
+        BytecodeDSLUtil::FunctionNameToAddressMap functions;
+
+        // The sum of the integers below the argument, by a loop that is
+        // replaced on the stack when hot.
+
+        bsl::vector<sjtt::Bytecode> code(&alloc);
+        bsl::string                 errorMessage;
+        const int ret = BytecodeDSLUtil::readDSL(
+                                      &code,
+                                      &errorMessage,
+                                      "Pi0|S1|Pi0|S2|L2|L0|I=i13|"
+                                      "L1|L2|+i|S1|++i2|J4|L1|X",
+                                      functions);
+        LOOP_ASSERT(errorMessage, 0 == ret);
+
+        bslma::TestAllocator ta;
+        {
+            TrampolineTable table(0, &ta);
+            for (int n = 0; n < 20; n += 7) {
+                const bdld::Datum argument = f(n);
+
+                bdlma::SequentialAllocator scratch(&ta);
+                bdld::Datum                expected;
+                const int                  expectedStatus =
+                          InterpretUtil::interpretBytecode(&expected,
+                                                           &ta,
+                                                           &code[0],
+                                                           0,
+                                                           &argument,
+                                                           1,
+                                                           &scratch);
+                bdld::Datum result;
+                const int   status = table.interpretBytecode(&result,
+                                                             &ta,
+                                                             &code[0],
+                                                             0,
+                                                             &argument,
+                                                             1,
+                                                             &scratch,
+                                                             "sum.sjt",
+                                                             0,
+                                                             3);
+                LOOP2_ASSERT(n, status, expectedStatus == status);
+                LOOP2_ASSERT(n, result, expected == result);
+                LOOP2_ASSERT(n, result, f(n * (n - 1) / 2) == result);
+                bdld::Datum::destroy(expected, &ta);
+                bdld::Datum::destroy(result, &ta);
+            }
+            ASSERT((TrampolineTable::isSupported() ? 1 : 0)
+                                                    == table.numTrampolines());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      case 2: {
+        if (verbose) cout << endl
+                          << "tagged frames" << endl
+                          << "=============" << endl;
+
+        // Each entry has a trampoline, recorded in the perf map under its
+        // name, and the body is called from it.
+
+        sjtt::Bytecode CODES[4];
+
+        char directory[64];
+        bsl::strcpy(directory, "/tmp/sjtu_trampolinetable.XXXXXX");
+        ASSERT(0 != ::mkdtemp(directory));
+
+        bslma::TestAllocator ta;
+        bsl::string          path;
+        Call                 call = { 0, 0 };
+        const void          *returnAddresses[2] = { 0, 0 };
+        {
+            sjtm::PerfMap   map(sjtm::PerfMap::e_PERF_MAP, directory, &ta);
+            TrampolineTable table(&map, &ta);
+            path = map.perfMapPath();
+
+            ASSERT(1 == table.call(CODES, 0, "t.sjt", &body, &call));
+            returnAddresses[0] = call.d_returnAddress_p;
+            ASSERT(2 == table.call(CODES, 2, "t.sjt", &body, &call));
+            returnAddresses[1] = call.d_returnAddress_p;
+            ASSERT(3 == table.call(CODES, 0, "t.sjt", &body, &call));
+            ASSERT(returnAddresses[0] == call.d_returnAddress_p);
+            ASSERT(4 == table.call(CODES + 2, 0, "t.sjt", &body, &call));
+            ASSERT(returnAddresses[1] == call.d_returnAddress_p);
+
+            if (!TrampolineTable::isSupported()) {
+                ASSERT(0 == table.numTrampolines());
+                ASSERT(0 == map.numRecords());
+                break;                                                // BREAK
+            }
+            ASSERT(2 == table.numTrampolines());
+            ASSERT(2 == map.numRecords());
+            ASSERT(returnAddresses[0] != returnAddresses[1]);
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+
+        const bsl::string lines = readFile(path);
+        ::unlink(path.c_str());
+        ::rmdir(directory);
+
+        const char *NAMES[] = { "sjt::t.sjt:0", "sjt::t.sjt:2" };
+        const char *next    = lines.c_str();
+        for (int i = 0; i < 2; ++i) {
+            unsigned long long start;
+            unsigned long long size;
+            char               name[32];
+            int                length = 0;
+            LOOP_ASSERT(i, 3 == bsl::sscanf(next,
+                                            "%llx %llx %31s\n%n",
+                                            &start,
+                                            &size,
+                                            name,
+                                            &length));
+            LOOP_ASSERT(i, bsl::string(NAMES[i]) == name);
+
+            const UintPtr address = reinterpret_cast<UintPtr>(
+                                                          returnAddresses[i]);
+            LOOP_ASSERT(i, start < address && address <= start + size);
+            next += length;
+        }
+        ASSERT('\0' == *next);
+      } break;
+      case 1: {
+        if (verbose) cout << endl
+                          << "breathing test" << endl
+                          << "==============" << endl;
+
+        sjtt::Bytecode CODE;
+
+        bslma::TestAllocator ta;
+        {
+            TrampolineTable table(0, &ta);
+            ASSERT(0 == table.numTrampolines());
+
+            Call call = { 41, 0 };
+            ASSERT(42 == table.call(&CODE, 0, "", &body, &call));
+            ASSERT(42 == call.d_numCalls);
+            ASSERT((TrampolineTable::isSupported() ? 1 : 0)
+                                                    == table.numTrampolines());
+        }
+        ASSERT(0 == ta.numBlocksInUse());
+      } break;
+      default: {
+        cerr << "WARNING: CASE `" << test << "' NOT FOUND." << endl;
+        testStatus = -1;
+      }
+    }
+
+    if (testStatus > 0) {
+        cerr << "Error, non-zero test status = " << testStatus << "." << endl;
+    }
+    return testStatus;
+}